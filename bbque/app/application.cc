@@ -25,6 +25,9 @@
 # include <cmath>
 #endif
 #include <limits>
+#ifdef CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+# include <sys/mman.h>
+#endif
 
 #include "bbque/application_manager.h"
 #include "bbque/app/working_mode.h"
@@ -91,6 +94,10 @@ Application::Application(std::string const & _name,
 	schedule.preSyncState = NEW;
 	schedule.syncState    = SYNC_NONE;
 	logger->Info("Built new EXC [%s]", StrId());
+
+#ifdef CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+	AttachTelemetry();
+#endif
 }
 
 Application::~Application() {
@@ -102,8 +109,52 @@ Application::~Application() {
 	if (tg_sem != nullptr)
 		sem_close(tg_sem);
 #endif // CONFIG_BBQUE_TG_PROG_MODEL
+#ifdef CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+	if (telemetry != nullptr)
+		munmap(telemetry, sizeof(rtlib::rtp_telemetry_page_t));
+#endif
+}
+
+#ifdef CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+
+void Application::AttachTelemetry() {
+	char shm_name[BBQUE_RTP_TELEMETRY_NAME_LENGTH];
+	rtlib::rtp_telemetry_name(shm_name, Pid(), ExcId());
+
+	// Not available for EXCs not registered through the RTLib
+	int fd = shm_open(shm_name, O_RDWR, 0);
+	if (fd < 0) {
+		logger->Debug("[%s] Telemetry page [%s] not available",
+			StrId(), shm_name);
+		return;
+	}
+
+	void * paddr = mmap(NULL, sizeof(rtlib::rtp_telemetry_page_t),
+			PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (paddr == MAP_FAILED) {
+		logger->Warn("[%s] Telemetry page [%s] mapping FAILED",
+			StrId(), shm_name);
+		return;
+	}
+
+	rtlib::rtp_telemetry_page_t * ppage =
+		static_cast<rtlib::rtp_telemetry_page_t *>(paddr);
+	if (ppage->version != BBQUE_RTP_TELEMETRY_VERSION) {
+		logger->Warn("[%s] Telemetry page [%s] version mismatch "
+			"(0x%08X != 0x%08X)", StrId(), shm_name,
+			ppage->version, BBQUE_RTP_TELEMETRY_VERSION);
+		munmap(paddr, sizeof(rtlib::rtp_telemetry_page_t));
+		return;
+	}
+
+	telemetry = ppage;
+	telemetry->attached.store(1);
+	logger->Info("[%s] Telemetry page [%s] attached", StrId(), shm_name);
 }
 
+#endif // CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+
 void Application::SetPriority(AppPrio_t _prio) {
 	bbque::ApplicationManager &am(bbque::ApplicationManager::GetInstance());
 	// If _prio value is greater then the lowest priority
@@ -418,9 +418,10 @@ void WorkingMode::UpdateBindingInfo(
 				resources.sched_bindings[resources.sync_refn],
 				static_cast<br::ResourceType>(r_type));
 		}
-		logger->Debug("UpdateBinding: %s R{%-3s}: %s",
-				str_id, br::GetResourceTypeString(r_type),
-				new_mask.ToStringCG().c_str());
+		if (logger->IsEnabled(bu::Logger::DEBUG_LEVEL))
+			logger->Debug("UpdateBinding: %s R{%-3s}: %s",
+					str_id, br::GetResourceTypeString(r_type),
+					new_mask.ToStringCG().c_str());
 
 		// Update current/previous bitset changes only if required
 		if (!update_changed || new_mask.Count() == 0) {
@@ -17,8 +17,11 @@
 
 #include "bbque/application_proxy.h"
 
+#include <cmath>
+
 #include "bbque/config.h"
 #include "bbque/application_manager.h"
+#include "bbque/configuration_manager.h"
 #include "bbque/process_manager.h"
 #include "bbque/resource_accounter.h"
 #include "bbque/resource_manager.h"
@@ -32,19 +35,79 @@
 #endif
 
 #define MODULE_NAMESPACE APPLICATION_PROXY_NAMESPACE
+#define MODULE_CONFIG "ApplicationProxy"
+
+/** The default number of executors of each pool */
+#define BBQUE_DEFAULT_AP_EXECUTORS 8
+/** The default maximum number of queued sessions of each pool */
+#define BBQUE_DEFAULT_AP_QUEUE_LENGTH 256
+/** The maximum number of command session objects kept for reuse */
+#define BBQUE_AP_CMD_SESSIONS_CACHED 64
+
+/** Metrics (class SAMPLE) declaration */
+#define AP_SAMPLE_METRIC(NAME, DESC)\
+ {APPLICATION_PROXY_NAMESPACE "." NAME, DESC, \
+	 MetricsCollector::SAMPLE, 0, NULL, 0}
 
 namespace ba = bbque::app;
 namespace bl = bbque::rtlib;
 namespace br = bbque::res;
+namespace po = boost::program_options;
 
 namespace bbque {
 
+/* Definition of metrics used by this module */
+MetricsCollector::MetricsCollection_t
+ApplicationProxy::metrics[AP_METRICS_COUNT] = {
+	//----- Sampling statistics
+	AP_SAMPLE_METRIC("rqs.depth", "Requests queue depth"),
+	AP_SAMPLE_METRIC("rqs.qtime", "Requests queuing t[ms]"),
+	AP_SAMPLE_METRIC("rqs.stime", "Requests service t[ms]"),
+	AP_SAMPLE_METRIC("cmd.depth", "Commands queue depth"),
+	AP_SAMPLE_METRIC("cmd.qtime", "Commands queuing t[ms]"),
+	AP_SAMPLE_METRIC("cmd.stime", "Commands service t[ms]"),
+};
+
 ApplicationProxy::ApplicationProxy():
-		Worker() {
+		Worker(),
+		mc(bu::MetricsCollector::GetInstance()),
+		next_token(1) {
+	unsigned int nr_executors;
+	unsigned int queue_length;
 
 	//---------- Setup Worker
 	Worker::Setup(BBQUE_MODULE_NAME("ap"), APPLICATION_PROXY_NAMESPACE);
 
+	//---------- Loading module configuration
+	ConfigurationManager & cfm(ConfigurationManager::GetInstance());
+	po::options_description opts_desc("Application Proxy Options");
+	opts_desc.add_options()
+		(MODULE_CONFIG ".executors",
+		 po::value<unsigned int>
+		 (&nr_executors)->default_value(BBQUE_DEFAULT_AP_EXECUTORS),
+		 "The number of executors serving requests (and commands)")
+		(MODULE_CONFIG ".queue_length",
+		 po::value<unsigned int>
+		 (&queue_length)->default_value(BBQUE_DEFAULT_AP_QUEUE_LENGTH),
+		 "The maximum number of requests (and commands) queued")
+		;
+	po::variables_map opts_vm;
+	cfm.ParseConfigurationFile(opts_desc, opts_vm);
+
+	//---------- Setup the sessions executors
+	executors[EXEC_REQUEST].reset(new bu::ExecutorPool(
+			nr_executors, queue_length, BBQUE_MODULE_NAME("ap.rq")));
+	executors[EXEC_COMMAND].reset(new bu::ExecutorPool(
+			nr_executors, queue_length, BBQUE_MODULE_NAME("ap.cm")));
+	logger->Info("Sessions executors: %d requests, %d commands "
+			"[queue length: %d]",
+			executors[EXEC_REQUEST]->Executors(),
+			executors[EXEC_COMMAND]->Executors(),
+			executors[EXEC_REQUEST]->Capacity());
+
+	//---------- Setup all the module metrics
+	mc.Register(metrics, AP_METRICS_COUNT);
+
 	//---------- Initialize the RPC channel module
 	// TODO look the configuration file for the required channel
 	// Build an RPCChannelIF object
@@ -70,6 +133,13 @@ ApplicationProxy::ApplicationProxy():
 
 ApplicationProxy::~ApplicationProxy() {
 	// TODO add code to release the RPC Channel module
+
+	// Wait for the queued sessions, which could still recycle a command
+	// session object, before releasing the cached ones
+	for (auto & pool: executors)
+		pool.reset();
+	for (cmdSn_t * pcs: cmdSnFree)
+		delete pcs;
 }
 
 ApplicationProxy & ApplicationProxy::GetInstance() {
@@ -85,15 +155,56 @@ bl::rpc_msg_type_t ApplicationProxy::GetNextMessage(pchMsg_t & pChMsg) {
 	return (bl::rpc_msg_type_t)pChMsg->typ;
 }
 
+void ApplicationProxy::Dispatch(ExecType_t type, bu::ExecutorPool::Job_t job) {
+	bu::ExecutorPool & pool(*executors[type]);
+	// The metrics of each pool are: queue depth, queuing and service time
+	uint8_t mbase = (type == EXEC_REQUEST) ?
+		AP_RQS_QUEUE_DEPTH : AP_CMD_QUEUE_DEPTH;
+	double queued_ms = bu::Timer::getTimestampMs();
+
+	mc.AddSample(metrics[mbase].mh, pool.Depth());
+
+	bu::ExecutorPool::Job_t timed_job([this, mbase, queued_ms, job]() {
+		double started_ms = bu::Timer::getTimestampMs();
+		mc.AddSample(metrics[mbase+1].mh, started_ms - queued_ms);
+		job();
+		mc.AddSample(metrics[mbase+2].mh,
+				bu::Timer::getTimestampMs() - started_ms);
+	});
+	if (pool.Submit(std::move(timed_job)))
+		return;
+
+	// Overloaded executors: do not delay the session, since its response
+	// could be awaited for with a timeout
+	logger->Warn("Dispatch: %s queue full [%d], spawning a dedicated executor",
+			(type == EXEC_REQUEST) ? "requests" : "commands",
+			pool.Capacity());
+	std::thread(timed_job).detach();
+}
+
 /*******************************************************************************
  * Command Sessions
  ******************************************************************************/
 
 inline ApplicationProxy::pcmdSn_t ApplicationProxy::SetupCmdSession(
-		AppPtr_t papp) const {
-	pcmdSn_t pcs(new cmdSn_t());
+		AppPtr_t papp) {
+	std::unique_lock<std::mutex> cmdSnFree_ul(cmdSnFree_mtx);
+	cmdSn_t * psn;
+
+	// Reuse a released command session object, if any
+	if (!cmdSnFree.empty()) {
+		psn = cmdSnFree.back();
+		cmdSnFree.pop_back();
+	}
+	else
+		psn = new cmdSn_t();
+	cmdSnFree_ul.unlock();
+
+	pcmdSn_t pcs(psn, [this](cmdSn_t * psn) { RecycleCmdSession(psn); });
+	pcs->pid = 0;
 	pcs->papp = papp;
 	pcs->resp_prm = resp_prm_t();
+	pcs->resp_ftr = resp_ftr_t();
 
 	// Resetting command session response message
 	// This is the condition verified by the reception thread
@@ -103,16 +214,37 @@ inline ApplicationProxy::pcmdSn_t ApplicationProxy::SetupCmdSession(
 	return pcs;
 }
 
+void ApplicationProxy::RecycleCmdSession(cmdSn_t * pcs) {
+	std::unique_lock<std::mutex> cmdSnFree_ul(cmdSnFree_mtx);
+
+	// Do not keep alive the application and the response buffer
+	pcs->papp.reset();
+	pcs->pmsg = NULL;
+
+	if (cmdSnFree.size() >= BBQUE_AP_CMD_SESSIONS_CACHED) {
+		cmdSnFree_ul.unlock();
+		delete pcs;
+		return;
+	}
+	cmdSnFree.push_back(pcs);
+}
+
+bool ApplicationProxy::WaitResponse(pcmdSn_t pcs,
+		std::unique_lock<std::mutex> & resp_ul, SyncDeadline_t deadline) {
+	return (pcs->resp_cv).wait_until(resp_ul, deadline,
+			[&pcs]() { return pcs->pmsg != NULL; });
+}
+
 inline void ApplicationProxy::EnqueueHandler(pcmdSn_t pcs) {
 	std::unique_lock<std::mutex> cmdSnMap_ul(cmdSnMap_mtx);
 
 	assert(pcs);
 
-	pcs->pid = gettid();
+	pcs->pid = next_token++;
 
 	if (cmdSnMap.find(pcs->pid) != cmdSnMap.end()) {
 		logger->Crit("EnqueueHandler: handler enqueuing FAILED "
-				"(Error: duplicated handler thread)");
+				"(Error: duplicated session token)");
 		assert(cmdSnMap.find(pcs->pid) == cmdSnMap.end());
 		return;
 	}
@@ -170,9 +302,6 @@ void ApplicationProxy::StopExecutionTrd(pcmdSn_t pcs) {
 #if 1
 	pcmdRsp_t pcmdRsp(new cmdRsp_t);
 
-	// Enqueuing the Command Session Handler
-	EnqueueHandler(pcs);
-
 	logger->Debug("StopExecutionTrd: [pid=%5d] (%s) START",
 			pcs->pid, pcs->papp->StrId());
 
@@ -183,6 +312,9 @@ void ApplicationProxy::StopExecutionTrd(pcmdSn_t pcs) {
 
 	logger->Debug("StopExecutionTrd: [pid=%5d] (%s) END",
 			pcs->pid, pcs->papp->StrId());
+
+	// No response expected
+	ReleaseCommandSession(pcs);
 #endif
 }
 
@@ -202,13 +334,13 @@ ApplicationProxy::StopExecution(AppPtr_t papp) {
 
 	// Setup a new command session
 	psn = SetupCmdSession(papp);
+	psn->resp_ftr = psn->resp_prm.get_future();
 
-	// Spawn a new Command Executor (passing the future)
-	psn->exe = std::thread(&ApplicationProxy::StopExecutionTrd, this, psn);
-	psn->exe.detach();
+	// Enqueuing the Command Session Handler
+	EnqueueHandler(psn);
 
-	// Return the promise (thus unlocking the executor)
-	psn->resp_prm.get_future();
+	// Queue the Command Executor
+	Dispatch(EXEC_COMMAND, [this, psn]() { StopExecutionTrd(psn); });
 #endif
 	return RTLIB_OK;
 }
@@ -224,14 +356,15 @@ ApplicationProxy::Prof_GetRuntimeData(ba::AppPtr_t papp) {
 	pcmdSn_t pcs(SetupCmdSession(papp));
 	assert(pcs);
 
-	// Command executor (passing the future)
-	pcs->exe = std::thread(
-			&ApplicationProxy::Prof_GetRuntimeDataTrd, this, pcs);
-	pcs->exe.detach();
-
-	// Setup the promise (thus unlocking the executor)
+	// Setup the promise
 	pcs->resp_ftr = (pcs->resp_prm).get_future();
 
+	// Enqueuing the Command Session Handler
+	EnqueueHandler(pcs);
+
+	// Queue the Command Executor
+	Dispatch(EXEC_COMMAND, [this, pcs]() { Prof_GetRuntimeDataTrd(pcs); });
+
 	return RTLIB_OK;
 }
 
@@ -239,18 +372,17 @@ RTLIB_ExitCode_t
 ApplicationProxy::Prof_GetRuntimeDataTrd(pcmdSn_t pcs) {
 	RTLIB_ExitCode_t result;
 
-	// Command session handler
-	EnqueueHandler(pcs);
-
 	// Send get runtime profile request
-	result = Prof_GetRuntimeDataSend(pcs->papp);
+	result = Prof_GetRuntimeDataSend(pcs);
 	if (result != RTLIB_OK) {
 		logger->Error("Prof_GetRuntimeDataTrd: profile data request failed");
+		ReleaseCommandSession(pcs);
 		return RTLIB_ERROR;
 	}
 
 	// Receive runtime profiling data
 	result = Prof_GetRuntimeDataRecv(pcs);
+	ReleaseCommandSession(pcs);
 	if (result != RTLIB_OK) {
 		logger->Error("Prof_GetRuntimeDataTrd: profile data receiving failed");
 		return RTLIB_ERROR;
@@ -261,17 +393,18 @@ ApplicationProxy::Prof_GetRuntimeDataTrd(pcmdSn_t pcs) {
 }
 
 RTLIB_ExitCode_t
-ApplicationProxy::Prof_GetRuntimeDataSend(ba::AppPtr_t papp) {
+ApplicationProxy::Prof_GetRuntimeDataSend(pcmdSn_t pcs) {
 	std::unique_lock<std::mutex> conCtxMap_ul(conCtxMap_mtx,
 			std::defer_lock);
 	conCtxMap_t::iterator it;
+	AppPtr_t papp = pcs->papp;
 	pconCtx_t pcon;
 
 	// Get runtime profile data request message
 	bl::rpc_msg_BBQ_GET_PROFILE_t stop_msg = {
 		{
 			bl::RPC_BBQ_GET_PROFILE,
-			static_cast<unsigned int>(gettid()),
+			pcs->pid,
 			static_cast<int>(papp->Pid()),
 			papp->ExcId()
 		},
@@ -306,19 +439,14 @@ ApplicationProxy::Prof_GetRuntimeDataRecv(pcmdSn_t pcs) {
 	std::unique_lock<std::mutex> resp_ul(pcs->resp_mtx);
 	bl::rpc_msg_BBQ_GET_PROFILE_RESP_t *pmsg_pyl;
 	rpc_msg_header_t *pmsg_hdr;
-	std::cv_status ready;
 	pchMsg_t pchMsg;
 
 	// Wait for a response (if not yet available)
 	if (!pcs->pmsg) {
 		logger->Debug("Prof_GetRuntimeDataRecv: waiting for runtime profile data, "
 				"Timeout: %d[ms]", BBQUE_SYNCP_TIMEOUT);
-		ready = (pcs->resp_cv).wait_for(resp_ul,
-				std::chrono::milliseconds(
-					BBQUE_SYNCP_TIMEOUT));
-		if (ready == std::cv_status::timeout) {
+		if (!WaitResponse(pcs, resp_ul, SyncDeadline())) {
 			logger->Warn("Prof_GetRuntimeDataRecv: TIMEOUT");
-			pcs->pmsg = NULL;
 			return RTLIB_BBQUE_CHANNEL_TIMEOUT;
 		}
 	}
@@ -500,23 +628,18 @@ ApplicationProxy::SyncP_PreChangeSend(pcmdSn_t pcs) {
 
 RTLIB_ExitCode_t
 ApplicationProxy::SyncP_PreChangeRecv(pcmdSn_t pcs,
-		pPreChangeRsp_t presp) {
+		pPreChangeRsp_t presp, SyncDeadline_t deadline) {
 	std::unique_lock<std::mutex> resp_ul(pcs->resp_mtx);
 	bl::rpc_msg_BBQ_SYNCP_PRECHANGE_RESP_t *pmsg_pyl;
 	rpc_msg_header_t *pmsg_hdr;
-	std::cv_status ready;
 	pchMsg_t pchMsg;
 
 	// Wait for a response (if not yet available)
 	if (!pcs->pmsg) {
 		logger->Debug("SyncP_PreChangeRecv: waiting for response, "
 				"Timeout: %d[ms]", BBQUE_SYNCP_TIMEOUT);
-		ready = (pcs->resp_cv).wait_for(resp_ul,
-				std::chrono::milliseconds(
-					BBQUE_SYNCP_TIMEOUT));
-		if (ready == std::cv_status::timeout) {
+		if (!WaitResponse(pcs, resp_ul, deadline)) {
 			logger->Warn("SyncP_PreChangeRecv: response TIMEOUT");
-			pcs->pmsg = NULL;
 			return RTLIB_BBQUE_CHANNEL_TIMEOUT;
 		}
 	}
@@ -543,94 +666,34 @@ ApplicationProxy::SyncP_PreChangeRecv(pcmdSn_t pcs,
 }
 
 RTLIB_ExitCode_t
-ApplicationProxy::SyncP_PreChange(pcmdSn_t pcs, pPreChangeRsp_t presp) {
-	assert(pcs);
-	assert(presp);
-
-	// Send the Command
-	presp->result = SyncP_PreChangeSend(pcs);
-	if (presp->result != RTLIB_OK)
-		return presp->result;
-
-	// Get back the response
-	presp->result = SyncP_PreChangeRecv(pcs, presp);
-	if (presp->result != RTLIB_OK)
-		return presp->result;
-
-#ifdef CONFIG_BBQUE_YP_SASB_ASYNC
-	// Give back the result to the calling thread
-	(presp->pcs->resp_prm).set_value(presp->result);
-	logger->Debug("APPs PRX [%05d]: Set response for [%s]",
-			presp->pcs->pid, presp->pcs->papp->StrId());
-#endif
-
-	return RTLIB_OK;
-
-}
-
-void
-ApplicationProxy::SyncP_PreChangeTrd(pPreChangeRsp_t presp) {
-	// Enqueuing the Command Session Handler
-	EnqueueHandler(presp->pcs);
-
-	logger->Debug("SyncP_PreChangeTrd: [pid=%05d] START",
-			presp->pcs->pid, presp->pcs->papp->StrId());
-
-	// Run the Command Executor
-	SyncP_PreChange(presp->pcs, presp);
-
-	logger->Debug("SyncP_PreChangeTrd: [pid=%05d]: (%s) END",
-			presp->pcs->pid, presp->pcs->papp->StrId());
-}
-
-RTLIB_ExitCode_t
-ApplicationProxy::SyncP_PreChange(AppPtr_t papp, pPreChangeRsp_t presp) {
-	RTLIB_ExitCode_t result = RTLIB_OK;
+ApplicationProxy::SyncP_PreChange_Post(AppPtr_t papp, pPreChangeRsp_t presp) {
 	assert(papp);
 	assert(presp);
 
 	presp->pcs = SetupCmdSession(papp);
 	assert(presp->pcs);
 
-#ifdef CONFIG_BBQUE_YP_SASB_ASYNC
-	// Spawn a new Command Executor (passing the future)
-	presp->pcs->exe = std::thread(&ApplicationProxy::SyncP_PreChangeTrd,
-			this, presp);
-	presp->pcs->exe.detach();
-
-	// Setup the promise (thus unlocking the executor)
-	presp->pcs->resp_ftr = (presp->pcs->resp_prm).get_future();
-
-#else
-	// Enqueuing the Command Session Handler
+	// Enqueuing the Command Session Handler, before sending the command
 	EnqueueHandler(presp->pcs);
 
-	// Run the Command Executor
-	result = SyncP_PreChange(presp->pcs, presp);
-
-	// Releasing the command session
-	ReleaseCommandSession(presp->pcs);
-#endif
+	presp->result = SyncP_PreChangeSend(presp->pcs);
+	if (presp->result != RTLIB_OK)
+		ReleaseCommandSession(presp->pcs);
 
-	return result;
+	return presp->result;
 }
 
 RTLIB_ExitCode_t
-ApplicationProxy::SyncP_PreChange_GetResult(pPreChangeRsp_t presp) {
-	RTLIB_ExitCode_t result = RTLIB_BBQUE_CHANNEL_TIMEOUT;
-	FutureStatus_t ftrStatus;
-
+ApplicationProxy::SyncP_PreChange_Collect(pPreChangeRsp_t presp,
+		SyncDeadline_t deadline) {
 	assert(presp);
 
-	// Wait for the promise being returned
-	ftrStatus = presp->pcs->resp_ftr.wait_for(std::chrono::milliseconds(BBQUE_SYNCP_TIMEOUT));
-	if (!FutureTimedout(ftrStatus))
-		result = presp->pcs->resp_ftr.get();
+	presp->result = SyncP_PreChangeRecv(presp->pcs, presp, deadline);
 
 	// Releasing the command session
 	ReleaseCommandSession(presp->pcs);
 
-	return result;
+	return presp->result;
 }
 
 /*******************************************************************************
@@ -683,22 +746,18 @@ ApplicationProxy::SyncP_SyncChangeSend(pcmdSn_t pcs) {
 
 RTLIB_ExitCode_t
 ApplicationProxy::SyncP_SyncChangeRecv(pcmdSn_t pcs,
-		pSyncChangeRsp_t presp) {
+		pSyncChangeRsp_t presp, SyncDeadline_t deadline) {
 	std::unique_lock<std::mutex> resp_ul(pcs->resp_mtx);
 	//rpc_msg_BBQ_SYNCP_SYNCCHANGE_RESP_t *pmsg_pyl;
 	rpc_msg_header_t *pmsg_hdr;
-	std::cv_status ready;
 	pchMsg_t pchMsg;
 
 	// Wait for a response (if not yet available)
 	if (!pcs->pmsg) {
 		logger->Debug("SyncP_SyncChangeRecv: waiting for response, Timeout: %d[ms]",
 			BBQUE_SYNCP_TIMEOUT);
-		ready = (pcs->resp_cv).wait_for(
-				resp_ul, std::chrono::milliseconds(BBQUE_SYNCP_TIMEOUT));
-		if (ready == std::cv_status::timeout) {
+		if (!WaitResponse(pcs, resp_ul, deadline)) {
 			logger->Warn("SyncP_SyncChangeRecv: response TIMEOUT");
-			pcs->pmsg = NULL;
 			return RTLIB_BBQUE_CHANNEL_TIMEOUT;
 		}
 	}
@@ -721,98 +780,34 @@ ApplicationProxy::SyncP_SyncChangeRecv(pcmdSn_t pcs,
 }
 
 RTLIB_ExitCode_t
-ApplicationProxy::SyncP_SyncChange(pcmdSn_t pcs, pSyncChangeRsp_t presp) {
-	assert(pcs);
-	assert(presp);
-
-	// Send the Command
-	presp->result = SyncP_SyncChangeSend(pcs);
-	if (presp->result != RTLIB_OK)
-		return presp->result;
-
-	// Get back the response
-	presp->result = SyncP_SyncChangeRecv(pcs, presp);
-	if (presp->result != RTLIB_OK)
-		return presp->result;
-
-#ifdef CONFIG_BBQUE_YP_SASB_ASYNC
-	// Give back the result to the calling thread
-	(presp->pcs->resp_prm).set_value(presp->result);
-	logger->Debug("APPs PRX [%05d]: Set response for [%s]",
-			presp->pcs->pid, presp->pcs->papp->StrId());
-#endif
-
-	return RTLIB_OK;
-
-}
-
-void
-ApplicationProxy::SyncP_SyncChangeTrd(pSyncChangeRsp_t presp) {
-
-	assert(presp);
-
-	// Enqueuing the Command Session Handler
-	EnqueueHandler(presp->pcs);
-
-	logger->Debug("SyncP_SyncChangeTrd: [pid=%05d]: [%s] START",
-			presp->pcs->pid, presp->pcs->papp->StrId());
-
-	// Run the Command Executor
-	SyncP_SyncChange(presp->pcs, presp);
-
-	logger->Debug("SyncP_SyncChangeTrd: [pid=%05d]: [%s] END",
-			presp->pcs->pid, presp->pcs->papp->StrId());
-}
-
-RTLIB_ExitCode_t
-ApplicationProxy::SyncP_SyncChange(AppPtr_t papp, pSyncChangeRsp_t presp) {
-	RTLIB_ExitCode_t result = RTLIB_OK;
-
+ApplicationProxy::SyncP_SyncChange_Post(AppPtr_t papp, pSyncChangeRsp_t presp) {
 	assert(papp);
 	assert(presp);
 
 	presp->pcs = SetupCmdSession(papp);
 	assert(presp->pcs);
 
-#ifdef CONFIG_BBQUE_YP_SASB_ASYNC
-	// Spawn a new Command Executor (passing the future)
-	presp->pcs->exe = std::thread(&ApplicationProxy::SyncP_SyncChangeTrd,
-			this, presp);
-	presp->pcs->exe.detach();
-
-	// Setup the promise (thus unlocking the executor)
-	presp->pcs->resp_ftr = (presp->pcs->resp_prm).get_future();
-#else
-	// Enqueuing the Command Session Handler
+	// Enqueuing the Command Session Handler, before sending the command
 	EnqueueHandler(presp->pcs);
 
-	// Run the Command Executor
-	result = SyncP_SyncChange(presp->pcs, presp);
-
-	// Releasing the command session
-	ReleaseCommandSession(presp->pcs);
-#endif
+	presp->result = SyncP_SyncChangeSend(presp->pcs);
+	if (presp->result != RTLIB_OK)
+		ReleaseCommandSession(presp->pcs);
 
-	return result;
+	return presp->result;
 }
 
 RTLIB_ExitCode_t
-ApplicationProxy::SyncP_SyncChange_GetResult(pSyncChangeRsp_t presp) {
-	RTLIB_ExitCode_t result = RTLIB_BBQUE_CHANNEL_TIMEOUT;
-	FutureStatus_t ftrStatus;
-
+ApplicationProxy::SyncP_SyncChange_Collect(pSyncChangeRsp_t presp,
+		SyncDeadline_t deadline) {
 	assert(presp);
 
-	// Wait for the promise being returned
-	ftrStatus = presp->pcs->resp_ftr.wait_for(std::chrono::milliseconds(
-				BBQUE_SYNCP_TIMEOUT));
-	if (!FutureTimedout(ftrStatus))
-		result = presp->pcs->resp_ftr.get();
+	presp->result = SyncP_SyncChangeRecv(presp->pcs, presp, deadline);
 
 	// Releasing the command session
 	ReleaseCommandSession(presp->pcs);
 
-	return result;
+	return presp->result;
 }
 
 
@@ -946,19 +941,14 @@ ApplicationProxy::SyncP_PostChangeRecv(pcmdSn_t pcs,
 	std::unique_lock<std::mutex> resp_ul(pcs->resp_mtx);
 	//rpc_msg_BBQ_SYNCP_POSTCHANGE_RESP_t *pmsg_pyl;
 	rpc_msg_header_t *pmsg_hdr;
-	std::cv_status ready;
 	pchMsg_t pchMsg;
 
 	// Wait for a response (if not yet available)
 	if (!pcs->pmsg) {
 		logger->Debug("SyncP_PostChangeRecv: waiting for PostChange response, "
 				"Timeout: %d[ms]", BBQUE_SYNCP_TIMEOUT);
-		ready = (pcs->resp_cv).wait_for(resp_ul,
-				std::chrono::milliseconds(
-					BBQUE_SYNCP_TIMEOUT));
-		if (ready == std::cv_status::timeout) {
+		if (!WaitResponse(pcs, resp_ul, SyncDeadline())) {
 			logger->Warn("SyncP_PostChangeRecv: PostChange response TIMEOUT");
-			pcs->pmsg = NULL;
 			return RTLIB_BBQUE_CHANNEL_TIMEOUT;
 		}
 	}
@@ -1092,10 +1082,10 @@ void ApplicationProxy::CompleteTransaction(pchMsg_t & pmsg) {
 	}
 
 	// Setup command session response buffer
+	std::unique_lock<std::mutex> resp_ul(pcs->resp_mtx);
 	pcs->pmsg = pmsg;
 
 	// Notify command session
-	std::unique_lock<std::mutex> resp_ul(pcs->resp_mtx);
 	(pcs->resp_cv).notify_one();
 }
 
@@ -1300,6 +1290,17 @@ void ApplicationProxy::RpcExcRuntimeProfileNotify(prqsSn_t prqs) {
 	pconCtx_t pcon;
 	ApplicationManager::ExitCode_t result;
 	assert(pchMsg);
+
+#ifdef CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+	// Acknowledge the notification before it could be discarded, otherwise
+	// the RTLib would coalesce all the further ones
+	bl::rtp_telemetry_sample_t sample;
+	bool sample_valid = false;
+	auto papp = am.GetApplication(pmsg_hdr->app_pid, pmsg_hdr->exc_id);
+	if (papp)
+		sample_valid = papp->ConsumeRuntimeTelemetry(sample);
+#endif
+
 	// Looking for a valid connection context
 	pcon = GetConnectionContext(pmsg_hdr);
 	if (!pcon)
@@ -1308,8 +1309,26 @@ void ApplicationProxy::RpcExcRuntimeProfileNotify(prqsSn_t prqs) {
 	logger->Info("RpcExcRuntimeProfileNotify: Profile received for EXC "
 			"[app: %s, pid: %d, exc: %d]",
 			pcon->app_name, pcon->app_pid, pmsg_hdr->exc_id);
+
+	int gap      = pmsg_pyl->gap;
+	int cusage   = pmsg_pyl->cusage;
+	int ctime_ms = pmsg_pyl->ctime_ms;
+
+#ifdef CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+	// Further notifications could have been coalesced into this one: get
+	// the latest profile from the telemetry page
+	if (sample_valid) {
+		gap      = std::round(sample.goal_gap);
+		cusage   = std::round(sample.cpu_budget);
+		ctime_ms = std::round(sample.cycle_time_max_ms);
+		logger->Debug("RpcExcRuntimeProfileNotify: latest profile "
+			"{Gap: %d, CPU: %d, CTime: %d ms, cycles: %lu}",
+			gap, cusage, ctime_ms, sample.cycles);
+	}
+#endif
+
 	result = am.SetRuntimeProfile(pcon->app_pid, pmsg_hdr->exc_id,
-				pmsg_pyl->gap, pmsg_pyl->cusage, pmsg_pyl->ctime_ms);
+				gap, cusage, ctime_ms);
 
 	switch (result) {
 		case ApplicationManager::AM_SUCCESS:
@@ -1518,19 +1537,10 @@ void ApplicationProxy::RpcAppExit(prqsSn_t prqs) {
 }
 
 void ApplicationProxy::RequestExecutor(prqsSn_t prqs) {
-	std::unique_lock<std::mutex> snCtxMap_ul(snCtxMap_mtx);
-	snCtxMap_t::iterator it;
-	psnCtx_t psc;
 
-	// Set the thread PID
+	// Set the executor thread PID
 	prqs->pid = gettid();
 
-	// This look could be acquiren only when the ProcessCommand has returned
-	// Thus we use this lock to synchronize the CommandExecutr starting with
-	// the completion of the ProcessCommand, which also setup thread
-	// tracking data structures.
-	snCtxMap_ul.unlock();
-
 	logger->Debug("RequestExecutor: [%d:%d]: Executor START",
 			prqs->pid, prqs->pmsg->typ);
 
@@ -1594,44 +1604,21 @@ void ApplicationProxy::RequestExecutor(prqsSn_t prqs) {
 		break;
 	}
 
-	// Releasing the thread tracking data before exiting
-	snCtxMap_ul.lock();
-	it = snCtxMap.lower_bound(prqs->pmsg->typ);
-	for ( ; it != snCtxMap.end() ; it++) {
-		psc = it->second;
-		if (psc->pid == prqs->pid) {
-			snCtxMap.erase(it);
-			break;
-		}
-	}
-	snCtxMap_ul.unlock();
-
 	logger->Debug("RequestExecutor: [%d:%d] Executor END",
 			prqs->pid, prqs->pmsg->typ);
 
 }
 
 void ApplicationProxy::ProcessRequest(pchMsg_t & pmsg) {
-	std::unique_lock<std::mutex> snCtxMap_ul(snCtxMap_mtx);
-	prqsSn_t prqsSn = prqsSn_t(new rqsSn_t);
+	prqsSn_t prqsSn = std::make_shared<rqsSn_t>();
 	assert(prqsSn);
 
 	prqsSn->pmsg = pmsg;
-	// Create a new executor thread, this will start locked since it needs
-	// the execMap_mtx we already hold. This is used to ensure that the
-	// executor thread start only alfter the playground has been properly
-	// prepared
-	prqsSn->exe = std::thread(
-				&ApplicationProxy::RequestExecutor,
-				this, prqsSn);
-	prqsSn->exe.detach();
 
 	logger->Debug("ProcessRequest: enqueuing new request...");
 
-	// Add a new threaded command executor
-	snCtxMap.insert(std::pair<uint8_t, psnCtx_t>(
-				pmsg->typ, prqsSn));
-
+	// Queue the request for the executors
+	Dispatch(EXEC_REQUEST, [this, prqsSn]() { RequestExecutor(prqsSn); });
 }
 
 void ApplicationProxy::Task() {
@@ -14,10 +14,12 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <algorithm>
 #include <string>
 
 #include "bbque/binding_manager.h"
 #include "bbque/configuration_manager.h"
+#include "bbque/platform_proxy.h"
 #include "bbque/res/resource_path.h"
 
 #define MODULE_NAMESPACE   "bq.bdm"
@@ -122,8 +124,124 @@ BindingManager::ExitCode_t BindingManager::LoadBindingDomains() {
 				binding.resources.size());
 	}
 
+	LoadTopologyDomains();
 	return OK;
 }
 
+
+void BindingManager::LoadTopologyDomains() {
+
+	for (auto & level_domains: topology)
+		level_domains.clear();
+
+#ifndef CONFIG_BBQUE_PIL_LEGACY
+	const pp::PlatformDescription * pd;
+	try {
+		pd = &PlatformProxy::GetPlatformDescription();
+	}
+	catch(const std::runtime_error & e) {
+		logger->Warn("Topology: platform description not available [%s]",
+				e.what());
+		return;
+	}
+	pp::PlatformDescription::System const & sys(pd->GetLocalSystem());
+
+	// NUMA nodes, i.e., the memories the CPUs refer to
+	std::map<BBQUE_RID_TYPE, TopologyDomainPtr_t> nodes;
+	for (auto const & mem: sys.GetMemoriesAll()) {
+		TopologyDomainPtr_t node(std::make_shared<TopologyDomain>());
+		node->level     = TopologyDomain::NODE;
+		node->id        = mem->GetId();
+		node->mem_id    = mem->GetId();
+		node->distances = mem->GetDistances();
+		nodes.emplace(node->id, node);
+	}
+
+	// LLC groups (CPUs), cores and hardware threads
+	for (auto const & cpu: sys.GetCPUsAll()) {
+		auto mem = cpu.GetMemory();
+		auto node_it = mem ? nodes.find(mem->GetId()) : nodes.end();
+		if (node_it == nodes.end()) {
+			logger->Warn("Topology: CPU%d: missing memory node", cpu.GetId());
+			continue;
+		}
+		TopologyDomainPtr_t & node(node_it->second);
+
+		TopologyDomainPtr_t llc(std::make_shared<TopologyDomain>());
+		llc->level  = TopologyDomain::LLC;
+		llc->id     = cpu.GetId();
+		llc->mem_id = node->id;
+		llc->parent = node.get();
+		llc->cpu_ids.Set(cpu.GetId());
+
+		std::map<uint16_t, TopologyDomainPtr_t> cores;
+		for (auto const & pe: cpu.GetProcessingElementsAll()) {
+			// Not available to the applications
+			if (pe.GetPartitionType() == pp::PlatformDescription::HOST)
+				continue;
+
+			TopologyDomainPtr_t & core(cores[pe.GetCoreId()]);
+			if (!core) {
+				core = std::make_shared<TopologyDomain>();
+				core->level  = TopologyDomain::CORE;
+				core->mem_id = node->id;
+				core->parent = llc.get();
+				core->cpu_ids.Set(cpu.GetId());
+				llc->children.push_back(core);
+			}
+
+			TopologyDomainPtr_t thread(std::make_shared<TopologyDomain>());
+			thread->level  = TopologyDomain::THREAD;
+			thread->id     = pe.GetId();
+			thread->mem_id = node->id;
+			thread->parent = core.get();
+			thread->cpu_ids.Set(cpu.GetId());
+			thread->pe_ids.Set(pe.GetId());
+			core->children.push_back(thread);
+			topology[TopologyDomain::THREAD].push_back(thread);
+
+			core->pe_ids.Set(pe.GetId());
+			llc->pe_ids.Set(pe.GetId());
+			node->pe_ids.Set(pe.GetId());
+		}
+
+		if (llc->children.empty())
+			continue;
+
+		// Core IDs are not unique across the sockets: use the first thread
+		for (auto & core_entry: cores) {
+			TopologyDomainPtr_t & core(core_entry.second);
+			core->id = core->pe_ids.FirstSet();
+			topology[TopologyDomain::CORE].push_back(core);
+		}
+
+		node->cpu_ids.Set(cpu.GetId());
+		node->children.push_back(llc);
+		topology[TopologyDomain::LLC].push_back(llc);
+		logger->Debug("Topology: node %d, LLC group %d: PEs {%s}",
+				node->id, llc->id, llc->pe_ids.ToStringCG().c_str());
+	}
+
+	for (auto & node_entry: nodes) {
+		if (node_entry.second->children.empty())
+			continue;
+		topology[TopologyDomain::NODE].push_back(node_entry.second);
+	}
+
+	for (auto & level_domains: topology) {
+		std::sort(level_domains.begin(), level_domains.end(),
+			[](TopologyDomainPtr_t const & a, TopologyDomainPtr_t const & b) {
+				return a->id < b->id;
+			});
+	}
+
+	logger->Info("Topology: %zu nodes, %zu LLC groups, %zu cores, %zu threads",
+			topology[TopologyDomain::NODE].size(),
+			topology[TopologyDomain::LLC].size(),
+			topology[TopologyDomain::CORE].size(),
+			topology[TopologyDomain::THREAD].size());
+#endif // CONFIG_BBQUE_PIL_LEGACY
+}
+
 } // namespace bbque
 
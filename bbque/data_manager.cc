@@ -83,6 +83,11 @@ DataManager::DataManager() : Worker(),
 
 	RestoreSubscribers();
 
+	// Setting the event loop of the subscribers connections
+	logger->Debug("Connections event loop start...");
+	connections_work.reset(new io_service::work(connections_ios));
+	connections_loop = std::thread([this]() { connections_ios.run(); });
+
 	logger->Info("Publisher start...");
 	Start();
 
@@ -98,7 +103,11 @@ DataManager::DataManager() : Worker(),
 }
 
 DataManager::~DataManager() {
-
+	if (connections_loop.joinable()) {
+		connections_work.reset();
+		connections_ios.stop();
+		connections_loop.join();
+	}
 }
 
 void DataManager::_PreTerminate() {
@@ -107,12 +116,21 @@ void DataManager::_PreTerminate() {
 	{
 		std::unique_lock<std::mutex> subs_lock(subscribers_mtx);
 		std::unique_lock<std::mutex> events_lock(events_mtx);
+		for (auto & s: subscribers_on_rate)
+			if (s->connection) s->connection->Close();
+		for (auto & s: subscribers_on_event)
+			if (s->connection) s->connection->Close();
 		subscribers_on_rate.clear();
 		subscribers_on_event.clear();
 		event_queue.clear();
 		subs_cv.notify_all();
 		event_cv.notify_all();
 	}
+	// Stop the connections event loop
+	connections_work.reset();
+	connections_ios.stop();
+	if (connections_loop.joinable())
+		connections_loop.join();
 	// Send signal to server
 	assert(subscription_server_tid != 0);
 	::kill(subscription_server_tid, SIGUSR1);
@@ -338,6 +356,7 @@ void DataManager::Subscribe(SubscriberPtr_t subscr, bool event_based) {
 				sub->subscription.event.to_string().c_str());
 
 			sub->subscription.event |= subscr->subscription.event;
+			sub->last_seq = 0;
 			logger->Debug("Subscribe: <%s> updated events: %s",
 				subscr->ip_address.c_str(),
 				sub->subscription.event.to_string().c_str());
@@ -359,6 +378,7 @@ void DataManager::Subscribe(SubscriberPtr_t subscr, bool event_based) {
 			sub->subscription.filter |= subscr->subscription.filter;
 			sub->subscription.period_ms = subscr->subscription.period_ms;
 			sub->period_deadline_ms     = sub->subscription.period_ms;
+			sub->last_seq = 0;
 			logger->Debug("Subscribe: <%s> updated filter: %s period: %d m",
 				subscr->ip_address.c_str(),
 				sub->subscription.filter.to_string().c_str(),
@@ -386,8 +406,11 @@ void DataManager::Unsubscribe(SubscriberPtr_t subscr, bool event_based) {
 		auto sub = FindSubscriber(subscr, subscribers_on_event);
 		if (sub != nullptr) {
 			sub->subscription.event &= ~(subscr->subscription.event);
-			if (sub->subscription.event.none())
+			if (sub->subscription.event.none()) {
 				subscribers_on_event.remove(sub);
+				if (sub->connection)
+					sub->connection->Close();
+			}
 		}
 		else
 			logger->Error("Unsubscribe: client not found!");
@@ -396,8 +419,13 @@ void DataManager::Unsubscribe(SubscriberPtr_t subscr, bool event_based) {
 		auto sub = FindSubscriber(subscr, subscribers_on_rate);
 		if (sub != nullptr){
 			sub->subscription.filter &= ~(subscr->subscription.filter);
-			if (sub->subscription.filter.none())
+			if (sub->subscription.filter.none()) {
 				subscribers_on_rate.remove(sub);
+				if (sub->connection)
+					sub->connection->Close();
+			}
+			else
+				sub->last_seq = 0;
 			subscribers_on_rate.sort();
 		}
 		else
@@ -546,86 +574,111 @@ void DataManager::PublishOnRate(){
 }
 
 DataManager::ExitCode_t DataManager::Push(SubscriberPtr_t sub) {
-	status_message_t updated_status;
-	updated_status.ts = static_cast<uint32_t>(utils::Timer::getTimestamp());
-	updated_status.n_app_status_msgs = 0;
-	updated_status.n_res_status_msgs = 0;
-	logger->Debug("Push: timestamp=%d", updated_status.ts);
+	if (!sub->connection)
+		sub->connection = std::make_shared<SubscriberConnection>(
+			connections_ios, sub->ip_address, sub->port_num, logger.get());
+
+	// Communication failures are detected asynchronously by the event loop
+	sub->comm_failures = sub->connection->Failures();
+	if (sub->comm_failures > max_client_attempts) {
+		logger->Error("Push: cannot connect to <%s:%d>",
+			sub->ip_address.c_str(), sub->port_num);
+		// Unsubscribing the unreachable client
+		Unsubscribe(sub, sub->subscription.event != 0);
+		return ERR_CLIENT_TIMEOUT;
+	}
+
+	// The whole status is sent if the client may have lost some updates
+	uint32_t base_seq = sub->last_seq;
+	if (sub->connection->TakeResync())
+		base_seq = 0;
+
+	uint32_t seq;
+	FramePtr_t frame;
+	{
+		std::unique_lock<std::mutex> status_lock(status_mtx);
+		frame = GetStatusFrame(base_seq, sub->subscription.filter, seq);
+	}
+	logger->Debug("Push: <%s:%d> %s frame [seq=%u base=%u size=%lu]",
+		sub->ip_address.c_str(), sub->port_num,
+		base_seq == 0 ? "full" : "delta", seq, base_seq, frame->size());
+
+	sub->connection->Send(frame, seq, base_seq);
+	sub->last_seq = seq;
+
+	if (sub->comm_failures > 0)
+		return ERR_CLIENT_COMM;
+	return OK;
+}
+
+FramePtr_t DataManager::GetStatusFrame(
+		uint32_t & base_seq, bd::sub_bitset_t filter, uint32_t & seq) {
+	seq = status_seq;
+
+	// Base status too old (or unknown): full frame
+	if ((base_seq < delta_horizon_seq) || (base_seq > status_seq))
+		base_seq = 0;
+	bool full = (base_seq == 0);
+
+	FrameKey_t key(base_seq, static_cast<uint8_t>(filter.to_ulong()));
+	auto cached = frames_cache.find(key);
+	if (cached != frames_cache.end())
+		return cached->second;
+
+	status_frame_header_t header;
+	header.magic    = BBQUE_DCI_FRAME_MAGIC;
+	header.version  = BBQUE_DCI_FRAME_VERSION;
+	header.type     = full ? FRAME_FULL : FRAME_DELTA;
+	header.filter   = key.second;
+	header.seq      = seq;
+	header.base_seq = base_seq;
+	header.ts       = static_cast<uint32_t>(utils::Timer::getTimestamp());
+	header.n_res    = 0;
+	header.n_app    = 0;
+	header.n_res_records = 0;
+	header.n_app_records = 0;
+	header.n_app_removed = 0;
+
+	std::string frame(sizeof(status_frame_header_t), '\0');
 
 	// Subscriber has "resource" subscription?
-	if ((sub->subscription.filter & bd::sub_bitset_t(FILTER_RESOURCE)) ==
+	if ((filter & bd::sub_bitset_t(FILTER_RESOURCE)) ==
 		bd::sub_bitset_t(FILTER_RESOURCE)) {
-		logger->Debug("Push: adding resources info for subscriber <%s>...",
-			sub->ip_address.c_str());
-
-		updated_status.n_res_status_msgs = num_resources;
-		for (auto res_stat: res_stats)
-			updated_status.res_status_msgs.push_back(res_stat);
-
-		// Debug logging
-		for (auto res_stat : updated_status.res_status_msgs) {
-			logger->Debug("Resource: id=%ld, occupancy=%d, load=%d, power=%d, temp=%d",
-				res_stat.id,
-				res_stat.occupancy,
-				res_stat.load,
-				res_stat.power,
-				res_stat.temp);
+		header.n_res = num_resources;
+		for (auto const & entry: res_records) {
+			if (!full && entry.second.seq <= base_seq)
+				continue;
+			frame.append(entry.second.encoded);
+			++header.n_res_records;
 		}
 	}
 
 	// Subscriber filter has "application" subscription?
-	if ((sub->subscription.filter & bd::sub_bitset_t(FILTER_APPLICATION)) ==
+	if ((filter & bd::sub_bitset_t(FILTER_APPLICATION)) ==
 		bd::sub_bitset_t(FILTER_APPLICATION)) {
-		logger->Debug("Push: adding applications info for subscriber <%s>...",
-			sub->ip_address.c_str());
-
-		updated_status.n_app_status_msgs = num_applications;
-		for (auto app_stat : app_stats)
-			updated_status.app_status_msgs.push_back(app_stat);
-
-		// Debug logging
-		for (auto app_stat : updated_status.app_status_msgs) {
-			logger->Debug("Push: Application: id=%d, name=%s, nr_tasks=%d, mapping=%d",
-				app_stat.id,
-				app_stat.name.c_str(),
-				app_stat.n_task,
-				app_stat.mapping);
-			for(auto task_stat : app_stat.tasks){
-				logger->Debug("Push: Task: id=%d, THR:%d, CT:%d, mapping=%d, n_threads=%d",
-				task_stat.id,
-				task_stat.throughput,
-				task_stat.completion_time,
-				task_stat.mapping,
-				task_stat.n_threads);
-			}
+		header.n_app = num_applications;
+		for (auto const & entry: app_records) {
+			if (!full && entry.second.seq <= base_seq)
+				continue;
+			frame.append(entry.second.encoded);
+			++header.n_app_records;
 		}
-	}
 
-	// TCP socket for data messages
-	tcp::iostream client_sock(sub->ip_address, std::to_string(sub->port_num));
-	if (!client_sock) {
-		logger->Error("Push: cannot connect to <%s:%d>",
-			sub->ip_address.c_str(), sub->port_num);
-		sub->comm_failures++;
-		if(sub->comm_failures > max_client_attempts){
-			// Unsubscribing the unreachable client
-			Unsubscribe(sub,sub->subscription.event != 0);
-			return ERR_CLIENT_TIMEOUT;
+		StatusFrameWriter writer(frame);
+		for (auto const & removed: app_removed) {
+			if (full || removed.second <= base_seq)
+				continue;
+			writer.Put64(removed.first);
+			++header.n_app_removed;
 		}
-		return ERR_CLIENT_COMM;
 	}
-	sub->comm_failures = 0;
 
-	// Message serialization and transmission
-	text_oarchive archive(client_sock);
-	try {
-		archive << updated_status;  // Send
-	} catch(boost::exception const& ex){
-		logger->Error("Boost archive exception");
-		return ERR_CLIENT_COMM;
-	}
+	header.length = frame.size() - sizeof(status_frame_header_t);
+	StatusFrameWriter::PutHeader(header, &frame[0]);
 
-	return OK;
+	FramePtr_t frame_ptr = std::make_shared<const std::string>(std::move(frame));
+	frames_cache.emplace(key, frame_ptr);
+	return frame_ptr;
 }
 
 res_bitset_t DataManager::BuildResourceBitset(br::ResourcePathPtr_t resource_path) {
@@ -659,12 +712,61 @@ res_bitset_t DataManager::BuildResourceBitset(br::ResourcePathPtr_t resource_pat
 }
 
 void DataManager::UpdateData(){
+	std::unique_lock<std::mutex> status_lock(status_mtx);
 
 	UpdateResourcesData();
 
 	UpdateApplicationsData();
 
-	logger->Info("UpdateData: completed");
+	UpdateStatusRecords();
+
+	logger->Info("UpdateData: completed [seq=%u]", status_seq);
+}
+
+void DataManager::UpdateStatusRecords() {
+	uint32_t seq = ++status_seq;
+	frames_cache.clear();
+
+	// Resources: only the changed encodings are marked with the new sequence
+	for (auto const & res_stat: res_stats) {
+		std::string encoded;
+		StatusFrameWriter(encoded).PutResource(res_stat);
+		auto & record = res_records[res_stat.id];
+		if (record.encoded != encoded) {
+			record.encoded = std::move(encoded);
+			record.seq = seq;
+		}
+	}
+
+	// Applications: track also the terminated ones
+	std::map<uint64_t, StatusRecord_t> prev_app_records;
+	prev_app_records.swap(app_records);
+	for (auto const & app_stat: app_stats) {
+		std::string encoded;
+		StatusFrameWriter(encoded).PutApplication(app_stat);
+		auto prev = prev_app_records.find(app_stat.id);
+		if ((prev != prev_app_records.end()) && (prev->second.encoded == encoded))
+			app_records.emplace(app_stat.id, std::move(prev->second));
+		else
+			app_records.emplace(app_stat.id, StatusRecord_t{std::move(encoded), seq});
+		app_removed.erase(app_stat.id);
+	}
+	for (auto const & prev: prev_app_records) {
+		if (app_records.find(prev.first) == app_records.end())
+			app_removed[prev.first] = seq;
+	}
+
+	// Forget the oldest removals, falling back to full frames for the
+	// clients still behind them
+	while (app_removed.size() > BBQUE_DM_MAX_REMOVED_APPS) {
+		auto oldest = std::min_element(app_removed.begin(), app_removed.end(),
+			[](std::pair<const uint64_t, uint32_t> const & a,
+			   std::pair<const uint64_t, uint32_t> const & b) {
+				return a.second < b.second;
+			});
+		delta_horizon_seq = std::max(delta_horizon_seq, oldest->second);
+		app_removed.erase(oldest);
+	}
 }
 
 void DataManager::UpdateResourcesData(){
@@ -677,7 +779,7 @@ void DataManager::UpdateResourcesData(){
 	// Updating resource status list
 	res_stats.clear();
 	for (auto & resource_ptr : resource_set) {
-		br::ResourcePathPtr_t resource_path = ra.GetPath(resource_ptr->Path());
+		br::ResourcePathPtr_t resource_path = resource_ptr->GetResourcePath();
 		logger->Debug("UpdateData: <%lu>: used=%lu  unreserved=%lu total=%lu",
 			BuildResourceBitset(resource_path),
 			resource_ptr->Used(),
@@ -748,7 +850,7 @@ void DataManager::UpdateApplicationsData(){
 			res::ResourcePtrList_t res_list = bind.second->GetResourcesList();
 			logger->Debug("UpdateData: resource request = <%s>", bind.first->ToString().c_str());
 			for(auto res : res_list){
-				auto app_res_path = ra.GetPath(res->Path());
+				auto app_res_path = res->GetResourcePath();
 				mapped_sys_id = app_res_path->GetID(res::ResourceType::SYSTEM);
 				app_res_list.push_back(BuildResourceBitset(app_res_path));
 				logger->Debug("UpdateData: resource mapped = <%s>", res->Path().c_str());
@@ -827,7 +929,7 @@ std::string DataManager::FindResourceAssigned(
 	for(auto bind : res_map){
 		res::ResourcePtrList_t res_list = bind.second->GetResourcesList();
 		for(auto res : res_list){
-			auto res_path = ra.GetPath(res->Path());
+			auto res_path = res->GetResourcePath();
 			//logger->Error("FindResourceAssigned: sys%d.grp%d.cpu%d - %s",
 			//	mapped_sys_id, mapped_cluster, mapped_proc, res->Path().c_str());
 			//logger->Error("Type: <%s>", br::GetResourceTypeString(res_path->Type(-1)));
@@ -850,5 +952,167 @@ std::string DataManager::FindResourceAssigned(
 	return std::string();
 }
 
+/*******************************************************************/
+/*                     Subscribers connections                     */
+/*******************************************************************/
+
+SubscriberConnection::SubscriberConnection(
+		io_service & ios,
+		std::string const & ip,
+		uint32_t port,
+		bu::Logger * logger):
+	ios(ios),
+	socket(ios),
+	ip_address(ip),
+	port_num(port),
+	logger(logger),
+	resync(true),
+	failures(0) {
+}
+
+void SubscriberConnection::Send(
+		FramePtr_t frame, uint32_t seq, uint32_t base_seq) {
+	auto self(shared_from_this());
+	ios.post([this, self, frame, seq, base_seq]() {
+		Enqueue(frame, seq, base_seq);
+	});
+}
+
+void SubscriberConnection::Close() {
+	auto self(shared_from_this());
+	ios.post([this, self]() {
+		closed = true;
+		Reset();
+	});
+}
+
+void SubscriberConnection::Enqueue(
+		FramePtr_t frame, uint32_t seq, uint32_t base_seq) {
+	if (closed)
+		return;
+
+	// A delta not following the last queued frame would corrupt the
+	// status of the client
+	if ((base_seq != 0) && (base_seq != tail_seq)) {
+		resync = true;
+		return;
+	}
+
+	if ((state == State::DISCONNECTED) && !Connect())
+		return;
+
+	// A full frame supersedes the ones not yet in transmission
+	if ((base_seq == 0) || (queue.size() >= BBQUE_DM_MAX_QUEUED_FRAMES)) {
+		queue.erase(queue.begin() + (writing ? 1 : 0), queue.end());
+		if (base_seq != 0) {
+			logger->Warn("Push: <%s:%d> too slow, skipping updates",
+				ip_address.c_str(), port_num);
+			tail_seq = 0;
+			resync = true;
+			return;
+		}
+	}
+
+	queue.push_back(frame);
+	tail_seq = seq;
+	if ((state == State::CONNECTED) && !writing)
+		WriteNext();
+}
+
+bool SubscriberConnection::Connect() {
+	boost::system::error_code ec;
+	ip::address address(ip::address::from_string(ip_address, ec));
+	if (ec) {
+		logger->Error("Push: <%s> is not a valid address", ip_address.c_str());
+		++failures;
+		return false;
+	}
+
+	logger->Debug("Push: connecting to <%s:%d>...",
+		ip_address.c_str(), port_num);
+	state = State::CONNECTING;
+
+	auto self(shared_from_this());
+	socket.async_connect(tcp::endpoint(address, port_num),
+		[this, self](boost::system::error_code const & ec) {
+			if (ec == boost::asio::error::operation_aborted)
+				return;
+			if (ec) {
+				logger->Error("Push: cannot connect to <%s:%d> [%s]",
+					ip_address.c_str(), port_num, ec.message().c_str());
+				++failures;
+				Reset();
+				return;
+			}
+
+			logger->Info("Push: connected to <%s:%d>",
+				ip_address.c_str(), port_num);
+			failures = 0;
+			state = State::CONNECTED;
+			boost::system::error_code opt_ec;
+			socket.set_option(tcp::no_delay(true), opt_ec);
+			WaitHangup();
+			WriteNext();
+		});
+	return true;
+}
+
+void SubscriberConnection::WaitHangup() {
+	// The client writes only to request the whole status, e.g. when it
+	// has received a DELTA frame not applying to its status. Any other
+	// read completion means the connection has been closed.
+	auto self(shared_from_this());
+	socket.async_read_some(boost::asio::buffer(&hangup_byte, 1),
+		[this, self](boost::system::error_code const & ec, size_t) {
+			if (ec == boost::asio::error::operation_aborted)
+				return;
+			if (!ec) {
+				logger->Debug("Push: <%s:%d> requested the whole status",
+					ip_address.c_str(), port_num);
+				resync = true;
+				WaitHangup();
+				return;
+			}
+			logger->Info("Push: <%s:%d> closed the connection",
+				ip_address.c_str(), port_num);
+			Reset();
+		});
+}
+
+void SubscriberConnection::WriteNext() {
+	if (queue.empty()) {
+		writing = false;
+		return;
+	}
+
+	writing = true;
+	FramePtr_t frame(queue.front());
+	auto self(shared_from_this());
+	boost::asio::async_write(socket, boost::asio::buffer(*frame),
+		[this, self, frame](boost::system::error_code const & ec, size_t) {
+			if (ec == boost::asio::error::operation_aborted)
+				return;
+			if (ec) {
+				logger->Error("Push: error in publishing to <%s:%d> [%s]",
+					ip_address.c_str(), port_num, ec.message().c_str());
+				++failures;
+				Reset();
+				return;
+			}
+			queue.pop_front();
+			WriteNext();
+		});
+}
+
+void SubscriberConnection::Reset() {
+	boost::system::error_code ec;
+	socket.close(ec);
+	state    = State::DISCONNECTED;
+	writing  = false;
+	tail_seq = 0;
+	queue.clear();
+	resync = true;
+}
+
 } // namespace bbque
 
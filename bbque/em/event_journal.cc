@@ -0,0 +1,514 @@
+/*
+ * Copyright (C) 2016  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bbque/em/event_journal.h"
+#include "bbque/em/event_manager.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <boost/filesystem.hpp>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = boost::filesystem;
+
+namespace bbque {
+
+namespace em {
+
+/*******************************************************************************
+ *  Records encoding
+ ******************************************************************************/
+
+/*
+ * A record is made by a 32 bits length, followed by the payload:
+ * - timestamp [ms]: int64
+ * - value: int32
+ * - valid: uint8
+ * - module, resource, application, type: uint16 length + characters
+ */
+
+template<typename T>
+static inline void Put(std::vector<char> & buffer, T value) {
+	size_t pos = buffer.size();
+	buffer.resize(pos + sizeof(T));
+	::memcpy(&buffer[pos], &value, sizeof(T));
+}
+
+static inline void PutString(std::vector<char> & buffer,
+		std::string const & str) {
+	uint16_t len = std::min<size_t>(str.size(), UINT16_MAX);
+	Put<uint16_t>(buffer, len);
+	buffer.insert(buffer.end(), str.data(), str.data() + len);
+}
+
+template<typename T>
+static inline bool Get(const char * & pos, const char * end, T & value) {
+	if (pos + sizeof(T) > end)
+		return false;
+	::memcpy(&value, pos, sizeof(T));
+	pos += sizeof(T);
+	return true;
+}
+
+static inline bool GetString(const char * & pos, const char * end,
+		std::string & str) {
+	uint16_t len;
+	if (!Get<uint16_t>(pos, end, len) || (pos + len > end))
+		return false;
+	str.assign(pos, len);
+	pos += len;
+	return true;
+}
+
+void EventJournal::Encode(Event const & event, std::vector<char> & buffer) {
+	size_t start = buffer.size();
+
+	// Reserve the room for the length
+	Put<uint32_t>(buffer, 0);
+
+	Put<int64_t>(buffer, event.GetTimestamp().count());
+	Put<int32_t>(buffer, event.GetValue());
+	Put<uint8_t>(buffer, event.IsValid());
+	PutString(buffer, event.GetModule());
+	PutString(buffer, event.GetResource());
+	PutString(buffer, event.GetApplication());
+	PutString(buffer, event.GetType());
+
+	uint32_t size = buffer.size() - start - sizeof(uint32_t);
+	::memcpy(&buffer[start], &size, sizeof(uint32_t));
+}
+
+bool EventJournal::Decode(const char * payload, size_t size, Event & event) {
+	const char * pos = payload;
+	const char * end = payload + size;
+	std::string module, resource, application, type;
+	int64_t timestamp;
+	int32_t value;
+	uint8_t valid;
+
+	if (!Get<int64_t>(pos, end, timestamp) ||
+			!Get<int32_t>(pos, end, value) ||
+			!Get<uint8_t>(pos, end, valid) ||
+			!GetString(pos, end, module) ||
+			!GetString(pos, end, resource) ||
+			!GetString(pos, end, application) ||
+			!GetString(pos, end, type))
+		return false;
+
+	event = Event(valid, module, resource, application, type, value);
+	event.SetTimestamp(std::chrono::milliseconds(timestamp));
+	return true;
+}
+
+
+/*******************************************************************************
+ *  Journal writer
+ ******************************************************************************/
+
+std::string EventJournal::SegmentPath(std::string const & base_path,
+		uint32_t id) {
+	char suffix[16];
+	snprintf(suffix, sizeof(suffix), ".%04u", id);
+	return base_path + suffix + EVENT_JOURNAL_SEGMENT_EXT;
+}
+
+std::string EventJournal::IndexPath(std::string const & base_path,
+		uint32_t id) {
+	char suffix[16];
+	snprintf(suffix, sizeof(suffix), ".%04u", id);
+	return base_path + suffix + EVENT_JOURNAL_INDEX_EXT;
+}
+
+EventJournal::EventJournal(std::string const & folder,
+		std::string const & name):
+	base_path(folder + name) {
+
+	logger = bu::Logger::GetLogger(EVENT_MANAGER_NAMESPACE ".jrn");
+	assert(logger);
+
+	pending.reserve(EVENT_JOURNAL_FLUSH_SIZE);
+	logger->Info("Journal: opening [%s]...", base_path.c_str());
+	flusher = std::thread(&EventJournal::Flusher, this);
+}
+
+EventJournal::~EventJournal() {
+	std::unique_lock<std::mutex> pending_ul(pending_mtx);
+	done = true;
+	pending_ul.unlock();
+	pending_cv.notify_one();
+
+	// The flusher writes the remaining events before exiting
+	flusher.join();
+	CloseSegment();
+}
+
+void EventJournal::Append(Event const & event) {
+	std::unique_lock<std::mutex> pending_ul(pending_mtx);
+	Encode(event, pending);
+
+	// Do not wait for the flush period if the buffer is growing too much
+	if (pending.size() >= EVENT_JOURNAL_FLUSH_SIZE) {
+		pending_ul.unlock();
+		pending_cv.notify_one();
+	}
+}
+
+void EventJournal::Flush() {
+	std::unique_lock<std::mutex> pending_ul(pending_mtx);
+	uint64_t request = ++flush_requested;
+	pending_cv.notify_one();
+	flushed_cv.wait(pending_ul, [this, request]() {
+			return done || (flush_served >= request); });
+}
+
+void EventJournal::CloseSegment() {
+	if (segment_fd >= 0)
+		::close(segment_fd);
+	if (index_fd >= 0)
+		::close(index_fd);
+	segment_fd = -1;
+	index_fd = -1;
+}
+
+bool EventJournal::RotateSegment() {
+	JournalHeader_t header;
+	std::string path;
+
+	if (segment_fd >= 0) {
+		CloseSegment();
+		++segment_id;
+	}
+
+	path = SegmentPath(base_path, segment_id);
+	segment_fd = ::open(path.c_str(),
+			O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+	if (segment_fd < 0) {
+		logger->Error("Journal: segment [%s] creation FAILED (Error %d: %s)",
+				path.c_str(), errno, strerror(errno));
+		return false;
+	}
+
+	path = IndexPath(base_path, segment_id);
+	index_fd = ::open(path.c_str(),
+			O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+	if (index_fd < 0) {
+		logger->Error("Journal: index [%s] creation FAILED (Error %d: %s)",
+				path.c_str(), errno, strerror(errno));
+		CloseSegment();
+		return false;
+	}
+
+	::memset(&header, 0, sizeof(header));
+	::memcpy(header.magic, EVENT_JOURNAL_MAGIC, sizeof(header.magic));
+	header.version    = EVENT_JOURNAL_VERSION;
+	header.segment_id = segment_id;
+	if (::write(segment_fd, &header, sizeof(header)) != sizeof(header)) {
+		logger->Error("Journal: segment [%05u] header write FAILED",
+				segment_id);
+		CloseSegment();
+		return false;
+	}
+
+	segment_size    = sizeof(header);
+	segment_records = 0;
+
+	logger->Debug("Journal: segment [%05u] opened", segment_id);
+	return true;
+}
+
+static bool WriteAll(int fd, const char * buffer, size_t size) {
+	while (size > 0) {
+		ssize_t bytes = ::write(fd, buffer, size);
+		if (bytes < 0) {
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+		buffer += bytes;
+		size   -= bytes;
+	}
+	return true;
+}
+
+void EventJournal::WriteRecords(std::vector<char> const & records) {
+	std::vector<JournalIndexEntry_t> index;
+	const char * pos = records.data();
+	const char * end = records.data() + records.size();
+	const char * chunk = pos;
+	uint64_t chunk_offset = segment_size;
+
+	// Lazily open the first segment, thus an unused journal leaves no files
+	if ((segment_fd < 0) && !RotateSegment())
+		return;
+
+	while (pos < end) {
+		uint32_t size;
+		::memcpy(&size, pos, sizeof(uint32_t));
+		size_t record_size = sizeof(uint32_t) + size;
+
+		// Rotate the segment, once the previous records have been written
+		if ((segment_records > 0) &&
+				(segment_size + record_size > EVENT_JOURNAL_SEGMENT_SIZE)) {
+			if (!WriteAll(segment_fd, chunk, pos - chunk) ||
+					!WriteAll(index_fd, (const char *)index.data(),
+						index.size() * sizeof(JournalIndexEntry_t))) {
+				logger->Error("Journal: segment [%05u] write FAILED "
+						"(Error %d: %s)", segment_id, errno, strerror(errno));
+			}
+			index.clear();
+			if (!RotateSegment())
+				return;
+			chunk = pos;
+			chunk_offset = segment_size;
+		}
+
+		// Sparse index of the record timestamps
+		if (segment_records % EVENT_JOURNAL_INDEX_STRIDE == 0) {
+			JournalIndexEntry_t entry;
+			::memcpy(&entry.timestamp, pos + sizeof(uint32_t),
+					sizeof(int64_t));
+			entry.offset = chunk_offset + (pos - chunk);
+			index.push_back(entry);
+		}
+
+		segment_size += record_size;
+		++segment_records;
+		pos += record_size;
+	}
+
+	if (!WriteAll(segment_fd, chunk, pos - chunk) ||
+			!WriteAll(index_fd, (const char *)index.data(),
+				index.size() * sizeof(JournalIndexEntry_t))) {
+		logger->Error("Journal: segment [%05u] write FAILED (Error %d: %s)",
+				segment_id, errno, strerror(errno));
+	}
+}
+
+void EventJournal::Flusher() {
+	std::unique_lock<std::mutex> pending_ul(pending_mtx);
+	std::vector<char> records;
+	uint64_t request;
+
+	prctl(PR_SET_NAME, (long unsigned int) "bq.em.jrn", 0, 0, 0);
+	records.reserve(EVENT_JOURNAL_FLUSH_SIZE);
+
+	while (true) {
+		pending_cv.wait_for(pending_ul,
+				std::chrono::milliseconds(EVENT_JOURNAL_FLUSH_PERIOD),
+				[this]() {
+					return done ||
+						(flush_requested > flush_served) ||
+						(pending.size() >= EVENT_JOURNAL_FLUSH_SIZE);
+				});
+
+		// Take the buffered records, and write them without blocking the
+		// producers
+		request = flush_requested;
+		records.swap(pending);
+		pending_ul.unlock();
+
+		if (!records.empty())
+			WriteRecords(records);
+		records.clear();
+
+		pending_ul.lock();
+		flush_served = request;
+		flushed_cv.notify_all();
+
+		if (done && pending.empty())
+			break;
+	}
+}
+
+
+/*******************************************************************************
+ *  Journal reader
+ ******************************************************************************/
+
+/**
+ * @brief A read-only memory mapping of a file
+ */
+class MappedFile {
+public:
+	MappedFile(std::string const & path) {
+		struct stat st;
+		int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+			return;
+		if ((::fstat(fd, &st) == 0) && (st.st_size > 0)) {
+			void * paddr = ::mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE,
+					fd, 0);
+			if (paddr != MAP_FAILED) {
+				data = (const char *)paddr;
+				size = st.st_size;
+			}
+		}
+		::close(fd);
+	}
+	~MappedFile() {
+		if (data)
+			::munmap((void *)data, size);
+	}
+	const char * data = nullptr;
+	size_t size = 0;
+};
+
+static bool ParseSegmentPath(std::string const & path,
+		std::string & base, uint32_t & id) {
+	static const std::string ext(EVENT_JOURNAL_SEGMENT_EXT);
+	unsigned int value;
+
+	// <base>.<id>.evj
+	if ((path.size() <= ext.size()) ||
+			(path.compare(path.size() - ext.size(), ext.size(), ext) != 0))
+		return false;
+	std::string stem(path, 0, path.size() - ext.size());
+	size_t dot = stem.rfind('.');
+	if ((dot == std::string::npos) ||
+			(sscanf(stem.c_str() + dot + 1, "%u", &value) != 1))
+		return false;
+
+	base = stem.substr(0, dot);
+	id   = value;
+	return true;
+}
+
+bool EventJournalReader::IsJournal(std::string const & path) {
+	std::string base;
+	uint32_t id;
+	boost::system::error_code ec;
+
+	if (ParseSegmentPath(path, base, id))
+		return true;
+	return fs::exists(EventJournal::SegmentPath(path, 0), ec);
+}
+
+EventJournalReader::EventJournalReader(std::string const & path) {
+	boost::system::error_code ec;
+	std::string base;
+	uint32_t id;
+
+	base_path = path;
+	if (ParseSegmentPath(path, base, id))
+		base_path = base;
+
+	// Collect the segments of the journal
+	fs::path base_fs(base_path);
+	fs::path folder(base_fs.parent_path());
+	if (folder.empty())
+		folder = ".";
+	for (fs::directory_iterator it(folder, ec), end; !ec && it != end;
+			it.increment(ec)) {
+		if (!ParseSegmentPath(it->path().string(), base, id))
+			continue;
+		if (fs::path(base).filename() != base_fs.filename())
+			continue;
+		segments.push_back(id);
+	}
+	std::sort(segments.begin(), segments.end());
+}
+
+bool EventJournalReader::ForEachInSegment(uint32_t id,
+		EventHandler_t & handler, int64_t from, int64_t to,
+		size_t & count) const {
+	MappedFile segment(EventJournal::SegmentPath(base_path, id));
+	MappedFile index(EventJournal::IndexPath(base_path, id));
+	JournalHeader_t header;
+	size_t offset = sizeof(JournalHeader_t);
+	Event event;
+
+	if (!segment.data || (segment.size < sizeof(JournalHeader_t)))
+		return true;
+	::memcpy(&header, segment.data, sizeof(header));
+	if (::memcmp(header.magic, EVENT_JOURNAL_MAGIC, sizeof(header.magic)) ||
+			(header.version != EVENT_JOURNAL_VERSION))
+		return true;
+
+	// Seek to the last indexed record preceding the window
+	if (index.data) {
+		size_t entries = index.size / sizeof(JournalIndexEntry_t);
+		const JournalIndexEntry_t * first =
+			(const JournalIndexEntry_t *)index.data;
+		const JournalIndexEntry_t * last = first + entries;
+		const JournalIndexEntry_t * it = std::lower_bound(first, last, from,
+				[](JournalIndexEntry_t const & entry, int64_t ts) {
+					return entry.timestamp < ts;
+				});
+		if (it != first) {
+			--it;
+			if (it->offset < segment.size)
+				offset = it->offset;
+		}
+		// The whole segment follows the window
+		if ((entries > 0) && (first->timestamp > to))
+			return false;
+	}
+
+	while (offset + sizeof(uint32_t) <= segment.size) {
+		uint32_t size;
+		int64_t timestamp;
+		::memcpy(&size, segment.data + offset, sizeof(uint32_t));
+		offset += sizeof(uint32_t);
+
+		// Truncated record (e.g. the daemon has been killed while writing)
+		if ((size < sizeof(int64_t)) || (offset + size > segment.size))
+			break;
+
+		::memcpy(&timestamp, segment.data + offset, sizeof(int64_t));
+		if (timestamp > to)
+			return false;
+		if ((timestamp >= from) &&
+				EventJournal::Decode(segment.data + offset, size, event)) {
+			handler(event);
+			++count;
+		}
+		offset += size;
+	}
+
+	return true;
+}
+
+size_t EventJournalReader::ForEach(EventHandler_t handler,
+		int64_t from, int64_t to) const {
+	size_t count = 0;
+
+	for (uint32_t id: segments) {
+		if (!ForEachInSegment(id, handler, from, to, count))
+			break;
+	}
+
+	return count;
+}
+
+std::vector<Event> EventJournalReader::Read(int64_t from, int64_t to) const {
+	std::vector<Event> events;
+	ForEach([&events](Event const & event) {
+			events.push_back(event);
+		}, from, to);
+	return events;
+}
+
+} // namespace em
+
+} // namespace bbque
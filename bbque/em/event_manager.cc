@@ -59,16 +59,23 @@ EventManager::EventManager() {
 	strftime(buffer, 80, "bbque-events_%Y_%m_%d_%T", timeinfo);
 	std::string filename(buffer);
 
-	// Output events file
-	filename     = filename + ":" + fractional_seconds + ".txt";
+	// Output events journal
+	filename     = filename + ":" + fractional_seconds;
 	archive_path = archive_folder_path + filename;
-	logger->Notice("Events file path: %s", archive_path.c_str());
+	logger->Notice("Events journal path: %s", archive_path.c_str());
 
-	std::ofstream ofs(archive_path);
+	journal = std::unique_ptr<EventJournal>(
+		new EventJournal(archive_folder_path, filename));
 }
 
 EventManager::EventManager(bool external) {
 	UNUSED(external);
+	logger = bu::Logger::GetLogger(EVENT_MANAGER_NAMESPACE);
+}
+
+EventManager::~EventManager() {
+	// Write the buffered events
+	journal.reset();
 }
 
 
@@ -85,9 +92,9 @@ void EventManager::SetPath(std::string path) {
 	archive_folder_path = path;
 }
 
-void EventManager::Serialize(EventWrapper ew) {
+void EventManager::Serialize(EventWrapper ew, std::string const & path) {
 	// Create and open the archive for output
-	std::ofstream ofs(archive_path);
+	std::ofstream ofs(path.empty() ? archive_path : path);
 	if (ofs.good()) {
 		try {
 			boost::archive::text_oarchive oa(ofs, boost::archive::no_header);
@@ -102,6 +109,18 @@ void EventManager::Serialize(EventWrapper ew) {
 
 EventWrapper EventManager::Deserialize() {
 	EventWrapper ew;
+
+	// Events journal: the most recent event first, as in the text archive
+	if (EventJournalReader::IsJournal(archive_path)) {
+		if (journal)
+			journal->Flush();
+		EventJournalReader reader(archive_path);
+		reader.ForEach([&ew](Event const & event) {
+				ew.AddEvent(event);
+			});
+		return ew;
+	}
+
 	// Open the archive for input
 	std::ifstream ifs(archive_path);
 	if (ifs.good()) {
@@ -118,29 +137,36 @@ EventWrapper EventManager::Deserialize() {
 	return ew;
 }
 
-void EventManager::InitializeArchive(Event event) {
-	logger->Info("Initialize Archive...");
+bool EventManager::Export(std::string const & path) {
+	EventWrapper ew(Deserialize());
 
-	milliseconds timestamp = duration_cast<milliseconds>(
-		system_clock::now().time_since_epoch());
-	event.SetTimestamp(timestamp);
+	if (ew.GetEvents().empty()) {
+		logger->Warn("Export: no events in [%s]", archive_path.c_str());
+		return false;
+	}
 
-	EventWrapper ew;
-	ew.AddEvent(event);
-	Serialize(ew);
+	logger->Info("Export: [%s] => [%s]", archive_path.c_str(), path.c_str());
+	Serialize(ew, path);
+	return true;
+}
+
+void EventManager::InitializeArchive(Event event) {
+	logger->Info("Initialize Archive...");
+	Push(event);
 }
 
 void EventManager::Push(Event event) {
-	logger->Info("Push Event...");
+	logger->Debug("Push Event...");
 
 	milliseconds timestamp = duration_cast<milliseconds>(
 		system_clock::now().time_since_epoch());
 	event.SetTimestamp(timestamp);
 
-	EventWrapper ew;
-	ew = Deserialize();
-	ew.AddEvent(event);
-	Serialize(ew);
+	if (!journal) {
+		logger->Error("Push: events journal not available");
+		return;
+	}
+	journal->Append(event);
 }
 
 } // namespace em
@@ -430,6 +430,38 @@ PlatformManager::ExitCode_t PlatformManager::MapResources(
 	return PLATFORM_OK;
 }
 
+PlatformManager::ExitCode_t PlatformManager::MapResourcesStart()
+{
+	ExitCode_t ec = lpp->MapResourcesStart();
+	if (unlikely(ec != PLATFORM_OK))
+		return ec;
+#ifdef CONFIG_BBQUE_DIST_MODE
+	ec = rpp->MapResourcesStart();
+#endif
+	return ec;
+}
+
+PlatformManager::ExitCode_t PlatformManager::MapResourcesCommit(
+		std::list<SchedPtr_t> & failed_apps)
+{
+	ExitCode_t ec = lpp->MapResourcesCommit(failed_apps);
+	if (unlikely(ec != PLATFORM_OK)) {
+		logger->Error("Mapping: Failed to enforce LOCAL bindings of %zu "
+			      "applications (error code: %i)", failed_apps.size(), ec);
+	}
+
+#ifdef CONFIG_BBQUE_DIST_MODE
+	ExitCode_t rec = rpp->MapResourcesCommit(failed_apps);
+	if (unlikely(rec != PLATFORM_OK)) {
+		logger->Error("Mapping: Failed to enforce REMOTE bindings "
+			      "(error code: %i)", rec);
+		ec = rec;
+	}
+#endif
+
+	return ec;
+}
+
 
 void PlatformManager::Exit()
 {
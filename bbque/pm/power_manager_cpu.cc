@@ -22,16 +22,18 @@
 #include "bbque/utils/iofs.h"
 
 #include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fcntl.h>
 #include <fstream>
+#include <unistd.h>
 #include <iostream>
 #include <boost/filesystem.hpp>
-#include <boost/lexical_cast.hpp>
-#include <boost/regex.hpp>
 #include <boost/date_time.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 
-#define LOAD_SAMPLING_INTERVAL_SECONDS 1
-#define LOAD_SAMPLING_NUMBER 1
+/** Minimum time between two reads of /proc/stat */
+#define LOAD_SAMPLING_MIN_INTERVAL_MS 5
 
 #define PROCSTAT_FIRST  1
 #define PROCSTAT_LAST   10
@@ -59,6 +61,10 @@ CPUPowerManager::CPUPowerManager():
 	// Core ID <--> Processing Element ID mapping
 	InitCoreIdMapping();
 
+	// Initial CPU cores activity counters, for the first load sampling
+	if (SampleLoad() != ExitStatus::OK)
+		logger->Warn("CPU cores activity information not available");
+
 	// --- Thermal monitoring intialization ---
 	po::variables_map opts_vm;
 	po::options_description opts_desc("PowerManager options");
@@ -226,39 +232,86 @@ void CPUPowerManager::InitFrequencyGovernors() {
  * Load                                                               *
  **********************************************************************/
 
-CPUPowerManager::ExitStatus CPUPowerManager::GetLoadInfo(
-		CPUPowerManager::LoadInfo * info,
-		BBQUE_RID_TYPE cpu_core_id) const {
+CPUPowerManager::ExitStatus CPUPowerManager::SampleLoad() const {
 	// Information about kernel activity is available in the /proc/stat
 	// file. All the values are aggregated since the system first booted.
 	// Thus, to compute the load, the variation of these values in a little
 	//  and constant timespan has to be computed.
-	std::ifstream procstat_info("/proc/stat");
-	std::string   procstat_entry;
+	int fd = ::open("/proc/stat", O_RDONLY);
+	if (fd < 0)
+		return CPUPowerManager::ExitStatus::ERR_GENERIC;
+
+	// Read the whole file at once: the buffer grows up to the file size
+	// and it is then reused
+	std::vector<char> & buffer(load_sampler.buffer);
+	if (buffer.empty())
+		buffer.resize(4096);
+	size_t len = 0;
+	ssize_t nr;
+	while ((nr = ::read(fd, buffer.data() + len, buffer.size() - len - 1)) > 0) {
+		len += nr;
+		if (len == buffer.size() - 1)
+			buffer.resize(buffer.size() * 2);
+	}
+	::close(fd);
+	buffer[len] = '\0';
+	load_sampler.last_read = std::chrono::steady_clock::now();
 
 	// The information about CPU-N can be found in the line whose sintax
 	// follows the pattern:
 	// 	cpun x y z w ...
 	// Check the Linux documentation to find information about those values
-	boost::regex cpu_info_stats("cpu" + std::to_string(cpu_core_id) +
-				" (\\d+) (\\d+) (\\d+) (\\d+) (\\d+) (\\d+)" +
-				" (\\d+) (\\d+) (\\d+) (\\d+)");
-
-	// Parsing the /proc/stat file to find the correct line
 	bool found = false;
-	while (std::getline(procstat_info, procstat_entry)) {
-		boost::smatch match;
-		// If that's the correct line
-		if (!boost::regex_match(procstat_entry, match, cpu_info_stats))
+	char * line = buffer.data();
+	while (line && *line) {
+		char * next_line = strchr(line, '\n');
+		if (next_line)
+			*next_line++ = '\0';
+
+		// Skip the aggregated "cpu" line and the non-CPU lines
+		if (strncmp(line, "cpu", 3) != 0 || !isdigit(line[3])) {
+			line = next_line;
 			continue;
+		}
+
+		char * field;
+		unsigned long cpu_core_id = strtoul(line + 3, &field, 10);
+		LoadInfo info;
+		for (int i = PROCSTAT_FIRST; i <= PROCSTAT_LAST; ++i) {
+			char * field_end;
+			uint64_t value = strtoull(field, &field_end, 10);
+			if (field_end == field)
+				break;
+			field = field_end;
+			// CPU core total time
+			info.total += value;
+			// CPU core idle time
+			if (i >= PROCSTAT_IDLE && i <= PROCSTAT_IOWAIT)
+				info.idle += value;
+		}
 		found = true;
 
-		// CPU core total time
-		for (int i = PROCSTAT_FIRST; i <= PROCSTAT_LAST; ++i)
-			info->total += boost::lexical_cast<int32_t>(match[i]);
-		// CPU core idle time
-		for (int i = PROCSTAT_IDLE; i <= PROCSTAT_IOWAIT; ++i)
-			info->idle += boost::lexical_cast<int32_t>(match[i]);
+		if (cpu_core_id >= load_sampler.counters.size()) {
+			load_sampler.counters.resize(cpu_core_id + 1);
+			load_sampler.load.resize(cpu_core_id + 1, -1);
+			load_sampler.consumed.resize(cpu_core_id + 1, true);
+		}
+
+		// Usage is computed as 1 - idle_time[%] (no variation, no update)
+		LoadInfo & prev_info(load_sampler.counters[cpu_core_id]);
+		if ((prev_info.total != 0) && (info.total > prev_info.total)) {
+			float usage =
+				100 - (100 * (float)(info.idle - prev_info.idle) /
+				(float)(info.total - prev_info.total));
+			// If the usage is very low the usage could become
+			// negative, because the contents of /proc/stat are not so
+			// accurate
+			if (usage < 0) usage = 0;
+			load_sampler.load[cpu_core_id] = static_cast<int32_t>(usage);
+			load_sampler.consumed[cpu_core_id] = false;
+		}
+		prev_info = info;
+		line = next_line;
 	}
 
 	if (!found) return CPUPowerManager::ExitStatus::ERR_GENERIC;
@@ -283,10 +336,13 @@ PowerManager::PMResult CPUPowerManager::GetLoad(
 		uint32_t pe_load = 0;
 		perc = 0;
 
-		// Cumulate the load of each core
+		// Cumulate the load of each core, from the same snapshot
 		br::ResourcePtrList_t const & r_list(ra.GetResources(rp));
+		if (r_list.empty())
+			return PMResult::ERR_RSRC_INVALID_PATH;
+		std::unique_lock<std::mutex> load_ul(load_sampler.mtx);
 		for (ResourcePtr_t rsrc: r_list) {
-			result = GetLoadCPU(rsrc->ID(), pe_load);
+			result = _GetLoadCPU(rsrc->ID(), pe_load);
 			if (result != PMResult::OK) return result;
 			perc += pe_load;
 		}
@@ -301,40 +357,39 @@ PowerManager::PMResult CPUPowerManager::GetLoad(
 PowerManager::PMResult CPUPowerManager::GetLoadCPU(
 		BBQUE_RID_TYPE cpu_core_id,
 		uint32_t & load) const {
+	std::unique_lock<std::mutex> load_ul(load_sampler.mtx);
+	return _GetLoadCPU(cpu_core_id, load);
+}
+
+PowerManager::PMResult CPUPowerManager::_GetLoadCPU(
+		BBQUE_RID_TYPE cpu_core_id,
+		uint32_t & load) const {
 	CPUPowerManager::ExitStatus result;
-	CPUPowerManager::LoadInfo start_info, end_info;
+	if (cpu_core_id < 0)
+		return PMResult::ERR_RSRC_INVALID_PATH;
 
 	// Getting the load of a specified CPU. This is possible by reading the
-	// /proc/stat file exposed by Linux. To compute the load, a minimum of two
-	// samples are needed. In fact, the measure is obtained computing the
-	// variation of the file content between two consecutive accesses.
-	for (int i = 0; i < LOAD_SAMPLING_NUMBER; ++i) {
-		// Performing the actual accesses, with an interval of
-		// LOAD_SAMPLING_INTERVAL_SECONDS (circa)
-		result = GetLoadInfo(&start_info, cpu_core_id);
-		if (result != ExitStatus::OK) {
-			logger->Error("No activity info on CPU core %d", cpu_core_id);
-			return PMResult::ERR_INFO_NOT_SUPPORTED;
-		}
-
-		sleep(LOAD_SAMPLING_INTERVAL_SECONDS);
-		result = GetLoadInfo(&end_info, cpu_core_id);
+	// /proc/stat file exposed by Linux. The snapshot is updated if this
+	// value has been already returned (a new monitoring period), unless
+	// the last read is too recent to provide a meaningful variation.
+	bool expired = std::chrono::steady_clock::now() - load_sampler.last_read >
+		std::chrono::milliseconds(LOAD_SAMPLING_MIN_INTERVAL_MS);
+	size_t core_idx = static_cast<size_t>(cpu_core_id);
+	if ((core_idx >= load_sampler.load.size())
+			|| (load_sampler.consumed[core_idx] && expired)) {
+		result = SampleLoad();
 		if (result != ExitStatus::OK) {
 			logger->Error("No activity info on CPU core %d", cpu_core_id);
 			return PMResult::ERR_INFO_NOT_SUPPORTED;
 		}
+	}
 
-		// Usage is computed as 1 - idle_time[%]
-		float usage =
-			100 - (100 * (float)(end_info.idle - start_info.idle) /
-			(float)(end_info.total - start_info.total));
-		// If the usage is very low and LOAD_SAMPLING_INTERVAL_SECONDS
-		// is very little, the usage could become negative, because
-		// both the computing and the contents of /proc/stat are not
-		// so accurate
-		if (usage < 0) usage = 0;
-		load = static_cast<uint32_t>(usage);
+	if (core_idx >= load_sampler.load.size()) {
+		logger->Error("No activity info on CPU core %d", cpu_core_id);
+		return PMResult::ERR_INFO_NOT_SUPPORTED;
 	}
+	load = std::max(load_sampler.load[core_idx], 0);
+	load_sampler.consumed[core_idx] = true;
 
 	return PowerManager::PMResult::OK;
 }
@@ -206,46 +206,118 @@ void PowerMonitor::Task() {
 	logger->Debug("Monitor: waiting for platform to be ready...");
 	ResourceAccounter & ra(ResourceAccounter::GetInstance());
 	ra.WaitForPlatformReady();
-	std::vector<std::thread> samplers(nr_threads);
+	StartSamplers();
 
-	uint16_t nr_resources_to_monitor = wm_info.resources.size();
-	uint16_t nr_resources_per_thread = nr_resources_to_monitor;
-	uint16_t nr_resources_left = 0;
-	if (nr_resources_to_monitor > nr_threads) {
-		nr_resources_per_thread = nr_resources_to_monitor / nr_threads;
-		nr_resources_left = nr_resources_to_monitor % nr_threads;
-	}
-	else
-		nr_threads = 1;
-	logger->Debug("Monitor: nr_threads=%d nr_resources_to_monitor=%d",
-		nr_threads, nr_resources_to_monitor);
+	std::unique_lock<std::mutex> worker_status_ul(worker_status_mtx);
+	auto next_period = std::chrono::steady_clock::now();
+	while (!done) {
+		if (!events.test(WM_EVENT_UPDATE)) {
+			logger->Debug("Monitor: no events to process");
+			worker_status_cv.wait(worker_status_ul);
+			next_period = std::chrono::steady_clock::now();
+			continue;
+		}
+		worker_status_ul.unlock();
 
-	uint16_t nt = 0, last_resource_id = 0;
-	for (; nt < nr_threads; ++nt) {
-		logger->Debug("Monitor: starting thread %d...", nt);
-		last_resource_id += nr_resources_per_thread;
-		samplers.push_back(std::thread(
-			&PowerMonitor::SampleResourcesStatus, this,
-			nt * nr_resources_per_thread,
-			last_resource_id));
+		// New period: release the samplers...
+		std::unique_lock<std::mutex> sampling_ul(sampling.mtx);
+		sampling.pending = samplers.size();
+		++sampling.period;
+		sampling.start_cv.notify_all();
+		sampling_ul.unlock();
 
+#ifdef CONFIG_BBQUE_PM_BATTERY
+		SampleBatteryStatus();
+#endif
+		// ...and wait for all of them
+		sampling_ul.lock();
+		sampling.end_cv.wait(sampling_ul,
+			[this]() { return sampling.pending == 0; });
+		sampling_ul.unlock();
+
+		// Periods are aligned to the start time. If the sampling took
+		// longer than a period, restart from now instead of catching up.
+		next_period += std::chrono::milliseconds(wm_info.period_ms);
+		auto now = std::chrono::steady_clock::now();
+		if (next_period < now)
+			next_period = now;
+
+		worker_status_ul.lock();
+		worker_status_cv.wait_until(worker_status_ul, next_period,
+			[this]() { return done; });
 	}
-	// The number of resources is not divisible by the number of threads...
-	// --> spawn one more thread
-	if (nr_resources_left > 0) {
-		logger->Debug("Monitor: starting thread %d [extra]...", nr_threads);
-		samplers.push_back(std::thread(
-			&PowerMonitor::SampleResourcesStatus, this,
-			nr_threads * nr_resources_per_thread,
-			nr_resources_to_monitor));
+	worker_status_ul.unlock();
+
+	StopSamplers();
+}
+
+void PowerMonitor::StartSamplers() {
+	uint16_t nr_resources_to_monitor = wm_info.resources.size();
+	uint16_t nr_samplers = std::min(nr_threads, nr_resources_to_monitor);
+	if (nr_samplers == 0)
+		nr_samplers = 1;
+	logger->Debug("Monitor: nr_threads=%d nr_resources_to_monitor=%d",
+		nr_samplers, nr_resources_to_monitor);
+
+	// Contiguous ranges: the first ones take one more resource, if the
+	// number of resources is not divisible by the number of threads
+	uint16_t nr_resources_per_thread = nr_resources_to_monitor / nr_samplers;
+	uint16_t nr_resources_left = nr_resources_to_monitor % nr_samplers;
+	uint16_t first_resource_id = 0;
+
+	// The samplers must wait for the period following the current one,
+	// whatever the time they actually start at
+	std::unique_lock<std::mutex> sampling_ul(sampling.mtx);
+	uint32_t start_period = sampling.period;
+	sampling_ul.unlock();
+
+	for (uint16_t nt = 0; nt < nr_samplers; ++nt) {
+		uint16_t last_resource_id = first_resource_id + nr_resources_per_thread;
+		if (nt < nr_resources_left)
+			++last_resource_id;
+		logger->Debug("Monitor: starting thread %d [%d, %d)...",
+			nt, first_resource_id, last_resource_id);
+		samplers.emplace_back(&PowerMonitor::SamplerLoop, this,
+			nt, first_resource_id, last_resource_id, start_period);
+		first_resource_id = last_resource_id;
 	}
+}
+
+void PowerMonitor::StopSamplers() {
+	std::unique_lock<std::mutex> sampling_ul(sampling.mtx);
+	sampling.stop = true;
+	sampling.start_cv.notify_all();
+	sampling_ul.unlock();
 
-#ifdef CONFIG_BBQUE_PM_BATTERY
-	samplers.push_back(std::thread(&PowerMonitor::SampleBatteryStatus, this));
-#endif
-	while(!done)
-		Wait();
 	std::for_each(samplers.begin(), samplers.end(), std::mem_fn(&std::thread::join));
+	samplers.clear();
+}
+
+void PowerMonitor::SamplerLoop(
+		uint16_t thd_id,
+		uint16_t first_resource_index,
+		uint16_t last_resource_index,
+		uint32_t start_period) {
+	std::unique_lock<std::mutex> sampling_ul(sampling.mtx);
+	uint32_t last_period = start_period;
+	logger->Debug("SamplerLoop: [thread %d] monitoring resources in range [%d, %d)",
+		thd_id, first_resource_index, last_resource_index);
+
+	while (true) {
+		sampling.start_cv.wait(sampling_ul, [this, &last_period]() {
+			return sampling.stop || (sampling.period != last_period); });
+		if (sampling.stop)
+			break;
+		last_period = sampling.period;
+		sampling_ul.unlock();
+
+		SampleResourcesStatus(thd_id, first_resource_index, last_resource_index);
+
+		sampling_ul.lock();
+		if (--sampling.pending == 0)
+			sampling.end_cv.notify_one();
+	}
+	logger->Notice("SamplerLoop: [thread %d] terminating", thd_id);
 }
 
 
@@ -301,8 +373,8 @@ PowerMonitor::ExitCode_t PowerMonitor::Register(
 		rsrc->EnablePowerProfile(samples_window);
 		logger->Info("Register: adding <%s> to power monitoring...",
 			rsrc->Path().c_str());
-		wm_info.resources.push_back({ra.GetPath(rsrc->Path()), rsrc});
-		wm_info.log_fp.emplace(ra.GetPath(rsrc->Path()), new std::ofstream());
+		wm_info.resources.push_back({rsrc->GetResourcePath(), rsrc});
+		wm_info.log_fp.emplace(rsrc->GetResourcePath(), new std::ofstream());
 	}
 
 	return ExitCode_t::OK;
@@ -391,85 +463,77 @@ void PowerMonitor::SendOptimizationRequest() {
 
 
 void  PowerMonitor::SampleResourcesStatus(
+		uint16_t thd_id,
 		uint16_t first_resource_index,
 		uint16_t last_resource_index) {
 	PowerManager::SamplesArray_t samples;
 	PowerManager::InfoType info_type;
-	uint16_t thd_id = 0;
-
-	if (last_resource_index != first_resource_index)
-		thd_id = first_resource_index / (last_resource_index - first_resource_index);
-	else
-		thd_id = first_resource_index;
-	logger->Debug("SampleResourcesStatus: [thread %d] monitoring resources in range [%d, %d)",
-		thd_id, first_resource_index, last_resource_index);
 
-	while (!done) {
-		if (events.none()) {
-			logger->Debug("SampleResourcesStatus: [thread %d] no events to process",
-				first_resource_index);
-			Wait();
-		}
-		if (!events.test(WM_EVENT_UPDATE))
-			continue;
-
-		// Power status monitoring over all the registered resources
-		uint16_t i = first_resource_index;
-		for (; i < last_resource_index; ++i) {
-			auto const & r_path(wm_info.resources[i].path);
-			auto & rsrc(wm_info.resources[i].resource_ptr);
-
-			std::string log_i("<" + rsrc->Path() + "> (I): ");
-			std::string log_m("<" + rsrc->Path() + "> (M): ");
-			std::string i_values, m_values;
-			uint info_idx   = 0;
-			uint info_count = 0;
-			logger->Debug("SampleResourcesStatus: [thread %d] monitoring <%s>",
-				thd_id, r_path->ToString().c_str());
-
-			for (; info_idx < PowerManager::InfoTypeIndex.size() &&
-					info_count < rsrc->GetPowerInfoEnabledCount();
-						++info_idx, ++info_count) {
-				// Check if the power profile information has been required
-				info_type = PowerManager::InfoTypeIndex[info_idx];
-				if (rsrc->GetPowerInfoSamplesWindowSize(info_type) <= 0) {
-					logger->Warn("SampleResourcesStatus: [thread %d] power profile "
-						"not enabled for %s",
-						thd_id, rsrc->Path().c_str());
-					continue;
-				}
-
-				// Call power manager get function and update the resource
-				// descriptor power profile information
-				if (PowerMonitorGet[info_idx] == nullptr) {
-					logger->Warn("SampleResourcesStatus: [thread %d] power monitoring "
-						"or <%s> not available",
-						thd_id, PowerManager::InfoTypeStr[info_idx]);
-					continue;
-				}
-				PowerMonitorGet[info_idx](pm, r_path, samples[info_idx]);
-				rsrc->UpdatePowerInfo(info_type, samples[info_idx]);
-
-				// Log messages
-				BuildLogString(rsrc, info_idx, i_values, m_values);
-
-				// Policy execution trigger (ENERGY is for the battery monitor thread)
-				if (info_type != PowerManager::InfoType::ENERGY)
-					ExecuteTrigger(rsrc, info_type);
+	// Power status monitoring over all the registered resources
+	uint16_t i = first_resource_index;
+	for (; i < last_resource_index; ++i) {
+		auto const & r_path(wm_info.resources[i].path);
+		auto & rsrc(wm_info.resources[i].resource_ptr);
+		uint info_idx   = 0;
+		uint info_count = 0;
+		logger->Debug("SampleResourcesStatus: [thread %d] monitoring <%s>",
+			thd_id, r_path->ToString().c_str());
+
+		for (; info_idx < PowerManager::InfoTypeIndex.size() &&
+				info_count < rsrc->GetPowerInfoEnabledCount();
+					++info_idx, ++info_count) {
+			// Check if the power profile information has been required
+			info_type = PowerManager::InfoTypeIndex[info_idx];
+			if (rsrc->GetPowerInfoSamplesWindowSize(info_type) <= 0) {
+				logger->Warn("SampleResourcesStatus: [thread %d] power profile "
+					"not enabled for %s",
+					thd_id, rsrc->Path().c_str());
+				continue;
 			}
 
-			logger->Debug("SampleResourcesStatus: [thread %d] sampling %s ",
-				thd_id, (log_i + i_values).c_str());
-			logger->Debug("SampleResourcesStatus: [thread %d] sampling %s ",
-				thd_id, (log_m + m_values).c_str());
-			if (wm_info.log_enabled) {
-				DataLogWrite(r_path, i_values);
+			// Call power manager get function and update the resource
+			// descriptor power profile information
+			if (PowerMonitorGet[info_idx] == nullptr) {
+				logger->Warn("SampleResourcesStatus: [thread %d] power monitoring "
+					"or <%s> not available",
+					thd_id, PowerManager::InfoTypeStr[info_idx]);
+				continue;
 			}
+			PowerMonitorGet[info_idx](pm, r_path, samples[info_idx]);
+			rsrc->UpdatePowerInfo(info_type, samples[info_idx]);
+		}
+
+		// Make the new values visible to triggers and policies
+		rsrc->PublishPowerInfo();
+
+		std::string log_i("<" + rsrc->Path() + "> (I): ");
+		std::string log_m("<" + rsrc->Path() + "> (M): ");
+		std::string i_values, m_values;
+		for (info_idx = 0, info_count = 0;
+				info_idx < PowerManager::InfoTypeIndex.size() &&
+				info_count < rsrc->GetPowerInfoEnabledCount();
+					++info_idx, ++info_count) {
+			info_type = PowerManager::InfoTypeIndex[info_idx];
+			if ((rsrc->GetPowerInfoSamplesWindowSize(info_type) <= 0)
+					|| (PowerMonitorGet[info_idx] == nullptr))
+				continue;
+
+			// Log messages
+			BuildLogString(rsrc, info_idx, i_values, m_values);
+
+			// Policy execution trigger (ENERGY is for the battery monitor thread)
+			if (info_type != PowerManager::InfoType::ENERGY)
+				ExecuteTrigger(rsrc, info_type);
 		}
 
-		std::this_thread::sleep_for(std::chrono::milliseconds(wm_info.period_ms));
+		logger->Debug("SampleResourcesStatus: [thread %d] sampling %s ",
+			thd_id, (log_i + i_values).c_str());
+		logger->Debug("SampleResourcesStatus: [thread %d] sampling %s ",
+			thd_id, (log_m + m_values).c_str());
+		if (wm_info.log_enabled) {
+			DataLogWrite(r_path, i_values);
+		}
 	}
-	logger->Notice("SampleResourcesStatus: [thread %d] terminating", thd_id);
 }
 
 
@@ -663,15 +727,10 @@ int PowerMonitor::SystemLifetimeCmdHandler(
 
 
 void PowerMonitor::SampleBatteryStatus() {
-	while (pbatt && !done) {
-		if (events.none())
-			Wait();
-		if (events.test(WM_EVENT_UPDATE)) {
-			logger->Debug("SampleBatteryStatus: battery power = %dmW", pbatt->GetPower());
-			ExecuteTriggerForBattery();
-		}
-		std::this_thread::sleep_for(std::chrono::milliseconds(wm_info.period_ms));
-	}
+	if (!pbatt)
+		return;
+	logger->Debug("SampleBatteryStatus: battery power = %dmW", pbatt->GetPower());
+	ExecuteTriggerForBattery();
 }
 
 
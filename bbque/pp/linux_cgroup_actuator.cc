@@ -0,0 +1,528 @@
+/*
+ * Copyright (C) 2016  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bbque/pp/linux_cgroup_actuator.h"
+
+#include "bbque/utils/utility.h"
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <libcgroup.h>
+#include <linux/magic.h>
+#include <linux/version.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
+#include <unistd.h>
+
+#ifndef CGROUP2_SUPER_MAGIC
+#define CGROUP2_SUPER_MAGIC 0x63677270
+#endif
+
+#define BBQUE_LINUXPP_CG_PROCS    "cgroup.procs"
+#define BBQUE_LINUXPP_CG_SUBTREE  "cgroup.subtree_control"
+#define BBQUE_LINUXPP_CG_CONTROLLERS "cgroup.controllers"
+
+namespace bbque {
+namespace pp {
+
+
+/** The controllers names, as listed by the kernel */
+static const char * cg_controller_names[] = {
+	"cpuset",
+	"cpu",
+	"memory",
+	"net_cls"
+};
+
+/** The controllers required by the current configuration */
+static const bool cg_controller_used[] = {
+	true,
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(3,2,0)
+	true,
+#else
+	false,
+#endif
+#ifdef CONFIG_BBQUE_LINUX_CG_MEMORY
+	true,
+#else
+	false,
+#endif
+#ifdef CONFIG_BBQUE_LINUX_CG_NET_BANDWIDTH
+	true
+#else
+	false
+#endif
+};
+
+/** The attributes files: controller, v1 name, v2 name */
+static const struct {
+	CGroupActuator::Controller_t controller;
+	const char * file_v1;
+	const char * file_v2;
+} cg_attributes[] = {
+	{ CGroupActuator::CG_CPUSET,  "cpuset.cpus",           "cpuset.cpus" },
+	{ CGroupActuator::CG_CPUSET,  "cpuset.mems",           "cpuset.mems" },
+	{ CGroupActuator::CG_CPU,     "cpu.cfs_period_us",     nullptr       },
+	{ CGroupActuator::CG_CPU,     "cpu.cfs_quota_us",      "cpu.max"     },
+	{ CGroupActuator::CG_MEMORY,  "memory.limit_in_bytes", "memory.max"  },
+	{ CGroupActuator::CG_NET_CLS, "net_cls.classid",       nullptr       }
+};
+
+
+/**
+ * @brief Create a directory and all its missing parents
+ */
+static int MakeDirs(std::string const & dir) {
+	size_t pos = 1;
+	while (pos != std::string::npos) {
+		pos = dir.find('/', pos + 1);
+		std::string sub_dir(dir, 0, pos);
+		if ((mkdir(sub_dir.c_str(), 0755) != 0) && (errno != EEXIST))
+			return -1;
+	}
+	return 0;
+}
+
+
+/*******************************************************************************
+ *  Control group
+ ******************************************************************************/
+
+CGroupActuator::CGroup::CGroup(CGroupActuator * owner, std::string const & path):
+	owner(owner),
+	path(path) {
+	for (int & fd: fds)
+		fd = -1;
+	for (int & fd: procs_fds)
+		fd = -1;
+}
+
+CGroupActuator::CGroup::~CGroup() {
+	owner->Dispose(this);
+
+	for (int fd: fds) {
+		if (fd >= 0)
+			close(fd);
+	}
+
+	for (int c = 0; c < CG_CONTROLLERS; ++c) {
+		if (procs_fds[c] >= 0)
+			close(procs_fds[c]);
+		if (dirs[c].empty() || !owner->procs_owner[c])
+			continue;
+
+		if (rmdir(dirs[c].c_str()) == 0 || errno != EBUSY)
+			continue;
+
+		// Still hosting some tasks: legacy hierarchies allow moving them
+		// into the parent control group (as libcgroup does)
+		if (owner->unified) {
+			owner->logger->Warn("CGroup: [%s] still in use, not removed",
+				dirs[c].c_str());
+			continue;
+		}
+		// The kernel accepts a single PID per write
+		std::string parent(dirs[c], 0, dirs[c].rfind('/'));
+		std::ifstream procs_ifs(dirs[c] + "/" BBQUE_LINUXPP_CG_PROCS);
+		std::string pid;
+		int parent_fd = -1;
+		while (std::getline(procs_ifs, pid))
+			owner->Write(parent_fd, parent, BBQUE_LINUXPP_CG_PROCS, pid);
+		if (parent_fd >= 0)
+			close(parent_fd);
+
+		if (rmdir(dirs[c].c_str()) != 0) {
+			owner->logger->Warn("CGroup: [%s] removal FAILED (%d: %s)",
+				dirs[c].c_str(), errno, strerror(errno));
+		}
+	}
+}
+
+
+/*******************************************************************************
+ *  Actuator
+ ******************************************************************************/
+
+CGroupActuator::CGroupActuator() {
+	logger = bu::Logger::GetLogger(LINUX_CG_ACTUATOR_NAMESPACE);
+	assert(logger);
+	for (bool & owner: procs_owner)
+		owner = false;
+}
+
+CGroupActuator::ExitCode_t CGroupActuator::Init() {
+	struct statfs root_fs;
+
+	// Unified hierarchy: the controllers available are listed into the
+	// root control group
+	if ((statfs(BBQUE_LINUXPP_CGROUP_ROOT, &root_fs) == 0) &&
+			(root_fs.f_type == CGROUP2_SUPER_MAGIC)) {
+		unified = true;
+		std::ifstream ctrls_ifs(
+			BBQUE_LINUXPP_CGROUP_ROOT "/" BBQUE_LINUXPP_CG_CONTROLLERS);
+		std::unordered_set<std::string> ctrls_available;
+		std::string ctrl_name;
+		while (ctrls_ifs >> ctrl_name)
+			ctrls_available.insert(ctrl_name);
+
+		for (int c = 0; c < CG_CONTROLLERS; ++c) {
+			if (!cg_controller_used[c])
+				continue;
+			if (ctrls_available.count(cg_controller_names[c]) == 0) {
+				logger->Warn("Init: controller [%s] not available "
+					"on the unified hierarchy", cg_controller_names[c]);
+				continue;
+			}
+			mounts[c] = BBQUE_LINUXPP_CGROUP_ROOT;
+		}
+	}
+	// Legacy hierarchies: one mount point per controller
+	else {
+		int cg_result = cgroup_init();
+		if (unlikely(cg_result)) {
+			logger->Error("Init: CGroup Library initializaton FAILED! "
+				"(Error: %d - %s)", cg_result, cgroup_strerror(cg_result));
+			return NOT_MOUNTED;
+		}
+
+		for (int c = 0; c < CG_CONTROLLERS; ++c) {
+			char * mount_path = NULL;
+			if (!cg_controller_used[c])
+				continue;
+			cg_result = cgroup_get_subsys_mount_point(
+				cg_controller_names[c], &mount_path);
+			if (unlikely(cg_result)) {
+				logger->Warn("Init: controller [%s] mountpoint lookup FAILED "
+					"(Error: %d - %s)", cg_controller_names[c],
+					cg_result, cgroup_strerror(cg_result));
+				continue;
+			}
+			mounts[c] = mount_path;
+			free(mount_path);
+		}
+	}
+
+	if (mounts[CG_CPUSET].empty()) {
+		logger->Error("Init: controller [cpuset] not mounted");
+		return NOT_MOUNTED;
+	}
+
+	// The tasks assignment is performed once per hierarchy
+	for (int c = 0; c < CG_CONTROLLERS; ++c) {
+		procs_owner[c] = !mounts[c].empty();
+		for (int p = 0; procs_owner[c] && p < c; ++p) {
+			if (mounts[p] == mounts[c])
+				procs_owner[c] = false;
+		}
+		if (!mounts[c].empty())
+			logger->Info("Init: controller [%s] mounted at [%s]",
+				cg_controller_names[c], mounts[c].c_str());
+	}
+
+	logger->Notice("Init: using %s control groups",
+		unified ? "v2 (unified)" : "v1 (legacy)");
+
+	return OK;
+}
+
+const char * CGroupActuator::FileName(Attribute_t attr) const {
+	if (unified)
+		return cg_attributes[attr].file_v2;
+	return cg_attributes[attr].file_v1;
+}
+
+void CGroupActuator::EnableControllers(std::string const & cg_path) {
+	std::string dir(BBQUE_LINUXPP_CGROUP_ROOT);
+	size_t pos = 0;
+
+	// Each ancestor must enable the controllers for its children, starting
+	// from the root
+	while (true) {
+		if (enabled_dirs.count(dir) == 0) {
+			// One write per controller: a controller rejected by the
+			// kernel would make all the others of the same write to fail
+			int subtree_fd = -1;
+			for (int c = 0; c < CG_CONTROLLERS; ++c) {
+				if (mounts[c].empty())
+					continue;
+				if (!Write(subtree_fd, dir, BBQUE_LINUXPP_CG_SUBTREE,
+						std::string("+") + cg_controller_names[c]))
+					logger->Warn("EnableControllers: [%s] cannot enable "
+						"[%s] for children", dir.c_str(),
+						cg_controller_names[c]);
+			}
+			if (subtree_fd >= 0)
+				close(subtree_fd);
+			enabled_dirs.insert(dir);
+		}
+
+		pos = cg_path.find('/', pos);
+		if (pos == std::string::npos)
+			break;
+		dir = BBQUE_LINUXPP_CGROUP_ROOT "/" + cg_path.substr(0, pos++);
+		if ((mkdir(dir.c_str(), 0755) != 0) && (errno != EEXIST)) {
+			logger->Error("EnableControllers: [%s] creation FAILED "
+				"(%d: %s)", dir.c_str(), errno, strerror(errno));
+			break;
+		}
+	}
+}
+
+CGroupActuator::CGroupPtr_t CGroupActuator::Create(const char * cg_path) {
+	CGroupPtr_t pcg(new CGroup(this, cg_path));
+
+	logger->Info("Create: control group [%s]", cg_path);
+	if (unified) {
+		std::unique_lock<std::mutex> cg_ul(cg_mtx);
+		EnableControllers(cg_path);
+	}
+
+	for (int c = 0; c < CG_CONTROLLERS; ++c) {
+		if (mounts[c].empty())
+			continue;
+		pcg->dirs[c] = mounts[c] + "/" + cg_path;
+		if (unlikely(MakeDirs(pcg->dirs[c]) != 0)) {
+			logger->Error("Create: [%s] creation FAILED (%d: %s)",
+				pcg->dirs[c].c_str(), errno, strerror(errno));
+			return nullptr;
+		}
+	}
+
+	// Check which attributes the kernel provides
+	for (int attr = 0; attr < ATTRIBUTES_COUNT; ++attr) {
+		const char * file = FileName(static_cast<Attribute_t>(attr));
+		std::string const & dir(pcg->dirs[cg_attributes[attr].controller]);
+		if (!file || dir.empty())
+			continue;
+		if (access((dir + "/" + file).c_str(), W_OK) == 0)
+			pcg->available |= (1 << attr);
+		else
+			logger->Debug("Create: [%s] attribute [%s] not available",
+				cg_path, file);
+	}
+
+	return pcg;
+}
+
+void CGroupActuator::Set(
+		CGroupPtr_t const & pcg,
+		Attribute_t attr,
+		std::string const & value) {
+	uint32_t attr_bit = (1 << attr);
+	std::unique_lock<std::mutex> cg_ul(cg_mtx);
+
+	if (!pcg->IsAvailable(attr))
+		return;
+
+	// Already applied: drop any different value staged in the meantime
+	if ((pcg->valid & attr_bit) && (pcg->applied[attr] == value)) {
+		pcg->dirty &= ~attr_bit;
+		return;
+	}
+
+	pcg->staged[attr] = value;
+	pcg->dirty |= attr_bit;
+	if (!pcg->pending) {
+		pcg->pending = true;
+		pending.push_back(pcg);
+	}
+}
+
+void CGroupActuator::SetCPUQuota(
+		CGroupPtr_t const & pcg,
+		int64_t quota_us,
+		uint32_t period_us) {
+	std::string period(std::to_string(period_us));
+
+	if (unified) {
+		if (quota_us < 0)
+			Set(pcg, CPU_QUOTA, "max " + period);
+		else
+			Set(pcg, CPU_QUOTA, std::to_string(quota_us) + " " + period);
+		return;
+	}
+
+	Set(pcg, CPU_PERIOD, period);
+	Set(pcg, CPU_QUOTA, std::to_string(quota_us < 0 ? -1 : quota_us));
+}
+
+void CGroupActuator::SetMemoryLimit(CGroupPtr_t const & pcg, int64_t bytes) {
+	if (bytes > 0)
+		Set(pcg, MEMORY_LIMIT, std::to_string(bytes));
+	else
+		Set(pcg, MEMORY_LIMIT, unified ? "max" : "-1");
+}
+
+void CGroupActuator::Attach(CGroupPtr_t const & pcg, pid_t pid) {
+	// Released out of the critical section, since it could be the last
+	// reference to a control group
+	CGroupPtr_t prev_pcg;
+	std::unique_lock<std::mutex> cg_ul(cg_mtx);
+
+	auto move_it = moves.find(pid);
+	if (move_it != moves.end()) {
+		prev_pcg = std::move(move_it->second);
+		moves.erase(move_it);
+	}
+
+	auto place_it = placement.find(pid);
+	if ((place_it != placement.end()) && (place_it->second == pcg.get()))
+		return;
+	moves.emplace(pid, pcg);
+}
+
+void CGroupActuator::Forget(pid_t pid) {
+	CGroupPtr_t prev_pcg;
+	std::unique_lock<std::mutex> cg_ul(cg_mtx);
+
+	auto move_it = moves.find(pid);
+	if (move_it != moves.end()) {
+		prev_pcg = std::move(move_it->second);
+		moves.erase(move_it);
+	}
+	placement.erase(pid);
+}
+
+void CGroupActuator::Dispose(CGroup const * pcg) {
+	std::unique_lock<std::mutex> cg_ul(cg_mtx);
+	for (auto it = placement.begin(); it != placement.end(); ) {
+		if (it->second == pcg)
+			it = placement.erase(it);
+		else
+			++it;
+	}
+}
+
+bool CGroupActuator::Write(
+		int & fd,
+		std::string const & dir,
+		const char * file,
+		std::string const & value) {
+
+	if (fd < 0) {
+		std::string path(dir + "/" + file);
+		fd = open(path.c_str(), O_WRONLY | O_CLOEXEC);
+		if (unlikely(fd < 0)) {
+			logger->Error("Write: [%s] open FAILED (%d: %s)",
+				path.c_str(), errno, strerror(errno));
+			return false;
+		}
+	}
+
+	// An empty value must be written as an empty line
+	ssize_t result;
+	if (value.empty())
+		result = pwrite(fd, "\n", 1, 0);
+	else
+		result = pwrite(fd, value.c_str(), value.size(), 0);
+	if (likely(result >= 0))
+		return true;
+
+	logger->Error("Write: [%s/%s] <= [%s] FAILED (%d: %s)",
+		dir.c_str(), file, value.c_str(), errno, strerror(errno));
+
+	// The control group has been removed meanwhile
+	if ((errno == ENODEV) || (errno == EBADF)) {
+		close(fd);
+		fd = -1;
+	}
+	return false;
+}
+
+CGroupActuator::ExitCode_t CGroupActuator::Commit(
+		std::unordered_set<pid_t> & failed_pids) {
+	// Declared before the lock, thus released out of the critical section
+	std::vector<CGroupPtr_t> to_write;
+	std::unordered_map<pid_t, CGroupPtr_t> to_move;
+	uint32_t writes_count = 0;
+	uint32_t errors_count = 0;
+	char pid_str[16];
+
+	std::unique_lock<std::mutex> cg_ul(cg_mtx);
+	to_write.swap(pending);
+	to_move.swap(moves);
+
+	// Attributes first, so that each control group is fully configured
+	// before hosting any task
+	for (CGroupPtr_t const & pcg: to_write) {
+		pcg->pending = false;
+		if (pcg->dirty == 0)
+			continue;
+		pcg->failed = false;
+
+		for (int attr = 0; attr < ATTRIBUTES_COUNT; ++attr) {
+			uint32_t attr_bit = (1 << attr);
+			if (!(pcg->dirty & attr_bit))
+				continue;
+
+			++writes_count;
+			if (Write(pcg->fds[attr],
+					pcg->dirs[cg_attributes[attr].controller],
+					FileName(static_cast<Attribute_t>(attr)),
+					pcg->staged[attr])) {
+				pcg->applied[attr].swap(pcg->staged[attr]);
+				pcg->valid |= attr_bit;
+				continue;
+			}
+
+			++errors_count;
+			pcg->valid &= ~attr_bit;
+			pcg->failed = true;
+		}
+		pcg->dirty = 0;
+	}
+
+	// Tasks assignment
+	for (auto const & move: to_move) {
+		pid_t pid = move.first;
+		CGroupPtr_t const & pcg(move.second);
+		bool moved = !pcg->failed;
+
+		snprintf(pid_str, sizeof(pid_str), "%d", pid);
+		for (int c = 0; moved && c < CG_CONTROLLERS; ++c) {
+			if (!procs_owner[c] || pcg->dirs[c].empty())
+				continue;
+			++writes_count;
+			moved = Write(pcg->procs_fds[c], pcg->dirs[c],
+					BBQUE_LINUXPP_CG_PROCS, pid_str);
+		}
+
+		if (likely(moved)) {
+			placement[pid] = pcg.get();
+			continue;
+		}
+
+		++errors_count;
+		placement.erase(pid);
+		failed_pids.insert(pid);
+	}
+
+	logger->Debug("Commit: %d control groups, %d tasks => %d writes, %d errors",
+		to_write.size(), to_move.size(), writes_count, errors_count);
+
+	if (errors_count)
+		return WRITE_FAILED;
+	return OK;
+}
+
+} // namespace pp
+
+} // namespace bbque
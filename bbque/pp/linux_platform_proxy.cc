@@ -22,10 +22,10 @@
 #include "bbque/res/resource_path.h"
 
 #include "bbque/utils/assert.h"
+#include "bbque/utils/timer.h"
 
 #include <boost/program_options.hpp>
 #include <fstream>
-#include <libcgroup.h>
 #include <linux/ethtool.h>
 #include <linux/sockios.h>
 #include <linux/version.h>
@@ -58,14 +58,8 @@
 
 #define BBQUE_LINUXPP_SILOS 			BBQUE_LINUXPP_CGROUP"/silos"
 
-#define BBQUE_LINUXPP_CPUS_PARAM 		"cpuset.cpus"
-#define BBQUE_LINUXPP_CPUP_PARAM 		"cpu.cfs_period_us"
-#define BBQUE_LINUXPP_CPUQ_PARAM 		"cpu.cfs_quota_us"
-#define BBQUE_LINUXPP_MEMN_PARAM 		"cpuset.mems"
-#define BBQUE_LINUXPP_MEMB_PARAM 		"memory.limit_in_bytes"
 #define BBQUE_LINUXPP_CPU_EXCLUSIVE_PARAM 	"cpuset.cpu_exclusive"
 #define BBQUE_LINUXPP_MEM_EXCLUSIVE_PARAM 	"cpuset.mem_exclusive"
-#define BBQUE_LINUXPP_PROCS_PARAM		"cgroup.procs"
 #define BBQUE_LINUXPP_NETCLS_PARAM 		"net_cls.classid"
 
 #define BBQUE_LINUXPP_SYS_MEMINFO		"/proc/meminfo"
@@ -103,7 +97,6 @@ LinuxPlatformProxy * LinuxPlatformProxy::GetInstance() {
 
 
 LinuxPlatformProxy::LinuxPlatformProxy() :
-	controller("cpuset"),
 	refreshMode(false)
 #ifdef CONFIG_BBQUE_LINUX_PROC_MANAGER
 	,
@@ -430,33 +423,26 @@ LinuxPlatformProxy::Release(SchedPtr_t papp) noexcept {
 	// Release CGroup plugin data
 	// ... thus releasing the corresponding control group
 	logger->Debug("Release: releasing platform-specific data [%s]", papp->StrId());
+	cg_act.Forget(papp->Pid());
 	papp->ClearPluginData(LINUX_PP_NAMESPACE);
 	return PLATFORM_OK;
 }
 
 LinuxPlatformProxy::ExitCode_t
 LinuxPlatformProxy::ReclaimResources(SchedPtr_t papp) noexcept {
-	RLinuxBindingsPtr_t prlb(new RLinuxBindings_t(MaxCpusCount, MaxMemsCount));
-	// FIXME: update once a better SetAttributes support is available
-	//CGroupDataPtr_t pcgd(new CGroupData_t);
-	CGroupDataPtr_t pcgd;
-	int error;
+	ExitCode_t result;
 
 	logger->Debug("ReclaimResources: CGroup resource claiming START");
 
 	// Move this app into "silos" CGroup
-	cgroup_set_value_uint64(psilos->pc_cpuset,
-		BBQUE_LINUXPP_PROCS_PARAM,
-		papp->Pid());
-
-	// Configure the CGroup based on resource bindings
 	logger->Notice("ReclaimResources: [%s] => SILOS[%s]",
 	papp->StrId(), psilos->cgpath);
-	error = cgroup_modify_cgroup(psilos->pcg);
-	if (unlikely(error)) {
+	cg_act.Attach(psilos->pcg, papp->Pid());
+
+	result = ApplyCGroups(papp, psilos);
+	if (unlikely(result != PLATFORM_OK)) {
 		logger->Error("ReclaimResources: CGroup resource reclaiming FAILED "
-		"(Error: libcgroup, kernel cgroup update "
-		"[%d: %s]", errno, strerror(errno));
+		"(Error: kernel cgroup update)");
 		return PLATFORM_MAPPING_FAILED;
 	}
 
@@ -531,6 +517,13 @@ LinuxPlatformProxy::MapResources(SchedPtr_t papp, ResourceAssignmentMapPtr_t pre
 
 #endif
 
+	// Enforce the bindings (at the end of the batch, if any)
+	result = ApplyCGroups(papp, pcgd);
+	if (unlikely(result != PLATFORM_OK)) {
+		logger->Error("MapResources: Update CGroups FAILED");
+		return PLATFORM_MAPPING_FAILED;
+	}
+
 
 #ifdef CONFIG_BBQUE_CGROUPS_DISTRIBUTED_ACTUATION
 	logger->Debug("MapResources: Distributed actuation: retrieving masks and ranking");
@@ -585,6 +578,52 @@ LinuxPlatformProxy::MapResources(SchedPtr_t papp, ResourceAssignmentMapPtr_t pre
 
 	return PLATFORM_OK;
 }
+
+LinuxPlatformProxy::ExitCode_t
+LinuxPlatformProxy::MapResourcesStart() noexcept {
+	std::unique_lock<std::mutex> batch_ul(cg_batch_mtx);
+	logger->Debug("MapResourcesStart: CGroup updates batch START");
+	cg_batch = true;
+	cg_batch_apps.clear();
+	return PLATFORM_OK;
+}
+
+LinuxPlatformProxy::ExitCode_t
+LinuxPlatformProxy::MapResourcesCommit(
+		std::list<SchedPtr_t> & failed_apps) noexcept {
+	std::vector<std::pair<SchedPtr_t, CGroupDataPtr_t>> batch_apps;
+	std::unordered_set<pid_t> failed_pids;
+	std::unordered_set<SchedPtr_t> failed_set;
+	bu::Timer commit_tmr(true);
+
+	std::unique_lock<std::mutex> batch_ul(cg_batch_mtx);
+	cg_batch = false;
+	batch_apps.swap(cg_batch_apps);
+	batch_ul.unlock();
+
+	// All the control groups updated in a single pass
+	if (likely(cg_act.Commit(failed_pids) == CGroupActuator::OK)) {
+		logger->Debug("MapResourcesCommit: %d CGroup updates in %.3f [ms]",
+			batch_apps.size(), commit_tmr.getElapsedTimeMs());
+		return PLATFORM_OK;
+	}
+
+	for (auto const & app_cg: batch_apps) {
+		SchedPtr_t const & papp(app_cg.first);
+		if (CGroupsApplied(papp, app_cg.second, failed_pids))
+			continue;
+		if (!failed_set.insert(papp).second)
+			continue;
+		logger->Error("MapResourcesCommit: [%s] CGroup update FAILED",
+			papp->StrId());
+		failed_apps.push_back(papp);
+	}
+
+	if (failed_set.empty())
+		return PLATFORM_OK;
+	return PLATFORM_MAPPING_FAILED;
+}
+
 #ifdef CONFIG_BBQUE_LINUX_CG_NET_BANDWIDTH
 LinuxPlatformProxy::ExitCode_t
 LinuxPlatformProxy::SetCGNetworkBandwidth(SchedPtr_t papp, CGroupDataPtr_t pcgd,
@@ -592,7 +631,6 @@ LinuxPlatformProxy::SetCGNetworkBandwidth(SchedPtr_t papp, CGroupDataPtr_t pcgd,
 					RLinuxBindingsPtr_t prlb) {
 	ResourceAccounter &ra = ResourceAccounter::GetInstance();
 	std::stringstream sstream_PID;
-	int res;
 
 	// net_cls.classid attribute has must be written as an hexadecimal string
 	// of the shape AAAABBBB. The handles correspond to traffic shapping class
@@ -605,15 +643,12 @@ LinuxPlatformProxy::SetCGNetworkBandwidth(SchedPtr_t papp, CGroupDataPtr_t pcgd,
 	sstream_PID << std::hex << papp->Pid();
 	std::string PID( "0x10" + sstream_PID.str() );
 
-	cgroup_add_value_string(pcgd->pc_net_cls,
-			BBQUE_LINUXPP_NETCLS_PARAM, PID.c_str());
-	res = cgroup_modify_cgroup(pcgd->pcg);
-	if (res) {
+	if (!pcgd->pcg->IsAvailable(CGroupActuator::NET_CLASSID)) {
 		logger->Error("SetCGNetworkBandwidth: CGroup NET_CLS resource mapping FAILED "
-				"(Error: libcgroup, kernel cgroup update "
-				"[%d: %s])", errno, strerror(errno));
+				"(Error: [%s] not available)", BBQUE_LINUXPP_NETCLS_PARAM);
 		return PLATFORM_MAPPING_FAILED;
 	}
+	cg_act.Set(pcgd->pcg, CGroupActuator::NET_CLASSID, PID);
 
 	br::ResourceBitset net_ifs(
 		br::ResourceBinder::GetMask(pres, br::ResourceType::NETWORK_IF));
@@ -972,26 +1007,12 @@ void LinuxPlatformProxy::InitPowerInfo(
 
 LinuxPlatformProxy::ExitCode_t LinuxPlatformProxy::InitCGroups() noexcept {
 	ExitCode_t pp_result;
-	char *mount_path = NULL;
-	int cg_result;
-
-	// Init the Control Group Library
-	cg_result = cgroup_init();
-	if (unlikely(cg_result)) {
-		logger->Error("InitCGroups: CGroup Library initializaton FAILED! "
-		"(Error: %d - %s)", cg_result, cgroup_strerror(cg_result));
-		return PLATFORM_INIT_FAILED;
-	}
 
-	cg_result = cgroup_get_subsys_mount_point(controller, &mount_path);
-	if (unlikely(cg_result)) {
-		logger->Error("InitCGroups: CGroup Library mountpoint lookup FAILED! "
-		"(Error: %d - %s)", cg_result, cgroup_strerror(cg_result));
-		return PLATFORM_GENERIC_ERROR;
+	// Lookup the mounted hierarchies (legacy or unified)
+	if (unlikely(cg_act.Init() != CGroupActuator::OK)) {
+		logger->Error("InitCGroups: CGroup hierarchies lookup FAILED!");
+		return PLATFORM_INIT_FAILED;
 	}
-	logger->Info("InitCGroups: controller [%s] mounted at [%s]",
-		controller, mount_path);
-
 
 	// TODO: check that the "bbq" cgroup already existis
 	// TODO: check that the "bbq" cgroup has CPUS and MEMS
@@ -1006,17 +1027,13 @@ LinuxPlatformProxy::ExitCode_t LinuxPlatformProxy::InitCGroups() noexcept {
 		return PLATFORM_GENERIC_ERROR;
 	}
 
-	free(mount_path);
-
 	return PLATFORM_OK;
 }
 
 LinuxPlatformProxy::ExitCode_t
 LinuxPlatformProxy::BuildSilosCG(CGroupDataPtr_t &pcgd) noexcept {
-	RLinuxBindingsPtr_t prlb(new RLinuxBindings_t(
-	        MaxCpusCount, MaxMemsCount));
+	std::unordered_set<pid_t> failed_pids;
 	ExitCode_t result;
-	int error;
 
 	logger->Debug("BuildSilosCG: Building SILOS CGroup...");
 
@@ -1027,20 +1044,14 @@ LinuxPlatformProxy::BuildSilosCG(CGroupDataPtr_t &pcgd) noexcept {
 		return result;
 
 	// Setting up silos (limited) resources, just to run the RTLib
-	sprintf(prlb->cpus, "0");
-	sprintf(prlb->mems, "0");
-
-	// Configuring silos constraints
-	cgroup_set_value_string(pcgd->pc_cpuset, BBQUE_LINUXPP_CPUS_PARAM, prlb->cpus);
-	cgroup_set_value_string(pcgd->pc_cpuset, BBQUE_LINUXPP_MEMN_PARAM, prlb->mems);
+	cg_act.Set(pcgd->pcg, CGroupActuator::CPUSET_CPUS, "0");
+	cg_act.Set(pcgd->pcg, CGroupActuator::CPUSET_MEMS, "0");
 
 	// Updating silos constraints
 	logger->Notice("BuildSilosCG: Updating kernel CGroup [%s]", pcgd->cgpath);
-	error = cgroup_modify_cgroup(pcgd->pcg);
-	if (unlikely(error)) {
+	if (unlikely(cg_act.Commit(failed_pids) != CGroupActuator::OK)) {
 		logger->Error("BuildSilosCG: CGroup resource mapping FAILED "
-		"(Error: libcgroup, kernel cgroup update "
-		"[%d: %s]", errno, strerror(errno));
+		"(Error: kernel cgroup update)");
 		return PLATFORM_MAPPING_FAILED;
 	}
 
@@ -1049,98 +1060,27 @@ LinuxPlatformProxy::BuildSilosCG(CGroupDataPtr_t &pcgd) noexcept {
 
 LinuxPlatformProxy::ExitCode_t
 LinuxPlatformProxy::BuildCGroup(CGroupDataPtr_t &pcgd) noexcept {
-	int result;
 
 	logger->Debug("BuildCGroup: Building CGroup [%s]...", pcgd->cgpath);
 
-	// Setup CGroup path for this application
-	pcgd->pcg = cgroup_new_cgroup(pcgd->cgpath);
+	// Create the kernel-space CGroup
+	pcgd->pcg = cg_act.Create(pcgd->cgpath);
 	if (unlikely(!pcgd->pcg)) {
 		logger->Error("BuildCGroup: CGroup resource mapping FAILED "
-		"(Error: libcgroup, \"cgroup\" creation)");
-		return PLATFORM_MAPPING_FAILED;
-	}
-
-	// Add "cpuset" controller
-	pcgd->pc_cpuset = cgroup_add_controller(pcgd->pcg, "cpuset");
-	if (unlikely(!pcgd->pc_cpuset)) {
-		logger->Error("BuildCGroup: CGroup resource mapping FAILED "
-		"(Error: libcgroup, [cpuset] \"controller\" "
-		"creation failed)");
+		"(Error: kernel cgroup creation)");
 		return PLATFORM_MAPPING_FAILED;
 	}
 
 #ifdef CONFIG_BBQUE_LINUX_CG_MEMORY
-	// Add "memory" controller
-	pcgd->pc_memory = cgroup_add_controller(pcgd->pcg, "memory");
-	if (unlikely(!pcgd->pc_memory)) {
-		logger->Error("BuildCGroup: CGroup resource mapping FAILED "
-		"(Error: libcgroup, [memory] \"controller\" "
-		"creation failed)");
-		return PLATFORM_MAPPING_FAILED;
+	if (!pcgd->pcg->IsAvailable(CGroupActuator::MEMORY_LIMIT)) {
+		logger->Warn("BuildCGroup: [%s] memory controller not available",
+			pcgd->cgpath);
 	}
 #endif
 
-#if LINUX_VERSION_CODE >= KERNEL_VERSION(3,2,0)
-
-	// Add "cpu" controller
-	pcgd->pc_cpu = cgroup_add_controller(pcgd->pcg, "cpu");
-	if (unlikely(!pcgd->pc_cpu)) {
-		logger->Error("BuildCGroup: CGroup resource mapping FAILED "
-		"(Error: libcgroup, [cpu] \"controller\" "
-		"creation failed)");
-		return PLATFORM_MAPPING_FAILED;
-	}
-
-#endif
-
-#ifdef CONFIG_BBQUE_LINUX_CG_NET_BANDWIDTH
-	pcgd->pc_net_cls = cgroup_add_controller(pcgd->pcg, "net_cls");
-	if (!pcgd->pc_net_cls) {
-		logger->Error("BuildCGroup: CGroup resource mapping FAILED "
-				"(Error: libcgroup, [net_cls] \"controller\" "
-				"creation failed)");
-		return PLATFORM_MAPPING_FAILED;
-	}
-#endif
-
-	// Create the kernel-space CGroup
-	// NOTE: the current libcg API is quite confuse and unclear
-	// regarding the "ignore_ownership" second parameter
-	logger->Info("BuildCGroup: Create kernel CGroup [%s]", pcgd->cgpath);
-	result = cgroup_create_cgroup(pcgd->pcg, 0);
-	if (unlikely(result && errno)) {
-		logger->Error("BuildCGroup: CGroup resource mapping FAILED "
-		"(Error: libcgroup, kernel cgroup creation "
-		"[%d: %s]", errno, strerror(errno));
-		cgroup_delete_cgroup(pcgd->pcg, 1);	// As suggested by documentation
-		return PLATFORM_MAPPING_FAILED;
-	}
-
-
-	// Unfortunately we cannot use pcgd->pcg to check if the "cpu" controller
-	// is available or not, so we have to open a new cgroup in order to check
-	// this
-	struct cgroup *temp_cg = cgroup_new_cgroup(pcgd->cgpath);
-	assert(temp_cg != NULL);
-	if (unlikely(0 != cgroup_get_cgroup(temp_cg))) {
-		logger->Error("BuildCGroup: Cannot re-open CGroup [%s], continuing with cpu quota"
-                      "disabled", pcgd->cgpath);
-		pcgd->cfs_quota_available = false;
-		return PLATFORM_OK;
-	}
-
-	struct cgroup_controller *temp_cgc = cgroup_get_controller(temp_cg, "cpu");
-
-	for (int i=0; i < cgroup_get_value_name_count(temp_cgc); i++) {
-		const char* cg_c_name = cgroup_get_value_name(temp_cgc, i);
-		if ( 0 == strcmp(cg_c_name, "cpu.cfs_quota_us") ) {
-			pcgd->cfs_quota_available = true;
-			return PLATFORM_OK;
-		}
-	}
-
-	pcgd->cfs_quota_available = false;
+	// The "cpu" controller could be not enabled by the kernel
+	pcgd->cfs_quota_available =
+		pcgd->pcg->IsAvailable(CGroupActuator::CPU_QUOTA);
 
 	return PLATFORM_OK;
 }
@@ -1188,7 +1128,10 @@ LinuxPlatformProxy::SetupCGroup(
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(3,2,0)
 	int64_t cpus_quota = -1; // NOTE: use "-1" for no quota assignement
 #endif
-	int result;
+
+	// NOTE: the attributes are only staged here, and then written by
+	// ApplyCGroups(), which skips the ones not changed since the last
+	// update
 
 	/**********************************************************************
 	 *    CPUSET Controller
@@ -1205,13 +1148,12 @@ LinuxPlatformProxy::SetupCGroup(
 #endif
 
 	// Set the assigned CPUs
-	cgroup_set_value_string(
-		pcgd->pc_cpuset, BBQUE_LINUXPP_CPUS_PARAM, prlb->cpus ? prlb->cpus : "");
+	cg_act.Set(pcgd->pcg, CGroupActuator::CPUSET_CPUS,
+		prlb->cpus ? prlb->cpus : "");
 
 	// Set the assigned memory NODE (only if we have at least one CPUS)
 	if (prlb->cpus[0]) {
-		cgroup_set_value_string(
-			pcgd->pc_cpuset, BBQUE_LINUXPP_MEMN_PARAM, prlb->mems);
+		cg_act.Set(pcgd->pcg, CGroupActuator::CPUSET_MEMS, prlb->mems);
 
 		logger->Debug("SetupCGroup: CPUSET for [%s]: {cpus [%c: %s], mems[%s]}",
 			pcgd->papp->StrId(),
@@ -1230,17 +1172,11 @@ LinuxPlatformProxy::SetupCGroup(
 #ifdef CONFIG_BBQUE_LINUX_CG_MEMORY
 	assert(prlb->amount_memb >= -1);
 
-	char quota[] = "9223372036854775807";
-	// Set the assigned MEMORY amount
-	if (prlb->amount_memb > 0)
-		sprintf(quota, "%lu", prlb->amount_memb);
-	else
-		sprintf(quota, "-1");
-
-	cgroup_set_value_string(pcgd->pc_memory, BBQUE_LINUXPP_MEMB_PARAM, quota);
+	// Set the assigned MEMORY amount (no limit if not assigned)
+	cg_act.SetMemoryLimit(pcgd->pcg, prlb->amount_memb);
 
-	logger->Debug("SetupCGroup: MEMORY for [%s]: {bytes_limit [%s]}",
-		pcgd->papp->StrId(), quota);
+	logger->Debug("SetupCGroup: MEMORY for [%s]: {bytes_limit [%ld]}",
+		pcgd->papp->StrId(), prlb->amount_memb);
 #endif
 
 	/**********************************************************************
@@ -1250,14 +1186,10 @@ LinuxPlatformProxy::SetupCGroup(
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(3,2,0)
 
 	uint32_t cfs_period_us = BBQUE_LINUXPP_CPUP_MAX;
-	char const *cfs_c = std::to_string(cfs_period_us).c_str();
 
 	if (likely(pcgd->cfs_quota_available)) {
 		bool quota_enforcing = true;
-		// Set the default CPU bandwidth period
-		cgroup_set_value_string(pcgd->pc_cpu, BBQUE_LINUXPP_CPUP_PARAM, cfs_c);
 
-		// Set the assigned CPU bandwidth amount
 		// NOTE: if a quota is NOT assigned we have amount_cpus="0", but this
 		// is not acceptable by the CFS controller, which requires a negative
 		// number to remove any constraint.
@@ -1279,36 +1211,28 @@ LinuxPlatformProxy::SetupCGroup(
 		if (quota_enforcing) {
 
 			cpus_quota = (cfs_period_us / 100) *	prlb->amount_cpus;
-			cgroup_set_value_int64(pcgd->pc_cpu, BBQUE_LINUXPP_CPUQ_PARAM, cpus_quota);
 
-			logger->Debug("SetupCGroup: CPU for [%s]: {period [%s], quota [%lu]}",
+			logger->Debug("SetupCGroup: CPU for [%s]: {period [%u], quota [%lu]}",
 					pcgd->papp->StrId(),
-					cfs_c,
+					cfs_period_us,
 					cpus_quota);
 		} else {
 
-			logger->Debug("SetupCGroup: CPU for [%s]: {period [%s], quota [-]}",
+			// Remove any quota previously enforced
+			cpus_quota = -1;
+
+			logger->Debug("SetupCGroup: CPU for [%s]: {period [%u], quota [-]}",
 					pcgd->papp->StrId(),
-					cfs_c);
+					cfs_period_us);
 		}
+
+		// Set the CPU bandwidth period and the assigned amount
+		cg_act.SetCPUQuota(pcgd->pcg, cpus_quota, cfs_period_us);
 	} else {
 		logger->Warn("SetupCGroup: CFS quota enforcement not supported by the kernel");
 	}
 #endif
 
-	/**********************************************************************
-	 *    CGroup Configuraiton
-	 **********************************************************************/
-
-	logger->Debug("SetupCGroup: Updating cgroup [%s]", pcgd->cgpath);
-	result = cgroup_modify_cgroup(pcgd->pcg);
-	if (unlikely(result)) {
-		logger->Error("SetupCGroup: cgroup resource mapping FAILED "
-		"(Error: libcgroup, kernel cgroup update "
-		"[%d: %s])", errno, strerror(errno));
-		return PLATFORM_MAPPING_FAILED;
-	}
-
 	/* If a task has not beed assigned, we are done */
 	if (!move)
 		return PLATFORM_OK;
@@ -1316,8 +1240,9 @@ LinuxPlatformProxy::SetupCGroup(
 	/**********************************************************************
 	 *    CGroup Task Assignement
 	 **********************************************************************/
-	// NOTE: task assignement must be done AFTER CGroup configuration, to
-	// ensure all the controller have been properly setup to manage the
+	// NOTE: task assignement is done AFTER CGroup configuration (the
+	// actuator moves the tasks once all the attributes have been written),
+	// to ensure all the controller have been properly setup to manage the
 	// task. Otherwise a task could be killed if being assigned to a
 	// CGroup not yet configure.
 
@@ -1325,17 +1250,7 @@ LinuxPlatformProxy::SetupCGroup(
 		pcgd->papp->StrId(),
 		prlb->cpus, prlb->amount_cpus,
 		prlb->mems, prlb->amount_memb);
-	cgroup_set_value_uint64(
-		pcgd->pc_cpuset, BBQUE_LINUXPP_PROCS_PARAM, pcgd->papp->Pid());
-
-	logger->Debug("SetupCGroup: Updating cgroup [%s]", pcgd->cgpath);
-	result = cgroup_modify_cgroup(pcgd->pcg);
-	if (unlikely(result)) {
-		logger->Error("SetupCGroup: cgroup resource mapping FAILED "
-		"(Error: libcgroup, kernel cgroup update "
-		"[%d: %s])", errno, strerror(errno));
-		return PLATFORM_MAPPING_FAILED;
-	}
+	cg_act.Attach(pcgd->pcg, pcgd->papp->Pid());
 
 	return PLATFORM_OK;
 }
@@ -1348,6 +1263,37 @@ LinuxPlatformProxy::BuildAppCG(SchedPtr_t papp, CGroupDataPtr_t &pcgd) noexcept
 }
 
 
+LinuxPlatformProxy::ExitCode_t
+LinuxPlatformProxy::ApplyCGroups(SchedPtr_t papp, CGroupDataPtr_t pcgd) noexcept {
+	std::unordered_set<pid_t> failed_pids;
+
+	// Batch in progress: enforced at MapResourcesCommit()
+	std::unique_lock<std::mutex> batch_ul(cg_batch_mtx);
+	if (cg_batch) {
+		cg_batch_apps.emplace_back(papp, pcgd);
+		return PLATFORM_OK;
+	}
+	batch_ul.unlock();
+
+	logger->Debug("ApplyCGroups: [%s] updating kernel CGroups", papp->StrId());
+	cg_act.Commit(failed_pids);
+	if (unlikely(!CGroupsApplied(papp, pcgd, failed_pids)))
+		return PLATFORM_MAPPING_FAILED;
+
+	return PLATFORM_OK;
+}
+
+bool LinuxPlatformProxy::CGroupsApplied(
+		SchedPtr_t papp,
+		CGroupDataPtr_t const & pcgd,
+		std::unordered_set<pid_t> const & failed_pids) const noexcept {
+	if (failed_pids.count(papp->Pid()))
+		return false;
+	if (pcgd && pcgd->pcg && pcgd->pcg->Failed())
+		return false;
+	return true;
+}
+
 
 }   // namespace pp
 }   // namespace bbque
@@ -183,6 +183,45 @@ LocalPlatformProxy::ExitCode_t LocalPlatformProxy::MapResources(
 	return PLATFORM_OK;
 }
 
+LocalPlatformProxy::ExitCode_t LocalPlatformProxy::MapResourcesStart() {
+	ExitCode_t ec;
+
+	ec = this->host->MapResourcesStart();
+	if (ec != PLATFORM_OK) {
+		return ec;
+	}
+
+	for (auto it=this->aux.begin() ; it < this->aux.end(); it++) {
+		ec = (*it)->MapResourcesStart();
+		if (ec != PLATFORM_OK) {
+			return ec;
+		}
+	}
+
+	return PLATFORM_OK;
+}
+
+LocalPlatformProxy::ExitCode_t LocalPlatformProxy::MapResourcesCommit(
+        std::list<SchedPtr_t> & failed_apps) {
+	ExitCode_t ec;
+	ExitCode_t result = PLATFORM_OK;
+
+	// All the proxies must enforce their bindings anyway
+	ec = this->host->MapResourcesCommit(failed_apps);
+	if (ec != PLATFORM_OK) {
+		result = ec;
+	}
+
+	for (auto it=this->aux.begin() ; it < this->aux.end(); it++) {
+		ec = (*it)->MapResourcesCommit(failed_apps);
+		if (ec != PLATFORM_OK) {
+			result = ec;
+		}
+	}
+
+	return result;
+}
+
 
 void LocalPlatformProxy::Exit() {
 	this->host->Exit();
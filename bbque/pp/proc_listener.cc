@@ -16,11 +16,17 @@
  */
 
 #include "bbque/pp/proc_listener.h"
+#include <cstddef>
 #include <cstdlib>
+#include <cstring>
 #include <linux/cn_proc.h>
 #include <linux/netlink.h>
 #include <linux/connector.h>
+#include <linux/filter.h>
+#include <arpa/inet.h>
+#include <poll.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <errno.h>
 #include <sstream>
@@ -53,8 +59,7 @@ std::string ProcessListener::GetProcName(int pid) {
 ProcessListener::ProcessListener():
 		prm(ProcessManager::GetInstance()) {
 	sock = -1;
-	buffSize = getpagesize();
-	buf = new char[buffSize];
+	buf = new char[PROC_LISTENER_BATCH * PROC_LISTENER_MSG_SIZE];
 	logger = bu::Logger::GetLogger(MODULE_NAMESPACE);
 	logger->Info("Linux Process Listener Started");
 
@@ -67,6 +72,11 @@ ProcessListener::ProcessListener():
 	//Socket creation (Datagram)
 	sock = socket (PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
 		NETLINK_CONNECTOR);
+	//Kernel side filtering of the events
+	if (!AttachFilter()) {
+		logger->Warn("Linux Process Listener socket filter not attached: "
+			"all the events will be processed");
+	}
 	//Socket Binding
 	sockaddr_nl addr;
 	addr.nl_family = AF_NETLINK;
@@ -129,91 +139,203 @@ ProcessListener::~ProcessListener() {
 	delete[] buf;
 }
 
-void ProcessListener::Task() {
+bool ProcessListener::AttachFilter() {
 	/*
-	 * Now we need to read the stream of messages. Just like the message we sent,
-	 * the stream of messages we receive are actually netlink messages,
-	 * and inside those netlink messages are connector messages,
-	 * and inside those are proc connector messages.
+	 * Offsets of the fields checked, from the beginning of the netlink
+	 * message. The kernel stores the fields in host byte order, while the
+	 * BPF load instructions read them in network byte order.
 	 */
-	msghdr msghdr;
-	sockaddr_nl addr;
-	iovec iov[1];
-	ssize_t len;
-
-	msghdr.msg_name = &addr;
-	msghdr.msg_namelen = sizeof addr;
-	msghdr.msg_iov = iov;
-	msghdr.msg_iovlen = 1;
-	msghdr.msg_control = NULL;
-	msghdr.msg_controllen = 0;
-	msghdr.msg_flags = 0;
-
-	iov[0].iov_base = buf;
-	iov[0].iov_len = buffSize;
+	const uint32_t cn_off = NLMSG_LENGTH(0);
+	const uint32_t ev_off = cn_off + offsetof(cn_msg, data);
+
+	sock_filter filter[] = {
+		// Only single part netlink messages...
+		BPF_STMT(BPF_LD | BPF_H | BPF_ABS,
+			offsetof(nlmsghdr, nlmsg_type)),
+		BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, htons(NLMSG_DONE), 1, 0),
+		BPF_STMT(BPF_RET | BPF_K, 0),
+		// ...from the proc connector...
+		BPF_STMT(BPF_LD | BPF_W | BPF_ABS,
+			cn_off + offsetof(cn_msg, id) + offsetof(cb_id, idx)),
+		BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, htonl(CN_IDX_PROC), 1, 0),
+		BPF_STMT(BPF_RET | BPF_K, 0),
+		BPF_STMT(BPF_LD | BPF_W | BPF_ABS,
+			cn_off + offsetof(cn_msg, id) + offsetof(cb_id, val)),
+		BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, htonl(CN_VAL_PROC), 1, 0),
+		BPF_STMT(BPF_RET | BPF_K, 0),
+		// ...notifying an EXEC...
+		BPF_STMT(BPF_LD | BPF_W | BPF_ABS,
+			ev_off + offsetof(proc_event, what)),
+		BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K,
+			htonl(proc_event::PROC_EVENT_EXEC), 0, 1),
+		BPF_STMT(BPF_RET | BPF_K, 0xffffffff),
+		// ...or the EXIT of a process (i.e., the thread group leader)
+		BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K,
+			htonl(proc_event::PROC_EVENT_EXIT), 1, 0),
+		BPF_STMT(BPF_RET | BPF_K, 0),
+		BPF_STMT(BPF_LD | BPF_W | BPF_ABS,
+			ev_off + offsetof(proc_event, event_data.exit.process_pid)),
+		BPF_STMT(BPF_MISC | BPF_TAX, 0),
+		BPF_STMT(BPF_LD | BPF_W | BPF_ABS,
+			ev_off + offsetof(proc_event, event_data.exit.process_tgid)),
+		BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_X, 0, 1, 0),
+		BPF_STMT(BPF_RET | BPF_K, 0),
+		BPF_STMT(BPF_RET | BPF_K, 0xffffffff),
+	};
+
+	sock_fprog fprog;
+	fprog.len = sizeof(filter) / sizeof(filter[0]);
+	fprog.filter = filter;
+	if (setsockopt(sock, SOL_SOCKET, SO_ATTACH_FILTER,
+			&fprog, sizeof(fprog)) < 0) {
+		logger->Debug("AttachFilter: %s", strerror(errno));
+		return false;
+	}
+	return true;
+}
+
+void ProcessListener::ParseMessage(char * msg, ssize_t len) {
 	/*
-	 * netlink allows arbitrary processes to send messages to each other,4
-	 * so we need to make sure the message actually comes from the kernel;
-	 * otherwise you have a potential security vulnerability.
-	 * recvmsg lets us receive the sender address as well as the data.
+	 * So now we have a netlink message package from the kernel,
+	 * this may contain multiple individual netlink messages
+	 * (it doesn’t, but it may). So we iterate over those.
 	 */
-	while (!done) {
-		len = recvmsg (sock, &msghdr, 0);
-		if (len<=0)
+	for (struct nlmsghdr *_nlmsghdr = (struct nlmsghdr *)msg;
+		NLMSG_OK (_nlmsghdr, len);
+		_nlmsghdr = NLMSG_NEXT (_nlmsghdr, len)){
+		/*
+		* Ignore No-Op messages
+		*/
+		if ((_nlmsghdr->nlmsg_type == NLMSG_ERROR) ||
+			(_nlmsghdr->nlmsg_type == NLMSG_NOOP))
 			continue;
 		/*
-		 * So now we have a netlink message package from the kernel,
-		 * this may contain multiple individual netlink messages
-		 * (it doesn’t, but it may). So we iterate over those.
+		 * Inside each individual netlink message is a connector
+		 * message, we extract that and make sure it comes from
+		 * the proc connector system.
 		 */
-		for (struct nlmsghdr *_nlmsghdr = (struct nlmsghdr *)buf;
-			NLMSG_OK (_nlmsghdr, len);
-			_nlmsghdr = NLMSG_NEXT (_nlmsghdr, len)){
-			/*
-			* Ignore No-Op messages
-			*/
-			if ((_nlmsghdr->nlmsg_type == NLMSG_ERROR) ||
-				(_nlmsghdr->nlmsg_type == NLMSG_NOOP))
-				continue;
-			/*
-			 * Inside each individual netlink message is a connector
-			 * message, we extract that and make sure it comes from
-			 * the proc connector system.
-			 */
-			cn_msg *_cn_msg = (cn_msg *)(NLMSG_DATA (_nlmsghdr));
-			if ((_cn_msg->id.idx != CN_IDX_PROC) ||
-				(_cn_msg->id.val != CN_VAL_PROC))
-				continue;
-			/*
-			 * Now we can safely extract the proc connector message;
-			 * this is a struct proc_event that we haven’t seen before.
-			 * It’s quite a large structure definition, since it contains a
-			 * union for each of the different possible message types.
-			 */
-			proc_event * e = (proc_event *)_cn_msg->data;
-			// Event Processing
-			switch (e->what){
-			case proc_event::PROC_EVENT_EXEC:
-				logger->Debug("Event : [ EXEC, pid: %i, name: %s ]",
-					e->event_data.exec.process_pid,
-					GetProcName(e->event_data.exec.process_pid).c_str());
-				prm.NotifyStart(
-					GetProcName(e->event_data.exec.process_pid),
-					e->event_data.exec.process_pid);
+		cn_msg *_cn_msg = (cn_msg *)(NLMSG_DATA (_nlmsghdr));
+		if ((_cn_msg->id.idx != CN_IDX_PROC) ||
+			(_cn_msg->id.val != CN_VAL_PROC))
+			continue;
+		/*
+		 * Now we can safely extract the proc connector message;
+		 * this is a struct proc_event that we haven’t seen before.
+		 * It’s quite a large structure definition, since it contains a
+		 * union for each of the different possible message types.
+		 */
+		proc_event * e = (proc_event *)_cn_msg->data;
+		int pid;
+		// Event Processing
+		switch (e->what){
+		case proc_event::PROC_EVENT_EXEC: {
+			pid = e->event_data.exec.process_pid;
+			std::string name(GetProcName(pid));
+			if (!prm.IsToManage(name)) {
+				// A managed process replaced by an unmanaged program, or a
+				// reused PID whose exit went missing: forget it, otherwise
+				// its next exit would be notified for the managed one
+				auto name_it = proc_names.find(pid);
+				if (name_it != proc_names.end()) {
+					logger->Debug("Event : [ EXEC, pid: %i, name: %s "
+							"replaced by %s ]", pid,
+						name_it->second.c_str(), name.c_str());
+					prm.NotifyExit(name_it->second, pid);
+					proc_names.erase(name_it);
+				}
 				break;
-			case proc_event::PROC_EVENT_EXIT:
-				logger->Debug("Event : [ EXIT, pid: %i, name: %s, "
-						"exit code: %i ]",
-					e->event_data.exec.process_pid,
-					GetProcName(e->event_data.exec.process_pid).c_str(),
-					e->event_data.exit.exit_code);
-				prm.NotifyExit(
-					GetProcName(e->event_data.exec.process_pid),
-					e->event_data.exec.process_pid);
+			}
+			logger->Debug("Event : [ EXEC, pid: %i, name: %s ]",
+				pid, name.c_str());
+			proc_names[pid] = name;
+			prm.NotifyStart(name, pid);
+			break;
+		}
+		case proc_event::PROC_EVENT_EXIT: {
+			// Threads termination (if not filtered by the kernel)
+			pid = e->event_data.exit.process_tgid;
+			if (pid != e->event_data.exit.process_pid)
 				break;
-			default:
+			// Not managed processes: nothing to do
+			auto name_it = proc_names.find(pid);
+			if (name_it == proc_names.end())
 				break;
+			logger->Debug("Event : [ EXIT, pid: %i, name: %s, "
+					"exit code: %i ]",
+				pid, name_it->second.c_str(),
+				e->event_data.exit.exit_code);
+			prm.NotifyExit(name_it->second, pid);
+			proc_names.erase(name_it);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+}
+
+void ProcessListener::Task() {
+	/*
+	 * Now we need to read the stream of messages. Just like the message we sent,
+	 * the stream of messages we receive are actually netlink messages,
+	 * and inside those netlink messages are connector messages,
+	 * and inside those are proc connector messages.
+	 * All the messages already queued are received at once, in batches of
+	 * PROC_LISTENER_BATCH messages.
+	 */
+	mmsghdr msgs[PROC_LISTENER_BATCH];
+	sockaddr_nl addrs[PROC_LISTENER_BATCH];
+	iovec iovs[PROC_LISTENER_BATCH];
+	pollfd pfd;
+	int msgs_num;
+
+	for (int i = 0; i < PROC_LISTENER_BATCH; ++i) {
+		iovs[i].iov_base = buf + i * PROC_LISTENER_MSG_SIZE;
+		iovs[i].iov_len = PROC_LISTENER_MSG_SIZE;
+		msgs[i].msg_hdr.msg_name = &addrs[i];
+		msgs[i].msg_hdr.msg_iov = &iovs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		msgs[i].msg_hdr.msg_control = NULL;
+		msgs[i].msg_hdr.msg_controllen = 0;
+		msgs[i].msg_hdr.msg_flags = 0;
+	}
+
+	pfd.fd = sock;
+	pfd.events = POLLIN;
+
+	while (!done) {
+		// Timeout or interrupted (e.g., by Terminate())
+		if (poll(&pfd, 1, PROC_LISTENER_POLL_MS) <= 0)
+			continue;
+
+		for (;;) {
+			for (int i = 0; i < PROC_LISTENER_BATCH; ++i)
+				msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_nl);
+
+			msgs_num = recvmmsg(sock, msgs, PROC_LISTENER_BATCH,
+				MSG_DONTWAIT, NULL);
+			if (msgs_num < 0) {
+				if (errno != ENOBUFS)
+					break;
+				logger->Warn("Task: socket buffer overrun, events lost");
+				continue;
+			}
+
+			for (int i = 0; i < msgs_num; ++i) {
+				/*
+				 * netlink allows arbitrary processes to send messages
+				 * to each other, so we need to make sure the message
+				 * actually comes from the kernel; otherwise you have a
+				 * potential security vulnerability.
+				 */
+				if (addrs[i].nl_pid != 0)
+					continue;
+				ParseMessage(buf + i * PROC_LISTENER_MSG_SIZE,
+					msgs[i].msg_len);
 			}
+
+			if (msgs_num < PROC_LISTENER_BATCH)
+				break;
 		}
 	}
 }
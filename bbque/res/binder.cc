@@ -28,6 +28,12 @@ namespace bu = bbque::utils;
 
 namespace bbque { namespace res {
 
+/** Logger shared by the binding functions (created at the first use) */
+static bu::Logger * BinderLogger() {
+	static std::unique_ptr<bu::Logger> logger(
+		bu::Logger::GetLogger(MODULE_NAMESPACE));
+	return logger.get();
+}
 
 void ResourceBinder::Bind(
 		ResourceAssignmentMap_t const & source_map,
@@ -39,7 +45,7 @@ void ResourceBinder::Bind(
 		ResourceBitset * filter_mask) {
 	ResourceAccounter &ra(ResourceAccounter::GetInstance());
 	ResourcePath::ExitCode_t rp_result;
-	std::unique_ptr<bu::Logger> logger = bu::Logger::GetLogger(MODULE_NAMESPACE);
+	bu::Logger * logger = BinderLogger();
 
 	// Proceed with the resource binding...
 	for (auto & ru_entry: source_map) {
@@ -126,7 +132,7 @@ void ResourceBinder::Bind(
 		br::ResourceBitset const & filter_mask,
 		br::ResourceAssignmentMapPtr_t out_map) {
 	ResourceAccounter &ra(ResourceAccounter::GetInstance());
-	std::unique_ptr<bu::Logger> logger = bu::Logger::GetLogger(MODULE_NAMESPACE);
+	bu::Logger * logger = BinderLogger();
 
 	auto assign_it = source_map.find(resource_path);
 	if (assign_it == source_map.end()) {
@@ -161,7 +167,7 @@ void ResourceBinder::Bind(
 void ResourceBinder::RemoveCompatibleAssignments(
 		br::ResourceAssignmentMapPtr_t out_map,
 		br::ResourcePathPtr_t out_path) {
-	std::unique_ptr<bu::Logger> logger = bu::Logger::GetLogger(MODULE_NAMESPACE);
+	bu::Logger * logger = BinderLogger();
 
 	br::ResourcePathPtr_t replace_path = nullptr;
 	for (auto & m: *out_map) {
@@ -201,7 +207,6 @@ ResourceBitset ResourceBinder::GetMask(
 ResourceBitset ResourceBinder::GetMask(
 		br::ResourceAssignmentMap_t const & assign_map,
 		br::ResourceType r_type) {
-	ResourceAccounter &ra(ResourceAccounter::GetInstance());
 	ResourceBitset r_mask;
 
 	// Scan the resource assignments map
@@ -210,7 +215,7 @@ ResourceBitset ResourceBinder::GetMask(
 		br::ResourceAssignmentPtr_t const & r_assign(ru_entry.second);
 		SetBit(ppath, r_type, r_mask);
 		for (br::ResourcePtr_t const & rsrc: r_assign->GetResourcesList())
-			SetBit(ra.GetPath(rsrc->Path()), r_type, r_mask);
+			SetBit(rsrc->GetResourcePath(), r_type, r_mask);
 	}
 	return r_mask;
 }
@@ -225,7 +230,7 @@ ResourceBitset ResourceBinder::GetMask(
 	ResourceBitset r_mask;
 	br::ResourceType found_rsrc_type, found_scope_type;
 	BBQUE_RID_TYPE found_scope_id;
-	std::unique_ptr<bu::Logger> logger = bu::Logger::GetLogger(MODULE_NAMESPACE);
+	bu::Logger * logger = BinderLogger();
 
 	logger->Debug("GetMask: scope=<%s%d> resource=<%s> view=%d",
 				br::GetResourceTypeString(r_scope_type), r_scope_id,
@@ -281,8 +286,7 @@ ResourceBitset ResourceBinder::GetMask(
 		SchedPtr_t papp,
 		RViewToken_t status_view) {
 	ResourceBitset r_mask;
-	std::unique_ptr<bu::Logger> logger = bu::Logger::GetLogger(MODULE_NAMESPACE);
-	ResourceAccounter &ra(ResourceAccounter::GetInstance());
+	bu::Logger * logger = BinderLogger();
 
 	// Sanity check
 	if (papp == nullptr) return r_mask;
@@ -306,7 +310,7 @@ ResourceBitset ResourceBinder::GetMask(
 					rsrc->Path().c_str(), papp->StrId());
 
 		// Scope resource (type and identifier)
-		br::ResourcePathPtr_t r_path(ra.GetPath(rsrc->Path()));
+		br::ResourcePathPtr_t const & r_path(rsrc->GetResourcePath());
 		if (r_path->ParentType(r_type) == r_scope_type
 				&& (r_path->GetID(r_scope_type) == r_scope_id
 					|| r_scope_id == R_ID_ANY)) {
@@ -328,7 +332,7 @@ ResourceBitset ResourceBinder::GetMaskInRange(
 		size_t end_pos) {
 	ResourceBitset r_mask;
 	size_t _count = 0;
-	std::unique_ptr<bu::Logger> logger = bu::Logger::GetLogger(MODULE_NAMESPACE);
+	bu::Logger * logger = BinderLogger();
 	for (ResourcePtr_t const & rsrc: resources_list) {
 		if (_count >= begin_pos && _count <= end_pos) {
 			r_mask.Set(rsrc->ID());
@@ -348,7 +352,7 @@ ResourceBitset ResourceBinder::GetMaskInRange(
 		ResourcePtrList_t::const_iterator & iter,
 		size_t _count) {
 	ResourceBitset r_mask;
-	std::unique_ptr<bu::Logger> logger = bu::Logger::GetLogger(MODULE_NAMESPACE);
+	bu::Logger * logger = BinderLogger();
 	// Rewind
 	if (iter == resources_list.end())
 		iter = resources_list.begin();
@@ -15,6 +15,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <cstdio>
 #include <cstring>
 
 #include "bbque/res/bitset.h"
@@ -25,74 +27,175 @@
 namespace bbque { namespace res {
 
 ResourceBitset::ResourceBitset():
-	first_set(R_ID_NONE),
-	last_set(R_ID_NONE),
-	count(0),
-	none(true) {
+	cg_valid(true) {
+	memset(inline_words, 0, sizeof(inline_words));
 }
 
 ResourceBitset::~ResourceBitset() {}
 
+void ResourceBitset::Grow(size_t words_count) {
+	if (words_count <= WordsCount())
+		return;
+	if (ext_words.empty())
+		ext_words.assign(inline_words, inline_words + BBQUE_RBS_INLINE_WORDS);
+	ext_words.resize(words_count, 0);
+}
+
+int32_t ResourceBitset::Next(int32_t pos, bool value) const {
+	Word_t const * words = Words();
+	size_t words_count = WordsCount();
+	size_t w = WordIndex(pos);
+
+	if (w >= words_count)
+		return words_count * BBQUE_RBS_WORD_BITS;
+
+	// Look for a set bit (in the complemented word, if looking for a
+	// clear one), ignoring the bits before the starting position
+	Word_t word = (value ? words[w] : ~words[w]) & (~Word_t(0) << (pos % BBQUE_RBS_WORD_BITS));
+	while (word == 0) {
+		if (++w == words_count)
+			return words_count * BBQUE_RBS_WORD_BITS;
+		word = value ? words[w] : ~words[w];
+	}
+	return w * BBQUE_RBS_WORD_BITS + __builtin_ctzll(word);
+}
+
+/******************************
+ *         Queries            *
+ ******************************/
+
+BBQUE_RID_TYPE ResourceBitset::Count() const {
+	Word_t const * words = Words();
+	BBQUE_RID_TYPE count = 0;
+	for (size_t w = 0; w < WordsCount(); ++w)
+		count += __builtin_popcountll(words[w]);
+	return count;
+}
+
+BBQUE_RID_TYPE ResourceBitset::FirstSet() const {
+	Word_t const * words = Words();
+	for (size_t w = 0; w < WordsCount(); ++w) {
+		if (words[w])
+			return w * BBQUE_RBS_WORD_BITS + __builtin_ctzll(words[w]);
+	}
+	return R_ID_NONE;
+}
+
+BBQUE_RID_TYPE ResourceBitset::LastSet() const {
+	Word_t const * words = Words();
+	for (size_t w = WordsCount(); w > 0; --w) {
+		if (words[w-1])
+			return w * BBQUE_RBS_WORD_BITS - 1 - __builtin_clzll(words[w-1]);
+	}
+	return R_ID_NONE;
+}
+
+std::string ResourceBitset::ToString() const {
+	BBQUE_RID_TYPE bits = std::max<BBQUE_RID_TYPE>(
+		BBQUE_MAX_R_ID_NUM + 1, LastSet() + 1);
+	std::string str(bits, '0');
+	for (BBQUE_RID_TYPE pos = Next(0, true); pos < bits; pos = Next(pos + 1, true))
+		str[bits - 1 - pos] = '1';
+	return str;
+}
+
+std::string const & ResourceBitset::ToStringCG() const {
+	char buff[32];
+	int32_t end = WordsCount() * BBQUE_RBS_WORD_BITS;
+
+	if (cg_valid)
+		return cg_str;
+
+	// Ranges of consecutive bits set
+	cg_str.clear();
+	for (int32_t first = Next(0, true); first < end; ) {
+		int32_t last = Next(first, false) - 1;
+		if (last > first)
+			snprintf(buff, sizeof(buff), "%s%d-%d",
+				cg_str.empty() ? "" : ",", first, last);
+		else
+			snprintf(buff, sizeof(buff), "%s%d",
+				cg_str.empty() ? "" : ",", first);
+		cg_str.append(buff);
+		first = Next(last + 1, true);
+	}
+	cg_valid = true;
+	return cg_str;
+}
+
 /******************************
  *         Operators          *
  ******************************/
 
+bool ResourceBitset::operator== (ResourceBitset const & rbs) const {
+	Word_t const * words = Words();
+	Word_t const * rbs_words = rbs.Words();
+	size_t words_count = std::min(WordsCount(), rbs.WordsCount());
+
+	if (memcmp(words, rbs_words, words_count * sizeof(Word_t)) != 0)
+		return false;
+	// The exceeding words must be empty
+	for (size_t w = words_count; w < WordsCount(); ++w)
+		if (words[w]) return false;
+	for (size_t w = words_count; w < rbs.WordsCount(); ++w)
+		if (rbs_words[w]) return false;
+	return true;
+}
+
 ResourceBitset ResourceBitset::operator|= (const ResourceBitset & rbs) {
-	int _bit = rbs.FirstSet();
-	while ((_bit >= 0) && (_bit <= rbs.LastSet())) {
-		if (rbs.Test(_bit)) Set(_bit);
-		_bit++;
-	}
+	Grow(rbs.WordsCount());
+	Word_t * words = Words();
+	Word_t const * rbs_words = rbs.Words();
+	for (size_t w = 0; w < rbs.WordsCount(); ++w)
+		words[w] |= rbs_words[w];
+	cg_valid = false;
 	return *this;
 }
 
 ResourceBitset ResourceBitset::operator&= (const ResourceBitset & rbs) {
-	Reset();
-	return (*this |= rbs);
+	Word_t * words = Words();
+	Word_t const * rbs_words = rbs.Words();
+	for (size_t w = 0; w < WordsCount(); ++w)
+		words[w] &= (w < rbs.WordsCount()) ? rbs_words[w] : 0;
+	cg_valid = false;
+	return *this;
 }
 
 /**/
 
 ResourceBitset::ExitCode_t ResourceBitset::Set(BBQUE_RID_TYPE pos) {
-	char buff[4] = "";
-
 	// Boundary check
-	if (pos > BBQUE_MAX_R_ID_NUM)
+	if (pos < 0)
 		return OUT_OF_RANGE;
+	Grow(WordIndex(pos) + 1);
+
 	// Set bit
-	if (bit_set.test(pos))
+	Word_t & word(Words()[WordIndex(pos)]);
+	if (word & BitMask(pos))
 		return OK;
-	bit_set.set(pos);
-
-	// Track set boundaries
-	if (pos > last_set)
-		last_set  = pos;
-	if ((pos < first_set) || (first_set < 0))
-		first_set = pos;
-
-	// Update CG string
-	if (count > 0)
-		snprintf(buff, 4, ",%d", pos);
-	else
-		snprintf(buff, 4, "%d", pos);
-	cg_str.append(buff);
-
-	++count;
-	if (none) none = false;
+	word |= BitMask(pos);
+	cg_valid = false;
 	return OK;
 }
 
 ResourceBitset::ExitCode_t ResourceBitset::Reset() {
-	bit_set.reset();
-	first_set = last_set = R_ID_NONE;
-	none  = true;
-	count = 0;
+	memset(Words(), 0, WordsCount() * sizeof(Word_t));
+	cg_str.clear();
+	cg_valid = true;
 	return OK;
 }
 
-
+ResourceBitset::ExitCode_t ResourceBitset::Reset(BBQUE_RID_TYPE pos) {
+	// Boundary check
+	if (pos < 0)
+		return OUT_OF_RANGE;
+	if (!Test(pos))
+		return OK;
+	Words()[WordIndex(pos)] &= ~BitMask(pos);
+	cg_valid = false;
+	return OK;
+}
 
 } // namespace res
 
 } // namespace bbque
-
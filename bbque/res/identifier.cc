@@ -17,12 +17,25 @@
 
 #include <cstdio>
 #include <cstring>
+#include <memory>
 #include <string>
 
 #include "bbque/res/identifier.h"
+#include "bbque/utils/logging/logger.h"
+
+#define MODULE_NAMESPACE "bq.rid"
+
+namespace bu = bbque::utils;
 
 namespace bbque { namespace res {
 
+/** Logger shared by the identifiers (created at the first use) */
+static bu::Logger * IdentifierLogger() {
+	static std::unique_ptr<bu::Logger> logger(
+		bu::Logger::GetLogger(MODULE_NAMESPACE));
+	return logger.get();
+}
+
 
 ResourceIdentifier::ResourceIdentifier(
 		ResourceType _type,
@@ -32,6 +45,9 @@ ResourceIdentifier::ResourceIdentifier(
 
 	// Sanity check
 	if ((_id < R_ID_NONE) || (_id > BBQUE_MAX_R_ID_NUM)) {
+		IdentifierLogger()->Error("Resource <%s> ID %d out of range [0, %d]: "
+			"increase CONFIG_BBQUE_RESOURCE_MAX_NUM",
+			GetResourceTypeString(type), _id, BBQUE_MAX_R_ID_NUM);
 		id   = R_ID_NONE;
 	}
 
@@ -69,6 +85,10 @@ void ResourceIdentifier::SetID(BBQUE_RID_TYPE _id) {
 	// ID boundaries check
 	if ((_id == R_ID_NONE) || (_id == R_ID_ANY) ||
 		(_id > BBQUE_MAX_R_ID_NUM)) {
+		if (_id > BBQUE_MAX_R_ID_NUM)
+			IdentifierLogger()->Error("Resource <%s> ID %d out of range "
+				"[0, %d]: increase CONFIG_BBQUE_RESOURCE_MAX_NUM",
+				GetResourceTypeString(type), _id, BBQUE_MAX_R_ID_NUM);
 		id = R_ID_NONE;
 		return;
 	}
@@ -25,10 +25,20 @@
 
 namespace bbque { namespace res {
 
+bu::Logger * ResourcePath::logger = nullptr;
+
+bu::Logger * ResourcePath::GetLogger() {
+	// Created once, at the first use, and never released
+	static std::unique_ptr<bu::Logger> rp_logger(
+		bu::Logger::GetLogger(MODULE_NAMESPACE));
+	return rp_logger.get();
+}
+
 ResourcePath::ResourcePath(std::string const & str_path):
 		global_type(ResourceType::UNDEFINED),
 		level_count(0) {
-	logger = bu::Logger::GetLogger(MODULE_NAMESPACE);
+	logger = GetLogger();
+	types_idx.fill(-1);
 	logger->Debug("RP{%s} object construction", str_path.c_str());
 
 	if (AppendString(str_path) != OK) {
@@ -41,7 +51,7 @@ ResourcePath::ResourcePath(std::string const & str_path):
 ResourcePath::ResourcePath(ResourcePath const & r_path):
 		global_type(ResourceType::UNDEFINED),
 		level_count(0) {
-	logger = bu::Logger::GetLogger(MODULE_NAMESPACE);
+	logger = GetLogger();
 	logger->Debug("RP{%s} object construction", r_path.ToString().c_str());
 	// Copy
 	identifiers = r_path.identifiers;
@@ -157,7 +167,7 @@ bool ResourcePath::IncludesType(ResourceType r_type) {
 
 void ResourcePath::Clear() {
 	identifiers.clear();
-	types_idx.clear();
+	types_idx.fill(-1);
 	types_bits.reset();
 	global_type = ResourceType::UNDEFINED;
 	level_count = 0;
@@ -182,7 +192,7 @@ ResourcePath::ExitCode_t ResourcePath::Append(
 		return ERR_USED_TYPE;
 	}
 	types_bits.set(r_type_index);
-	types_idx.emplace(r_type_index, level_count);
+	types_idx[r_type_index] = level_count;
 
 	// Append the new resource identifier (sp) to the list
 	auto curr_resource_ident = std::make_shared<ResourceIdentifier>(r_type, r_id);
@@ -275,11 +285,7 @@ ResourcePath::ExitCode_t ResourcePath::Concat(
  ******************************************************************/
 
 int8_t ResourcePath::GetLevel(ResourceType r_type) const {
-	std::unordered_map<uint16_t, uint8_t>::const_iterator index_it;
-	index_it = types_idx.find(static_cast<uint16_t>(r_type));
-	if (index_it == types_idx.end())
-		return -1;
-	return index_it->second;
+	return types_idx[static_cast<uint16_t>(r_type)];
 }
 
 
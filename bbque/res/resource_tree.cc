@@ -55,10 +55,86 @@ ResourceTree::find_list(ResourcePath & rsrc_path, uint16_t match_flags) const {
 	if (match_flags & RT_MATCH_TYPE & RT_MATCH_MIXED)
 		match_flags = RT_MATCH_MIXED;
 
-	find_node(root, head_path, end_path, match_flags, matchings);
+	// Already solved query?
+	std::string const key(query_key(rsrc_path, match_flags));
+	std::unique_lock<std::mutex> cache_ul(cache_mtx);
+	auto cache_it = matchings_cache.find(key);
+	if (cache_it != matchings_cache.end())
+		return cache_it->second;
+
+	// Fully qualified path (type and ID on every level): at most one
+	// resource can match, and the nodes index provides the candidates
+	bool qualified = !(match_flags & RT_MATCH_TYPE) && (head_path != end_path);
+	for (auto const & rid: rsrc_path.GetIdentifiers()) {
+		if ((rid->Type() == ResourceType::UNDEFINED) || (rid->ID() < 0)) {
+			qualified = false;
+			break;
+		}
+	}
+
+	if (qualified)
+		find_exact(rsrc_path, matchings);
+	else
+		find_node(root, head_path, end_path, match_flags, matchings);
+
+	matchings_cache.emplace(key, matchings);
 	return matchings;
 }
 
+void ResourceTree::invalidate() {
+	std::unique_lock<std::mutex> cache_ul(cache_mtx);
+	matchings_cache.clear();
+}
+
+std::string ResourceTree::query_key(
+		ResourcePath const & rsrc_path, uint16_t match_flags) {
+	// One byte for the flags, three bytes (type and ID) per level: the
+	// typical path fits the small string buffer, with no allocations
+	std::string key(1, static_cast<char>(match_flags));
+	for (auto const & rid: rsrc_path.GetIdentifiers()) {
+		uint16_t r_id = static_cast<uint16_t>(rid->ID());
+		key.push_back(static_cast<char>(rid->Type()));
+		key.push_back(static_cast<char>(r_id & 0xFF));
+		key.push_back(static_cast<char>(r_id >> 8));
+	}
+	return key;
+}
+
+bool ResourceTree::find_exact(
+		ResourcePath const & rsrc_path,
+		ResourcePtrList_t & matchings) const {
+	auto const & identifiers(rsrc_path.GetIdentifiers());
+	auto const & last_rid(identifiers.back());
+
+	auto index_it = nodes_per_id.find(id_key(last_rid->Type(), last_rid->ID()));
+	if (index_it == nodes_per_id.end())
+		return false;
+
+	for (uint32_t node_idx: index_it->second) {
+		ResourceNodePtr_t node(nodes[node_idx]);
+		if (node->depth != identifiers.size())
+			continue;
+
+		// Check the upper levels, up to the root
+		bool match = true;
+		for (int lvl = identifiers.size() - 1; lvl >= 0; --lvl) {
+			if (node->data->Compare(*identifiers[lvl]) != Resource::EQUAL) {
+				match = false;
+				break;
+			}
+			node = node->parent;
+		}
+		if (!match)
+			continue;
+
+		matchings.push_back(nodes[node_idx]->data);
+		logger->Debug("find_exact: found %s",
+				matchings.back()->Path().c_str());
+		return true;
+	}
+	return false;
+}
+
 ResourcePtr_t & ResourceTree::insert(ResourcePath const & rsrc_path) {
 
 	// Seeking on the last matching resource path level (tree node)
@@ -107,6 +183,7 @@ ResourcePtr_t & ResourceTree::insert(ResourcePath const & rsrc_path) {
 	}
 
 	++count;
+	invalidate();
 	logger->Debug("insert: count = %d, depth: %d", count, max_depth);
 	return curr_node->data;
 }
@@ -198,6 +275,11 @@ ResourceTree::add_node(ResourceNodePtr_t curr_node, ResourcePtr_t resource_ptr)
 
 	// Append it as child of the current node
 	curr_node->children.push_back(new_node);
+
+	// Index it by resource identity
+	nodes.push_back(new_node);
+	nodes_per_id[id_key(resource_ptr->Type(), resource_ptr->ID())].push_back(
+		nodes.size() - 1);
 	return new_node;
 }
 
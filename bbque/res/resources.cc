@@ -32,7 +32,8 @@ Resource::Resource(std::string const & res_path, uint64_t tot):
 	br::ResourceIdentifier(br::ResourceType::UNDEFINED, 0),
 	total(tot),
 	reserved(0),
-	offline(false) {
+	offline(false),
+	views_unpublished(0) {
 	path.assign(res_path);
 
 	// Extract the name from the path
@@ -50,7 +51,8 @@ Resource::Resource(br::ResourceType type, BBQUE_RID_TYPE id, uint64_t tot):
 	br::ResourceIdentifier(type, id),
 	total(tot),
 	reserved(0),
-	offline(false) {
+	offline(false),
+	views_unpublished(0) {
 
 	// Initialize profiling data structures
 	InitProfilingInfo();
@@ -62,7 +64,14 @@ void Resource::InitProfilingInfo() {
 	av_profile.lastOfflineTime = 0;
 	av_profile.lastOnlineTime  = 0;
 #ifdef CONFIG_BBQUE_PM
-	pw_profile.values.resize(8);
+	pw_profile.values.resize(int(PowerManager::InfoType::COUNT));
+	for (auto & snapshot: pw_profile.snapshots) {
+		for (auto & value: snapshot.instant)
+			value.store(0.0, std::memory_order_relaxed);
+		for (auto & value: snapshot.mean)
+			value.store(0.0, std::memory_order_relaxed);
+	}
+	pw_profile.published_count.store(0);
 #endif
 	rb_profile.degradation_perc = std::make_shared<bu::EMA>(3);
 }
@@ -111,7 +120,7 @@ void Resource::SetOnline() {
 
 uint64_t Resource::Used(RViewToken_t view_id) {
 	// Retrieve the state view
-	ResourceStatePtr_t view(GetStateView(view_id));
+	ResourceState const * view = GetStateView(view_id);
 	if (!view)
 		return 0;
 
@@ -119,9 +128,9 @@ uint64_t Resource::Used(RViewToken_t view_id) {
 	return view->used;
 }
 
-uint64_t Resource::Available(SchedPtr_t papp, RViewToken_t view_id) {
+uint64_t Resource::Available(SchedPtr_t const & papp, RViewToken_t view_id) {
 	uint64_t total_available = Unreserved();
-	ResourceStatePtr_t view;
+	ResourceState * view;
 
 	// Offlined resources are considered not available
 	if (IsOffline())
@@ -142,13 +151,13 @@ uint64_t Resource::Available(SchedPtr_t papp, RViewToken_t view_id) {
 		return total_available;
 
 	// Add resources allocated by requesting applicatiion
-	total_available += ApplicationUsage(papp, view->apps);
+	total_available += ApplicationUsage(papp, view);
 	return total_available;
 
 }
 
 uint64_t Resource::ApplicationUsage(SchedPtr_t const & papp, RViewToken_t view_id) {
-	ResourceStatePtr_t view(GetStateView(view_id));
+	ResourceState * view = GetStateView(view_id);
 	if (!view) {
 		DB(fprintf(stderr, FW("Resource {%s}: cannot find view %" PRIu64 "\n"),
 					name.c_str(), view_id));
@@ -156,84 +165,72 @@ uint64_t Resource::ApplicationUsage(SchedPtr_t const & papp, RViewToken_t view_i
 	}
 
 	// Call the "low-level" ApplicationUsage()
-	return ApplicationUsage(papp, view->apps);
+	return ApplicationUsage(papp, view);
 }
 
 Resource::ExitCode_t Resource::UsedBy(AppUid_t & app_uid,
 		uint64_t & amount,
 		uint8_t nth,
 		RViewToken_t view_id) {
-	// Get the map of Apps/EXCs using the resource
-	AppUsageQtyMap_t apps_map;
-	size_t mapsize = ApplicationsCount(apps_map, view_id);
-	size_t count = 0;
+	ResourceState const * view = GetStateView(view_id);
 	app_uid = 0;
 	amount  = 0;
 
 	// Index overflow check
-	if (nth >= mapsize)
+	if ((!view) || (nth >= view->apps.size()))
 		return RS_NO_APPS;
 
-	// Search the nth-th App/EXC using the resource
-	for (auto const & apps_it: apps_map) {
-		// Skip until the required index has not been reached
-		if (count < nth) continue;
-		// Return the amount of resource used and the App/EXC Uid
-		amount  = apps_it.second;
-		app_uid = apps_it.first;
-		++count;
-
-		return RS_SUCCESS;
-	}
-
-	return RS_NO_APPS;
+	// Return the amount of resource used and the App/EXC Uid
+	app_uid = view->apps[nth].first;
+	amount  = view->apps[nth].second;
+	return RS_SUCCESS;
 }
 
 
 uint64_t Resource::Acquire(SchedPtr_t const & papp, uint64_t amount,
 		RViewToken_t view_id) {
-	ResourceStatePtr_t view(GetStateView(view_id));
-	if (!view) {
-		view = std::make_shared<ResourceState>();
-		state_views[view_id] = view;
-	}
-
-	// Try to set the new "used" value
-	uint64_t fut_used = view->used + amount;
+	// Check the new "used" value before triggering a copy of the state
+	ResourceState * view = GetStateView(view_id);
+	uint64_t fut_used = amount;
+	if (view)
+		fut_used += view->used;
 	if (fut_used > total)
 		return 0;
 
 	// Set new used value and application that requested the resource
+	view = GetWritableStateView(view_id);
 	view->used = fut_used;
-	view->apps[papp->Uid()] = amount;
+	view->SetAppUsage(papp->Uid(), amount);
 	return amount;
 }
 
 uint64_t Resource::Release(SchedPtr_t const & papp, RViewToken_t view_id) {
-	ResourceStatePtr_t view(GetStateView(view_id));
-	if (!view) {
-		DB(fprintf(stderr,
-			FW("Resource {%s}: cannot find view %" PRIu64 "\n"),
-				name.c_str(), view_id));
-		return 0;
-	}
-	return Release(papp->Uid(), view);
+	return Release(papp->Uid(), view_id);
 }
 
 uint64_t Resource::Release(AppUid_t app_uid, RViewToken_t view_id) {
-	ResourceStatePtr_t view(GetStateView(view_id));
+	ResourceState * view = GetStateView(view_id);
 	if (!view) {
 		DB(fprintf(stderr,
 			FW("Resource {%s}: cannot find view %" PRIu64 "\n"),
 				name.c_str(), view_id));
 		return 0;
 	}
-	return Release(app_uid, view);
+
+	// Do not copy a shared state if the application is not using the
+	// resource
+	if (view->FindApp(app_uid) == view->apps.end()) {
+		DB(fprintf(stderr, FD("Resource {%s}: no resources allocated to uid=%d\n"),
+					name.c_str(), app_uid));
+		return 0;
+	}
+
+	return Release(app_uid, GetWritableStateView(view_id));
 }
 
-uint64_t Resource::Release(AppUid_t app_uid, ResourceStatePtr_t view) {
+uint64_t Resource::Release(AppUid_t app_uid, ResourceState * view) {
 	// Lookup the application using the resource
-	auto lkp = view->apps.find(app_uid);
+	auto lkp = view->FindApp(app_uid);
 	if (lkp == view->apps.end()) {
 		DB(fprintf(stderr, FD("Resource {%s}: no resources allocated to uid=%d\n"),
 					name.c_str(), app_uid));
@@ -243,7 +240,7 @@ uint64_t Resource::Release(AppUid_t app_uid, ResourceStatePtr_t view) {
 	// Decrease the used value and remove the application
 	uint64_t used_by_app = lkp->second;
 	view->used -= used_by_app;
-	view->apps.erase(app_uid);
+	view->apps.erase(lkp);
 
 	// Return the amount of resource released
 	return used_by_app;
@@ -255,28 +252,34 @@ void Resource::DeleteView(RViewToken_t view_id) {
 	// Avoid to delete the default view
 	if (view_id == ra.GetSystemView())
 		return;
-	state_views.erase(view_id);
+	std::unique_lock<std::mutex> views_ul(views_mtx);
+	auto it = FindView(view_id);
+	if (it != state_views.end()) {
+		PublishView(view_id, nullptr);
+		state_views.erase(it);
+	}
 }
 
 uint16_t Resource::ApplicationsCount(AppUsageQtyMap_t & apps_map, RViewToken_t view_id) {
-	ResourceStatePtr_t view(GetStateView(view_id));
+	ResourceState const * view = GetStateView(view_id);
 	if (!view)
 		return 0;
-	// Return the size and a reference to the map
-	apps_map = view->apps;
+	// Return the size and a copy of the usage amounts
+	apps_map.clear();
+	apps_map.insert(view->apps.begin(), view->apps.end());
 	return apps_map.size();
 }
 
-uint64_t Resource::ApplicationUsage(SchedPtr_t const & papp, AppUsageQtyMap_t & apps_map) {
+uint64_t Resource::ApplicationUsage(SchedPtr_t const & papp, ResourceState * view) {
 	if (!papp) {
 		DB(fprintf(stderr, FW("Resource {%s}: App/EXC null pointer\n"),
 					name.c_str()));
 		return 0;
 	}
 
-	// Retrieve the application from the map
-	auto app_using_it(apps_map.find(papp->Uid()));
-	if (app_using_it == apps_map.end()) {
+	// Retrieve the application from the usage amounts
+	auto app_using_it(view->FindApp(papp->Uid()));
+	if (app_using_it == view->apps.end()) {
 		DB(fprintf(stderr, FD("Resource {%s}: no usage value for [%s]\n"),
 					name.c_str(), papp->StrId()));
 		return 0;
@@ -286,20 +289,107 @@ uint64_t Resource::ApplicationUsage(SchedPtr_t const & papp, AppUsageQtyMap_t &
 	return app_using_it->second;
 }
 
-ResourceStatePtr_t Resource::GetStateView(RViewToken_t view_id) {
-	ResourceAccounter &ra(ResourceAccounter::GetInstance());
+ResourceState * Resource::GetStateView(RViewToken_t view_id) {
 	// Default view if token = 0
-	if (view_id == 0)
+	if (view_id == 0) {
+		ResourceAccounter &ra(ResourceAccounter::GetInstance());
 		view_id = ra.GetSystemView();
+	}
 
-	// Retrieve the view from hash map otherwise
-	auto it = state_views.find(view_id);
+	// Look for the view among the published ones. The token is checked
+	// again after loading the state, since the slot could have been
+	// reused for another view meanwhile.
+	for (auto & slot: view_slots) {
+		if (slot.id.load(std::memory_order_acquire) != view_id)
+			continue;
+		ResourceState * state = slot.state.load(std::memory_order_acquire);
+		if (state && (slot.id.load(std::memory_order_relaxed) == view_id))
+			return state;
+	}
+	if (views_unpublished.load(std::memory_order_acquire) == 0)
+		return nullptr;
+
+	// Retrieve the view from the table otherwise
+	std::unique_lock<std::mutex> views_ul(views_mtx);
+	auto it = FindView(view_id);
 	if (it != state_views.end())
-		return it->second;
+		return it->second.get();
 
 	return nullptr;
 }
 
+void Resource::PublishView(RViewToken_t view_id, ResourceState * state) {
+	ViewSlot * free_slot = nullptr;
+
+	for (auto & slot: view_slots) {
+		ResourceState * slot_state = slot.state.load(std::memory_order_relaxed);
+		if (!slot_state) {
+			if (!free_slot)
+				free_slot = &slot;
+			continue;
+		}
+		if (slot.id.load(std::memory_order_relaxed) != view_id)
+			continue;
+		// Already published: update (or release) the slot
+		slot.state.store(state, std::memory_order_release);
+		return;
+	}
+
+	// Not published
+	if (!state) {
+		--views_unpublished;
+		return;
+	}
+	if (!free_slot) {
+		++views_unpublished;
+		return;
+	}
+	free_slot->id.store(view_id, std::memory_order_relaxed);
+	free_slot->state.store(state, std::memory_order_release);
+}
+
+ResourceState * Resource::GetWritableStateView(RViewToken_t view_id) {
+	// Default view if token = 0
+	if (view_id == 0) {
+		ResourceAccounter &ra(ResourceAccounter::GetInstance());
+		view_id = ra.GetSystemView();
+	}
+
+	// Allocate a new state, or clone the one shared with other views
+	std::unique_lock<std::mutex> views_ul(views_mtx);
+	auto it = FindView(view_id);
+	if (it == state_views.end()) {
+		state_views.emplace_back(view_id, std::make_shared<ResourceState>());
+		PublishView(view_id, state_views.back().second.get());
+		return state_views.back().second.get();
+	}
+	if (it->second.use_count() > 1) {
+		it->second = std::make_shared<ResourceState>(*(it->second));
+		PublishView(view_id, it->second.get());
+	}
+
+	return it->second.get();
+}
+
+void Resource::ShareView(RViewToken_t src_view_id, RViewToken_t dst_view_id) {
+	ResourceAccounter &ra(ResourceAccounter::GetInstance());
+	if (src_view_id == 0)
+		src_view_id = ra.GetSystemView();
+
+	std::unique_lock<std::mutex> views_ul(views_mtx);
+	auto src_it = FindView(src_view_id);
+	if (src_it == state_views.end())
+		return;
+	ResourceStatePtr_t src_state(src_it->second);
+
+	auto dst_it = FindView(dst_view_id);
+	if (dst_it != state_views.end())
+		dst_it->second = src_state;
+	else
+		state_views.emplace_back(dst_view_id, src_state);
+	PublishView(dst_view_id, src_state.get());
+}
+
 #ifdef CONFIG_BBQUE_PM
 
 void Resource::EnablePowerProfile(
@@ -328,16 +418,35 @@ void Resource::EnablePowerProfile() {
 	EnablePowerProfile(default_samples_window);
 }
 
-double Resource::GetPowerInfo(PowerManager::InfoType i_type, ValueType v_type) {
+void Resource::PublishPowerInfo() {
+	// Fill the back buffer, while the readers access the front one
+	uint32_t count = pw_profile.published_count.load(std::memory_order_relaxed);
+	auto & snapshot(pw_profile.snapshots[(count + 1) % 2]);
+
 	std::unique_lock<std::mutex> ul(pw_profile.mux);
-	if (!pw_profile.values[int(i_type)])
-		return 0.0;
+	for (uint i = 0; i < pw_profile.values.size(); ++i) {
+		if (!pw_profile.values[i])
+			continue;
+		snapshot.instant[i].store(
+			pw_profile.values[i]->last_value(), std::memory_order_relaxed);
+		snapshot.mean[i].store(
+			pw_profile.values[i]->get(), std::memory_order_relaxed);
+	}
+	ul.unlock();
+
+	// Swap the buffers
+	pw_profile.published_count.store(count + 1, std::memory_order_release);
+}
+
+double Resource::GetPowerInfo(PowerManager::InfoType i_type, ValueType v_type) const {
+	uint32_t count = pw_profile.published_count.load(std::memory_order_acquire);
+	auto const & snapshot(pw_profile.snapshots[count % 2]);
 	// Instant or mean value?
 	switch (v_type) {
 	case INSTANT:
-		return pw_profile.values[int(i_type)]->last_value();
+		return snapshot.instant[int(i_type)].load(std::memory_order_relaxed);
 	case MEAN:
-		return pw_profile.values[int(i_type)]->get();
+		return snapshot.mean[int(i_type)].load(std::memory_order_relaxed);
 	}
 	return 0.0;
 }
@@ -482,6 +482,10 @@ inline uint64_t ResourceAccounter::QueryStatus(
 		ba::SchedPtr_t papp) const {
 	uint64_t value = 0;
 
+	// Resolve the default view once, instead of once per resource
+	if (status_view == 0)
+		status_view = sys_view_token;
+
 	// For all the descriptors in the list add the quantity of resource in the
 	// specified state (available, used, total)
 	for (br::ResourcePtr_t const & rsrc: resources_list) {
@@ -532,7 +536,7 @@ uint64_t ResourceAccounter::GetAssignedAmount(
 
 		// Iterate over the bound resources
 		for (br::ResourcePtr_t const & rsrc: r_assign->GetResourcesList()) {
-			br::ResourcePathPtr_t r_path(GetPath(rsrc->Path()));
+			br::ResourcePathPtr_t const & r_path(rsrc->GetResourcePath());
 			logger->Debug("GetAssignedAmount: path:<%s>",
 				r_path->ToString().c_str());
 			// Scope resource ID
@@ -621,8 +625,10 @@ inline ResourceAccounter::ExitCode_t ResourceAccounter::GetAppAssignmentsByView(
 	}
 
 	// "Alternate" state view
+	std::unique_lock<std::mutex> views_ul(views_mtx);
 	auto view_it = assign_per_views.find(status_view);
 	if (view_it == assign_per_views.end()) {
+		views_ul.unlock();
 		logger->Error("GetAppAssignmentsByView:"
 				"Cannot find the resource state view referenced by %d",
 				status_view);
@@ -634,6 +640,15 @@ inline ResourceAccounter::ExitCode_t ResourceAccounter::GetAppAssignmentsByView(
 	return RA_SUCCESS;
 }
 
+ResourceSetPtr_t ResourceAccounter::GetResourceSetByView(
+		br::RViewToken_t status_view) {
+	std::unique_lock<std::mutex> views_ul(views_mtx);
+	auto view_it = rsrc_per_views.find(status_view);
+	if (view_it == rsrc_per_views.end())
+		return nullptr;
+	return view_it->second;
+}
+
 /************************************************************************
  *                   RESOURCE MANAGEMENT                                *
  ************************************************************************/
@@ -670,7 +685,8 @@ br::ResourcePtr_t ResourceAccounter::RegisterResource(
 
 	// Insert the path in the paths set
 	resource_set.emplace(resource_ptr);
-	r_paths.emplace(strpath, resource_path_ptr);
+	auto rp_entry = r_paths.emplace(strpath, resource_path_ptr);
+	resource_ptr->SetResourcePath(rp_entry.first->second);
 	path_max_len = std::max((int) path_max_len, (int) strpath.length());
 
 	// Track the number of resources per type
@@ -734,6 +750,7 @@ ResourceAccounter::ExitCode_t ResourceAccounter::UpdateResource(
 	reserved = resource_ptr->Total() - availability;
 	ReserveResources(resource_path_ptr, reserved);
 	resource_ptr->SetOnline();
+	resources.invalidate();
 
 	// Back to READY
 	SetState(State::READY);
@@ -821,6 +838,7 @@ ResourceAccounter::ExitCode_t  ResourceAccounter::OfflineResources(
 		logger->Debug("OfflineResources: setting on %s",
 			resource_ptr->Path().c_str());
 	}
+	resources.invalidate();
 
 	return RA_SUCCESS;
 }
@@ -840,6 +858,7 @@ ResourceAccounter::ExitCode_t  ResourceAccounter::OnlineResources(
 		logger->Debug("OnlineResources: setting on %s",
 			resource_ptr->Path().c_str());
 	}
+	resources.invalidate();
 
 	return RA_SUCCESS;
 }
@@ -868,6 +887,7 @@ ResourceAccounter::ExitCode_t ResourceAccounter::_GetView(
 	token = std::hash<std::string>()(req_path);
 	logger->Debug("GetView: new resource state view token = %ld", token);
 
+	std::unique_lock<std::mutex> views_ul(views_mtx);
 	// Allocate a new view for the applications resource assignments
 	assign_per_views.emplace(token, std::make_shared<AppAssignmentsMap_t>());
 	//Allocate a new view for the set of resources allocated
@@ -890,29 +910,81 @@ ResourceAccounter::ExitCode_t ResourceAccounter::_PutView(
 	}
 
 	// Get the resource set using the referenced view
+	std::unique_lock<std::mutex> views_ul(views_mtx);
 	ResourceViewsMap_t::iterator rviews_it(rsrc_per_views.find(status_view));
 	if (rviews_it == rsrc_per_views.end()) {
+		views_ul.unlock();
 		logger->Warn("PutView: cannot find resource view token %ld", status_view);
 		return RA_ERR_MISS_VIEW;
 	}
-
-	// For each resource delete the view
-	for (auto & resource_set: *(rviews_it->second))
-		resource_set->DeleteView(status_view);
+	ResourceSetPtr_t rsrc_set(rviews_it->second);
 
 	// Remove the map of Apps/EXCs resource assignments and the resource reference
 	// set of this view
 	assign_per_views.erase(status_view);
-	rsrc_per_views.erase(status_view);
+	rsrc_per_views.erase(rviews_it);
+	size_t nr_rsrc_views   = rsrc_per_views.size();
+	size_t nr_assign_views = assign_per_views.size();
+	views_ul.unlock();
+
+	// For each resource delete the view
+	for (auto & resource_set: *rsrc_set)
+		resource_set->DeleteView(status_view);
 
 	logger->Debug("PutView: [%ld] cleared view", status_view);
 	logger->Debug("PutView: [%ld] currently managed {resource sets = %ld, "
 			" assign_map = %d}",
-			status_view, rsrc_per_views.size(), assign_per_views.erase(status_view));
+			status_view, nr_rsrc_views, nr_assign_views);
 
 	return RA_SUCCESS;
 }
 
+ResourceAccounter::ExitCode_t ResourceAccounter::InheritView(
+		br::RViewToken_t parent_view,
+		br::RViewToken_t status_view) {
+	WaitForPlatformReady();
+	return _InheritView(parent_view, status_view);
+}
+
+ResourceAccounter::ExitCode_t ResourceAccounter::_InheritView(
+		br::RViewToken_t parent_view,
+		br::RViewToken_t status_view) {
+	if (parent_view == 0)
+		parent_view = sys_view_token;
+
+	// Resource assignments of the parent view
+	AppAssignmentsMapPtr_t parent_assign;
+	if (GetAppAssignmentsByView(parent_view, parent_assign) != RA_SUCCESS) {
+		logger->Error("InheritView: [%ld] unknown parent view", parent_view);
+		return RA_ERR_MISS_VIEW;
+	}
+	ResourceSetPtr_t parent_rsrc(GetResourceSetByView(parent_view));
+	if (!parent_rsrc) {
+		logger->Error("InheritView: [%ld] missing parent resource set",
+			parent_view);
+		return RA_ERR_MISS_VIEW;
+	}
+
+	// The view to initialize
+	AppAssignmentsMapPtr_t view_assign;
+	ResourceSetPtr_t view_rsrc(GetResourceSetByView(status_view));
+	if ((!view_rsrc) ||
+			(GetAppAssignmentsByView(status_view, view_assign) != RA_SUCCESS)) {
+		logger->Error("InheritView: [%ld] unknown view", status_view);
+		return RA_ERR_MISS_VIEW;
+	}
+
+	// Copy the assignments and share the resource states
+	*view_assign = *parent_assign;
+	*view_rsrc   = *parent_rsrc;
+	for (auto & resource_ptr: *view_rsrc)
+		resource_ptr->ShareView(parent_view, status_view);
+
+	logger->Debug("InheritView: [%ld] inherits [%ld] {apps = %zu, resources = %zu}",
+			status_view, parent_view, view_assign->size(), view_rsrc->size());
+	return RA_SUCCESS;
+}
+
 br::RViewToken_t ResourceAccounter::SetView(br::RViewToken_t status_view) {
 	WaitForPlatformReady();
 	return _SetView(status_view);
@@ -930,8 +1002,8 @@ br::RViewToken_t ResourceAccounter::_SetView(br::RViewToken_t status_view) {
 
 	// Set the system state view pointer to the map of applications resource
 	// usages of this view and point to
-	AppAssignmentsViewsMap_t::iterator assign_view_it(assign_per_views.find(status_view));
-	if (assign_view_it == assign_per_views.end()) {
+	AppAssignmentsMapPtr_t view_assign;
+	if (GetAppAssignmentsByView(status_view, view_assign) != RA_SUCCESS) {
 		logger->Fatal("SetView: [%ld] unknown view", status_view);
 		return sys_view_token;
 	}
@@ -940,15 +1012,16 @@ br::RViewToken_t ResourceAccounter::_SetView(br::RViewToken_t status_view) {
 	// of Apps/EXCs resource assignments
 	old_sys_status_view = sys_view_token;
 	sys_view_token      = status_view;
-	sys_assign_view     = assign_view_it->second;
+	sys_assign_view     = view_assign;
 
 	// Put the old view
 	_PutView(old_sys_status_view);
 
 	logger->Info("SetView: [%ld] is the new system state view.", sys_view_token);
+	std::unique_lock<std::mutex> views_ul(views_mtx);
 	logger->Debug("SetView: [%ld] currently managed {resource sets = %ld,"
 			" assign_map = %d}",
-			sys_view_token, rsrc_per_views.size(), assign_per_views.erase(status_view));
+			sys_view_token, rsrc_per_views.size(), assign_per_views.size());
 	return sys_view_token;
 }
 
@@ -1003,6 +1076,32 @@ ResourceAccounter::ExitCode_t ResourceAccounter::SyncInit() {
 	AppsUidMapIt apps_it;
 	ba::SchedPtr_t papp;
 
+	// Inherit the scheduled view: the resource states are shared and copied
+	// only if touched by the bookings of the session
+	result = _InheritView(sch_view_token, sync_ssn.view);
+	if (result != RA_SUCCESS) {
+		logger->Fatal("SyncInit [%d]: cannot inherit the scheduled view."
+				" Aborting sync session...", sync_ssn.count);
+		SyncAbort();
+		return RA_ERR_SYNC_INIT;
+	}
+
+	// Drop the bookings of the Applications/EXC that are not RUNNING, i.e.,
+	// the ones to synchronize (re-acquired by SyncAcquireResources) or not
+	// managed anymore
+	AppAssignmentsMapPtr_t sync_assign;
+	GetAppAssignmentsByView(sync_ssn.view, sync_assign);
+	for (auto assign_it = sync_assign->begin();
+			assign_it != sync_assign->end(); ) {
+		papp = am.GetApplication(assign_it->first);
+		if (papp && papp->Running()) {
+			++assign_it;
+			continue;
+		}
+		DropBookingCounts(assign_it->first, assign_it->second, sync_ssn.view);
+		assign_it = sync_assign->erase(assign_it);
+	}
+
 	// Running Applications/ExC
 	papp = am.GetFirst(ApplicationStatusIF::RUNNING, apps_it);
 	for ( ; papp; papp = am.GetNext(ApplicationStatusIF::RUNNING, apps_it)) {
@@ -1010,6 +1109,13 @@ ResourceAccounter::ExitCode_t ResourceAccounter::SyncInit() {
 				papp->StrId(),
 				papp->CurrentAWM()->Id());
 
+		// Booking inherited from the scheduled view
+		auto assign_it(sync_assign->find(papp->Uid()));
+		if (assign_it != sync_assign->end()) {
+			assign_it->second = papp->CurrentAWM()->GetResourceBinding();
+			continue;
+		}
+
 		// Re-acquire the resources (these should not have a "Next AWM"!)
 		result = _BookResources(
 				papp, papp->CurrentAWM()->GetResourceBinding(),
@@ -1172,7 +1278,7 @@ void ResourceAccounter::ReleaseResources(
 		return;
 	}
 
-	if (rsrc_per_views.find(status_view) == rsrc_per_views.end()) {
+	if (!GetResourceSetByView(status_view)) {
 		logger->Debug("Release: resource state view already cleared");
 		return;
 	}
@@ -1221,14 +1327,13 @@ ResourceAccounter::IncBookingCounts(
 		status_view);
 
 	// Get the set of resources referenced in the view
-	auto rsrc_view(rsrc_per_views.find(status_view));
-	assert(rsrc_view != rsrc_per_views.end());
-	if (rsrc_view == rsrc_per_views.end()) {
+	ResourceSetPtr_t rsrc_set(GetResourceSetByView(status_view));
+	assert(rsrc_set);
+	if (!rsrc_set) {
 		logger->Fatal("IncBooking: invalid resource state view token [%ld]",
 			status_view);
 		return RA_ERR_MISS_VIEW;
 	}
-	auto & rsrc_set(rsrc_view->second);
 
 	// Get the map of resources used by the application (from the state view
 	// referenced by 'status_view').
@@ -1414,12 +1519,11 @@ void ResourceAccounter::DecBookingCounts(
 			papp->StrId(), assign_map->size(), status_view);
 
 	// Get the set of resources referenced in the view
-	ResourceViewsMap_t::iterator rsrc_view(rsrc_per_views.find(status_view));
-	if (rsrc_view == rsrc_per_views.end()) {
+	ResourceSetPtr_t rsrc_set(GetResourceSetByView(status_view));
+	if (!rsrc_set) {
 		logger->Fatal("DecCount: invalid resource state view: [%ld]", status_view);
 		return;
 	}
-	auto & rsrc_set(rsrc_view->second);
 
 	// Release the all the resources hold by the Application/EXC
 	for (auto & ru_entry: *(assign_map.get())) {
@@ -1454,13 +1558,35 @@ ResourceAccounter::ExitCode_t ResourceAccounter::UndoResourceBooking(
 
 		// If no more applications are using this resource, remove it from
 		// the set of resources referenced in the resource state view
-		if ((rsrc_set) && (rsrc->ApplicationsCount() == 0))
+		if ((rsrc_set) && (rsrc->ApplicationsCount(status_view) == 0)) {
 			rsrc_set->erase(rsrc);
+			rsrc->DeleteView(status_view);
+		}
 	}
 	assert(usage_freed == r_assign->GetAmount());
 	return RA_SUCCESS;
 }
 
+void ResourceAccounter::DropBookingCounts(
+		AppUid_t app_uid,
+		br::ResourceAssignmentMapPtr_t const & assign_map,
+		br::RViewToken_t status_view) {
+	ResourceSetPtr_t rsrc_set(GetResourceSetByView(status_view));
+	logger->Debug("DropCount: [uid=%d] holds %zu resources in view=[%ld]",
+			app_uid, assign_map->size(), status_view);
+
+	for (auto & ru_entry: *(assign_map.get())) {
+		for (br::ResourcePtr_t & rsrc: ru_entry.second->GetResourcesList()) {
+			if (rsrc->Release(app_uid, status_view) == 0)
+				continue;
+			if ((rsrc_set) && (rsrc->ApplicationsCount(status_view) == 0)) {
+				rsrc_set->erase(rsrc);
+				rsrc->DeleteView(status_view);
+			}
+		}
+	}
+}
+
 /************************************************************************
  *                   COMMANDS HANDLING                                  *
  ************************************************************************/
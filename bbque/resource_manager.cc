@@ -70,6 +70,7 @@ namespace po = boost::program_options;
 using bp::PluginManager;
 using bu::MetricsCollector;
 using std::chrono::milliseconds;
+using std::chrono::steady_clock;
 
 namespace bbque {
 
@@ -94,6 +95,8 @@ ResourceManager::metrics[RM_METRICS_COUNT] = {
 	RM_COUNTER_METRIC("syn.tot",	"Total Synchronization activations"),
 	RM_COUNTER_METRIC("syn.failed",	"  FAILED synchronizations"),
 
+	RM_COUNTER_METRIC("sch.coalesced","Events coalesced into other schedules"),
+
 	//----- Sampling statistics
 	RM_SAMPLE_METRIC("evt.avg.time",  "Avg events processing t[ms]"),
 	RM_SAMPLE_METRIC("evt.avg.start", "  START events"),
@@ -114,6 +117,8 @@ ResourceManager::metrics[RM_METRICS_COUNT] = {
 	RM_PERIOD_METRIC("sch.per",   "Avg Scheduler period t[ms]"),
 	RM_PERIOD_METRIC("syn.per",   "Avg Synchronization period t[ms]"),
 
+	RM_SAMPLE_METRIC("sch.avg.evts", "Avg events served by a schedule"),
+
 };
 
 
@@ -196,10 +201,39 @@ ResourceManager::Setup() {
 		 (&opt_interval)->default_value(
 			 BBQUE_DEFAULT_RESOURCE_MANAGER_OPT_INTERVAL),
 		 "The interval [ms] of activation of the periodic optimization")
+		("ResourceManager.opt_min_interval",
+		 po::value<uint32_t>
+		 (&opt_min_interval)->default_value(
+			 BBQUE_DEFAULT_RESOURCE_MANAGER_OPT_MIN_INTERVAL),
+		 "The minimum interval [ms] between two optimizations")
+		("ResourceManager.opt_max_delay",
+		 po::value<uint32_t>
+		 (&opt_max_delay)->default_value(
+			 BBQUE_DEFAULT_RESOURCE_MANAGER_OPT_MAX_DELAY),
+		 "The maximum delay [ms] of an event due to batching")
+		("ResourceManager.opt_max_load",
+		 po::value<uint16_t>
+		 (&opt_max_load)->default_value(
+			 BBQUE_DEFAULT_RESOURCE_MANAGER_OPT_MAX_LOAD),
+		 "The maximum share [%] of time spent into optimizations")
 		;
 	po::variables_map opts_vm;
 	cm.ParseConfigurationFile(opts_desc, opts_vm);
 
+	if (opt_max_load == 0 || opt_max_load > 100) {
+		logger->Warn("Optimization max load %d[%%] out of range, using 100[%%]",
+				opt_max_load);
+		opt_max_load = 100;
+	}
+	if (opt_max_delay && opt_min_interval > opt_max_delay) {
+		logger->Warn("Optimization min interval %d[ms] longer than the "
+				"max delay, using %d[ms]", opt_min_interval, opt_max_delay);
+		opt_min_interval = opt_max_delay;
+	}
+	logger->Info("Optimization rate control: min interval %d[ms], "
+			"max delay %d[ms], max load %d[%%]",
+			opt_min_interval, opt_max_delay, opt_max_load);
+
 	//---------- Dump list of registered plugins
 	const bp::PluginManager::RegistrationMap & rm = pm.GetRegistrationMap();
 	logger->Info("RM: Registered plugins:");
@@ -326,10 +360,26 @@ void ResourceManager::Optimize() {
 	SchedulerManager::ExitCode_t schedResult;
 	static bu::Timer optimization_tmr;
 	double period;
+	double cost = 0;
+	uint32_t events;
 	bool active_apps = true;
 
 	SetReady(false);
 
+	// Take in charge all the events waiting for an optimization: the ones
+	// notified from now on are going to be served by the next run
+	std::unique_lock<std::mutex> opt_ul(opt_mtx);
+	events = opt_events;
+	opt_events = 0;
+	opt_next_time = steady_clock::now() +
+		milliseconds(static_cast<uint32_t>(opt_cost_ms + opt_gap_ms));
+	opt_ul.unlock();
+	if (events) {
+		logger->Debug("Optimize: serving %d events", events);
+		RM_ADD_SAMPLE(metrics, RM_SCHED_EVENTS, events);
+		RM_COUNT_EVENTS(metrics, RM_SCHED_COALESCED, events - 1);
+	}
+
 	// If the optimization has been triggered by a platform event (BBQ_PLAT) the policy must be
 	// executed anyway. To the contrary, if it is an application event (BBQ_OPTS) check if
 	// there are actually active applications
@@ -364,16 +414,19 @@ void ResourceManager::Optimize() {
 		optimization_tmr.start();
 		schedResult = sm.Schedule();
 		optimization_tmr.stop();
+		cost += optimization_tmr.getElapsedTimeMs();
 		switch(schedResult) {
 		case SchedulerManager::MISSING_POLICY:
 		case SchedulerManager::FAILED:
 			logger->Warn("Schedule FAILED (Error: scheduling policy failed)");
 			RM_COUNT_EVENT(metrics, RM_SCHED_FAILED);
+			OptimizationDone(cost);
 			SetReady(true);
 			return;
 		case SchedulerManager::DELAYED:
 			logger->Error("Schedule DELAYED");
 			RM_COUNT_EVENT(metrics, RM_SCHED_DELAYED);
+			OptimizationDone(cost);
 			SetReady(true);
 			return;
 		default:
@@ -408,6 +461,7 @@ void ResourceManager::Optimize() {
 		optimization_tmr.start();
 		syncResult = ym.SyncSchedule();
 		optimization_tmr.stop();
+		cost += optimization_tmr.getElapsedTimeMs();
 		if (syncResult != SynchronizationManager::OK) {
 			RM_COUNT_EVENT(metrics, RM_SYNCH_FAILED);
 			// FIXME here we should implement some counter-meaure to
@@ -420,6 +474,7 @@ void ResourceManager::Optimize() {
 #endif
 		logger->Notice("Sync Time: %11.3f[us]", optimization_tmr.getElapsedTimeUs());
 	}
+	OptimizationDone(cost);
 
 #ifdef CONFIG_BBQUE_SCHED_PROFILING
 	//--- Profiling
@@ -442,6 +497,58 @@ void ResourceManager::Optimize() {
 #endif
 }
 
+void ResourceManager::OptimizationDone(double cost) {
+	std::unique_lock<std::mutex> opt_ul(opt_mtx);
+
+	// Exponential moving average of the cost of a run
+	if (opt_cost_ms == 0)
+		opt_cost_ms = cost;
+	else
+		opt_cost_ms = (3 * opt_cost_ms + cost) / 4;
+
+	// The next run must not start before the time required to keep the
+	// optimization load within the configured share
+	opt_gap_ms = opt_cost_ms * (100 - opt_max_load) / opt_max_load;
+	if (opt_gap_ms < opt_min_interval)
+		opt_gap_ms = opt_min_interval;
+	opt_next_time = steady_clock::now() +
+		milliseconds(static_cast<uint32_t>(opt_gap_ms));
+
+	logger->Debug("Optimize: cost %.3f[ms] (avg %.3f[ms]), next in %.0f[ms]",
+			cost, opt_cost_ms, opt_gap_ms);
+}
+
+void ResourceManager::ScheduleOptimization(milliseconds delay) {
+	std::unique_lock<std::mutex> opt_ul(opt_mtx);
+	steady_clock::time_point now = steady_clock::now();
+	steady_clock::time_point deadline;
+	uint32_t events;
+
+	// Account for the event, and for the time the first one is waiting
+	events = ++opt_events;
+	if (events == 1)
+		opt_first_evt = now;
+
+	// Rate control: not before the end of the interval from the previous
+	// run (or the expected end of the current one)
+	if (now + delay < opt_next_time)
+		delay = std::chrono::duration_cast<milliseconds>(opt_next_time - now);
+
+	// Batching bound: not after the max delay from the first event
+	if (opt_max_delay) {
+		deadline = opt_first_evt + milliseconds(opt_max_delay);
+		if (now + delay > deadline)
+			delay = (deadline > now) ?
+				std::chrono::duration_cast<milliseconds>(deadline - now) :
+				SCHEDULE_NOW;
+	}
+	opt_ul.unlock();
+
+	logger->Debug("Optimization required in %d[ms] (%d events pending)",
+			static_cast<uint32_t>(delay.count()), events);
+	optimize_dfr.Schedule(delay);
+}
+
 void ResourceManager::EvtExcStart() {
 	uint32_t timeout = 0;
 
@@ -468,7 +575,7 @@ void ResourceManager::EvtExcStart() {
 		return;
 	}
 	timeout = BBQUE_RM_OPT_EXC_START_DEFER_MS;
-	optimize_dfr.Schedule(milliseconds(timeout));
+	ScheduleOptimization(milliseconds(timeout));
 
 	// Collecing execution metrics
 	RM_GET_TIMING(metrics, RM_EVT_TIME_START, rm_tmr);
@@ -484,7 +591,7 @@ void ResourceManager::EvtExcStop() {
 
 	// This is a simple optimization triggering policy
 	timeout = BBQUE_RM_OPT_EXC_STOP_DEFER_MS;
-	optimize_dfr.Schedule(milliseconds(timeout));
+	ScheduleOptimization(milliseconds(timeout));
 
 	// Collecing execution metrics
 	RM_GET_TIMING(metrics, RM_EVT_TIME_STOP, rm_tmr);
@@ -502,7 +609,7 @@ void ResourceManager::EvtBbqPlat() {
 	// TODO add a better policy which triggers immediate rescheduling only
 	// on resources reduction. Perhaps such a policy could be plugged into
 	// the PlatformProxy module.
-	optimize_dfr.Schedule();
+	ScheduleOptimization(SCHEDULE_NOW);
 
 	// Collecing execution metrics
 	RM_GET_TIMING(metrics, RM_EVT_TIME_PLAT, rm_tmr);
@@ -520,7 +627,7 @@ void ResourceManager::EvtBbqOpts() {
 	// default just to increase the chance for aggregation of multiple
 	// requests
 	timeout = BBQUE_RM_OPT_REQUEST_DEFER_MS;
-	optimize_dfr.Schedule(milliseconds(timeout));
+	ScheduleOptimization(milliseconds(timeout));
 
 	// Collecing execution metrics
 	RM_GET_TIMING(metrics, RM_EVT_TIME_OPTS, rm_tmr);
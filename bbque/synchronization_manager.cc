@@ -166,18 +166,18 @@ SynchronizationManager::Sync_PreChange(ApplicationStatusIF::SyncState_t syncStat
 	ExitCode_t syncInProgress = NOTHING_TO_SYNC;
 	AppsUidMapIt apps_it;
 
-	typedef std::map<AppPtr_t, ApplicationProxy::pPreChangeRsp_t> RspMap_t;
-	typedef std::pair<AppPtr_t, ApplicationProxy::pPreChangeRsp_t> RspMapEntry_t;
+	typedef std::pair<AppPtr_t, ApplicationProxy::pPreChangeRsp_t> PendingRsp_t;
 
 	ApplicationProxy::pPreChangeRsp_t presp;
-	RspMap_t::iterator resp_it;
+	std::vector<PendingRsp_t> pending;
 	RTLIB_ExitCode_t result;
-	RspMap_t rsp_map;
 	AppPtr_t papp;
 
 	logger->Debug("Sync_PreChange: STEP 1 => START");
 	SM_RESET_TIMING(sm_tmr);
 
+	// Post the command to all the EXCs, thus they run the PreChange in
+	// parallel and the step takes as long as the slowest of them
 	papp = am.GetFirst(syncState, apps_it);
 	for ( ; papp; papp = am.GetNext(syncState, apps_it)) {
 
@@ -200,30 +200,25 @@ SynchronizationManager::Sync_PreChange(ApplicationStatusIF::SyncState_t syncStat
 			continue;
 		}
 
-		// Pre-Change (just starting it if asynchronous)
 		presp = ApplicationProxy::pPreChangeRsp_t(
 				new ApplicationProxy::preChangeRsp_t());
-		result = ap.SyncP_PreChange(papp, presp);
+		result = ap.SyncP_PreChange_Post(papp, presp);
 		if (result != RTLIB_OK)
 			continue;
 
 		// This flag is set if there is at least one sync pending
 		syncInProgress = OK;
+		pending.push_back(PendingRsp_t(papp, presp));
+	}
 
+	// Collecting EXC responses, all within the same deadline
+	ApplicationProxy::SyncDeadline_t deadline(ApplicationProxy::SyncDeadline());
+	for (auto & prsp: pending) {
+		papp  = prsp.first;
+		presp = prsp.second;
 
-// Pre-Change completion (just if asynchronous)
-#ifdef CONFIG_BBQUE_YP_SASB_ASYNC
-		// Mapping the response future for responses collection
-		rsp_map.insert(RspMapEntry_t(papp, presp));
-
-	}
+		result = ap.SyncP_PreChange_Collect(presp, deadline);
 
-	// Collecting EXC responses
-	resp_it = rsp_map.begin();
-	while (resp_it != rsp_map.end()) {
-		papp  = (*resp_it).first;
-		presp = (*resp_it).second;
-#endif
 		// Jumping meanwhile disabled applications
 		if (papp->Disabled()) {
 			logger->Debug("Sync_PreChange: STEP 1: "
@@ -232,19 +227,7 @@ SynchronizationManager::Sync_PreChange(ApplicationStatusIF::SyncState_t syncStat
 			continue;
 		}
 
-		Sync_PreChange_Check_EXC_Response(papp, presp);
-
-// Pre-Change completion (just if asynchronous)
-#ifdef CONFIG_BBQUE_YP_SASB_ASYNC
-		// Remove the respose future
-		resp_it = rsp_map.erase(resp_it);
-#else
-		++resp_it;
-#endif // CONFIG_BBQUE_YP_SASB_ASYNC
-
-		// This is required just for clean compilation
-		continue;
-
+		Sync_PreChange_Check_EXC_Response(papp, presp, result);
 	}
 
 	// Collecing execution metrics
@@ -260,18 +243,11 @@ SynchronizationManager::Sync_PreChange(ApplicationStatusIF::SyncState_t syncStat
 
 void SynchronizationManager::Sync_PreChange_Check_EXC_Response(
 		AppPtr_t papp,
-		ApplicationProxy::pPreChangeRsp_t presp) {
+		ApplicationProxy::pPreChangeRsp_t presp,
+		RTLIB_ExitCode_t result) {
 
 	SynchronizationPolicyIF::ExitCode_t syncp_result;
 
-// Pre-Change completion (just if asynchronous)
-#ifdef CONFIG_BBQUE_YP_SASB_ASYNC
-	RTLIB_ExitCode_t result;
-	logger->Debug("Sync_PreChange: STEP 1 => [%s] ... (wait) ... ",
-		papp->StrId());
-
-	// Send RTLIB Sync-PreChange message
-	result = ap.SyncP_PreChange_GetResult(presp);
 	if (result == RTLIB_BBQUE_CHANNEL_TIMEOUT) {
 		logger->Warn("Sync_PreChange: STEP 1 => [%s] TIMEOUT!",
 			papp->StrId());
@@ -293,7 +269,6 @@ void SynchronizationManager::Sync_PreChange_Check_EXC_Response(
 		assert(false);
 	}
 
-#endif
 	logger->Debug("Sync_PreChange: STEP 1 => [%s] OK!",
 		papp->StrId());
 	logger->Debug("Sync_PreChange: STEP 1 => [%s] sync_latency=%dms",
@@ -311,18 +286,18 @@ SynchronizationManager::Sync_SyncChange(
 		ApplicationStatusIF::SyncState_t syncState) {
 	AppsUidMapIt apps_it;
 
-	typedef std::map<AppPtr_t, ApplicationProxy::pSyncChangeRsp_t> RspMap_t;
-	typedef std::pair<AppPtr_t, ApplicationProxy::pSyncChangeRsp_t> RspMapEntry_t;
+	typedef std::pair<AppPtr_t, ApplicationProxy::pSyncChangeRsp_t> PendingRsp_t;
 
 	ApplicationProxy::pSyncChangeRsp_t presp;
-	RspMap_t::iterator resp_it;
+	std::vector<PendingRsp_t> pending;
 	RTLIB_ExitCode_t result;
-	RspMap_t rsp_map;
 	AppPtr_t papp;
 
 	logger->Debug("Sync_SyncChange: STEP 2 => START");
 	SM_RESET_TIMING(sm_tmr);
 
+	// Post the command to all the EXCs, thus they reach the sync point in
+	// parallel and the step takes as long as the slowest of them
 	papp = am.GetFirst(syncState, apps_it);
 	for ( ; papp; papp = am.GetNext(syncState, apps_it)) {
 
@@ -342,25 +317,23 @@ SynchronizationManager::Sync_SyncChange(
 			continue;
 		}
 
-		// Sync-Change (just starting it if asynchronous)
 		presp = ApplicationProxy::pSyncChangeRsp_t(
 				new ApplicationProxy::syncChangeRsp_t());
-		result = ap.SyncP_SyncChange(papp, presp);
+		result = ap.SyncP_SyncChange_Post(papp, presp);
 		if (result != RTLIB_OK)
 			continue;
 
-// Sync-Change completion (just if asynchronous)
-#ifdef CONFIG_BBQUE_YP_SASB_ASYNC
-		// Mapping the response future for responses collection
-		rsp_map.insert(RspMapEntry_t(papp, presp));
+		pending.push_back(PendingRsp_t(papp, presp));
 	}
 
-	// Collecting EXC responses
-	resp_it = rsp_map.begin();
-	for (; resp_it != rsp_map.end(); ++resp_it) {
-		papp  = (*resp_it).first;
-		presp = (*resp_it).second;
-#endif
+	// Collecting EXC responses, all within the same deadline
+	ApplicationProxy::SyncDeadline_t deadline(ApplicationProxy::SyncDeadline());
+	for (auto & prsp: pending) {
+		papp  = prsp.first;
+		presp = prsp.second;
+
+		result = ap.SyncP_SyncChange_Collect(presp, deadline);
+
 		// Jumping meanwhile disabled applications
 		if (papp->Disabled()) {
 			logger->Debug("Sync_SyncChange: STEP 2 => [%s] "
@@ -369,17 +342,7 @@ SynchronizationManager::Sync_SyncChange(
 			continue;
 		}
 
-		Sync_SyncChange_Check_EXC_Response(papp, presp);
-
-// Sync-Change completion (just if asynchronous)
-#ifdef CONFIG_BBQUE_YP_SASB_ASYNC
-		// Remove the respose future
-		rsp_map.erase(resp_it);
-#endif // CONFIG_BBQUE_YP_SASB_ASYNC
-
-		// This is required just for clean compilation
-		continue;
-
+		Sync_SyncChange_Check_EXC_Response(papp, presp, result);
 	}
 
 	// Collecing execution metrics
@@ -391,16 +354,10 @@ SynchronizationManager::Sync_SyncChange(
 
 void SynchronizationManager::Sync_SyncChange_Check_EXC_Response(
 		AppPtr_t papp,
-		ApplicationProxy::pSyncChangeRsp_t presp) {
-
-// Sync-Change completion (just if asynchronous)
-#ifdef CONFIG_BBQUE_YP_SASB_ASYNC
-	RTLIB_ExitCode_t result;
-	logger->Debug("Sync_SyncChange: STEP 2 => [%s] ... (wait)... ",
- 		papp->StrId());
+		ApplicationProxy::pSyncChangeRsp_t presp,
+		RTLIB_ExitCode_t result) {
+	UNUSED(presp); // Nothing to process in the response right now
 
-	// Send RTLIB Sync-Change message
-	result = ap.SyncP_SyncChange_GetResult(presp);
 	if (result == RTLIB_BBQUE_CHANNEL_TIMEOUT) {
 		logger->Warn("Sync_SyncChange: STEP 2 => [%s] TIMEOUT! ",
 			papp->StrId());
@@ -429,7 +386,7 @@ void SynchronizationManager::Sync_SyncChange_Check_EXC_Response(
 		DB(logger->Warn("TODO: Check sync policy for sync miss reaction"));
 		sync_fails_apps.insert(papp);
 	}
-#endif
+
 	// Accounting for syncpoints missed
 	SM_COUNT_EVENT(metrics, SM_SYNCP_SYNC_HIT);
 	logger->Debug("Sync_SyncChange: STEP 2 => OK!");
@@ -546,12 +503,16 @@ void SynchronizationManager::SyncCommit(AppPtr_t papp) {
 SynchronizationManager::ExitCode_t
 SynchronizationManager::Sync_Platform(ApplicationStatusIF::SyncState_t syncState) {
 	ExitCode_t result;
-	bool at_least_one_success = false;
+	uint32_t synced_count = 0;
+	std::list<SchedPtr_t> failed_apps;
 
 	logger->Debug("Sync_Platform <%s>: START adaptive applications",
 		Schedulable::SyncStateStr(syncState));
 	SM_RESET_TIMING(sm_tmr);
 
+	// Bindings are enforced all together at the end
+	plm.MapResourcesStart();
+
 	AppsUidMapIt apps_it;
 	AppPtr_t papp;
 	papp = am.GetFirst(syncState, apps_it);
@@ -572,21 +533,30 @@ SynchronizationManager::Sync_Platform(ApplicationStatusIF::SyncState_t syncState
 			sync_fails_apps.insert(papp);
 			continue;
 		}
-		else
-			if (!at_least_one_success)
-				at_least_one_success = true;
+		++synced_count;
 
 		logger->Debug("Sync_Platform <%s>: [%s] => OK",
 			papp->SyncStateStr(syncState),
 			papp->StrId());
 	}
 
+	if (plm.MapResourcesCommit(failed_apps) != PlatformManager::PLATFORM_OK) {
+		for (auto & psched: failed_apps) {
+			logger->Error("Sync_Platform <%s>: [%s] bindings enforcement failed",
+				Schedulable::SyncStateStr(syncState), psched->StrId());
+			auto ret = sync_fails_apps.insert(
+				std::static_pointer_cast<Application>(psched));
+			if (ret.second && synced_count > 0)
+				--synced_count;
+		}
+	}
+
 	// Collecting execution metrics
 	SM_GET_TIMING_SYNCSTATE(metrics, SM_SYNCP_TIME_SYNCPLAT, sm_tmr, syncState);
 	logger->Debug("Sync_Platform <%s> DONE with adaptive applications",
 		papp->SyncStateStr(syncState));
 
-	if (at_least_one_success)
+	if (synced_count > 0)
 		return OK;
 	return PLATFORM_SYNC_FAILED;
 }
@@ -869,7 +839,8 @@ SynchronizationManager::Sync_PostChangeForProcesses() {
 SynchronizationManager::ExitCode_t
 SynchronizationManager::Sync_PlatformForProcesses() {
 	ExitCode_t result;
-	bool at_least_one_success = false;
+	uint32_t synced_count = 0;
+	std::list<SchedPtr_t> failed_procs;
 
 	logger->Debug("STEP M.2: SyncPlatform() START: processes");
 	SM_RESET_TIMING(sm_tmr);
@@ -879,6 +850,9 @@ SynchronizationManager::Sync_PlatformForProcesses() {
 		return NOTHING_TO_SYNC;
 	}
 
+	// Bindings are enforced all together at the end
+	plm.MapResourcesStart();
+
 	ProcessMapIterator procs_it;
 	ProcPtr_t proc = prm.GetFirst(Schedulable::SYNC, procs_it);
 	for ( ; proc; proc = prm.GetNext(Schedulable::SYNC, procs_it)) {
@@ -888,15 +862,24 @@ SynchronizationManager::Sync_PlatformForProcesses() {
 			sync_fails_procs.insert(proc);
 			continue;
 		}
-		else
-			if (!at_least_one_success)
-				at_least_one_success = true;
+		++synced_count;
 		logger->Info("STEP M.2: <--------- OK -- [%s]", proc->StrId());
 	}
 
+	if (plm.MapResourcesCommit(failed_procs) != PlatformManager::PLATFORM_OK) {
+		for (auto & psched: failed_procs) {
+			logger->Error("STEP M.2: cannot enforce bindings of [%s]",
+				psched->StrId());
+			auto ret = sync_fails_procs.insert(
+				std::static_pointer_cast<Process>(psched));
+			if (ret.second && synced_count > 0)
+				--synced_count;
+		}
+	}
+
 	// Collecting execution metrics
 	logger->Debug("STEP M.2: SyncPlatform() DONE: processes");
-	if (at_least_one_success)
+	if (synced_count > 0)
 		return OK;
 	return PLATFORM_SYNC_FAILED;
 }
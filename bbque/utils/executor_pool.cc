@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2012  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bbque/utils/executor_pool.h"
+
+#include <sys/prctl.h>
+
+namespace bbque { namespace utils {
+
+ExecutorPool::ExecutorPool(unsigned int nr_executors, size_t capacity,
+		std::string const & name):
+		name(name),
+		enqueue_pos(0),
+		dequeue_pos(0),
+		queued(0),
+		sleeping(0),
+		done(false) {
+
+	size_t size = 2;
+	while (size < capacity)
+		size <<= 1;
+	mask  = size - 1;
+	cells = std::unique_ptr<Cell[]>(new Cell[size]);
+	for (size_t i = 0; i < size; ++i)
+		cells[i].seq.store(i, std::memory_order_relaxed);
+
+	if (nr_executors == 0)
+		nr_executors = 1;
+	for (unsigned int i = 0; i < nr_executors; ++i)
+		threads.emplace_back(&ExecutorPool::Run, this, i);
+}
+
+ExecutorPool::~ExecutorPool() {
+	std::unique_lock<std::mutex> idle_ul(idle_mtx);
+	done = true;
+	idle_ul.unlock();
+	idle_cv.notify_all();
+
+	for (auto & executor: threads)
+		executor.join();
+}
+
+bool ExecutorPool::Submit(Job_t && job) {
+	size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+	Cell * cell;
+
+	// Reserve a free cell
+	while (true) {
+		cell = &cells[pos & mask];
+		size_t seq = cell->seq.load(std::memory_order_acquire);
+		intptr_t diff = (intptr_t) seq - (intptr_t) pos;
+		if (diff == 0) {
+			if (enqueue_pos.compare_exchange_weak(pos, pos + 1,
+					std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0) {
+			// The oldest job has not been taken yet: the ring is full
+			return false;
+		}
+		else
+			pos = enqueue_pos.load(std::memory_order_relaxed);
+	}
+
+	// Count the job before publishing it, thus it is never taken (and
+	// uncounted) before being counted
+	++queued;
+	cell->job = std::move(job);
+	cell->seq.store(pos + 1, std::memory_order_release);
+
+	// Wake up an executor only if some of them is sleeping. The mutex is
+	// acquired to not miss an executor which is going to sleep right now.
+	if (sleeping.load() > 0) {
+		std::unique_lock<std::mutex> idle_ul(idle_mtx);
+		idle_ul.unlock();
+		idle_cv.notify_one();
+	}
+
+	return true;
+}
+
+bool ExecutorPool::Dequeue(Job_t & job) {
+	size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+	Cell * cell;
+
+	while (true) {
+		cell = &cells[pos & mask];
+		size_t seq = cell->seq.load(std::memory_order_acquire);
+		intptr_t diff = (intptr_t) seq - (intptr_t) (pos + 1);
+		if (diff == 0) {
+			if (dequeue_pos.compare_exchange_weak(pos, pos + 1,
+					std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0) {
+			// Nothing written at this position yet: the ring is empty
+			return false;
+		}
+		else
+			pos = dequeue_pos.load(std::memory_order_relaxed);
+	}
+
+	job = std::move(cell->job);
+	cell->job = nullptr;
+	cell->seq.store(pos + mask + 1, std::memory_order_release);
+	--queued;
+
+	return true;
+}
+
+void ExecutorPool::Run(unsigned int id) {
+	std::string thread_name(name + std::to_string(id));
+	prctl(PR_SET_NAME, (long unsigned int) thread_name.c_str(), 0, 0, 0);
+
+	Job_t job;
+	while (true) {
+		if (Dequeue(job)) {
+			job();
+			job = nullptr;
+			continue;
+		}
+
+		// Nothing to do: sleep until a new job is queued
+		std::unique_lock<std::mutex> idle_ul(idle_mtx);
+		++sleeping;
+		idle_cv.wait(idle_ul, [this]() { return done || (queued > 0); });
+		--sleeping;
+		if (done && (queued == 0))
+			break;
+	}
+}
+
+} // namespace utils
+
+} // namespace bbque
@@ -0,0 +1,978 @@
+/*
+ * Copyright (C) 2012  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bbque/utils/logging/async_logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+
+#define LOG_MAX_SENTENCE 256
+
+/** The maximum length of a single conversion specification */
+#define LOG_MAX_SPEC 32
+
+/** The cache line size the ring positions are padded to */
+#define BBQUE_LOG_ASYNC_CACHE_LINE 64
+
+static_assert((BBQUE_LOG_ASYNC_RING_SIZE & (BBQUE_LOG_ASYNC_RING_SIZE - 1)) == 0,
+	"BBQUE_LOG_ASYNC_RING_SIZE must be a power of 2");
+static_assert(BBQUE_LOG_ASYNC_RING_SIZE >= 4 * BBQUE_LOG_ASYNC_RECORD_MAX,
+	"BBQUE_LOG_ASYNC_RING_SIZE too small");
+
+namespace bbque { namespace utils {
+
+namespace {
+
+/*******************************************************************************
+ *  Captured messages encoding
+ ******************************************************************************/
+
+/**
+ * The type of a captured argument, which is the type the conversion
+ * specification expects after the default argument promotions
+ */
+enum ArgType : uint8_t {
+	ARG_NONE,     // "%%"
+	ARG_INT,
+	ARG_LONG,
+	ARG_LLONG,
+	ARG_INTMAX,
+	ARG_SIZE,
+	ARG_PTRDIFF,
+	ARG_DOUBLE,
+	ARG_LDOUBLE,
+	ARG_PTR,
+	ARG_STR
+};
+
+/** A conversion specification of a format string */
+struct FormatSpec {
+	const char * begin; // The '%'
+	const char * end;   // One past the conversion specifier
+	uint8_t stars;      // Width and precision provided as arguments
+	ArgType type;
+};
+
+/**
+ * @brief Parse the conversion specification starting at p
+ * @return false if the specification is not supported, in which case the
+ * message must be formatted synchronously
+ */
+bool ParseSpec(const char * p, FormatSpec & spec) {
+	const char * q = p + 1;
+	char length = 0;
+
+	spec.begin = p;
+	spec.stars = 0;
+	if (*q == '%') {
+		spec.type = ARG_NONE;
+		spec.end  = q + 1;
+		return true;
+	}
+
+	// Flags, width and precision
+	while (*q && strchr("-+ #0'", *q))
+		++q;
+	if (*q == '*') {
+		++spec.stars;
+		++q;
+	}
+	else {
+		while (isdigit(*q))
+			++q;
+		// Positional arguments
+		if (*q == '$')
+			return false;
+	}
+	if (*q == '.') {
+		++q;
+		if (*q == '*') {
+			++spec.stars;
+			++q;
+		}
+		else {
+			while (isdigit(*q))
+				++q;
+		}
+	}
+
+	// Length modifier ('q' stands for "ll")
+	switch (*q) {
+	case 'h':
+		length = 'h';
+		if (*++q == 'h')
+			++q;
+		break;
+	case 'l':
+		length = 'l';
+		if (*++q == 'l') {
+			length = 'q';
+			++q;
+		}
+		break;
+	case 'L':
+	case 'j':
+	case 'z':
+	case 't':
+		length = *q++;
+		break;
+	}
+
+	// Conversion specifier
+	switch (*q) {
+	case 'd':
+	case 'i':
+	case 'o':
+	case 'u':
+	case 'x':
+	case 'X':
+		switch (length) {
+		case 'l': spec.type = ARG_LONG;    break;
+		case 'q': spec.type = ARG_LLONG;   break;
+		case 'j': spec.type = ARG_INTMAX;  break;
+		case 'z': spec.type = ARG_SIZE;    break;
+		case 't': spec.type = ARG_PTRDIFF; break;
+		case 'L': return false;
+		default:  spec.type = ARG_INT;
+		}
+		break;
+	case 'c':
+		if (length)
+			return false;
+		spec.type = ARG_INT;
+		break;
+	case 'e':
+	case 'E':
+	case 'f':
+	case 'F':
+	case 'g':
+	case 'G':
+	case 'a':
+	case 'A':
+		if (length == 'L')
+			spec.type = ARG_LDOUBLE;
+		else if (length == 0 || length == 'l')
+			spec.type = ARG_DOUBLE;
+		else
+			return false;
+		break;
+	case 's':
+		if (length)
+			return false;
+		spec.type = ARG_STR;
+		break;
+	case 'p':
+		if (length)
+			return false;
+		spec.type = ARG_PTR;
+		break;
+	default:
+		// "%n", wide characters and malformed specifications
+		return false;
+	}
+
+	spec.end = q + 1;
+	return (spec.end - spec.begin) < LOG_MAX_SPEC;
+}
+
+/** The record is just filling the ring up to its end */
+#define RECORD_PADDING 0x1
+
+/**
+ * A captured message, which is followed by a copy of its format string (NUL
+ * terminated) and then by its arguments, each one encoded as the ArgType
+ * byte followed by the raw value. String arguments are encoded by their u16
+ * length followed by the NUL terminated characters.
+ *
+ * The format string is copied since it is not always a literal: callers can
+ * log a message built into a buffer which is gone by the time the record is
+ * formatted.
+ */
+struct RecordHeader {
+	uint32_t size;      // Whole record size, multiple of 8 [bytes]
+	uint8_t  flags;
+	uint8_t  priority;
+	uint16_t nargs;
+	uint16_t fmt_len;   // Format string length, without the terminator
+	uint16_t reserved[3];
+	Logger * sink;
+};
+
+static_assert(sizeof(RecordHeader) % 8 == 0, "RecordHeader not aligned");
+
+/**
+ * @brief Encode a message into a record
+ * @return the size of the record, 0 if the message cannot be captured
+ */
+size_t EncodeRecord(char * rec, const char * fmt, va_list args) {
+	RecordHeader * header = reinterpret_cast<RecordHeader *>(rec);
+	size_t pos = sizeof(RecordHeader);
+	uint16_t nargs = 0;
+	FormatSpec spec;
+
+	size_t fmt_len = strnlen(fmt, BBQUE_LOG_ASYNC_RECORD_MAX - pos);
+	if (pos + fmt_len + 1 > BBQUE_LOG_ASYNC_RECORD_MAX)
+		return 0;
+	memcpy(rec + pos, fmt, fmt_len + 1);
+	pos += fmt_len + 1;
+
+	auto put = [&](ArgType type, const void * value, size_t size) {
+		if ((nargs == BBQUE_LOG_ASYNC_ARGS_MAX) ||
+				(pos + 1 + size > BBQUE_LOG_ASYNC_RECORD_MAX))
+			return false;
+		rec[pos] = type;
+		memcpy(rec + pos + 1, value, size);
+		pos += 1 + size;
+		++nargs;
+		return true;
+	};
+
+	for (const char * p = strchr(fmt, '%'); p; p = strchr(spec.end, '%')) {
+		if (!ParseSpec(p, spec))
+			return 0;
+		for (uint8_t i = 0; i < spec.stars; ++i) {
+			int star = va_arg(args, int);
+			if (!put(ARG_INT, &star, sizeof(star)))
+				return 0;
+		}
+
+		bool captured = true;
+		switch (spec.type) {
+		case ARG_NONE:
+			break;
+		case ARG_INT: {
+			int v = va_arg(args, int);
+			captured = put(spec.type, &v, sizeof(v));
+			break;
+		}
+		case ARG_LONG: {
+			long v = va_arg(args, long);
+			captured = put(spec.type, &v, sizeof(v));
+			break;
+		}
+		case ARG_LLONG: {
+			long long v = va_arg(args, long long);
+			captured = put(spec.type, &v, sizeof(v));
+			break;
+		}
+		case ARG_INTMAX: {
+			intmax_t v = va_arg(args, intmax_t);
+			captured = put(spec.type, &v, sizeof(v));
+			break;
+		}
+		case ARG_SIZE: {
+			size_t v = va_arg(args, size_t);
+			captured = put(spec.type, &v, sizeof(v));
+			break;
+		}
+		case ARG_PTRDIFF: {
+			ptrdiff_t v = va_arg(args, ptrdiff_t);
+			captured = put(spec.type, &v, sizeof(v));
+			break;
+		}
+		case ARG_DOUBLE: {
+			double v = va_arg(args, double);
+			captured = put(spec.type, &v, sizeof(v));
+			break;
+		}
+		case ARG_LDOUBLE: {
+			long double v = va_arg(args, long double);
+			captured = put(spec.type, &v, sizeof(v));
+			break;
+		}
+		case ARG_PTR: {
+			void * v = va_arg(args, void *);
+			captured = put(spec.type, &v, sizeof(v));
+			break;
+		}
+		case ARG_STR: {
+			const char * s = va_arg(args, const char *);
+			if (s == nullptr)
+				s = "(null)";
+			// Strings are truncated to the space left, since the sink
+			// truncates the messages anyway
+			if ((nargs == BBQUE_LOG_ASYNC_ARGS_MAX) ||
+					(pos + 4 > BBQUE_LOG_ASYNC_RECORD_MAX))
+				return 0;
+			uint16_t len = strnlen(s, BBQUE_LOG_ASYNC_RECORD_MAX - pos - 4);
+			rec[pos] = ARG_STR;
+			memcpy(rec + pos + 1, &len, sizeof(len));
+			memcpy(rec + pos + 3, s, len);
+			rec[pos + 3 + len] = '\0';
+			pos += 4 + len;
+			++nargs;
+			break;
+		}
+		}
+		if (!captured)
+			return 0;
+	}
+
+	header->flags    = 0;
+	header->nargs    = nargs;
+	header->fmt_len  = fmt_len;
+	return (pos + 7) & ~static_cast<size_t>(7);
+}
+
+template <typename T>
+T ReadArg(const char *& arg) {
+	T value;
+	memcpy(&value, arg + 1, sizeof(T));
+	arg += 1 + sizeof(T);
+	return value;
+}
+
+template <typename T>
+int FormatArg(char * dest, size_t size, FormatSpec const & spec,
+		int const * star, T value) {
+	char fmt[LOG_MAX_SPEC];
+	size_t len = spec.end - spec.begin;
+
+	memcpy(fmt, spec.begin, len);
+	fmt[len] = '\0';
+	switch (spec.stars) {
+	case 0:
+		return snprintf(dest, size, fmt, value);
+	case 1:
+		return snprintf(dest, size, fmt, star[0], value);
+	default:
+		return snprintf(dest, size, fmt, star[0], star[1], value);
+	}
+}
+
+/**
+ * @brief Format a captured message
+ */
+void FormatRecord(RecordHeader const * header, char * dest, size_t size) {
+	const char * literal = reinterpret_cast<const char *>(header + 1);
+	const char * arg = literal + header->fmt_len + 1;
+	size_t len = 0;
+	FormatSpec spec;
+	int star[2];
+
+	auto append = [&](const char * s, size_t n) {
+		n = std::min(n, size - 1 - len);
+		memcpy(dest + len, s, n);
+		len += n;
+	};
+	auto advance = [&](int n) {
+		if (n > 0)
+			len = std::min(len + n, size - 1);
+	};
+
+	for (const char * p = strchr(literal, '%'); p; p = strchr(literal, '%')) {
+		append(literal, p - literal);
+		ParseSpec(p, spec);
+		literal = spec.end;
+		if (spec.type == ARG_NONE) {
+			append("%", 1);
+			continue;
+		}
+		for (uint8_t i = 0; i < spec.stars; ++i)
+			star[i] = ReadArg<int>(arg);
+
+		char * out = dest + len;
+		size_t left = size - len;
+		switch (spec.type) {
+		case ARG_INT:
+			advance(FormatArg(out, left, spec, star, ReadArg<int>(arg)));
+			break;
+		case ARG_LONG:
+			advance(FormatArg(out, left, spec, star, ReadArg<long>(arg)));
+			break;
+		case ARG_LLONG:
+			advance(FormatArg(out, left, spec, star,
+				ReadArg<long long>(arg)));
+			break;
+		case ARG_INTMAX:
+			advance(FormatArg(out, left, spec, star,
+				ReadArg<intmax_t>(arg)));
+			break;
+		case ARG_SIZE:
+			advance(FormatArg(out, left, spec, star, ReadArg<size_t>(arg)));
+			break;
+		case ARG_PTRDIFF:
+			advance(FormatArg(out, left, spec, star,
+				ReadArg<ptrdiff_t>(arg)));
+			break;
+		case ARG_DOUBLE:
+			advance(FormatArg(out, left, spec, star, ReadArg<double>(arg)));
+			break;
+		case ARG_LDOUBLE:
+			advance(FormatArg(out, left, spec, star,
+				ReadArg<long double>(arg)));
+			break;
+		case ARG_PTR:
+			advance(FormatArg(out, left, spec, star, ReadArg<void *>(arg)));
+			break;
+		case ARG_STR: {
+			uint16_t str_len;
+			memcpy(&str_len, arg + 1, sizeof(str_len));
+			advance(FormatArg(out, left, spec, star, arg + 3));
+			arg += 4 + str_len;
+			break;
+		}
+		case ARG_NONE:
+			break;
+		}
+	}
+	append(literal, strlen(literal));
+	dest[len] = '\0';
+}
+
+/**
+ * @brief Forward an already formatted message to a logger
+ */
+void Dispatch(Logger * sink, Logger::Priority priority, const char * msg) {
+	switch (priority) {
+	case Logger::DEBUG_LEVEL:
+		sink->Debug("%s", msg);
+		break;
+	case Logger::INFO_LEVEL:
+		sink->Info("%s", msg);
+		break;
+	case Logger::NOTICE_LEVEL:
+		sink->Notice("%s", msg);
+		break;
+	case Logger::WARN_LEVEL:
+		sink->Warn("%s", msg);
+		break;
+	case Logger::ERROR_LEVEL:
+		sink->Error("%s", msg);
+		break;
+	case Logger::CRIT_LEVEL:
+		sink->Crit("%s", msg);
+		break;
+	case Logger::ALERT_LEVEL:
+		sink->Alert("%s", msg);
+		break;
+	case Logger::FATAL_LEVEL:
+		sink->Fatal("%s", msg);
+		break;
+	}
+}
+
+
+/*******************************************************************************
+ *  Per-thread ring buffers
+ ******************************************************************************/
+
+/**
+ * @class LogRing
+ * @brief Single producer, single consumer ring of captured messages
+ *
+ * The producer is the thread owning the ring, the consumer is the background
+ * thread. Records are never split across the end of the ring: a padding
+ * record fills the ring up to its end instead.
+ */
+class LogRing {
+
+public:
+
+	LogRing() : buffer(new char[BBQUE_LOG_ASYNC_RING_SIZE]) {}
+
+	/**
+	 * @brief Reserve a contiguous space of len bytes
+	 * @return nullptr if the ring is full
+	 */
+	char * Reserve(size_t len) {
+		size_t h = head.load(std::memory_order_relaxed);
+		size_t t = tail.load(std::memory_order_acquire);
+		size_t offset = h & (BBQUE_LOG_ASYNC_RING_SIZE - 1);
+		size_t contiguous = BBQUE_LOG_ASYNC_RING_SIZE - offset;
+		size_t needed = (len <= contiguous) ? len : contiguous + len;
+
+		if (BBQUE_LOG_ASYNC_RING_SIZE - (h - t) < needed)
+			return nullptr;
+		if (len > contiguous) {
+			RecordHeader * pad =
+				reinterpret_cast<RecordHeader *>(buffer.get() + offset);
+			pad->size  = contiguous;
+			pad->flags = RECORD_PADDING;
+			h += contiguous;
+			offset = 0;
+		}
+		reserved = h;
+		return buffer.get() + offset;
+	}
+
+	/**
+	 * @brief Publish the record written in the reserved space
+	 */
+	void Commit(size_t len) {
+		head.store(reserved + len, std::memory_order_release);
+	}
+
+	/**
+	 * @brief The bytes currently used
+	 */
+	size_t Used() const {
+		return head.load(std::memory_order_relaxed) -
+			tail.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief The oldest record, nullptr if the ring is empty
+	 */
+	RecordHeader const * Front() {
+		size_t t = tail.load(std::memory_order_relaxed);
+		size_t h = head.load(std::memory_order_acquire);
+		while (t != h) {
+			RecordHeader const * header = reinterpret_cast<RecordHeader *>(
+				buffer.get() + (t & (BBQUE_LOG_ASYNC_RING_SIZE - 1)));
+			if (!(header->flags & RECORD_PADDING))
+				return header;
+			t += header->size;
+			tail.store(t, std::memory_order_release);
+		}
+		return nullptr;
+	}
+
+	/**
+	 * @brief Release the oldest record
+	 */
+	void Pop(RecordHeader const * header) {
+		tail.store(tail.load(std::memory_order_relaxed) + header->size,
+			std::memory_order_release);
+	}
+
+	/** Messages dropped since the last drain */
+	std::atomic<uint32_t> dropped{0};
+
+	/** The sink of the last record drained (consumer only) */
+	Logger * last_sink = nullptr;
+
+	/** Set when the owner thread has terminated */
+	std::atomic<bool> orphaned{false};
+
+private:
+
+	std::unique_ptr<char[]> buffer;
+
+	/** The producer reservation */
+	size_t reserved = 0;
+
+	/*
+	 * The producer and consumer positions are padded to cache lines of
+	 * their own, rather than aligned, since the rings are allocated on
+	 * the heap
+	 */
+	char pad_head[BBQUE_LOG_ASYNC_CACHE_LINE];
+
+	std::atomic<size_t> head{0};
+
+	char pad_tail[BBQUE_LOG_ASYNC_CACHE_LINE - sizeof(std::atomic<size_t>)];
+
+	std::atomic<size_t> tail{0};
+
+	char pad_end[BBQUE_LOG_ASYNC_CACHE_LINE - sizeof(std::atomic<size_t>)];
+
+};
+
+/**
+ * Hand the ring over to the background thread when the owner terminates
+ */
+struct ThreadRing {
+	LogRing * ring = nullptr;
+	~ThreadRing() {
+		if (ring)
+			ring->orphaned.store(true, std::memory_order_release);
+		ring = nullptr;
+	}
+};
+
+thread_local ThreadRing thread_ring;
+
+
+/*******************************************************************************
+ *  Background thread
+ ******************************************************************************/
+
+/**
+ * @class AsyncLogBackend
+ * @brief The thread formatting and forwarding the captured messages
+ *
+ * The backend is never destroyed, since loggers are used also by the
+ * destructors of static objects. At exit, the pending messages are flushed
+ * and the loggers fall back to synchronous logging.
+ */
+class AsyncLogBackend {
+
+public:
+
+	static AsyncLogBackend & GetInstance() {
+		static AsyncLogBackend * instance = new AsyncLogBackend();
+		return *instance;
+	}
+
+	/**
+	 * @brief Capture a message into the ring of the calling thread
+	 * @return false if the message must be logged synchronously
+	 */
+	bool Push(Logger * sink, Logger::Priority priority,
+			const char * fmt, va_list args) {
+		alignas(8) char rec[BBQUE_LOG_ASYNC_RECORD_MAX];
+		RecordHeader * header = reinterpret_cast<RecordHeader *>(rec);
+
+		if (!running.load(std::memory_order_acquire))
+			return false;
+		size_t size = EncodeRecord(rec, fmt, args);
+		if (size == 0)
+			return false;
+
+		LogRing * ring = thread_ring.ring;
+		if (ring == nullptr)
+			ring = Register();
+
+		char * dest = ring->Reserve(size);
+		if (dest == nullptr) {
+#ifdef CONFIG_BBQUE_LOGGER_ASYNC_BLOCK
+			dest = WaitSpace(ring, size);
+#else
+			ring->dropped.fetch_add(1, std::memory_order_relaxed);
+			Wake();
+			return true;
+#endif
+		}
+
+		header->size     = size;
+		header->priority = priority;
+		header->sink     = sink;
+		memcpy(dest, rec, size);
+		ring->Commit(size);
+
+		if (ring->Used() > BBQUE_LOG_ASYNC_RING_SIZE / 2)
+			Wake();
+		return true;
+	}
+
+	/**
+	 * @brief Wait for all the messages captured so far to be logged
+	 */
+	void Flush() {
+		if (!running.load(std::memory_order_acquire) ||
+				(std::this_thread::get_id() == worker.get_id()))
+			return;
+		std::unique_lock<std::mutex> lk(mtx);
+		uint64_t request = ++flush_requested;
+		cv.notify_one();
+		flushed_cv.wait(lk, [&] {
+			return (flush_completed >= request) || done; });
+	}
+
+private:
+
+	/** True while the background thread is serving the captures */
+	std::atomic<bool> running{false};
+
+	/** Set when the background thread must drain the rings early */
+	std::atomic<bool> wake_pending{false};
+
+	/** Producers waiting for space (block policy) */
+	std::atomic<uint32_t> blocked{0};
+
+	std::mutex mtx;
+
+	/** The background thread waits for a wake up or a flush request */
+	std::condition_variable cv;
+
+	/** Flush requesters wait for the drain to complete */
+	std::condition_variable flushed_cv;
+
+	/** Producers (block policy) wait for space */
+	std::condition_variable space_cv;
+
+	uint64_t flush_requested = 0;
+
+	uint64_t flush_completed = 0;
+
+	bool done = false;
+
+	std::mutex rings_mtx;
+
+	std::vector<LogRing *> rings;
+
+	std::thread worker;
+
+
+	AsyncLogBackend() {
+		running = true;
+		worker = std::thread(&AsyncLogBackend::Run, this);
+		// Messages logged by the destructors of static objects, as well as
+		// by a forked child (where the background thread is missing), are
+		// logged synchronously
+		atexit([] { GetInstance().Stop(); });
+		pthread_atfork(nullptr, nullptr, [] {
+			GetInstance().running.store(false); });
+	}
+
+	LogRing * Register() {
+		LogRing * ring = new LogRing();
+		std::unique_lock<std::mutex> lk(rings_mtx);
+		rings.push_back(ring);
+		thread_ring.ring = ring;
+		return ring;
+	}
+
+	void Wake() {
+		if (!wake_pending.exchange(true, std::memory_order_relaxed))
+			cv.notify_one();
+	}
+
+#ifdef CONFIG_BBQUE_LOGGER_ASYNC_BLOCK
+	char * WaitSpace(LogRing * ring, size_t size) {
+		char * dest;
+		++blocked;
+		Wake();
+		std::unique_lock<std::mutex> lk(mtx);
+		while ((dest = ring->Reserve(size)) == nullptr)
+			space_cv.wait_for(lk,
+				std::chrono::milliseconds(BBQUE_LOG_ASYNC_PERIOD_MS));
+		--blocked;
+		return dest;
+	}
+#endif
+
+	void Stop() {
+		Flush();
+		// Nothing to stop in a forked child
+		if (!running.exchange(false))
+			return;
+		std::unique_lock<std::mutex> lk(mtx);
+		done = true;
+		cv.notify_one();
+		lk.unlock();
+		if (worker.joinable())
+			worker.join();
+	}
+
+	void Run() {
+		std::unique_lock<std::mutex> lk(mtx);
+		while (!done) {
+			cv.wait_for(lk, std::chrono::milliseconds(BBQUE_LOG_ASYNC_PERIOD_MS),
+				[&] {
+					return wake_pending.load(std::memory_order_relaxed) ||
+						(flush_requested > flush_completed) || done;
+				});
+			uint64_t request = flush_requested;
+			wake_pending = false;
+			lk.unlock();
+			Drain();
+			lk.lock();
+			flush_completed = request;
+			flushed_cv.notify_all();
+		}
+		lk.unlock();
+		Drain();
+	}
+
+	/**
+	 * @brief Log all the captured messages and release the rings of the
+	 * terminated threads
+	 */
+	void Drain() {
+		std::vector<LogRing *> current;
+		char msg[LOG_MAX_SENTENCE];
+
+		{
+			std::unique_lock<std::mutex> lk(rings_mtx);
+			current = rings;
+		}
+
+		for (LogRing * ring : current) {
+			bool orphaned = ring->orphaned.load(std::memory_order_acquire);
+			RecordHeader const * header;
+			while ((header = ring->Front()) != nullptr) {
+				FormatRecord(header, msg, sizeof(msg));
+				Dispatch(header->sink,
+					static_cast<Logger::Priority>(header->priority), msg);
+				ring->last_sink = header->sink;
+				ring->Pop(header);
+			}
+			uint32_t dropped = ring->dropped.exchange(0);
+			if ((dropped > 0) && ring->last_sink)
+				ring->last_sink->Warn("Logger: %u messages dropped "
+					"(buffer full)", dropped);
+			if (blocked.load(std::memory_order_relaxed) > 0)
+				space_cv.notify_all();
+			if (!orphaned)
+				continue;
+
+			std::unique_lock<std::mutex> lk(rings_mtx);
+			for (auto it = rings.begin(); it != rings.end(); ++it) {
+				if (*it == ring) {
+					rings.erase(it);
+					break;
+				}
+			}
+			delete ring;
+		}
+	}
+
+};
+
+} // namespace
+
+
+/*******************************************************************************
+ *  AsyncLogger
+ ******************************************************************************/
+
+std::unique_ptr<Logger>
+AsyncLogger::GetInstance(Configuration const & conf,
+		std::unique_ptr<Logger> sink) {
+	return std::unique_ptr<Logger>(new AsyncLogger(conf, std::move(sink)));
+}
+
+AsyncLogger::AsyncLogger(Configuration const & conf,
+		std::unique_ptr<Logger> sink) :
+	Logger(conf),
+	sink(std::move(sink)) {
+	for (int p = DEBUG_LEVEL; p <= FATAL_LEVEL; ++p)
+		enabled[p] = (p >= BBQUE_LOG_LEVEL_MIN) &&
+			this->sink->IsEnabled(static_cast<Priority>(p));
+	AsyncLogBackend::GetInstance();
+}
+
+AsyncLogger::~AsyncLogger() {
+	// Pending records refer to the sink
+	Flush();
+}
+
+void AsyncLogger::Flush() {
+	AsyncLogBackend::GetInstance().Flush();
+}
+
+void AsyncLogger::Capture(Priority priority, const char *fmt, va_list args) {
+	char str[LOG_MAX_SENTENCE];
+	va_list args_copy;
+
+	if (priority < CRIT_LEVEL) {
+		va_copy(args_copy, args);
+		bool captured = AsyncLogBackend::GetInstance().Push(
+			sink.get(), priority, fmt, args_copy);
+		va_end(args_copy);
+		if (captured)
+			return;
+	}
+
+	// Synchronous logging, after the messages already captured
+	Flush();
+	vsnprintf(str, LOG_MAX_SENTENCE, fmt, args);
+	Dispatch(sink.get(), priority, str);
+}
+
+//----- Logger interface
+
+#ifdef BBQUE_DEBUG
+void AsyncLogger::Debug(const char *fmt, ...) {
+	va_list args;
+
+	if (enabled[DEBUG_LEVEL]) {
+		va_start(args, fmt);
+		Capture(DEBUG_LEVEL, fmt, args);
+		va_end(args);
+	}
+}
+#endif
+
+void AsyncLogger::Info(const char *fmt, ...) {
+	va_list args;
+
+	if (enabled[INFO_LEVEL]) {
+		va_start(args, fmt);
+		Capture(INFO_LEVEL, fmt, args);
+		va_end(args);
+	}
+}
+
+void AsyncLogger::Notice(const char *fmt, ...) {
+	va_list args;
+
+	if (enabled[NOTICE_LEVEL]) {
+		va_start(args, fmt);
+		Capture(NOTICE_LEVEL, fmt, args);
+		va_end(args);
+	}
+}
+
+void AsyncLogger::Warn(const char *fmt, ...) {
+	va_list args;
+
+	if (enabled[WARN_LEVEL]) {
+		va_start(args, fmt);
+		Capture(WARN_LEVEL, fmt, args);
+		va_end(args);
+	}
+}
+
+void AsyncLogger::Error(const char *fmt, ...) {
+	va_list args;
+
+	if (enabled[ERROR_LEVEL]) {
+		va_start(args, fmt);
+		Capture(ERROR_LEVEL, fmt, args);
+		va_end(args);
+	}
+}
+
+void AsyncLogger::Crit(const char *fmt, ...) {
+	va_list args;
+
+	if (enabled[CRIT_LEVEL]) {
+		va_start(args, fmt);
+		Capture(CRIT_LEVEL, fmt, args);
+		va_end(args);
+	}
+}
+
+void AsyncLogger::Alert(const char *fmt, ...) {
+	va_list args;
+
+	if (enabled[ALERT_LEVEL]) {
+		va_start(args, fmt);
+		Capture(ALERT_LEVEL, fmt, args);
+		va_end(args);
+	}
+}
+
+void AsyncLogger::Fatal(const char *fmt, ...) {
+	va_list args;
+
+	if (enabled[FATAL_LEVEL]) {
+		va_start(args, fmt);
+		Capture(FATAL_LEVEL, fmt, args);
+		va_end(args);
+	}
+}
+
+} // namespace utils
+
+} // namespace bbque
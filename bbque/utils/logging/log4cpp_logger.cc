@@ -114,6 +114,20 @@ bool Log4CppLogger::Configure(Configuration const & conf) {
 
 }
 
+bool Log4CppLogger::IsEnabled(Priority priority) const {
+	static const l4::Priority::Value l4_priority[] = {
+		l4::Priority::DEBUG,
+		l4::Priority::INFO,
+		l4::Priority::NOTICE,
+		l4::Priority::WARN,
+		l4::Priority::ERROR,
+		l4::Priority::CRIT,
+		l4::Priority::ALERT,
+		l4::Priority::FATAL
+	};
+	return logger.isPriorityEnabled(l4_priority[priority]);
+}
+
 //----- Logger interface
 
 #ifdef BBQUE_DEBUG
@@ -25,6 +25,9 @@
 #elif defined CONFIG_TARGET_ANDROID
 # include "bbque/utils/logging/android_logger.h"
 #endif
+#ifdef CONFIG_BBQUE_LOGGER_ASYNC
+# include "bbque/utils/logging/async_logger.h"
+#endif
 
 namespace bbque { namespace utils {
 
@@ -50,6 +53,10 @@ std::unique_ptr<Logger> Logger::GetLogger(Configuration const & conf) {
 		logger->Error("Logger module loading/configuration FAILED");
 		logger->Warn("Using (dummy) console logger");
 	}
+#ifdef CONFIG_BBQUE_LOGGER_ASYNC
+	// Formatting and I/O are moved to a background thread
+	logger = AsyncLogger::GetInstance(conf, std::move(logger));
+#endif
 	return logger;
 }
 
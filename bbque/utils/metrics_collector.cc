@@ -19,6 +19,10 @@
 
 #include "bbque/modules_factory.h"
 
+#include <bitset>
+#include <limits>
+#include <thread>
+
 #define METRICS_COLLECTOR_NAMESPACE "bq.mc"
 #define MODULE_NAMESPACE METRICS_COLLECTOR_NAMESPACE
 
@@ -26,18 +30,220 @@ namespace bp = bbque::plugins;
 
 namespace bbque { namespace utils {
 
+/*******************************************************************************
+ *    Per-thread shards
+ ******************************************************************************/
+
+namespace {
+
+std::mutex shards_mtx;
+std::bitset<BBQUE_MC_MAX_SHARDS> shards_used;
+
+/**
+ * @brief The shard of the metrics updated by a thread
+ *
+ * The shard id is assigned at the first metric update of the thread, and it
+ * is released at the thread exit, to be reused by the threads created later
+ * on. The new owner keeps accumulating into the slots of the previous one.
+ */
+class ThreadShard {
+public:
+	ThreadShard() : id(BBQUE_MC_MAX_SHARDS) {
+		std::unique_lock<std::mutex> ul(shards_mtx);
+		for (size_t i = 0; i < BBQUE_MC_MAX_SHARDS; ++i) {
+			if (shards_used[i])
+				continue;
+			shards_used[i] = true;
+			id = i;
+			break;
+		}
+	}
+
+	~ThreadShard() {
+		if (id == BBQUE_MC_MAX_SHARDS)
+			return;
+		std::unique_lock<std::mutex> ul(shards_mtx);
+		shards_used[id] = false;
+	}
+
+	/** The shard id, BBQUE_MC_MAX_SHARDS for the shared one */
+	size_t id;
+};
+
+thread_local ThreadShard current_shard;
+
+void InitSlot(MetricsCollector::ShardSlot & slot, uint32_t epoch) {
+	slot.epoch.store(epoch, std::memory_order_relaxed);
+	slot.count.store(0, std::memory_order_relaxed);
+	slot.mean.store(0, std::memory_order_relaxed);
+	slot.m2.store(0, std::memory_order_relaxed);
+	slot.min.store(std::numeric_limits<double>::max(),
+		std::memory_order_relaxed);
+	slot.max.store(std::numeric_limits<double>::lowest(),
+		std::memory_order_relaxed);
+}
+
+template<typename UpdateFn>
+inline void UpdateSlot(MetricsCollector::ShardSlot & slot, uint32_t epoch,
+		UpdateFn update) {
+	uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+	slot.seq.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	// Statistics of a previous epoch are dropped
+	if (unlikely(slot.epoch.load(std::memory_order_relaxed) != epoch))
+		InitSlot(slot, epoch);
+	update(slot);
+
+	slot.seq.store(seq + 2, std::memory_order_release);
+}
+
+} // namespace
+
+void MetricsCollector::SlotStats::Merge(uint64_t n,
+		double n_mean, double n_m2, double n_min, double n_max) {
+	if (n == 0)
+		return;
+
+	if (count == 0) {
+		count = n; mean = n_mean; m2 = n_m2; min = n_min; max = n_max;
+		return;
+	}
+
+	// Parallel algorithm for the variance (Chan et al.)
+	uint64_t total = count + n;
+	double delta = n_mean - mean;
+	mean += delta * n / total;
+	m2 += n_m2 + delta * delta * (static_cast<double>(count) * n / total);
+	min = std::min(min, n_min);
+	max = std::max(max, n_max);
+	count = total;
+}
+
+MetricsCollector::ShardedMetric::ShardedMetric(
+		const char *name, const char *desc, MetricClass_t mc,
+		uint8_t sm_count, const char **sm_desc) :
+	Metric(name, desc, mc, sm_count, sm_desc),
+	epoch(0) {
+	for (size_t i = 0; i <= BBQUE_MC_MAX_SHARDS; ++i)
+		shards[i].store(NULL, std::memory_order_relaxed);
+}
+
+MetricsCollector::ShardedMetric::~ShardedMetric() {
+	for (size_t i = 0; i <= BBQUE_MC_MAX_SHARDS; ++i)
+		delete [] shards[i].load(std::memory_order_relaxed);
+}
+
+MetricsCollector::ShardSlot *
+MetricsCollector::ShardedMetric::GetShard(size_t shard_id) {
+	ShardSlot * slots = shards[shard_id].load(std::memory_order_acquire);
+	if (likely(slots != NULL))
+		return slots;
+
+	// First update from this shard: only its owner could get here
+	slots = new ShardSlot[1 + sm_count];
+	for (uint16_t i = 0; i <= sm_count; ++i) {
+		slots[i].seq.store(0, std::memory_order_relaxed);
+		InitSlot(slots[i], epoch.load(std::memory_order_relaxed));
+	}
+	shards[shard_id].store(slots, std::memory_order_release);
+	return slots;
+}
+
+template<typename UpdateFn>
+void MetricsCollector::ShardedMetric::Update(uint8_t sm_idx,
+		UpdateFn update) {
+	uint32_t current_epoch = epoch.load(std::memory_order_relaxed);
+	size_t shard_id = current_shard.id;
+
+	// Threads exceeding the shards count update the shared one
+	std::unique_lock<std::mutex> ul(mtx, std::defer_lock);
+	if (unlikely(shard_id == BBQUE_MC_MAX_SHARDS))
+		ul.lock();
+
+	ShardSlot * slots = GetShard(shard_id);
+	UpdateSlot(slots[0], current_epoch, update);
+	if (HasSubmetrics())
+		UpdateSlot(slots[1 + sm_idx], current_epoch, update);
+}
+
+void MetricsCollector::ShardedMetric::Count(uint64_t amount, uint8_t sm_idx) {
+	Update(sm_idx, [amount](ShardSlot & slot) {
+		slot.count.store(slot.count.load(std::memory_order_relaxed) + amount,
+			std::memory_order_relaxed);
+	});
+}
+
+void MetricsCollector::ShardedMetric::Sample(double sample, uint8_t sm_idx) {
+	Update(sm_idx, [sample](ShardSlot & slot) {
+		// Online algorithm for the variance (Welford)
+		uint64_t n = slot.count.load(std::memory_order_relaxed) + 1;
+		double mean = slot.mean.load(std::memory_order_relaxed);
+		double delta = sample - mean;
+		mean += delta / n;
+		slot.count.store(n, std::memory_order_relaxed);
+		slot.mean.store(mean, std::memory_order_relaxed);
+		slot.m2.store(slot.m2.load(std::memory_order_relaxed) +
+			delta * (sample - mean), std::memory_order_relaxed);
+		if (sample < slot.min.load(std::memory_order_relaxed))
+			slot.min.store(sample, std::memory_order_relaxed);
+		if (sample > slot.max.load(std::memory_order_relaxed))
+			slot.max.store(sample, std::memory_order_relaxed);
+	});
+}
+
+MetricsCollector::SlotStats
+MetricsCollector::ShardedMetric::Collect(uint16_t slot) const {
+	uint32_t current_epoch = epoch.load(std::memory_order_acquire);
+	SlotStats stats;
+
+	for (size_t i = 0; i <= BBQUE_MC_MAX_SHARDS; ++i) {
+		ShardSlot const * slots = shards[i].load(std::memory_order_acquire);
+		if (slots == NULL)
+			continue;
+		ShardSlot const & s(slots[slot]);
+
+		// Get a consistent snapshot of the slot
+		uint32_t seq_begin, seq_end, s_epoch;
+		uint64_t n;
+		double mean, m2, min, max;
+		do {
+			seq_begin = s.seq.load(std::memory_order_acquire);
+			if (seq_begin & 0x1) {
+				std::this_thread::yield();
+				continue;
+			}
+			s_epoch = s.epoch.load(std::memory_order_relaxed);
+			n    = s.count.load(std::memory_order_relaxed);
+			mean = s.mean.load(std::memory_order_relaxed);
+			m2   = s.m2.load(std::memory_order_relaxed);
+			min  = s.min.load(std::memory_order_relaxed);
+			max  = s.max.load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			seq_end = s.seq.load(std::memory_order_relaxed);
+		} while ((seq_begin & 0x1) || (seq_begin != seq_end));
+
+		if (s_epoch != current_epoch)
+			continue;
+		stats.Merge(n, mean, m2, min, max);
+	}
+
+	return stats;
+}
+
+void MetricsCollector::ShardedMetric::Reset() {
+	epoch.fetch_add(1, std::memory_order_release);
+}
+
+/*******************************************************************************
+ *    Metrics classes
+ ******************************************************************************/
+
 MetricsCollector::CounterMetric::CounterMetric(
 		const char *name, const char *desc,
 		uint8_t sm_count, const char **sm_desc) :
-	Metric(name, desc, COUNTER, sm_count, sm_desc),
-	cnt(0), sm_cnt(sm_count) {
-
-}
+	ShardedMetric(name, desc, COUNTER, sm_count, sm_desc) {
 
-void MetricsCollector::CounterMetric::Reset() {
-	cnt = 0;
-	for (uint8_t i = 0; i < sm_cnt.size(); ++i)
-		sm_cnt[i] = 0;
 }
 
 MetricsCollector::ValueMetric::ValueMetric(
@@ -64,19 +270,8 @@ void MetricsCollector::ValueMetric::Reset() {
 MetricsCollector::SamplesMetric::SamplesMetric(
 		const char *name, const char *desc,
 		uint8_t sm_count, const char **sm_desc) :
-	Metric(name, desc, SAMPLE, sm_count, sm_desc),
-	sm_pstat(sm_count) {
-	pstat = pStatMetric_t(new statMetric_t);
-	for (uint8_t i = 0; i < sm_pstat.size(); ++i) {
-		sm_pstat[i] = pStatMetric_t(new statMetric_t);
-	}
-}
+	ShardedMetric(name, desc, SAMPLE, sm_count, sm_desc) {
 
-void MetricsCollector::SamplesMetric::Reset() {
-	pstat = pStatMetric_t(new statMetric_t);
-	for (uint8_t i = 0; i < sm_pstat.size(); ++i) {
-		sm_pstat[i] = pStatMetric_t(new statMetric_t);
-	}
 }
 
 MetricsCollector::PeriodMetric::PeriodMetric(
@@ -108,6 +303,9 @@ MetricsCollector::MetricsCollector() {
 	logger = bu::Logger::GetLogger(METRICS_COLLECTOR_NAMESPACE);
 	assert(logger);
 
+	for (size_t i = 0; i < BBQUE_MC_MAX_METRICS; ++i)
+		metricsTable[i].store(NULL, std::memory_order_relaxed);
+
 	//---------- Register commands
 	CommandManager &cm = CommandManager::GetInstance();
 	cm.RegisterCommand(MODULE_NAMESPACE ".report", static_cast<CommandHandler*>(this),
@@ -122,23 +320,12 @@ MetricsCollector::~MetricsCollector() {
 
 MetricsCollector::MetricHandler_t
 MetricsCollector::GetHandler(const char *name) {
-	return std::hash<const char *>()(name);
-}
-
-MetricsCollector::pMetric_t
-MetricsCollector::GetMetric(MetricHandler_t hdlr) {
-	MetricsMap_t::iterator it = metricsMap.find(hdlr);
+	MetricsNames_t::iterator it = metricsNames.find(name);
 	// Lookup for metrics
-	if (it != metricsMap.end())
+	if (it != metricsNames.end())
 		return (*it).second;
-	// Return NULL pointer
-	return pMetric_t();
-}
-
-MetricsCollector::pMetric_t
-MetricsCollector::GetMetric(const char *name) {
-	MetricHandler_t hdlr = GetHandler(name);
-	return GetMetric(hdlr);
+	// Not registered
+	return 0;
 }
 
 MetricsCollector::ExitCode_t
@@ -146,18 +333,26 @@ MetricsCollector::Register(const char *name, const char *desc,
 		MetricClass_t mc, MetricHandler_t & mh,
 		uint8_t count, const char **pdescs) {
 	std::unique_lock<std::mutex> metrics_ul(metrics_mtx);
-	pMetric_t pm = GetMetric(name);
+	MetricHandler_t registered_mh = GetHandler(name);
+	pMetric_t pm;
 
 	// Check if the metric has not yet been registered
-	if (pm) {
+	if (registered_mh) {
 		logger->Error("Metric [%s] registration FAILED "
 				"(Error: metric already registered)", name);
-		DB(assert(!pm));
+		DB(assert(!registered_mh));
+		mh = registered_mh;
 		return DUPLICATE;
 	}
 
+	// Check there is still room into the metrics table
+	if (metricsCount == BBQUE_MC_MAX_METRICS) {
+		logger->Error("Metric [%s] registration FAILED "
+				"(Error: too many metrics)", name);
+		return UNSUPPORTED;
+	}
+
 	// Build a new metric container
-	assert(!pm);
 	switch(mc) {
 	case COUNTER:
 		pm = pMetric_t(new CounterMetric(name, desc, count, pdescs));
@@ -177,13 +372,14 @@ MetricsCollector::Register(const char *name, const char *desc,
 		return UNSUPPORTED;
 	}
 
-	// Compute the metric handler
-	mh = GetHandler(name);
+	// The metric handler is its position into the metrics table
+	mh = ++metricsCount;
 
 	// Save the metric containter into proper map
 	assert(mc < CLASSES_COUNT);
-	metricsMap.insert(MetricsMapEntry_t(mh, pm));
+	metricsNames.insert(MetricsNames_t::value_type(name, mh));
 	metricsVec[mc].insert(MetricsMapEntry_t(mh, pm));
+	metricsTable[mh - 1].store(pm.get(), std::memory_order_release);
 
 	logger->Debug("New metric [%s:%s => %s] registered, "
 			"with [%d] sub-metrics",
@@ -213,8 +409,7 @@ MetricsCollector::Register(MetricsCollection_t *mc, uint8_t count) {
 
 MetricsCollector::ExitCode_t
 MetricsCollector::Count(MetricHandler_t mh, uint64_t amount, uint8_t idx) {
-	pMetric_t pm = GetMetric(mh);
-	CounterMetric *m;
+	Metric *pm = GetMetric(mh);
 
 	// Check if the metric has not yet been registered
 	if (!pm) {
@@ -231,16 +426,8 @@ MetricsCollector::Count(MetricHandler_t mh, uint64_t amount, uint8_t idx) {
 		return UNSUPPORTED;
 	}
 
-	// Lock this metric
-	std::unique_lock<std::mutex> ul(pm->mtx);
-
-	// Get the SAMPLE metrics
-	m = (CounterMetric*)pm.get();
-
-	// Increase the counter for the specified value
-	m->cnt += amount;
-	if (m->HasSubmetrics())
-		m->sm_cnt[idx] += amount;
+	// Increase the counter (of this thread) for the specified value
+	static_cast<CounterMetric *>(pm)->Count(amount, idx);
 
 	return OK;
 }
@@ -248,7 +435,7 @@ MetricsCollector::Count(MetricHandler_t mh, uint64_t amount, uint8_t idx) {
 MetricsCollector::ExitCode_t
 MetricsCollector::UpdateValue(MetricHandler_t mh, double amount,
 		uint8_t idx) {
-	pMetric_t pm = GetMetric(mh);
+	Metric *pm = GetMetric(mh);
 	ValueMetric *m;
 
 	// Check if the metric has not yet been registered
@@ -270,7 +457,7 @@ MetricsCollector::UpdateValue(MetricHandler_t mh, double amount,
 	std::unique_lock<std::mutex> ul(pm->mtx);
 
 	// Get the VALUE metric
-	m = (ValueMetric*)pm.get();
+	m = static_cast<ValueMetric *>(pm);
 
 	// Update the value if not zero, otherwise reset it
 	if (amount) {
@@ -316,8 +503,7 @@ MetricsCollector::Reset(MetricHandler_t mh, uint8_t idx) {
 MetricsCollector::ExitCode_t
 MetricsCollector::AddSample(MetricHandler_t mh,
 		double sample, uint8_t idx) {
-	pMetric_t pm = GetMetric(mh);
-	SamplesMetric *m;
+	Metric *pm = GetMetric(mh);
 
 	// Check if the metric has not yet been registered
 	if (!pm) {
@@ -334,16 +520,8 @@ MetricsCollector::AddSample(MetricHandler_t mh,
 		return UNSUPPORTED;
 	}
 
-	// Lock this metric
-	std::unique_lock<std::mutex> ul(pm->mtx);
-
-	// Get the SAMPLE metrics
-	m = (SamplesMetric*)pm.get();
-
-	// Push-in the new sample into the accumulator
-	(*m->pstat)(sample);
-	if (m->HasSubmetrics())
-		(*m->sm_pstat[idx])(sample);
+	// Push-in the new sample into the statistics (of this thread)
+	static_cast<SamplesMetric *>(pm)->Sample(sample, idx);
 
 	return OK;
 }
@@ -351,7 +529,7 @@ MetricsCollector::AddSample(MetricHandler_t mh,
 MetricsCollector::ExitCode_t
 MetricsCollector::PeriodSample(MetricHandler_t mh,
 		double & last_period, uint8_t idx) {
-	pMetric_t pm = GetMetric(mh);
+	Metric *pm = GetMetric(mh);
 	PeriodMetric *m;
 
 	// Check if the metric has not yet been registered
@@ -373,7 +551,7 @@ MetricsCollector::PeriodSample(MetricHandler_t mh,
 	std::unique_lock<std::mutex> ul(pm->mtx);
 
 	// Get the SAMPLE metrics
-	m = (PeriodMetric*)pm.get();
+	m = static_cast<PeriodMetric *>(pm);
 
 	// Start the submetrics sampling timer (if not already)
 	if (m->HasSubmetrics() &&
@@ -455,15 +633,15 @@ MetricsCollector::DumpCountSM(CounterMetric *m, uint8_t idx) {
 	}
 	// Dump sub-metric
 	logger->Notice(
-		" %-20s | %9 " PRIu64 " : %s",
-		_name, m->sm_cnt[idx], _desc);
+		" %-20s | %9" PRIu64 " : %s",
+		_name, m->Collect(1 + idx).count, _desc);
 }
 
 void
 MetricsCollector::DumpCounter(CounterMetric *m) {
 	logger->Notice(
 		" %-20s | %9" PRIu64 " : %s",
-		m->name, m->cnt, m->desc);
+		m->name, m->Collect(0).count, m->desc);
 
 	if (!m->HasSubmetrics())
 		return;
@@ -536,11 +714,12 @@ MetricsCollector::DumpSampleSM(SamplesMetric *m, uint8_t idx,
 	snprintf(ms.name, 21, "%s[%02hu]", m->name, idx);
 
 	// Get sub-metrics statistics
-	if (count(*m->sm_pstat[idx])) {
-		ms.min = min(*m->sm_pstat[idx]);
-		ms.max = max(*m->sm_pstat[idx]);
-		ms.avg = mean(*m->sm_pstat[idx]);
-		ms.var = variance(*m->sm_pstat[idx]);
+	SlotStats stats(m->Collect(1 + idx));
+	if (stats.count) {
+		ms.min = stats.min;
+		ms.max = stats.max;
+		ms.avg = stats.mean;
+		ms.var = stats.Variance();
 	} else {
 		ms.min = 0; ms.max = 0; ms.avg = 0; ms.var = 0;
 	}
@@ -570,12 +749,13 @@ MetricsCollector::DumpSampleSM(SamplesMetric *m, uint8_t idx,
 void
 MetricsCollector::DumpSample(SamplesMetric *m) {
 	MetricStats<double> ms;
+	SlotStats stats(m->Collect(0));
 
-	if (count(*m->pstat)) {
-		ms.min = min(*m->pstat);
-		ms.max = max(*m->pstat);
-		ms.avg = mean(*m->pstat);
-		ms.var = variance(*m->pstat);
+	if (stats.count) {
+		ms.min = stats.min;
+		ms.max = stats.max;
+		ms.avg = stats.mean;
+		ms.var = stats.Variance();
 	}
 	logger->Notice(
 		" %-20s | %9.3f | %9.3f | %9.3f | %9.3f : %s",
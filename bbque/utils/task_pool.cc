@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2012  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bbque/utils/task_pool.h"
+
+#include <algorithm>
+#include <sys/prctl.h>
+
+namespace bbque { namespace utils {
+
+thread_local TaskPool * TaskPool::current_pool = nullptr;
+
+thread_local int TaskPool::current_id = -1;
+
+
+TaskPool::TaskPool(unsigned int nr_workers, std::string const & name):
+		name(name),
+		next_queue(0),
+		pending(0),
+		executed(0),
+		stolen(0) {
+
+	if (nr_workers == 0)
+		nr_workers = std::max(1u, std::thread::hardware_concurrency());
+
+	for (unsigned int i = 0; i < nr_workers; ++i)
+		queues.emplace_back(new WorkQueue);
+	for (unsigned int i = 0; i < nr_workers; ++i)
+		threads.emplace_back(&TaskPool::Run, this, i);
+}
+
+TaskPool::~TaskPool() {
+	std::unique_lock<std::mutex> idle_ul(idle_mtx);
+	done = true;
+	idle_ul.unlock();
+	idle_cv.notify_all();
+
+	for (auto & worker: threads)
+		worker.join();
+}
+
+void TaskPool::Enqueue(Task_t && task) {
+	int id = SelfId();
+
+	// Tasks spawned by a worker stay local, the other ones are spread
+	if (id < 0)
+		id = next_queue.fetch_add(1) % queues.size();
+
+	WorkQueue & wq(*queues[id]);
+	std::unique_lock<std::mutex> wq_ul(wq.mtx);
+	wq.tasks.push_back(std::move(task));
+	++pending;
+	wq_ul.unlock();
+
+	// Acquire the lock to not miss a worker going idle right now
+	std::unique_lock<std::mutex> idle_ul(idle_mtx);
+	idle_ul.unlock();
+	idle_cv.notify_one();
+}
+
+bool TaskPool::RunPending(int id) {
+	Task_t task;
+	size_t nr_queues = queues.size();
+
+	// Own queue first (the most recent task)...
+	if (id >= 0) {
+		WorkQueue & wq(*queues[id]);
+		std::unique_lock<std::mutex> wq_ul(wq.mtx);
+		if (!wq.tasks.empty()) {
+			task = std::move(wq.tasks.back());
+			wq.tasks.pop_back();
+		}
+	}
+
+	// ...then steal the oldest task of another queue
+	for (size_t i = 1; !task && (i <= nr_queues); ++i) {
+		size_t victim = (id + i) % nr_queues;
+		WorkQueue & wq(*queues[victim]);
+		std::unique_lock<std::mutex> wq_ul(wq.mtx);
+		if (wq.tasks.empty())
+			continue;
+		task = std::move(wq.tasks.front());
+		wq.tasks.pop_front();
+		if (id >= 0)
+			++stolen;
+	}
+
+	if (!task)
+		return false;
+
+	--pending;
+	task();
+	++executed;
+	return true;
+}
+
+void TaskPool::Run(unsigned int id) {
+	std::string thread_name(name + std::to_string(id));
+	prctl(PR_SET_NAME, (long unsigned int) thread_name.c_str(), 0, 0, 0);
+
+	current_pool = this;
+	current_id   = id;
+
+	while (true) {
+		if (RunPending(id))
+			continue;
+
+		// Nothing to do: sleep until a new task is queued
+		std::unique_lock<std::mutex> idle_ul(idle_mtx);
+		idle_cv.wait(idle_ul, [this]() { return done || (pending > 0); });
+		if (done && (pending == 0))
+			break;
+	}
+}
+
+void TaskPool::ParallelFor(size_t first, size_t last,
+		std::function<void(size_t)> const & func) {
+
+	if (first >= last)
+		return;
+
+	// The state is shared with the helper tasks, which can still be
+	// running (just after the last index) when this call returns
+	struct ForState {
+		std::atomic<size_t> next;
+		std::atomic<size_t> running;
+		std::mutex mtx;
+		std::condition_variable cv;
+	};
+	auto state = std::make_shared<ForState>();
+	state->next = first;
+
+	auto body = [state, last, &func]() {
+		size_t idx;
+		while ((idx = state->next.fetch_add(1)) < last)
+			func(idx);
+	};
+
+	// One helper per worker, up to the number of indexes to process
+	size_t nr_helpers = std::min<size_t>(Workers(), last - first - 1);
+	state->running = nr_helpers;
+	for (size_t i = 0; i < nr_helpers; ++i) {
+		Enqueue([state, body]() {
+			body();
+			if (--state->running == 0) {
+				std::unique_lock<std::mutex> state_ul(state->mtx);
+				state->cv.notify_all();
+			}
+		});
+	}
+
+	// Take part to the execution, then wait for the helpers. The helpers
+	// not yet started are executed here, to not depend on the workers
+	// availability (the caller can be a worker itself).
+	body();
+	int id = SelfId();
+	while (state->running > 0) {
+		if (RunPending(id))
+			continue;
+		std::unique_lock<std::mutex> state_ul(state->mtx);
+		state->cv.wait(state_ul, [&state]() { return state->running == 0; });
+	}
+}
+
+} // namespace utils
+
+} // namespace bbque
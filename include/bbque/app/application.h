@@ -359,6 +359,36 @@ public:
 		rt_prof = rt_profile;
 	}
 
+#ifdef CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+	/**
+	 * @see ApplicationStatusIF
+	 */
+	inline bool GetRuntimeTelemetry(
+			rtlib::rtp_telemetry_sample_t & sample) const {
+		if (telemetry == nullptr)
+			return false;
+		return rtlib::rtp_telemetry_read(telemetry, sample);
+	}
+
+	/**
+	 * @brief Get the latest runtime profile, acknowledging the pending
+	 * runtime profile notification
+	 *
+	 * The RTLib does not send further notifications until the pending one
+	 * has been acknowledged.
+	 *
+	 * @param sample The profile to fill
+	 *
+	 * @return false if no profile is available
+	 */
+	inline bool ConsumeRuntimeTelemetry(rtlib::rtp_telemetry_sample_t & sample) {
+		if (telemetry == nullptr)
+			return false;
+		telemetry->notify_pending.store(0);
+		return rtlib::rtp_telemetry_read(telemetry, sample);
+	}
+#endif // CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+
 	/**
 	 * @brief Save predictions about profiling data
 	 *
@@ -459,6 +489,18 @@ private:
 
 	std::mutex rt_prof_mtx;
 
+#ifdef CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+	/**
+	 * The telemetry page published by the RTLib (if available)
+	 */
+	rtlib::rtp_telemetry_page_t * telemetry = nullptr;
+
+	/**
+	 * @brief Map the telemetry page published by the RTLib
+	 */
+	void AttachTelemetry();
+#endif
+
 #ifdef CONFIG_BBQUE_TG_PROG_MODEL
 	/**
 	 * Task-graph serialization file path
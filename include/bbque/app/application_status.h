@@ -27,6 +27,10 @@
 #include "bbque/rtlib.h"
 #include "tg/requirements.h"
 
+#ifdef CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+# include "bbque/rtlib/rtp_telemetry.h"
+#endif
+
 
 namespace bu = bbque::utils;
 
@@ -147,6 +151,22 @@ public:
 	virtual struct RuntimeProfiling_t GetRuntimeProfile(
 			bool mark_outdated = false) = 0;
 
+#ifdef CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+	/**
+	 * @brief Get the latest runtime profile published by the RTLib
+	 *
+	 * The profile is read from the telemetry page of the execution
+	 * context, i.e., it is updated at each processing cycle without any
+	 * RPC message.
+	 *
+	 * @param sample The profile to fill
+	 *
+	 * @return false if no profile is available
+	 */
+	virtual bool GetRuntimeTelemetry(
+			rtlib::rtp_telemetry_sample_t & sample) const = 0;
+#endif
+
 	/**
 	 * @brief SetRuntime Profile information for this app
 	 */
@@ -20,15 +20,21 @@
 
 #include "bbque/app/application.h"
 #include "bbque/command_manager.h"
+#include "bbque/utils/executor_pool.h"
+#include "bbque/utils/metrics_collector.h"
+#include "bbque/utils/timer.h"
 #include "bbque/utils/worker.h"
 #include "bbque/utils/logging/logger.h"
 #include "bbque/plugins/rpc_channel.h"
 #include "bbque/rtlib/rpc_messages.h"
+#include "bbque/cpp11/chrono.h"
 #include "bbque/cpp11/thread.h"
 #include "bbque/cpp11/future.h"
 
+#include <atomic>
 #include <map>
 #include <memory>
+#include <vector>
 
 #define APPLICATION_PROXY_NAMESPACE "bq.ap"
 
@@ -37,6 +43,8 @@ namespace bl = bbque::rtlib;
 namespace bp = bbque::plugins;
 namespace bu = bbque::utils;
 
+using bbque::utils::MetricsCollector;
+
 namespace bbque {
 
 
@@ -55,7 +63,7 @@ private:
 	plugins::RPCChannelIF *rpc;
 
 	typedef struct snCtx {
-		std::thread exe;
+		/** The session identifier (the token of the RPC messages) */
 		ba::AppPid_t pid;
 	} snCtx_t;
 
@@ -76,6 +84,11 @@ private:
 		pchMsg_t pmsg;
 	} cmdSn_t;
 
+	/**
+	 * A pointer to a command session. The session objects are recycled:
+	 * when the last reference is dropped, the object goes back to the
+	 * pool of free command sessions.
+	 */
 	typedef std::shared_ptr<cmdSn_t> pcmdSn_t;
 
 	typedef struct cmdRsp {
@@ -111,6 +124,17 @@ public:
  * Synchronization Protocol
  ******************************************************************************/
 
+	/** The time limit for collecting the responses of a protocol step */
+	typedef std::chrono::steady_clock::time_point SyncDeadline_t;
+
+	/**
+	 * @brief The deadline of a protocol step started now
+	 */
+	static inline SyncDeadline_t SyncDeadline() {
+		return std::chrono::steady_clock::now() +
+			std::chrono::milliseconds(BBQUE_SYNCP_TIMEOUT);
+	}
+
 //----- PreChange
 
 	/** The response to a PreChange command */
@@ -122,14 +146,21 @@ public:
 	typedef std::shared_ptr<preChangeRsp_t> pPreChangeRsp_t;
 
 	/**
-	 * @brief Synchronous PreChange
+	 * @brief Send a PreChange, without waiting for the response
+	 *
+	 * If the command has been sent, the response must be collected by
+	 * SyncP_PreChange_Collect. Posting the commands to all the EXCs before
+	 * collecting any response allows them to run their PreChange in
+	 * parallel.
 	 */
-	RTLIB_ExitCode SyncP_PreChange(ba::AppPtr_t papp, pPreChangeRsp_t presp);
+	RTLIB_ExitCode SyncP_PreChange_Post(ba::AppPtr_t papp, pPreChangeRsp_t presp);
 
 	/**
-	 * @brief Get the result of an issued Asynchronous PreChange
+	 * @brief Wait, up to the specified deadline, the response to a posted
+	 * PreChange
 	 */
-	RTLIB_ExitCode SyncP_PreChange_GetResult(pPreChangeRsp_t presp);
+	RTLIB_ExitCode SyncP_PreChange_Collect(pPreChangeRsp_t presp,
+			SyncDeadline_t deadline);
 
 //----- SyncChange
 
@@ -141,14 +172,19 @@ public:
 	typedef std::shared_ptr<syncChangeRsp_t> pSyncChangeRsp_t;
 
 	/**
-	 * @brief Synchronous SyncChange
+	 * @brief Send a SyncChange, without waiting for the response
+	 *
+	 * If the command has been sent, the response must be collected by
+	 * SyncP_SyncChange_Collect.
 	 */
-	RTLIB_ExitCode SyncP_SyncChange(ba::AppPtr_t papp, pSyncChangeRsp_t presp);
+	RTLIB_ExitCode SyncP_SyncChange_Post(ba::AppPtr_t papp, pSyncChangeRsp_t presp);
 
 	/**
-	 * @brief Get the result of an issued Asynchronous PreChange
+	 * @brief Wait, up to the specified deadline, the response to a posted
+	 * SyncChange
 	 */
-	RTLIB_ExitCode SyncP_SyncChange_GetResult(pSyncChangeRsp_t presp);
+	RTLIB_ExitCode SyncP_SyncChange_Collect(pSyncChangeRsp_t presp,
+			SyncDeadline_t deadline);
 
 //----- DoChange
 
@@ -180,13 +216,46 @@ public:
 	int CommandsCb(int argc, char *argv[]);
 private:
 
-	typedef std::shared_ptr<snCtx_t> psnCtx_t;
+	MetricsCollector & mc;
+
+	/**
+	 * @brief The executors of the sessions
+	 *
+	 * The requests coming from the applications and the commands sent to
+	 * them are served by two distinct pools, thus a request executor
+	 * waiting for a synchronization never holds back the commands of the
+	 * synchronization itself.
+	 */
+	typedef enum ExecType {
+		EXEC_REQUEST = 0,
+		EXEC_COMMAND,
+
+		EXEC_TYPE_COUNT
+	} ExecType_t;
+
+	std::unique_ptr<bu::ExecutorPool> executors[EXEC_TYPE_COUNT];
+
+	/** The identifier of the next command session */
+	std::atomic<bl::rpc_msg_token_t> next_token;
+
+	/** The command session objects ready to be reused */
+	std::vector<cmdSn_t *> cmdSnFree;
 
-	typedef std::map<uint8_t, psnCtx_t> snCtxMap_t;
+	std::mutex cmdSnFree_mtx;
 
-	snCtxMap_t snCtxMap;
+	typedef enum AppProxyMetrics {
+		//----- Sampling statistics
+		AP_RQS_QUEUE_DEPTH = 0,
+		AP_RQS_QUEUE_TIME,
+		AP_RQS_SERVICE_TIME,
+		AP_CMD_QUEUE_DEPTH,
+		AP_CMD_QUEUE_TIME,
+		AP_CMD_SERVICE_TIME,
 
-	std::mutex snCtxMap_mtx;
+		AP_METRICS_COUNT
+	} AppProxyMetrics_t;
+
+	static MetricsCollector::MetricsCollection_t metrics[AP_METRICS_COUNT];
 
 	typedef struct conCtx {
 		/** The applicaiton PID */
@@ -215,8 +284,8 @@ private:
 	/**
 	 * @brief	A multimap to track active Command Sessions.
 	 *
-	 * This multimap maps command session threads ID on the session data.
-	 * @param AppPid_t the command session thread ID
+	 * This multimap maps command session tokens on the session data.
+	 * @param AppPid_t the command session token
 	 * @param pcmdSn_t the command session handler
 	 */
 	typedef std::map<bl::rpc_msg_token_t, pcmdSn_t> cmdSnMap_t;
@@ -239,7 +308,30 @@ private:
  * Command Sessions
  ******************************************************************************/
 
-	inline pcmdSn_t SetupCmdSession(ba::AppPtr_t papp) const;
+	inline pcmdSn_t SetupCmdSession(ba::AppPtr_t papp);
+
+	/**
+	 * @brief Give back a command session object to the pool
+	 */
+	void RecycleCmdSession(cmdSn_t * pcs);
+
+	/**
+	 * @brief Wait for the response of a command session
+	 *
+	 * @param resp_ul The lock on the session response mutex
+	 *
+	 * @return false if the deadline expired without a response
+	 */
+	bool WaitResponse(pcmdSn_t pcs, std::unique_lock<std::mutex> & resp_ul,
+			SyncDeadline_t deadline);
+
+	/**
+	 * @brief Queue a job into the executors pool of the specified type
+	 *
+	 * The queuing time and the service time of the job are sampled. If the
+	 * queue is full, the job is served by a dedicated thread.
+	 */
+	void Dispatch(ExecType_t type, bu::ExecutorPool::Job_t job);
 
 	/**
 	 * @brief Enqueue a command session for response processing
@@ -248,12 +340,13 @@ private:
 	 * each response received from an applications should be dispatched to the
 	 * thread which generated the command. Thus, the execution context which
 	 * has generated a command must save a reference to itself for the proper
-	 * dispatching of resposes.
+	 * dispatching of resposes. Each session gets a unique token, which is
+	 * sent with the command and returned back with the response.
 	 *
 	 * @param pcs command session handler which is waiting for a response
 	 *
-	 * @note This method must be called from within the session execution
-	 * context, i.e. the command processing thread for asynchronous commands.
+	 * @note The session must be released, by ReleaseCommandSession, once
+	 * the response has been processed (or it is not expected anymore).
 	 */
 	inline void EnqueueHandler(pcmdSn_t pcs);
 
@@ -274,7 +367,7 @@ private:
 	 */
 	RTLIB_ExitCode_t Prof_GetRuntimeDataTrd(pcmdSn_t pcs);
 
-	RTLIB_ExitCode_t Prof_GetRuntimeDataSend(ba::AppPtr_t papp);
+	RTLIB_ExitCode_t Prof_GetRuntimeDataSend(pcmdSn_t pcs);
 
 	RTLIB_ExitCode_t Prof_GetRuntimeDataRecv(pcmdSn_t pcs);
 
@@ -287,21 +380,15 @@ private:
 
 	RTLIB_ExitCode SyncP_PreChangeSend(pcmdSn_t pcs);
 
-	RTLIB_ExitCode SyncP_PreChangeRecv(pcmdSn_t pcs, pPreChangeRsp_t preps);
-
-	RTLIB_ExitCode SyncP_PreChange(pcmdSn_t pcs, pPreChangeRsp_t presp);
-
-	void SyncP_PreChangeTrd(pPreChangeRsp_t presp);
+	RTLIB_ExitCode SyncP_PreChangeRecv(pcmdSn_t pcs, pPreChangeRsp_t preps,
+			SyncDeadline_t deadline);
 
 //----- SyncChange
 
 	RTLIB_ExitCode SyncP_SyncChangeSend(pcmdSn_t pcs);
 
-	RTLIB_ExitCode SyncP_SyncChangeRecv(pcmdSn_t pcs, pSyncChangeRsp_t preps);
-
-	RTLIB_ExitCode SyncP_SyncChange(pcmdSn_t pcs, pSyncChangeRsp_t presp);
-
-	void SyncP_SyncChangeTrd(pSyncChangeRsp_t presp);
+	RTLIB_ExitCode SyncP_SyncChangeRecv(pcmdSn_t pcs, pSyncChangeRsp_t preps,
+			SyncDeadline_t deadline);
 
 //----- DoChange
 
@@ -22,8 +22,10 @@
 #include <map>
 #include <memory>
 #include <set>
+#include <vector>
 
 #include "bbque/resource_accounter.h"
+#include "bbque/res/bitset.h"
 #include "bbque/utils/logging/logger.h"
 
 
@@ -58,6 +60,62 @@ using BindingInfo_t = BindingInfo;
 using BindingMap_t  = std::map<br::ResourceType, std::shared_ptr<BindingInfo_t>>;
 
 
+/**
+ * @class TopologyDomain
+ * @brief A domain of the hierarchical CPU topology of the local system
+ *
+ * The topology is a tree of four levels: NUMA node, last level cache
+ * (LLC) group, core and hardware thread. The LLC groups are the CPUs of the
+ * platform description, thus a domain can be bound to by selecting its CPU
+ * (cpu_ids) and then filtering the processing elements (pe_ids).
+ */
+class TopologyDomain {
+
+public:
+
+	enum Level_t {
+		NODE = 0,
+		LLC,
+		CORE,
+		THREAD,
+		LEVEL_COUNT
+	};
+
+	/** The topology level */
+	Level_t level;
+
+	/**
+	 * The domain ID: the memory ID of a node, the CPU ID of an LLC group,
+	 * the first processing element ID of a core or the processing element
+	 * ID of a hardware thread
+	 */
+	BBQUE_RID_TYPE id;
+
+	/** The memory (NUMA node) the domain is local to */
+	BBQUE_RID_TYPE mem_id;
+
+	/** The IDs of the CPUs (LLC groups) including the domain */
+	br::ResourceBitset cpu_ids;
+
+	/** The IDs of the processing elements of the domain */
+	br::ResourceBitset pe_ids;
+
+	/** Node level: the distances to the other nodes, by memory ID */
+	std::vector<uint32_t> distances;
+
+	/** The domain including this one (nullptr for nodes) */
+	TopologyDomain * parent = nullptr;
+
+	/** The domains of the next level included into this one */
+	std::vector<std::shared_ptr<TopologyDomain>> children;
+
+};
+
+using TopologyDomainPtr_t  = std::shared_ptr<TopologyDomain>;
+
+using TopologyDomainList_t = std::vector<TopologyDomainPtr_t>;
+
+
 /**
  * @class BindingManager
  *
@@ -79,6 +137,8 @@ public:
 
 	virtual ~BindingManager()  {
 		domains.clear();
+		for (auto & level_domains: topology)
+			level_domains.clear();
 	}
 
 	/**
@@ -97,6 +157,21 @@ public:
 		return domains;
 	}
 
+	/**
+	 * @brief The hierarchical topology of the local CPUs
+	 *
+	 * Only the processing elements available to the applications are
+	 * included. The list is empty if the platform description is not
+	 * available (legacy platform loader).
+	 *
+	 * @param level The topology level
+	 * @return The domains of the level, sorted by ID
+	 */
+	inline TopologyDomainList_t const & GetTopologyDomains(
+			TopologyDomain::Level_t level) const {
+		return topology[level];
+	}
+
 private:
 
 	std::unique_ptr<bu::Logger> logger;
@@ -109,6 +184,9 @@ private:
 	 */
 	BindingMap_t domains;
 
+	/** The topology domains, by level */
+	TopologyDomainList_t topology[TopologyDomain::LEVEL_COUNT];
+
 
 	BindingManager();
 
@@ -117,6 +195,11 @@ private:
 	 */
 	void InitBindingDomains();
 
+	/**
+	 * @brief Build the topology domains from the platform description
+	 */
+	void LoadTopologyDomains();
+
 };
 
 }
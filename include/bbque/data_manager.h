@@ -23,9 +23,13 @@
 #include "bbque/configuration_manager.h"
 #include "bbque/resource_accounter.h"
 #include "dci/types.h"
+#include "dci/status_frame.h"
 
 #include <atomic>
+#include <deque>
 #include <list>
+#include <map>
+#include <memory>
 #include <iostream>
 #include <fstream>
 #include <thread>
@@ -54,6 +58,12 @@ using namespace bbque::stat;
 
 #define MAX_SUB_COMM_FAILURE 5
 
+/** The maximum number of frames queued for a subscriber */
+#define BBQUE_DM_MAX_QUEUED_FRAMES 16
+
+/** The maximum number of terminated applications tracked for the deltas */
+#define BBQUE_DM_MAX_REMOVED_APPS  1024
+
 #define BBQUE_DM_ARCHIVE_PREFIX  BBQUE_PATH_PREFIX"/var/dm_archive_"
 
 namespace bbque {
@@ -61,6 +71,118 @@ namespace data {
 
 using sub_bitset_t = std::bitset<8>;
 
+/// An encoded status frame, shared by all the subscribers it is sent to
+using FramePtr_t = std::shared_ptr<const std::string>;
+
+/**
+ * @class SubscriberConnection
+ * @brief The persistent data connection towards a subscriber
+ *
+ * The connection is opened at the first publication, and then kept open
+ * to send all the following status frames. All the socket operations are
+ * performed asynchronously by the DataManager event loop thread, while the
+ * frames can be sent from any thread.
+ *
+ * Since a DELTA frame is meaningful only on top of the previous one, the
+ * connection drops the DELTA frames not following the last queued frame
+ * (e.g., after a reconnection or when the client is too slow), and it
+ * requests the publisher to send a FULL frame instead. The same happens
+ * when the client asks for the whole status.
+ */
+class SubscriberConnection:
+		public std::enable_shared_from_this<SubscriberConnection> {
+public:
+
+	SubscriberConnection(
+			boost::asio::io_service & ios,
+			std::string const & ip,
+			uint32_t port,
+			bu::Logger * logger);
+
+	/**
+	 * @brief Queue a frame for the transmission
+	 * @param frame The encoded frame
+	 * @param seq The status sequence number of the frame
+	 * @param base_seq The sequence number the DELTA frame applies to, 0 for
+	 * a FULL frame
+	 */
+	void Send(FramePtr_t frame, uint32_t seq, uint32_t base_seq);
+
+	/**
+	 * @brief Close the connection and drop the queued frames
+	 */
+	void Close();
+
+	/**
+	 * @brief Check if the next frame must be a FULL one
+	 *
+	 * This returns true only once for each resynchronization request.
+	 */
+	inline bool TakeResync() {
+		return resync.exchange(false);
+	}
+
+	/**
+	 * @brief The number of consecutive communication failures
+	 */
+	inline uint16_t Failures() const {
+		return failures;
+	}
+
+private:
+
+	enum class State {
+		DISCONNECTED,
+		CONNECTING,
+		CONNECTED
+	};
+
+	boost::asio::io_service & ios;
+
+	boost::asio::ip::tcp::socket socket;
+
+	std::string ip_address;
+
+	uint32_t port_num;
+
+	bu::Logger * logger;
+
+	/* The following attributes are accessed only by the event loop */
+
+	State state = State::DISCONNECTED;
+
+	bool closed = false;
+
+	/// A write operation is in progress on the front frame
+	bool writing = false;
+
+	/// The frames waiting for the transmission
+	std::deque<FramePtr_t> queue;
+
+	/// The sequence number of the last queued frame
+	uint32_t tail_seq = 0;
+
+	/// Buffer for the client requests, and to detect the closing of the
+	/// connection
+	char hangup_byte;
+
+	/// A FULL frame is required
+	std::atomic<bool> resync;
+
+	std::atomic<uint16_t> failures;
+
+	void Enqueue(FramePtr_t frame, uint32_t seq, uint32_t base_seq);
+
+	bool Connect();
+
+	void WaitHangup();
+
+	void WriteNext();
+
+	void Reset();
+};
+
+
 /**
  * @class Subscription
  * @brief Subscription objects for data requests
@@ -108,6 +230,10 @@ public:
 	Subscription subscription;        /// Information subscribed data
 	int16_t      period_deadline_ms;  /// Milliseconds before next update
 	uint16_t     comm_failures = 0;   /// Number of communication failures
+	uint32_t     last_seq = 0;        /// Sequence number of the last frame sent
+
+	/// Persistent data connection (not checkpointed)
+	std::shared_ptr<SubscriberConnection> connection;
 
 	bool cmp(Subscriber & s1, Subscriber & s2) {
 		if(s1.period_deadline_ms < s2.period_deadline_ms)
@@ -143,6 +269,7 @@ using SubscriberPtr_t     = boost::shared_ptr<Subscriber>;
 using SubscriberPtrList_t = std::list<SubscriberPtr_t>;
 using sockaddr_in_t       = struct sockaddr_in;
 using SubscriberListIt_t  = std::list<SubscriberPtr_t>::iterator;
+using FrameKey_t          = std::pair<uint32_t, uint8_t>;
 
 /**
  * @class DataManager
@@ -208,6 +335,15 @@ private:
 	/// Time interval between different data publishing
 	uint16_t actual_sleep_time;
 
+	/// Event loop multiplexing the data connections of all the subscribers
+	boost::asio::io_service connections_ios;
+
+	/// Keep the event loop running while there are no connections
+	std::unique_ptr<boost::asio::io_service::work> connections_work;
+
+	/// The event loop thread
+	std::thread connections_loop;
+
 	/// List of rate-based subscribers
 	SubscriberPtrList_t subscribers_on_rate;
 
@@ -239,6 +375,37 @@ private:
 	/// The number of current managed applications
 	uint32_t num_applications;
 
+	/**
+	 * @struct StatusRecord_t
+	 * @brief The encoding of a resource or application status, and the
+	 * sequence number of the status update in which it last changed
+	 */
+	struct StatusRecord_t {
+		std::string encoded;
+		uint32_t seq;
+	};
+
+	/// Mutex to protect the status records and the frames cache
+	std::mutex status_mtx;
+
+	/// Sequence number of the last status update
+	uint32_t status_seq = 0;
+
+	/// DELTA frames cannot be built on top of a status older than this
+	uint32_t delta_horizon_seq = 0;
+
+	/// The status records of the resources, by resource bitset
+	std::map<res_bitset_t, StatusRecord_t> res_records;
+
+	/// The status records of the running applications, by id
+	std::map<uint64_t, StatusRecord_t> app_records;
+
+	/// The terminated applications, with the update of their removal
+	std::map<uint64_t, uint32_t> app_removed;
+
+	/// The frames built from the last status update, by (base_seq, filter)
+	std::map<FrameKey_t, FramePtr_t> frames_cache;
+
 	/// Mutex to protect concurrent access to the event map
 	std::mutex events_mtx;
 
@@ -345,11 +512,33 @@ private:
 	 */
 	ExitCode_t Push(SubscriberPtr_t sub);
 
+	/**
+	 * @brief Get the frame carrying the current status
+	 *
+	 * The frame is encoded only once per status update, and then shared
+	 * among all the subscribers having the same filter and base status.
+	 * The status_mtx must be held.
+	 *
+	 * @param base_seq The status already known by the subscriber, 0 to
+	 * get a FULL frame
+	 * @param filter The sections to include
+	 * @param seq The sequence number of the status carried by the frame
+	 * @return the encoded frame
+	 */
+	FramePtr_t GetStatusFrame(
+			uint32_t & base_seq, data::sub_bitset_t filter, uint32_t & seq);
+
 	/**
 	 * @brief Update the content data information
 	 */
 	void UpdateData();
 
+	/**
+	 * @brief Update the encoded status records, marking the changed ones
+	 * with a new status sequence number
+	 */
+	void UpdateStatusRecords();
+
 	/**
 	 * @brief Update the content of resources data information
 	 */
@@ -0,0 +1,277 @@
+/*
+ * Copyright (C) 2016  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BBQUE_EVENT_JOURNAL_H_
+#define BBQUE_EVENT_JOURNAL_H_
+
+#include "bbque/em/event.h"
+#include "bbque/utils/logging/logger.h"
+#include "bbque/cpp11/condition_variable.h"
+#include "bbque/cpp11/mutex.h"
+#include "bbque/cpp11/thread.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/** The file extension of a journal segment */
+#define EVENT_JOURNAL_SEGMENT_EXT ".evj"
+/** The file extension of a journal segment index */
+#define EVENT_JOURNAL_INDEX_EXT ".evi"
+
+/** The maximum size of a journal segment [bytes] */
+#define EVENT_JOURNAL_SEGMENT_SIZE (8 * 1024 * 1024)
+/** The number of records between two index entries */
+#define EVENT_JOURNAL_INDEX_STRIDE 64
+/** The maximum time the events are buffered before being written [ms] */
+#define EVENT_JOURNAL_FLUSH_PERIOD 1000
+/** The amount of buffered events triggering an early write [bytes] */
+#define EVENT_JOURNAL_FLUSH_SIZE (64 * 1024)
+
+#define EVENT_JOURNAL_MAGIC "BBQEVJ01"
+#define EVENT_JOURNAL_VERSION 1
+
+namespace bu = bbque::utils;
+
+namespace bbque {
+
+namespace em {
+
+/**
+ * @brief The header of a journal segment file
+ */
+typedef struct JournalHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t segment_id;
+} JournalHeader_t;
+
+/**
+ * @brief An entry of a journal segment index
+ *
+ * The index file is a plain array of entries, one each
+ * EVENT_JOURNAL_INDEX_STRIDE records of the segment.
+ */
+typedef struct JournalIndexEntry {
+	/** The timestamp of the record [ms] */
+	int64_t timestamp;
+	/** The offset of the record into the segment file */
+	uint64_t offset;
+} JournalIndexEntry_t;
+
+/**
+ * @class EventJournal
+ *
+ * @brief An append-only binary journal of events
+ *
+ * Each event is encoded into a length-prefixed binary record, which is
+ * appended to an in-memory buffer. A flusher thread writes the buffered
+ * records to the current segment file, either periodically or when the
+ * buffer grows too much. The segment files are rotated once they reach
+ * EVENT_JOURNAL_SEGMENT_SIZE, and each of them comes with a sparse index of
+ * the records timestamps, thus a reader can map a segment and seek to a
+ * given time without decoding all the previous records.
+ *
+ * A journal is a set of files in the same folder, named:
+ * <name>.<segment_id>.evj (records) and <name>.<segment_id>.evi (index)
+ */
+class EventJournal {
+
+public:
+
+	/**
+	 * @brief Open a new journal
+	 *
+	 * @param folder The folder of the journal files
+	 * @param name The base name of the journal files
+	 */
+	EventJournal(std::string const & folder, std::string const & name);
+
+	/**
+	 * @brief Write the pending events and close the journal
+	 */
+	~EventJournal();
+
+	/**
+	 * @brief Append an event to the journal
+	 *
+	 * The event is just encoded and buffered, the write is performed by the
+	 * flusher thread.
+	 */
+	void Append(Event const & event);
+
+	/**
+	 * @brief Wait for all the events appended so far to be written
+	 */
+	void Flush();
+
+	/**
+	 * @brief The base path (folder and name) of the journal files
+	 */
+	inline std::string const & BasePath() const {
+		return base_path;
+	}
+
+	/**
+	 * @brief The path of a journal segment file
+	 */
+	static std::string SegmentPath(std::string const & base_path, uint32_t id);
+
+	/**
+	 * @brief The path of a journal segment index file
+	 */
+	static std::string IndexPath(std::string const & base_path, uint32_t id);
+
+	/**
+	 * @brief Encode an event, appending the record to a buffer
+	 */
+	static void Encode(Event const & event, std::vector<char> & buffer);
+
+	/**
+	 * @brief Decode the payload of a record
+	 *
+	 * @return false if the record is malformed
+	 */
+	static bool Decode(const char * payload, size_t size, Event & event);
+
+private:
+
+	std::unique_ptr<bu::Logger> logger;
+
+	std::string base_path;
+
+	/** The events encoded and not yet written */
+	std::vector<char> pending;
+
+	/** The number of Flush() requests, and the number of served ones */
+	uint64_t flush_requested = 0;
+	uint64_t flush_served = 0;
+
+	bool done = false;
+
+	std::mutex pending_mtx;
+
+	/** Wake up the flusher thread */
+	std::condition_variable pending_cv;
+
+	/** Notify the completion of a write */
+	std::condition_variable flushed_cv;
+
+	std::thread flusher;
+
+	/** The current segment (accessed only by the flusher thread) */
+	uint32_t segment_id = 0;
+	int segment_fd = -1;
+	int index_fd = -1;
+	uint64_t segment_size = 0;
+	uint64_t segment_records = 0;
+
+	/**
+	 * @brief Close the current segment and open the next one
+	 */
+	bool RotateSegment();
+
+	void CloseSegment();
+
+	/**
+	 * @brief Write a buffer of records into the segments
+	 */
+	void WriteRecords(std::vector<char> const & records);
+
+	/**
+	 * @brief The flusher thread loop
+	 */
+	void Flusher();
+
+};
+
+/**
+ * @class EventJournalReader
+ *
+ * @brief Read the events of a journal
+ *
+ * The segment files are memory mapped, and the index is used to skip the
+ * records before the beginning of the requested time window.
+ */
+class EventJournalReader {
+
+public:
+
+	typedef std::function<void(Event const &)> EventHandler_t;
+
+	/**
+	 * @brief Build a reader of a journal
+	 *
+	 * @param path The base path of the journal files, or the path of any
+	 * of its segments
+	 */
+	EventJournalReader(std::string const & path);
+
+	/**
+	 * @brief Check if a path refers to a journal
+	 */
+	static bool IsJournal(std::string const & path);
+
+	/**
+	 * @brief The number of segments of the journal
+	 */
+	inline size_t Segments() const {
+		return segments.size();
+	}
+
+	/**
+	 * @brief Visit the events in the specified time window, in the journal
+	 * order (i.e. chronological)
+	 *
+	 * @param from The first timestamp of the window [ms]
+	 * @param to The last timestamp of the window [ms]
+	 *
+	 * @return the number of visited events
+	 */
+	size_t ForEach(EventHandler_t handler,
+			int64_t from = INT64_MIN, int64_t to = INT64_MAX) const;
+
+	/**
+	 * @brief Read the events in the specified time window
+	 */
+	std::vector<Event> Read(
+			int64_t from = INT64_MIN, int64_t to = INT64_MAX) const;
+
+private:
+
+	std::string base_path;
+
+	/** The ids of the segments, in order */
+	std::vector<uint32_t> segments;
+
+	/**
+	 * @brief Visit the events of a segment
+	 *
+	 * @return false if a record following the window has been found
+	 */
+	bool ForEachInSegment(uint32_t id, EventHandler_t & handler,
+			int64_t from, int64_t to, size_t & count) const;
+
+};
+
+} // namespace em
+
+} // namespace bbque
+
+#endif // BBQUE_EVENT_JOURNAL_H_
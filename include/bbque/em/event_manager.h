@@ -20,9 +20,12 @@
 
 #include "bbque/config.h"
 #include "bbque/em/event.h"
+#include "bbque/em/event_journal.h"
 #include "bbque/em/event_wrapper.h"
 #include "bbque/utils/logging/logger.h"
 
+#include <memory>
+
 namespace bu = bbque::utils;
 
 #define EVENT_MANAGER_NAMESPACE "bq.em"
@@ -51,7 +54,7 @@ public:
 	/**
 	 * @brief Destructor
 	 */
-	virtual ~EventManager() {}
+	virtual ~EventManager();
 
 	/**
 	 * @brief Get the EventManager instance
@@ -60,7 +63,8 @@ public:
 
 	/**
 	 * @brief Set the archive path to which the EventManager points to
-	 * @param archive name of the archive
+	 * @param archive name of the archive, either a text archive or an
+	 * events journal (base name or any of its segments)
 	 */
 	void SetArchive(std::string archive);
 
@@ -84,21 +88,35 @@ public:
 
 	/**
 	 * @brief Push
+	 *
+	 * The event is appended to the events journal, without reading back
+	 * the previous ones.
+	 *
 	 * @param event The event to push
 	 */
 	void Push(Event event);
 
 	/**
-	 * @brief Serialize
+	 * @brief Serialize into a text archive
 	 * @param ew The eventWrapper to serialize
+	 * @param path The text archive path (the current archive if empty)
 	 */
-	void Serialize(EventWrapper ew);
+	void Serialize(EventWrapper ew, std::string const & path = "");
 
 	/**
-	 * @brief Deserialize
+	 * @brief Deserialize the current archive
+	 *
+	 * The archive can be either a text archive or an events journal.
 	 */
 	EventWrapper Deserialize();
 
+	/**
+	 * @brief Export the events journal into a text archive
+	 * @param path The text archive path
+	 * @return false if there are not events to export
+	 */
+	bool Export(std::string const & path);
+
 private:
 
 	/**
@@ -116,6 +134,11 @@ private:
 	 */
 	std::string archive_folder_path = ARCHIVE_FOLDER;
 
+	/**
+	 * @brief The journal of the events pushed by this instance
+	 */
+	std::unique_ptr<EventJournal> journal;
+
 };
 
 } // namespace em
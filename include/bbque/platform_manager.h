@@ -83,6 +83,19 @@ public:
 	virtual ExitCode_t MapResources(
 		SchedPtr_t papp, ResourceAssignmentMapPtr_t pres, bool excl = true) override;
 
+	/**
+	 * @brief Start a batch of resource bindings
+	 */
+	virtual ExitCode_t MapResourcesStart() override;
+
+	/**
+	 * @brief Enforce the resource bindings of the current batch
+	 *
+	 * @param failed_apps Filled with the applications whose bindings
+	 * have not been enforced
+	 */
+	virtual ExitCode_t MapResourcesCommit(std::list<SchedPtr_t> & failed_apps) override;
+
 	/**
 	 * @brief Check if the resource is a "high-performance" is single-ISA
 	 * heterogeneous platforms
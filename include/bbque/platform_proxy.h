@@ -25,6 +25,7 @@
 #include "bbque/pp/platform_description.h"
 
 #include <cstdint>
+#include <list>
 
 #define PLATFORM_PROXY_NAMESPACE "bq.pp"
 
@@ -118,6 +119,29 @@ public:
 	virtual ExitCode_t MapResources(
 			SchedPtr_t papp, ResourceAssignmentMapPtr_t pres, bool excl = true) = 0;
 
+	/**
+	 * @brief Start a batch of resource bindings
+	 *
+	 * The bindings requested by the following MapResources() and
+	 * ReclaimResources() calls can be enforced at the MapResourcesCommit()
+	 * call, in a single pass. The default implementation enforces each
+	 * binding immediately.
+	 */
+	virtual ExitCode_t MapResourcesStart() {
+		return PLATFORM_OK;
+	}
+
+	/**
+	 * @brief Enforce the resource bindings of the current batch
+	 *
+	 * @param failed_apps Filled with the applications whose bindings
+	 * have not been enforced
+	 */
+	virtual ExitCode_t MapResourcesCommit(std::list<SchedPtr_t> & failed_apps) {
+		(void) failed_apps;
+		return PLATFORM_OK;
+	}
+
 	/**
 	 * @brief Graceful closure of the platform proxy
 	 */
@@ -18,7 +18,9 @@
 #ifndef BBQUE_POWER_MANAGER_CPU_H_
 #define BBQUE_POWER_MANAGER_CPU_H_
 
+#include <chrono>
 #include <map>
+#include <mutex>
 #include <vector>
 
 #include "bbque/pm/power_manager.h"
@@ -205,10 +207,36 @@ protected:
 	 * (processor activity in 'jitters')
 	 */
 	struct LoadInfo {
-		int32_t total = 0;
-		int32_t idle  = 0;
+		uint64_t total = 0;
+		uint64_t idle  = 0;
 	};
 
+	/**
+	 * @struct LoadSampler_t
+	 * @brief System-wide snapshot of the CPU cores load
+	 *
+	 * A single read of /proc/stat updates the load of all the cores,
+	 * computed from the variation of the counters since the previous read.
+	 * The file is read again only when the load of a core is required a
+	 * second time (i.e., in the next monitoring period).
+	 */
+	struct LoadSampler_t {
+		std::mutex mtx;
+		/** Time of the last read */
+		std::chrono::steady_clock::time_point last_read;
+		/** Counters of the last read, per CPU core */
+		std::vector<LoadInfo> counters;
+		/** Load [%] per CPU core (-1 if not available) */
+		std::vector<int32_t> load;
+		/** True if the load has been returned since the last read */
+		std::vector<bool> consumed;
+		/** Content of /proc/stat */
+		std::vector<char> buffer;
+	};
+
+	/*** CPU cores load snapshot */
+	mutable LoadSampler_t load_sampler;
+
 
 	void InitCoreIdMapping();
 
@@ -222,14 +250,20 @@ protected:
 	void _GetAvailableFrequencies(int cpu_id, std::shared_ptr<std::vector<uint32_t>> v);
 
 	/**
-	 *  Sample CPU activity samples from /proc/stat
+	 *  Get the load of a CPU core from the snapshot, updating it if needed
 	 */
 	PMResult GetLoadCPU(BBQUE_RID_TYPE cpu_core_id, uint32_t & load) const;
 
 	/**
-	 *  Sample CPU activity samples from /proc/stat
+	 *  Get the load of a CPU core, with the snapshot lock already held
+	 */
+	PMResult _GetLoadCPU(BBQUE_RID_TYPE cpu_core_id, uint32_t & load) const;
+
+	/**
+	 *  Sample CPU activity samples of all the cores from /proc/stat, and
+	 *  update the load snapshot
 	 */
-	ExitStatus GetLoadInfo(LoadInfo *info, BBQUE_RID_TYPE cpu_core_id) const;
+	ExitStatus SampleLoad() const;
 
 	/**
 	 *  Set Cpufreq scaling governor for PE pe_id
@@ -259,6 +259,28 @@ private:
 	 */
 	uint16_t nr_threads = 1;
 
+	/**
+	 * @struct SamplingControl_t
+	 * @brief Synchronization of the sampler threads on the monitoring period
+	 *
+	 * The sampler threads are started once, each one with a fixed range of
+	 * resources. At the beginning of each period the monitor thread bumps
+	 * the period counter, and then waits for all the samplers to complete.
+	 */
+	struct SamplingControl_t {
+		std::mutex mtx;
+		std::condition_variable start_cv; /** New period started         */
+		std::condition_variable end_cv;   /** All the samplers completed */
+		uint32_t period = 0;              /** Current period counter     */
+		uint16_t pending = 0;             /** Samplers not completed yet */
+		bool stop = false;                /** Samplers must terminate    */
+	} sampling;
+
+	/**
+	 * @brief The sampler threads
+	 */
+	std::vector<std::thread> samplers;
+
 	/**
 	 * @brief Keep track of sending status of an optimization request
 	 */
@@ -318,10 +340,41 @@ private:
 	/**
 	 * @brief Sample the power-thermal status information
 	 *
+	 * @param thd_id Identifier of the sampler thread (for logging)
+	 * @param first_resource_index First resource to monitor (from reg. index)
+	 * @param last_resource_index Last resource to monitor (from reg. array)
+	 */
+	void SampleResourcesStatus(
+			uint16_t thd_id,
+			uint16_t first_resource_index,
+			uint16_t last_resource_index);
+
+	/**
+	 * @brief Sampler thread: sample a fixed range of resources at each
+	 * monitoring period
+	 *
+	 * @param thd_id Identifier of the sampler thread
 	 * @param first_resource_index First resource to monitor (from reg. index)
 	 * @param last_resource_index Last resource to monitor (from reg. array)
+	 * @param start_period The sampling period at the time the thread has
+	 * been started, i.e. the one preceding its first period
+	 */
+	void SamplerLoop(
+			uint16_t thd_id,
+			uint16_t first_resource_index,
+			uint16_t last_resource_index,
+			uint32_t start_period);
+
+	/**
+	 * @brief Start the sampler threads, splitting the registered resources
+	 * in contiguous ranges
+	 */
+	void StartSamplers();
+
+	/**
+	 * @brief Terminate the sampler threads
 	 */
-	void SampleResourcesStatus(uint16_t first_resource_index, uint16_t last_resource_index);
+	void StopSamplers();
 
 	/**
 	 * @brief Periodic task
@@ -0,0 +1,296 @@
+/*
+ * Copyright (C) 2016  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BBQUE_LINUX_CGROUP_ACTUATOR_H_
+#define BBQUE_LINUX_CGROUP_ACTUATOR_H_
+
+#include "bbque/config.h"
+#include "bbque/utils/logging/logger.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <sys/types.h>
+
+#define LINUX_CG_ACTUATOR_NAMESPACE "bq.pp.linux.cg"
+
+/** The default mount point of the control groups file-system(s) */
+#define BBQUE_LINUXPP_CGROUP_ROOT "/sys/fs/cgroup"
+
+namespace bu = bbque::utils;
+
+namespace bbque {
+namespace pp {
+
+/**
+ * @class CGroupActuator
+ * @brief Write the control groups attributes through the kernel interface
+ *
+ * The values of the attributes are not written as soon as they are set, but
+ * staged and then enforced by Commit(), in a single pass for all the
+ * control groups updated in the meantime. Only the attributes whose staged
+ * value differs from the last one successfully written are actually
+ * updated, and each attribute file is opened once and then kept open for
+ * the lifetime of the control group. The same holds for the tasks
+ * assignment: a process is moved only if not already into the target
+ * control group.
+ *
+ * Both the legacy (v1) hierarchies, whose mount points are retrieved by
+ * the libcgroup, and the unified (v2) hierarchy are supported. The latter
+ * is detected at initialization time, and it is used whenever mounted on
+ * BBQUE_LINUXPP_CGROUP_ROOT.
+ *
+ * @note The applied state is tracked assuming the BarbequeRTRM is the only
+ * writer of its control groups.
+ */
+class CGroupActuator {
+
+public:
+
+	typedef enum ExitCode {
+		OK = 0,
+		NOT_MOUNTED,
+		WRITE_FAILED
+	} ExitCode_t;
+
+	/** The controllers used */
+	typedef enum Controller {
+		CG_CPUSET = 0,
+		CG_CPU,
+		CG_MEMORY,
+		CG_NET_CLS,
+		CG_CONTROLLERS
+	} Controller_t;
+
+	/**
+	 * The controlled attributes. Attributes are written in the
+	 * following order.
+	 */
+	typedef enum Attribute {
+		CPUSET_CPUS = 0,
+		CPUSET_MEMS,
+		CPU_PERIOD,    /**< v1 only: on v2 the period is part of CPU_QUOTA */
+		CPU_QUOTA,
+		MEMORY_LIMIT,
+		NET_CLASSID,   /**< v1 only */
+		ATTRIBUTES_COUNT
+	} Attribute_t;
+
+	/**
+	 * @class CGroup
+	 * @brief A control group, along with its applied and staged state
+	 *
+	 * The kernel control group is removed on destruction.
+	 */
+	class CGroup {
+
+	friend class CGroupActuator;
+
+	public:
+
+		~CGroup();
+
+		/** The path, relative to the hierarchy root */
+		inline const char * Path() const {
+			return path.c_str();
+		}
+
+		/** True if the attribute is provided by the kernel */
+		inline bool IsAvailable(Attribute_t attr) const {
+			return available & (1 << attr);
+		}
+
+		/** True if the last write of its attributes failed */
+		inline bool Failed() const {
+			return failed;
+		}
+
+	private:
+
+		CGroup(CGroupActuator * owner, std::string const & path);
+
+		CGroupActuator * owner;
+
+		std::string path;
+
+		/** The directories, one per controller hierarchy (empty if unused) */
+		std::string dirs[CG_CONTROLLERS];
+
+		/** Attribute files, opened at the first write */
+		int fds[ATTRIBUTES_COUNT];
+
+		/** The "cgroup.procs" files, one per hierarchy */
+		int procs_fds[CG_CONTROLLERS];
+
+		/** The values successfully written */
+		std::string applied[ATTRIBUTES_COUNT];
+
+		/** The values to write at the next Commit() */
+		std::string staged[ATTRIBUTES_COUNT];
+
+		/** Bitmask of the attributes whose applied value is known */
+		uint32_t valid = 0;
+
+		/** Bitmask of the staged attributes differing from the applied ones */
+		uint32_t dirty = 0;
+
+		/** Bitmask of the attributes provided by the kernel */
+		uint32_t available = 0;
+
+		/** Waiting for the next Commit() */
+		bool pending = false;
+
+		bool failed = false;
+	};
+
+	using CGroupPtr_t = std::shared_ptr<CGroup>;
+
+
+	CGroupActuator();
+
+	/**
+	 * @brief Detect the mounted hierarchies
+	 */
+	ExitCode_t Init();
+
+	/** True if running on the cgroup v2 unified hierarchy */
+	inline bool IsUnified() const {
+		return unified;
+	}
+
+	/**
+	 * @brief Create a control group (if not existing)
+	 *
+	 * @param cg_path The path, relative to the hierarchy root
+	 * @return The control group, nullptr in case of error
+	 */
+	CGroupPtr_t Create(const char * cg_path);
+
+	/**
+	 * @brief Stage the value of an attribute
+	 *
+	 * Values must be formatted as expected by the mounted hierarchy (see
+	 * SetCPUQuota() and SetMemoryLimit() for the attributes whose format
+	 * differs between v1 and v2).
+	 */
+	void Set(CGroupPtr_t const & pcg, Attribute_t attr, std::string const & value);
+
+	/**
+	 * @brief Stage the CFS bandwidth of a control group
+	 *
+	 * @param quota_us The quota [us], negative for no quota
+	 * @param period_us The period [us]
+	 */
+	void SetCPUQuota(CGroupPtr_t const & pcg, int64_t quota_us, uint32_t period_us);
+
+	/**
+	 * @brief Stage the memory limit of a control group
+	 *
+	 * @param bytes The limit, not positive for no limit
+	 */
+	void SetMemoryLimit(CGroupPtr_t const & pcg, int64_t bytes);
+
+	/**
+	 * @brief Stage the assignment of a process to a control group
+	 *
+	 * Processes are moved after all the attributes have been written.
+	 */
+	void Attach(CGroupPtr_t const & pcg, pid_t pid);
+
+	/**
+	 * @brief Forget about the assignment of a (terminated) process
+	 *
+	 * This must be called when a process exits, since its PID could be
+	 * reused.
+	 */
+	void Forget(pid_t pid);
+
+	/**
+	 * @brief Write all the staged attributes and move the processes
+	 *
+	 * The control groups whose attributes have not been written are marked
+	 * as failed (@see CGroup::Failed()), and the processes to move into
+	 * them are not moved.
+	 *
+	 * @param failed_pids Filled with the processes not moved
+	 * @return OK if all the writes succeeded, WRITE_FAILED otherwise
+	 */
+	ExitCode_t Commit(std::unordered_set<pid_t> & failed_pids);
+
+private:
+
+	std::unique_ptr<bu::Logger> logger;
+
+	/**
+	 * Mutual exclusion on the staged state, since processes can be
+	 * reclaimed outside of the synchronization sessions
+	 */
+	std::mutex cg_mtx;
+
+	bool unified = false;
+
+	/** The hierarchy mount points, one per controller (empty if unused) */
+	std::string mounts[CG_CONTROLLERS];
+
+	/** The controllers whose hierarchy hosts the tasks assignment */
+	bool procs_owner[CG_CONTROLLERS];
+
+	/** Unified hierarchy: directories with controllers already enabled */
+	std::unordered_set<std::string> enabled_dirs;
+
+	/** The control groups with staged attributes */
+	std::vector<CGroupPtr_t> pending;
+
+	/** The staged processes assignments */
+	std::unordered_map<pid_t, CGroupPtr_t> moves;
+
+	/** The applied processes assignments */
+	std::unordered_map<pid_t, CGroup const *> placement;
+
+	/**
+	 * @brief Enable the controllers for the children of each directory along
+	 * the path (unified hierarchy only)
+	 */
+	void EnableControllers(std::string const & cg_path);
+
+	/**
+	 * @brief Write a value into a (cached) attribute file
+	 *
+	 * @return false in case of error
+	 */
+	bool Write(int & fd, std::string const & dir, const char * file,
+			std::string const & value);
+
+	/**
+	 * @brief Drop any reference to a control group being destroyed
+	 */
+	void Dispose(CGroup const * pcg);
+
+	/** The attribute file name in the mounted hierarchy */
+	const char * FileName(Attribute_t attr) const;
+};
+
+} // namespace pp
+
+} // namespace bbque
+
+#endif // BBQUE_LINUX_CGROUP_ACTUATOR_H_
@@ -30,6 +30,10 @@
 #include "bbque/pp/proc_listener.h"
 
 #include <bitset>
+#include <list>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
 
 namespace bbque {
 namespace pp {
@@ -86,6 +90,19 @@ public:
 	ExitCode_t MapResources(
 	        SchedPtr_t papp, ResourceAssignmentMapPtr_t pres, bool excl) noexcept override final;
 
+	/**
+	 * @brief Linux specific resource binding batch start.
+	 *
+	 * The control groups updates are staged until MapResourcesCommit()
+	 */
+	ExitCode_t MapResourcesStart() noexcept override final;
+
+	/**
+	 * @brief Linux specific resource binding batch enforcement.
+	 */
+	ExitCode_t MapResourcesCommit(
+	        std::list<SchedPtr_t> & failed_apps) noexcept override final;
+
 	/**
 	 * @brief Linux platform specific termination.
 	 */
@@ -108,14 +125,6 @@ private:
 	const int MaxMemsCount = BBQUE_MAX_R_ID_NUM+1;
 
 //-------------------- ATTRIBUTES
-	/**
-	 * @brief the control group controller
-	 *
-	 * This is a reference to the controller used on a generic Linux host.
-	 * So far we use the "cpuset" controller.
-	 */
-	const char *controller;
-
 	bool refreshMode;
 
 	int cfs_margin_pct    = 0;  /**< CFS bandwidth enforcement safety margin (default: 0%) */
@@ -133,6 +142,24 @@ private:
 	 */
 	CGroupDataPtr_t psilos;
 
+	/**
+	 * @brief The control groups attributes writer
+	 */
+	CGroupActuator cg_act;
+
+	/**
+	 * @brief A batch of resource bindings is in progress
+	 */
+	bool cg_batch = false;
+
+	/**
+	 * @brief The control groups updated by the current batch, along
+	 * with the application requiring the update
+	 */
+	std::vector<std::pair<SchedPtr_t, CGroupDataPtr_t>> cg_batch_apps;
+
+	std::mutex cg_batch_mtx;
+
 #ifdef CONFIG_TARGET_ARM_BIG_LITTLE
 	/**
 	 * @brief ARM big.LITTLE support: type of each CPU core
@@ -201,7 +228,8 @@ private:
 	// --- CGroup-releated methods
 
 	/**
-	 * @brief Load the libcgroup and initialize the internal representation
+	 * @brief Detect the control groups hierarchies and initialize the
+	 * internal representation
 	 */
 	ExitCode_t InitCGroups() noexcept;
 
@@ -215,6 +243,21 @@ private:
 	ExitCode_t SetupCGroup(CGroupDataPtr_t &pcgd, RLinuxBindingsPtr_t prlb,
 	                       bool excl = false, bool move = true) noexcept;
 	ExitCode_t BuildAppCG(SchedPtr_t papp, CGroupDataPtr_t &pcgd) noexcept;
+
+	/**
+	 * @brief Enforce the control group updates staged for an application
+	 *
+	 * If a batch is in progress, the updates are postponed to the
+	 * MapResourcesCommit() call.
+	 */
+	ExitCode_t ApplyCGroups(SchedPtr_t papp, CGroupDataPtr_t pcgd) noexcept;
+
+	/**
+	 * @brief Check if the staged updates of an application have been
+	 * enforced
+	 */
+	bool CGroupsApplied(SchedPtr_t papp, CGroupDataPtr_t const & pcgd,
+	        std::unordered_set<pid_t> const & failed_pids) const noexcept;
 };
 
 }   // namespace pp
@@ -7,6 +7,7 @@ include linux_platform_proxy.h!
 #endif
 
 #include "bbque/app/schedulable.h"
+#include "bbque/pp/linux_cgroup_actuator.h"
 
 #ifdef CONFIG_BBQUE_LINUX_CG_NET_BANDWIDTH
 #include <netlink/libnetlink.h>
@@ -14,7 +15,6 @@ include linux_platform_proxy.h!
 
 #include <cstdint>
 #include <memory>
-#include <libcgroup.h>
 
 /**
  * @brief The CGroup expected to assigne resources to BBQ
@@ -90,39 +90,22 @@ struct CGroupData_t : public bbque::utils::PluginData_t {
 	bbque::app::SchedPtr_t papp; /** The controlled application */
 #define BBQUE_LINUXPP_CGROUP_PATH_MAX 128 // "user.slice/res/12345:ABCDEF:00";
 	char cgpath[BBQUE_LINUXPP_CGROUP_PATH_MAX];
-	struct cgroup *pcg;
-	struct cgroup_controller *pc_cpu;
-	struct cgroup_controller *pc_cpuset;
-	struct cgroup_controller *pc_memory;
-	struct cgroup_controller *pc_net_cls;
+	CGroupActuator::CGroupPtr_t pcg;  /** The kernel control group (removed on release) */
 	bool cfs_quota_available = false; /** Target system supports CFS quota management? */
 
 	CGroupData_t(bbque::app::SchedPtr_t sched_app) :
 		bu::PluginData_t(LINUX_PP_NAMESPACE, "cgroup"),
-		papp(sched_app), pcg(NULL), pc_cpu(NULL),
-		pc_cpuset(NULL), pc_memory(NULL) {
+		papp(sched_app) {
 		snprintf(cgpath, BBQUE_LINUXPP_CGROUP_PATH_MAX,
 		         BBQUE_LINUXPP_RESOURCES"/%s",
 		         papp->StrId());
 	}
 
 	CGroupData_t(const char *cgp) :
-		bu::PluginData_t(LINUX_PP_NAMESPACE, "cgroup"),
-		pcg(NULL), pc_cpu(NULL),
-		pc_cpuset(NULL), pc_memory(NULL) {
+		bu::PluginData_t(LINUX_PP_NAMESPACE, "cgroup") {
 		snprintf(cgpath, BBQUE_LINUXPP_CGROUP_PATH_MAX,
 		         "%s", cgp);
 	}
-
-	~CGroupData_t() {
-		if (pcg != NULL) {
-			// Removing kernel cgroup
-			cgroup_delete_cgroup(pcg, 1);
-			// Releasing libcgroup resources
-			cgroup_free(&pcg);
-		}
-	}
-
 };
 
 using CGroupDataPtr_t = std::shared_ptr<CGroupData_t>;
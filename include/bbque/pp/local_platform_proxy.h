@@ -60,6 +60,16 @@ public:
 		ResourceAssignmentMapPtr_t pres,
 		bool excl = true) ;
 
+	/**
+	 * @brief Platform specific resource binding batch start.
+	 */
+	virtual ExitCode_t MapResourcesStart();
+
+	/**
+	 * @brief Platform specific resource binding batch enforcement.
+	 */
+	virtual ExitCode_t MapResourcesCommit(std::list<SchedPtr_t> & failed_apps);
+
 	/**
 	 * @brief Platform specific proxy termination.
 	 */
@@ -161,11 +161,25 @@ public:
 			this->quantity = quantity;
 		}
 
+		/**
+		 * The distances from this memory (NUMA) node to each node,
+		 * indexed by memory id: 0 for the nodes not available (e.g.,
+		 * offline). Empty if unknown.
+		 */
+		inline const std::vector<uint32_t> & GetDistances() const {
+			return this->distances;
+		}
+
+		inline void SetDistances(const std::vector<uint32_t> & distances) {
+			this->distances = distances;
+		}
+
 		void SetType(res::ResourceType type) = delete;
 
 
 	private:
 		uint64_t quantity;
+		std::vector<uint32_t> distances;
 
 
 	};
@@ -21,6 +21,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <linux/cn_proc.h>
 
 #include "bbque/app/application.h"
@@ -33,10 +34,31 @@
 #include "bbque/res/identifier.h"
 #include "bbque/utils/worker.h"
 
+/** Number of messages received at most by a single system call */
+#define PROC_LISTENER_BATCH       32
+
+/** Size of the buffer of a single message */
+#define PROC_LISTENER_MSG_SIZE    256
+
+/** [ms] Maximum time to wait for new messages, before checking termination */
+#define PROC_LISTENER_POLL_MS     1000
+
 namespace bu = bbque::utils;
 
 namespace bbque {
 
+/**
+ * @class ProcessListener
+ * @brief Listen to the processes start and termination events
+ *
+ * The events are notified by the Linux process connector. Since the
+ * connector broadcasts the events of every process of the system, a socket
+ * filter is attached, which lets only the program executions and the
+ * processes (not threads) terminations reach the listener. Received
+ * messages are drained in batches, and the names of the managed processes
+ * are cached, thus the terminations of the other processes are discarded
+ * without reading /proc.
+ */
 class ProcessListener : public Worker {
 public:
 	/**
@@ -75,10 +97,30 @@ private:
 	std::unique_ptr<bu::Logger> logger;
 
 	/**
-	 * @brief Buffer
+	 * @brief Buffer of the received messages (PROC_LISTENER_BATCH
+	 * messages of PROC_LISTENER_MSG_SIZE bytes)
 	 */
 	char *buf;
-	int buffSize;
+
+	/**
+	 * @brief The names of the managed processes, by PID
+	 */
+	std::unordered_map<int, std::string> proc_names;
+
+	/**
+	 * @brief Attach the socket filter passing only the EXEC events and the
+	 * EXIT events of the processes
+	 *
+	 * @return true if attached, false otherwise (all the events will be
+	 * received)
+	 */
+	bool AttachFilter();
+
+	/**
+	 * @brief Process a connector message
+	 */
+	void ParseMessage(char * msg, ssize_t len);
+
 	/**
 	 * @brief Helper function to retrieve the name of a given PID
 	 */
@@ -18,10 +18,18 @@
 #ifndef BBQUE_RESOURCE_BITSET_H_
 #define BBQUE_RESOURCE_BITSET_H_
 
-#include <bitset>
+#include <cstdint>
+#include <string>
+#include <vector>
 
 #include "bbque/res/identifier.h"
 
+/** Number of bits per storage word */
+#define BBQUE_RBS_WORD_BITS    64
+
+/** Number of storage words not requiring a dynamic allocation */
+#define BBQUE_RBS_INLINE_WORDS 4
+
 namespace bbque { namespace res {
 
 /**
@@ -32,6 +40,13 @@ namespace bbque { namespace res {
  * the information.
  * This is commonly exploited to keep track of the IDs of a specific resource
  * type, from a set of resource assignments or resource descriptors.
+ *
+ * The size of the set is not fixed at compile time, but it grows according
+ * to the highest ID set, i.e., it follows the size of the platform loaded.
+ * Any non negative ID can be set: the IDs of the resources are bounded by
+ * the ResourceIdentifier (BBQUE_MAX_R_ID_NUM) instead.
+ * Up to BBQUE_RBS_INLINE_WORDS words of bits are stored without any dynamic
+ * allocation. Queries and set operations work a word at a time.
  */
 class ResourceBitset {
 
@@ -53,47 +68,53 @@ public:
 	ExitCode_t Reset(BBQUE_RID_TYPE pos);
 
 	inline bool Test(BBQUE_RID_TYPE pos) const {
-		return bit_set.test(pos);
+		if ((pos < 0) || (WordIndex(pos) >= WordsCount()))
+			return false;
+		return Words()[WordIndex(pos)] & BitMask(pos);
 	}
 
-	inline BBQUE_RID_TYPE Count() const {
-		return count;
-	}
+	/** The number of bits set */
+	BBQUE_RID_TYPE Count() const;
 
-	inline BBQUE_RID_TYPE FirstSet() const {
-		return first_set;
-	}
+	/** The lowest bit set (R_ID_NONE if empty) */
+	BBQUE_RID_TYPE FirstSet() const;
 
-	inline BBQUE_RID_TYPE LastSet() const {
-		return last_set;
-	}
+	/** The highest bit set (R_ID_NONE if empty) */
+	BBQUE_RID_TYPE LastSet() const;
 
-	inline std::string ToString() const {
-		return bit_set.to_string();
-	}
+	/**
+	 * @brief The string of the bits, from the highest to the lowest
+	 *
+	 * At least BBQUE_MAX_R_ID_NUM+1 bits are reported.
+	 */
+	std::string ToString() const;
 
-	inline std::string const & ToStringCG() const {
-		return cg_str;
-	}
+	/**
+	 * @brief The string of the bits set, in the cpuset list format of the
+	 * control groups (e.g., "0-3,8,10-11")
+	 *
+	 * The string is built at the first call after a change of the set.
+	 * @note Not to be called concurrently on the same object.
+	 */
+	std::string const & ToStringCG() const;
 
+	/** The lowest BBQUE_RBS_WORD_BITS bits */
 	inline unsigned long ToULong() const {
-		return bit_set.to_ulong();
+		return Words()[0];
 	}
 
 	/*****************************************************************
 	 *                        Operators                              *
 	 *****************************************************************/
 
-	bool operator== (ResourceBitset const & rbs) {
-		return bit_set == rbs.bit_set;
-	}
+	bool operator== (ResourceBitset const & rbs) const;
 
-	bool operator!= (ResourceBitset const & rbs) {
-		return bit_set != rbs.bit_set;
+	bool operator!= (ResourceBitset const & rbs) const {
+		return !(*this == rbs);
 	}
 
-	bool operator[] (BBQUE_RID_TYPE pos) {
-		return bit_set[pos];
+	bool operator[] (BBQUE_RID_TYPE pos) const {
+		return Test(pos);
 	}
 
 	ResourceBitset operator|= (const ResourceBitset & rbs);
@@ -102,17 +123,52 @@ public:
 
 private:
 
-	std::bitset<BBQUE_MAX_R_ID_NUM+1> bit_set;
+	typedef uint64_t Word_t;
+
+	/** The first words of bits */
+	Word_t inline_words[BBQUE_RBS_INLINE_WORDS];
 
-	BBQUE_RID_TYPE first_set;
+	/** All the words of bits, if more than BBQUE_RBS_INLINE_WORDS */
+	std::vector<Word_t> ext_words;
 
-	BBQUE_RID_TYPE last_set;
+	/** The cpuset string (built on demand) */
+	mutable std::string cg_str;
 
-	BBQUE_RID_TYPE count;
+	/** True if cg_str reflects the current set */
+	mutable bool cg_valid;
 
-	bool none;
+	inline Word_t * Words() {
+		return ext_words.empty() ? inline_words : ext_words.data();
+	}
+
+	inline Word_t const * Words() const {
+		return ext_words.empty() ? inline_words : ext_words.data();
+	}
+
+	inline size_t WordsCount() const {
+		return ext_words.empty() ? BBQUE_RBS_INLINE_WORDS : ext_words.size();
+	}
 
-	std::string cg_str;
+	static inline size_t WordIndex(BBQUE_RID_TYPE pos) {
+		return pos / BBQUE_RBS_WORD_BITS;
+	}
+
+	static inline Word_t BitMask(BBQUE_RID_TYPE pos) {
+		return Word_t(1) << (pos % BBQUE_RBS_WORD_BITS);
+	}
+
+	/**
+	 * @brief Extend the storage to (at least) the given number of words
+	 */
+	void Grow(size_t words_count);
+
+	/**
+	 * @brief The first bit with the given value, starting from a position
+	 *
+	 * @return The position of the bit, or WordsCount()*BBQUE_RBS_WORD_BITS
+	 * if not found
+	 */
+	int32_t Next(int32_t pos, bool value) const;
 };
 
 } // namespace res
@@ -120,4 +176,3 @@ private:
 } // namespace bbque
 
 #endif // BBQUE_RESOURCE_BITSET_H_
-
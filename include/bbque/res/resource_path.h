@@ -18,10 +18,10 @@
 #ifndef BBQUE_RESOURCE_PATH_H_
 #define BBQUE_RESOURCE_PATH_H_
 
+#include <array>
 #include <bitset>
 #include <memory>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "bbque/res/identifier.h"
@@ -323,6 +323,11 @@ public:
 	 */
 	ResourceIdentifierPtr_t GetIdentifier(ResourceType r_type) const;
 
+	/**
+	 * @brief Get the shared logger, creating it at the first call
+	 */
+	static bu::Logger * GetLogger();
+
 	/**
 	 * @brief Retrieve the entire list of identifiers
 	 *
@@ -369,8 +374,12 @@ public:
 
 private:
 
-	/** Logger instance */
-	std::unique_ptr<bu::Logger> logger;
+	/**
+	 * Logger instance, shared by all the resource path objects. Paths are
+	 * built and copied on the resource binding path, thus they must not
+	 * carry their own logger.
+	 */
+	static bu::Logger * logger;
 
 	/** Resource identifiers: one for each level of the the path */
 	std::vector<ResourceIdentifierPtr_t> identifiers;
@@ -378,8 +387,11 @@ private:
 	/** Keep track of the resource types in the path */
 	std::bitset<R_TYPE_COUNT> types_bits;
 
-	/** Keep track of the position of the resource type in the vector */
-	std::unordered_map<uint16_t, uint8_t> types_idx;
+	/**
+	 * Position of each resource type in the vector, indexed by type
+	 * (-1 if the type is not in the path)
+	 */
+	std::array<int8_t, R_TYPE_COUNT> types_idx;
 
 	/** The type of resource referenced by the path. */
 	ResourceType global_type;
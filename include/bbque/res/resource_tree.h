@@ -21,7 +21,9 @@
 #include <cstdint>
 #include <list>
 #include <map>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "bbque/utils/logging/logger.h"
@@ -163,6 +165,9 @@ public:
 	 *   xx1: FIRST
 	 * </tt>
 	 *
+	 * The result of each query is memoised, per path and matching flags,
+	 * until the next call to @ref invalidate().
+	 *
 	 * @param rsrc_path   A resource path object to match
 	 * @param match_flags The matching flags
 	 *
@@ -171,6 +176,14 @@ public:
 	ResourcePtrList_t find_list(ResourcePath & rsrc_path,
 			uint16_t match_flags = 0) const;
 
+	/**
+	 * @brief Drop the memoised query results
+	 *
+	 * To call whenever the set of resources, or their online/offline
+	 * status, changes. The insertion of a new resource does it implicitly.
+	 */
+	void invalidate();
+
 	/**
 	 * @brief Maximum depth of the tree
 	 * @return The maxim depth value
@@ -192,6 +205,9 @@ public:
 	 */
 	inline void clear() {
 		clear_node(root);
+		nodes.clear();
+		nodes_per_id.clear();
+		invalidate();
 	}
 
 private:
@@ -208,6 +224,47 @@ private:
 	/** Counter of resources */
 	uint16_t count;
 
+	/** All the nodes of the tree (root excluded), in insertion order */
+	std::vector<ResourceNodePtr_t> nodes;
+
+	/** Per resource identity (type, ID) positions in the nodes array */
+	std::unordered_map<uint32_t, std::vector<uint32_t>> nodes_per_id;
+
+	/** Memoised query results, per path and matching flags */
+	mutable std::unordered_map<std::string, ResourcePtrList_t> matchings_cache;
+
+	/** Serialize the accesses to the memoised query results */
+	mutable std::mutex cache_mtx;
+
+	/**
+	 * @brief Key of a resource identity in the nodes index
+	 */
+	static inline uint32_t id_key(ResourceType r_type, BBQUE_RID_TYPE r_id) {
+		return (static_cast<uint32_t>(r_type) << 16) |
+			static_cast<uint16_t>(r_id);
+	}
+
+	/**
+	 * @brief Key of a query (path and matching flags) in the cache
+	 */
+	static std::string query_key(
+			ResourcePath const & rsrc_path, uint16_t match_flags);
+
+	/**
+	 * @brief Look up a fully qualified path through the nodes index
+	 *
+	 * The candidate nodes are the ones having the same identity of the
+	 * last level of the path. The matching is checked going up to the
+	 * root, instead of visiting the tree from the top.
+	 *
+	 * @param rsrc_path A path with type and ID specified on every level
+	 * @param matchings A list to fill with the matching descriptor
+	 *
+	 * @return True if the resource has been found
+	 */
+	bool find_exact(ResourcePath const & rsrc_path,
+			ResourcePtrList_t & matchings) const;
+
 	/**
 	 * @brief Find a node
 	 *
@@ -18,13 +18,16 @@
 #ifndef BBQUE_RESOURCES_H_
 #define BBQUE_RESOURCES_H_
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <cstring>
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "bbque/config.h"
@@ -72,8 +75,20 @@ using ResourceStatePtr_t = std::shared_ptr<ResourceState>;
 /** Map of amounts of resource used by applications. Key: Application UID */
 using AppUsageQtyMap_t = std::map<AppUid_t, uint64_t>;
 
-/** Hash map collecting the state views of a resource */
-using RSHashMap_t =  std::unordered_map<RViewToken_t, ResourceStatePtr_t>;
+/** Pair Application UID / amount of resource used */
+using AppUsage_t = std::pair<AppUid_t, uint64_t>;
+
+/** Contiguous vector of amounts of resource used by applications */
+using AppUsageVector_t = std::vector<AppUsage_t>;
+
+/** Pair state view token / resource state */
+using RSViewEntry_t = std::pair<RViewToken_t, ResourceStatePtr_t>;
+
+/** Table collecting the state views of a resource */
+using RSViewsTable_t = std::vector<RSViewEntry_t>;
+
+/** The number of state views a resource can look up without locking */
+#define BBQUE_RES_VIEW_SLOTS 16
 
 
 /**
@@ -104,14 +119,44 @@ struct ResourceState {
 		apps.clear();
 	}
 
+	/**
+	 * @brief Lookup the usage entry of an application
+	 *
+	 * @param app_uid The application unique id
+	 * @return An iterator to the entry, or apps.end() if not found
+	 */
+	inline AppUsageVector_t::iterator FindApp(AppUid_t app_uid) {
+		auto it = apps.begin();
+		for (; it != apps.end(); ++it) {
+			if (it->first == app_uid)
+				break;
+		}
+		return it;
+	}
+
+	/**
+	 * @brief Set the amount of resource used by an application
+	 *
+	 * @param app_uid The application unique id
+	 * @param amount The amount of resource used
+	 */
+	inline void SetAppUsage(AppUid_t app_uid, uint64_t amount) {
+		auto it = FindApp(app_uid);
+		if (it != apps.end())
+			it->second = amount;
+		else
+			apps.emplace_back(app_uid, amount);
+	}
+
 	/** The amount of resource used in the system   */
 	uint64_t used;
 
 	/**
 	 * Amounts of resource used by each of the applications holding the
-	 * resource
+	 * resource. The number of applications sharing a resource is usually
+	 * small, thus a contiguous vector is scanned faster than a tree.
 	 */
-	AppUsageQtyMap_t apps;
+	AppUsageVector_t apps;
 
 };
 
@@ -217,6 +262,24 @@ public:
 		return path;
 	}
 
+	/**
+	 * @brief Set the resolved resource path object
+	 *
+	 * This is set once, at registration time, by the ResourceAccounter,
+	 * and it avoids to look up the path by string afterwards.
+	 */
+	inline void SetResourcePath(ResourcePathPtr_t r_path) {
+		path_ptr = r_path;
+	}
+
+	/**
+	 * @brief The registered resource path object
+	 * @return A shared pointer to the resource path
+	 */
+	inline ResourcePathPtr_t const & GetResourcePath() const {
+		return path_ptr;
+	}
+
 
 	/**********************************************************************
 	 * ACCOUNTING INFORMATION                                             *
@@ -257,7 +320,8 @@ public:
 	 * @return How much resource is still available including the amount of
 	 * resource used by the given application
 	 */
-	uint64_t Available(SchedPtr_t papp = SchedPtr_t(), RViewToken_t view_id = 0);
+	uint64_t Available(
+		SchedPtr_t const & papp = SchedPtr_t(), RViewToken_t view_id = 0);
 
 	/**
 	 * @brief Count of applications using the resource
@@ -266,8 +330,10 @@ public:
 	 * @return Number of applications
 	 */
 	inline uint16_t ApplicationsCount(RViewToken_t view_id = 0) {
-		AppUsageQtyMap_t apps_map;
-		return ApplicationsCount(apps_map, view_id);
+		ResourceState const * view = GetStateView(view_id);
+		if (!view)
+			return 0;
+		return view->apps.size();
 	}
 
 	/**
@@ -311,6 +377,7 @@ public:
 	 * @return The size of the map
 	 */
 	inline size_t ViewCount() {
+		std::unique_lock<std::mutex> views_ul(views_mtx);
 		return state_views.size();
 	}
 
@@ -420,16 +487,30 @@ public:
 		pw_profile.values[int(i_type)]->update(sample);
 	}
 
+	/**
+	 * @brief Make the updated power profile information visible
+	 *
+	 * The instant and mean values are copied into the back buffer, which
+	 * then becomes the one accessed by the readers. To call once per
+	 * sampling period, after the calls to @ref UpdatePowerInfo.
+	 * Only one thread at a time must publish the information of a given
+	 * resource.
+	 */
+	void PublishPowerInfo();
+
 	/**
 	 * @brief Power profile information
 	 *
+	 * This does not lock: the value is read from the last published buffer
+	 * (@see PublishPowerInfo).
+	 *
 	 * @param i_type Information type (e.g., LOAD, TEMPERATURE, FREQUENCY,...)
 	 * @param v_type Specify if the value required is the instantaneous or the
 	 * mean (exponential) computed on a set of samples (@see ValueType)
 	 *
 	 * @return The value of power profile information required
 	 */
-	double GetPowerInfo(PowerManager::InfoType i_type, ValueType v_type = MEAN);
+	double GetPowerInfo(PowerManager::InfoType i_type, ValueType v_type = MEAN) const;
 
 #endif // CONFIG_BBQUE_PM
 
@@ -490,6 +571,14 @@ private:
 		PowerManager::SamplesArray_t samples_window; /** Flags of the available run-time information */
 		std::vector<pEma_t> values;                 /** Sampled values */
 		uint enabled_count;                          /** Count of power profiling info enabled */
+
+		/** Published values: instant and mean, per information type */
+		struct Snapshot {
+			std::array<std::atomic<double>, int(PowerManager::InfoType::COUNT)> instant;
+			std::array<std::atomic<double>, int(PowerManager::InfoType::COUNT)> mean;
+		} snapshots[2];
+		/** Number of publications: the last one is in snapshots[count % 2] */
+		std::atomic<uint32_t> published_count;
 	} PowerProfile_t;
 
 
@@ -512,6 +601,9 @@ private:
 	/** Former resource path string  */
 	std::string path;
 
+	/** Resolved resource path object */
+	ResourcePathPtr_t path_ptr;
+
 	/** Resource name, e.g. CPU architecture name */
 	std::string model;
 
@@ -535,20 +627,52 @@ private:
 
 
 	/**
-	 * Hash map with all the views of the resource.
-	 * A "view" is a resource state. We can think at the hash map as a map
+	 * Table with all the views of the resource.
+	 * A "view" is a resource state. We can think at the table as a map
 	 * containing the "real" state of resource, plus other "temporary" states.
 	 * Such temporary states allows the Scheduler/Optimizer, i.e., to make
 	 * intermediate evaluations, before commit the ultimate scheduling.
 	 *
-	 * Each view is identified by a "token" which is hashed in order to
-	 * retrieve the ResourceState descriptor.
+	 * Each view is identified by a "token". Since only a few views are alive
+	 * at the same time (system, scheduled, synchronization...), the table is
+	 * a contiguous vector, linearly scanned to retrieve the ResourceState
+	 * descriptor.
 	 *
 	 * It's up to the Resource Accounter to maintain a consistent view of the
 	 * system state. Thus ResourceAccounter will manage tokens and the state
 	 * views life-cycle.
 	 */
-	RSHashMap_t state_views;
+	RSViewsTable_t state_views;
+
+	/**
+	 * Mutual exclusion on the table of views, which can be updated by
+	 * threads booking the resource in different views. The ResourceState
+	 * objects are not protected: each view is updated by one thread at a
+	 * time, and a state shared by several views is never updated in place.
+	 */
+	std::mutex views_mtx;
+
+	/**
+	 * @struct ViewSlot
+	 * @brief A state view published for the lookups without locking
+	 *
+	 * A slot is free if its state is null. The slots are updated with
+	 * views_mtx held, setting the token before the state.
+	 */
+	struct ViewSlot {
+		ViewSlot(): id(0), state(nullptr) {}
+		std::atomic<RViewToken_t> id;
+		std::atomic<ResourceState *> state;
+	};
+
+	/**
+	 * The states of (up to BBQUE_RES_VIEW_SLOTS) views of the table, which
+	 * are looked up by GetStateView() without taking views_mtx
+	 */
+	ViewSlot view_slots[BBQUE_RES_VIEW_SLOTS];
+
+	/** The number of views of the table not published into a slot */
+	std::atomic<uint16_t> views_unpublished;
 
 	/**
 	 * @brief Availability information initialization
@@ -606,7 +730,7 @@ private:
 	 * @param view The resource status view from which releasing the resource
 	 * @return The amount of resource released
 	 */
-	uint64_t Release(AppUid_t app_uid, ResourceStatePtr_t view);
+	uint64_t Release(AppUid_t app_uid, ResourceState * view);
 
 
 	/**
@@ -624,20 +748,76 @@ private:
 	 * @brief Amount of resource used by the application
 	 *
 	 * @param papp Application (shared pointer) using the resource
-	 * @param apps_map Reference to the map of App/EXC to get
+	 * @param view The resource state to query
 	 *
 	 * @return The 'quota' of resource used by the application
 	 */
-	uint64_t ApplicationUsage(SchedPtr_t const & papp, AppUsageQtyMap_t & apps_map);
+	uint64_t ApplicationUsage(SchedPtr_t const & papp, ResourceState * view);
+
 
+	/**
+	 * @brief Lookup the entry of a view in the table
+	 *
+	 * To call with views_mtx held.
+	 *
+	 * @param view_id The resource state view token (0 is not translated)
+	 * @return An iterator to the entry, or state_views.end() if not found
+	 */
+	inline RSViewsTable_t::iterator FindView(RViewToken_t view_id) {
+		auto it = state_views.begin();
+		for (; it != state_views.end(); ++it) {
+			if (it->first == view_id)
+				break;
+		}
+		return it;
+	}
+
+	/**
+	 * @brief Publish the state of a view for the lookups without locking
+	 *
+	 * To call with views_mtx held, whenever the state of a view of the
+	 * table is added, replaced or removed.
+	 *
+	 * @param view_id The resource state view token (0 is not translated)
+	 * @param state The state of the view, nullptr if the view is removed
+	 */
+	void PublishView(RViewToken_t view_id, ResourceState * state);
 
 	/**
 	 * @brief Get the view referenced by the token
 	 *
+	 * The returned pointer is not owning, and it is valid until the view is
+	 * updated or deleted. This does not lock the table, unless the view has
+	 * not been published into a slot (@see PublishView).
+	 *
 	 * @param view_id The resource state view token
 	 * @return The ResourceState fo the referenced view
 	 */
-	ResourceStatePtr_t GetStateView(RViewToken_t view_id);
+	ResourceState * GetStateView(RViewToken_t view_id);
+
+	/**
+	 * @brief Get the view referenced by the token for updating it
+	 *
+	 * Copy-on-write support: if the ResourceState object is shared with
+	 * other views, it is cloned before being returned. If the view does not
+	 * exist, a new empty state is allocated.
+	 *
+	 * @param view_id The resource state view token
+	 * @return The ResourceState owned by the referenced view
+	 */
+	ResourceState * GetWritableStateView(RViewToken_t view_id);
+
+	/**
+	 * @brief Share the state of a view with another view
+	 *
+	 * The destination view references the same ResourceState object of the
+	 * source view. The object is cloned only when one of the two views is
+	 * updated (@see GetWritableStateView).
+	 *
+	 * @param src_view_id The token of the view to share
+	 * @param dst_view_id The token of the view inheriting the state
+	 */
+	void ShareView(RViewToken_t src_view_id, RViewToken_t dst_view_id);
 
 	/**
 	 * @brief Delete a state view
@@ -427,6 +427,11 @@ public:
 	 */
 	ExitCode_t PutView(br::RViewToken_t tok);
 
+	/**
+	 * @see ResourceAccounterConfIF
+	 */
+	ExitCode_t InheritView(br::RViewToken_t parent_tok, br::RViewToken_t tok);
+
 	/**
 	 * @brief Get the system resource state view
 	 *
@@ -614,6 +619,14 @@ private:
 	uint8_t path_max_len = 0;
 
 
+	/**
+	 * Mutual exclusion on the maps of the views. Different views can be
+	 * booked by concurrent threads (e.g. a scheduling policy evaluating
+	 * alternative schedules in parallel), while the same view must be
+	 * updated by one thread at a time.
+	 */
+	std::mutex views_mtx;
+
 	/**
 	 * Map containing the pointers to the map of resource assignments specified in
 	 * the current working modes of each application. The key is the view
@@ -702,6 +715,22 @@ private:
 	 */
 	ExitCode_t _PutView(br::RViewToken_t tok);
 
+	/**
+	 * @brief Initialize a view as a copy-on-write child of another one
+	 *
+	 * The map of Apps/EXCs resource assignments is copied, while the state
+	 * of each resource is shared with the parent view. A resource state is
+	 * cloned only when a booking updates it. Therefore the cost of the
+	 * inheritance does not depend on the number of applications.
+	 *
+	 * @param parent_view The token of the view to inherit
+	 * @param status_view The token of the (empty) view to initialize
+	 *
+	 * @return RA_SUCCESS if the view has been initialized, RA_ERR_MISS_VIEW
+	 * if one of the two views cannot be found
+	 */
+	ExitCode_t _InheritView(br::RViewToken_t parent_view, br::RViewToken_t status_view);
+
 
 	/**
 	 * @brief Get a list of resource descriptor
@@ -767,6 +796,15 @@ private:
 	ExitCode_t GetAppAssignmentsByView(
 		br::RViewToken_t status_view, AppAssignmentsMapPtr_t & apps_assign);
 
+	/**
+	 * @brief Get a pointer to the set of resources referenced in a state view
+	 *
+	 * @param status_view The token referencing the resource state view
+	 * @return The set of resources, nullptr if the token doesn't match any
+	 * state view
+	 */
+	ResourceSetPtr_t GetResourceSetByView(br::RViewToken_t status_view);
+
 	/**
 	 * @brief Book e a set of resources (not thread-safe)
 	 *
@@ -913,12 +951,29 @@ private:
 	        br::RViewToken_t status_view,
 	        ResourceSetPtr_t & rsrc_set);
 
+	/**
+	 * @brief Drop the bookings of an Application/EXC from a view
+	 *
+	 * Differently from @ref DecBookingCounts, this does not require the
+	 * application descriptor, which may not exist anymore.
+	 *
+	 * @param app_uid The unique id of the Application/EXC
+	 * @param assign_map Map of resource assignments to drop
+	 * @param status_view The token referencing the resource state view
+	 */
+	void DropBookingCounts(
+	        AppUid_t app_uid,
+	        br::ResourceAssignmentMapPtr_t const & assign_map,
+	        br::RViewToken_t status_view);
+
 	/**
 	 * @brief Init the synchronized mode session
 	 *
 	 * This inititalizes the sync session view by adding the resource assignments
 	 * of the RUNNING Applications/ExC. Thus the ones that will not be
-	 * reconfigured or migrated.
+	 * reconfigured or migrated. The view is built as a copy-on-write child of
+	 * the scheduled view, such that only the resources of the applications to
+	 * synchronize are actually updated.
 	 *
 	 * @return RA_ERR_SYNC_INIT if the something goes wrong in the assignment
 	 * resources to the previuosly running applications/EXC.
@@ -65,6 +65,22 @@ public:
 	 */
 	virtual ExitCode_t PutView(br::RViewToken_t tok) = 0;
 
+	/**
+	 * @brief Initialize a resources view as a copy of another one
+	 *
+	 * The view referenced by the token, previously obtained through
+	 * GetView(), starts from the state of the parent view, instead of a
+	 * blank one. This allows a component to explore several alternative
+	 * bookings on top of the same partial state.
+	 *
+	 * @param parent_tok The token of the view to copy (0 for the system view)
+	 * @param tok The token of the view to initialize
+	 * @return RA_SUCCESS if the view has been initialized, RA_ERR_MISS_VIEW
+	 * if one of the two views cannot be found
+	 */
+	virtual ExitCode_t InheritView(br::RViewToken_t parent_tok,
+			br::RViewToken_t tok) = 0;
+
 };
 
 } // namespace bbque
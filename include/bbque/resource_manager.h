@@ -49,6 +49,7 @@
 #include "bbque/utils/worker.h"
 
 #include <bitset>
+#include <chrono>
 #include <map>
 #include <string>
 
@@ -272,6 +273,8 @@ private:
 		RM_SYNCH_TOTAL,
 		RM_SYNCH_FAILED,
 
+		RM_SCHED_COALESCED,
+
 		//----- Sample statistics
 		RM_EVT_TIME,
 		RM_EVT_TIME_START,
@@ -292,6 +295,8 @@ private:
 		RM_SCHED_PERIOD,
 		RM_SYNCH_PERIOD,
 
+		RM_SCHED_EVENTS,
+
 		RM_METRICS_COUNT
 	} ResMgrMetrics_t;
 
@@ -340,6 +345,56 @@ private:
 	// By default we use an event based activation of optimizations
 #define BBQUE_DEFAULT_RESOURCE_MANAGER_OPT_INTERVAL 0
 
+	/**
+	 * @brief The minimum interval [ms] between two optimization runs
+	 *
+	 * This is the lower bound of the time between the end of an
+	 * optimization run and the beginning of the next one, whatever the
+	 * event triggering it.
+	 */
+	uint32_t opt_min_interval;
+
+	/**
+	 * @brief The maximum delay [ms] of an event, due to batching
+	 *
+	 * An optimization run is never deferred, for batching or rate control
+	 * reasons, more than this time after the first event it serves. If
+	 * null, no bound is enforced.
+	 */
+	uint32_t opt_max_delay;
+
+	/**
+	 * @brief The maximum share [%] of time spent into optimization runs
+	 *
+	 * The interval between two optimization runs is adapted to the
+	 * measured cost of the scheduling and synchronization, so that the
+	 * optimization does not take more than this share of the time, under
+	 * bursts of events.
+	 */
+	uint16_t opt_max_load;
+
+#define BBQUE_DEFAULT_RESOURCE_MANAGER_OPT_MIN_INTERVAL 0
+#define BBQUE_DEFAULT_RESOURCE_MANAGER_OPT_MAX_DELAY 500
+#define BBQUE_DEFAULT_RESOURCE_MANAGER_OPT_MAX_LOAD 50
+
+	/** Mutual exclusion on the optimization rate control status */
+	std::mutex opt_mtx;
+
+	/** The number of events waiting for the next optimization run */
+	uint32_t opt_events = 0;
+
+	/** The time of the first event waiting for the next optimization run */
+	std::chrono::steady_clock::time_point opt_first_evt;
+
+	/** The earliest time of the next optimization run */
+	std::chrono::steady_clock::time_point opt_next_time;
+
+	/** [ms] The (moving average) cost of an optimization run */
+	double opt_cost_ms = 0;
+
+	/** [ms] The current interval between two optimization runs */
+	double opt_gap_ms = 0;
+
 	/**
 	 * @brief Set to ready or not ready, depending on having an optimization in
 	 * progress or not
@@ -356,6 +411,25 @@ private:
 	 */
 	void Optimize();
 
+	/**
+	 * @brief Request an optimization run, on behalf of an event
+	 *
+	 * The events requiring an optimization are coalesced into a single
+	 * run: the run is deferred by (at least) the required time, but not
+	 * earlier than the minimum interval from the previous one, and not
+	 * later than the maximum delay from the first event it serves.
+	 *
+	 * @param delay The time the event would defer the optimization by
+	 */
+	void ScheduleOptimization(std::chrono::milliseconds delay);
+
+	/**
+	 * @brief Update the rate control status at the end of an optimization
+	 *
+	 * @param cost The time [ms] spent into scheduling and synchronization
+	 */
+	void OptimizationDone(double cost);
+
 	/**
 	 * @brief   The run-time resource manager setup routine
 	 * This provides all the required playground setup to run the Barbeque RTRM.
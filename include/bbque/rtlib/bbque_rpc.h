@@ -29,7 +29,6 @@
 #include "bbque/cpp11/mutex.h"
 #include "bbque/cpp11/thread.h"
 
-#include "sys/times.h"
 
 #ifdef CONFIG_BBQUE_RTLIB_PERF_SUPPORT
 # include "bbque/utils/perf.h"
@@ -39,6 +38,10 @@
 #include "bbque/rtlib/bbque_ocl_stats.h"
 #endif
 
+#ifdef CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+# include "bbque/rtlib/rtp_telemetry.h"
+#endif
+
 #include <map>
 #include <memory>
 #include <string>
@@ -172,7 +175,9 @@ public:
 	RTLIB_ExitCode_t ForwardRuntimeProfile(
 		const RTLIB_EXCHandler_t exc_handler);
 
-	//TODO document me
+	/**
+	 * @brief Compute the goal gap of an EXC, given its runtime statistics
+	 */
 	RTLIB_ExitCode_t UpdateAllocation(
 		const RTLIB_EXCHandler_t exc_handler);
 
@@ -401,8 +406,10 @@ protected:
 
 	struct CpuUsageStats {
 		bool reset_timestamp = true;
-		struct tms time_sample;
-		clock_t previous_time, previous_tms_stime, previous_tms_utime, current_time;
+		/** [ns] The wall-clock time at the last sample */
+		uint64_t previous_time_ns = 0;
+		/** [ns] The CPU time consumed by the process at the last sample */
+		uint64_t previous_cpu_time_ns = 0;
 	};
 
 	typedef std::shared_ptr<PerfEventStats_t> pPerfEventStats_t;
@@ -484,9 +491,21 @@ protected:
 	 */
 	typedef std::map<uint16_t, pSystemResources_t> SysResMap_t;
 
+#define EXC_MAGIC 0x45584342 ///< Tags a valid RegisteredExecutionContext
+
 	typedef struct RegisteredExecutionContext {
-		/** The Execution Context data */
+		/**
+		 * The Execution Context data
+		 *
+		 * This must be the first member: the EXC handler returned to the
+		 * application is the address of this structure, thus an handler
+		 * is resolved into its EXC without any lookup.
+		 */
 		RTLIB_EXCParameters_t parameters;
+		/** EXC_MAGIC while this structure is alive */
+		uint32_t magic = EXC_MAGIC;
+		/** The (owning) entry of this EXC in the map of registered EXCs */
+		std::shared_ptr<RegisteredExecutionContext> const * entry = nullptr;
 		/** The name of this Execuion Context */
 		std::string name;
 		/** The RTLIB assigned ID for this Execution Context */
@@ -570,6 +589,11 @@ protected:
 		    bool rtp_forward = false;
 		} runtime_profiling;
 
+#ifdef CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+		/** The shared memory page of the runtime profile */
+		rtp_telemetry_page_t * telemetry = nullptr;
+#endif
+
 		double mon_tstart = 0; // [ms] at the last monitoring start time
 
 		/** CPS performance monitoring/control */
@@ -619,6 +643,7 @@ protected:
 
 		~RegisteredExecutionContext()
 		{
+			magic = 0;
 			awm_stats.clear();
 			current_awm_stats = pAwmStats_t();
 		}
@@ -628,17 +653,17 @@ protected:
 	typedef std::shared_ptr<RegisteredExecutionContext_t> pRegisteredEXC_t;
 
 	//--- AWM Validity
-	inline bool isAwmValid(pRegisteredEXC_t exc) const
+	inline bool isAwmValid(pRegisteredEXC_t const & exc) const
 	{
 		return (exc->flags & EXC_FLAGS_AWM_VALID);
 	}
-	inline void setAwmValid(pRegisteredEXC_t exc) const
+	inline void setAwmValid(pRegisteredEXC_t const & exc) const
 	{
 		logger->Debug("AWM  <= Valid [%d:%s:%d]",
 					  exc->id, exc->name.c_str(), exc->current_awm_id);
 		exc->flags |= EXC_FLAGS_AWM_VALID;
 	}
-	inline void clearAwmValid(pRegisteredEXC_t exc) const
+	inline void clearAwmValid(pRegisteredEXC_t const & exc) const
 	{
 		logger->Debug("AWM  <= Invalid [%d:%s]",
 					  exc->id, exc->name.c_str());
@@ -646,17 +671,17 @@ protected:
 	}
 
 	//--- AWM Wait
-	inline bool isAwmWaiting(pRegisteredEXC_t exc) const
+	inline bool isAwmWaiting(pRegisteredEXC_t const & exc) const
 	{
 		return (exc->flags & EXC_FLAGS_AWM_WAITING);
 	}
-	inline void setAwmWaiting(pRegisteredEXC_t exc) const
+	inline void setAwmWaiting(pRegisteredEXC_t const & exc) const
 	{
 		logger->Debug("AWM  <= Waiting [%d:%s]",
 					  exc->id, exc->name.c_str());
 		exc->flags |= EXC_FLAGS_AWM_WAITING;
 	}
-	inline void clearAwmWaiting(pRegisteredEXC_t exc) const
+	inline void clearAwmWaiting(pRegisteredEXC_t const & exc) const
 	{
 		logger->Debug("AWM  <= NOT Waiting [%d:%s]",
 					  exc->id, exc->name.c_str());
@@ -664,17 +689,17 @@ protected:
 	}
 
 	//--- AWM Assignment
-	inline bool isAwmAssigned(pRegisteredEXC_t exc) const
+	inline bool isAwmAssigned(pRegisteredEXC_t const & exc) const
 	{
 		return (exc->flags & EXC_FLAGS_AWM_ASSIGNED);
 	}
-	inline void setAwmAssigned(pRegisteredEXC_t exc) const
+	inline void setAwmAssigned(pRegisteredEXC_t const & exc) const
 	{
 		logger->Debug("AWM  <= Assigned [%d:%s]",
 					  exc->id, exc->name.c_str());
 		exc->flags |= EXC_FLAGS_AWM_ASSIGNED;
 	}
-	inline void clearAwmAssigned(pRegisteredEXC_t exc) const
+	inline void clearAwmAssigned(pRegisteredEXC_t const & exc) const
 	{
 		logger->Debug("AWM  <= NOT Assigned [%d:%s]",
 					  exc->id, exc->name.c_str());
@@ -682,17 +707,17 @@ protected:
 	}
 
 	//--- Sync Mode Status
-	inline bool isSyncMode(pRegisteredEXC_t exc) const
+	inline bool isSyncMode(pRegisteredEXC_t const & exc) const
 	{
 		return (exc->flags & EXC_FLAGS_EXC_SYNC);
 	}
-	inline void setSyncMode(pRegisteredEXC_t exc) const
+	inline void setSyncMode(pRegisteredEXC_t const & exc) const
 	{
 		logger->Debug("SYNC <= Enter [%d:%s]",
 					  exc->id, exc->name.c_str());
 		exc->flags |= EXC_FLAGS_EXC_SYNC;
 	}
-	inline void clearSyncMode(pRegisteredEXC_t exc) const
+	inline void clearSyncMode(pRegisteredEXC_t const & exc) const
 	{
 		logger->Debug("SYNC <= Exit [%d:%s]",
 					  exc->id, exc->name.c_str());
@@ -700,17 +725,17 @@ protected:
 	}
 
 	//--- Sync Done
-	inline bool isSyncDone(pRegisteredEXC_t exc) const
+	inline bool isSyncDone(pRegisteredEXC_t const & exc) const
 	{
 		return (exc->flags & EXC_FLAGS_EXC_SYNC_DONE);
 	}
-	inline void setSyncDone(pRegisteredEXC_t exc) const
+	inline void setSyncDone(pRegisteredEXC_t const & exc) const
 	{
 		logger->Debug("SYNC <= Done [%d:%s:%d]",
 					  exc->id, exc->name.c_str(), exc->current_awm_id);
 		exc->flags |= EXC_FLAGS_EXC_SYNC_DONE;
 	}
-	inline void clearSyncDone(pRegisteredEXC_t exc) const
+	inline void clearSyncDone(pRegisteredEXC_t const & exc) const
 	{
 		logger->Debug("SYNC <= Pending [%d:%s]",
 					  exc->id, exc->name.c_str());
@@ -718,17 +743,17 @@ protected:
 	}
 
 	//--- EXC Registration status
-	inline bool isRegistered(pRegisteredEXC_t exc) const
+	inline bool isRegistered(pRegisteredEXC_t const & exc) const
 	{
 		return (exc->flags & EXC_FLAGS_EXC_REGISTERED);
 	}
-	inline void setRegistered(pRegisteredEXC_t exc) const
+	inline void setRegistered(pRegisteredEXC_t const & exc) const
 	{
 		logger->Debug("EXC  <= Registered [%d:%s]",
 					  exc->id, exc->name.c_str());
 		exc->flags |= EXC_FLAGS_EXC_REGISTERED;
 	}
-	inline void clearRegistered(pRegisteredEXC_t exc) const
+	inline void clearRegistered(pRegisteredEXC_t const & exc) const
 	{
 		logger->Debug("EXC  <= Unregistered [%d:%s]",
 					  exc->id, exc->name.c_str());
@@ -736,17 +761,17 @@ protected:
 	}
 
 	//--- EXC Enable status
-	inline bool isEnabled(pRegisteredEXC_t exc) const
+	inline bool isEnabled(pRegisteredEXC_t const & exc) const
 	{
 		return (exc->flags & EXC_FLAGS_EXC_ENABLED);
 	}
-	inline void setEnabled(pRegisteredEXC_t exc) const
+	inline void setEnabled(pRegisteredEXC_t const & exc) const
 	{
 		logger->Debug("EXC  <= Enabled [%d:%s]",
 					  exc->id, exc->name.c_str());
 		exc->flags |= EXC_FLAGS_EXC_ENABLED;
 	}
-	inline void clearEnabled(pRegisteredEXC_t exc) const
+	inline void clearEnabled(pRegisteredEXC_t const & exc) const
 	{
 		logger->Debug("EXC  <= Disabled [%d:%s]",
 					  exc->id, exc->name.c_str());
@@ -754,17 +779,17 @@ protected:
 	}
 
 	//--- EXC Blocked status
-	inline bool isBlocked(pRegisteredEXC_t exc) const
+	inline bool isBlocked(pRegisteredEXC_t const & exc) const
 	{
 		return (exc->flags & EXC_FLAGS_EXC_BLOCKED);
 	}
-	inline void setBlocked(pRegisteredEXC_t exc) const
+	inline void setBlocked(pRegisteredEXC_t const & exc) const
 	{
 		logger->Debug("EXC  <= Blocked [%d:%s]",
 					  exc->id, exc->name.c_str());
 		exc->flags |= EXC_FLAGS_EXC_BLOCKED;
 	}
-	inline void clearBlocked(pRegisteredEXC_t exc) const
+	inline void clearBlocked(pRegisteredEXC_t const & exc) const
 	{
 		logger->Debug("EXC  <= UnBlocked [%d:%s]",
 					  exc->id, exc->name.c_str());
@@ -999,16 +1024,43 @@ private:
 	/**
 	 * @brief Update statistics for the currently selected AWM
 	 */
-	RTLIB_ExitCode_t UpdateStatistics(pRegisteredEXC_t exc);
+	RTLIB_ExitCode_t UpdateStatistics(pRegisteredEXC_t const & exc);
 
-	RTLIB_ExitCode_t UpdateCPUBandwidthStats(pRegisteredEXC_t exc);
-	void InitCPUBandwidthStats(pRegisteredEXC_t exc);
+	RTLIB_ExitCode_t UpdateCPUBandwidthStats(pRegisteredEXC_t const & exc);
+	void InitCPUBandwidthStats(pRegisteredEXC_t const & exc);
 
 	/**
 	 * @brief Update statistics about onMonitor execution for the currently
 	 * selected awm
 	 */
-	RTLIB_ExitCode_t UpdateMonitorStatistics(pRegisteredEXC_t exc);
+	RTLIB_ExitCode_t UpdateMonitorStatistics(pRegisteredEXC_t const & exc);
+
+	/**
+	 * @brief Compute the goal gap of an already resolved EXC
+	 */
+	RTLIB_ExitCode_t UpdateAllocation(pRegisteredEXC_t const & exc);
+
+	/**
+	 * @brief Forward the runtime profile of an already resolved EXC
+	 */
+	RTLIB_ExitCode_t ForwardRuntimeProfile(pRegisteredEXC_t const & exc);
+
+#ifdef CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+	/**
+	 * @brief Create the runtime profile telemetry page of an EXC
+	 */
+	RTLIB_ExitCode_t TelemetrySetup(pRegisteredEXC_t const & exc);
+
+	/**
+	 * @brief Release the runtime profile telemetry page of an EXC
+	 */
+	void TelemetryRelease(pRegisteredEXC_t const & exc);
+
+	/**
+	 * @brief Publish the runtime profile of the last processing cycle
+	 */
+	void TelemetryPublish(pRegisteredEXC_t const & exc);
+#endif
 
 	/**
 	 * @brief Log the header for statistics collection
@@ -1148,13 +1200,25 @@ private:
 	 * Utility functions
 	 ******************************************************************************/
 
-	pRegisteredEXC_t getRegistered(
+	/**
+	 * @brief Get the EXC of the given handler
+	 *
+	 * The handler is resolved in constant time, and the returned reference
+	 * (to the exc_map entry) is valid as long as this object, thus it can
+	 * be used without copying the pointer.
+	 */
+	pRegisteredEXC_t const & getRegistered(
 		const RTLIB_EXCHandler_t exc_handler);
 
 	/**
 	 * @brief Get an EXC handler for the give EXC ID
 	 */
-	pRegisteredEXC_t getRegistered(uint8_t exc_id);
+	pRegisteredEXC_t const & getRegistered(uint8_t exc_id);
+
+	/**
+	 * @brief The EXC returned by failed lookups
+	 */
+	static const pRegisteredEXC_t no_exc;
 
 
 	/**
@@ -1191,7 +1255,7 @@ private:
 	/** Very, very detailed stats (-d -d -d), adding prefetch events */
 	static PerfEventAttr_t very_very_detailed_events[];
 
-	inline uint8_t PerfRegisteredEvents(pRegisteredEXC_t exc)
+	inline uint8_t PerfRegisteredEvents(pRegisteredEXC_t const & exc)
 	{
 		return exc->events_map.size();
 	}
@@ -1202,12 +1266,12 @@ private:
 		return (ppea->type == type && ppea->config == config);
 	}
 
-	inline void PerfDisable(pRegisteredEXC_t exc)
+	inline void PerfDisable(pRegisteredEXC_t const & exc)
 	{
 		exc->perf.Disable();
 	}
 
-	inline void PerfEnable(pRegisteredEXC_t exc)
+	inline void PerfEnable(pRegisteredEXC_t const & exc)
 	{
 		exc->perf.Enable();
 	}
@@ -1216,7 +1280,7 @@ private:
 
 	void PerfSetupStats(pRegisteredEXC_t exc, pAwmStats_t awm_stats);
 
-	void PerfCollectStats(pRegisteredEXC_t exc);
+	void PerfCollectStats(pRegisteredEXC_t const & exc);
 
 	void PerfPrintStats(pRegisteredEXC_t exc, pAwmStats_t awm_stats);
 
@@ -1249,7 +1313,7 @@ private:
 	 *    Cycles Per Second (CPS) Control Support
 	 ******************************************************************************/
 
-	void ForceCPS(pRegisteredEXC_t exc);
+	void ForceCPS(pRegisteredEXC_t const & exc);
 
 
 };
@@ -0,0 +1,326 @@
+/*
+ * Copyright (C) 2012  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BBQUE_RPC_SHM_CHANNEL_H_
+#define BBQUE_RPC_SHM_CHANNEL_H_
+
+#include "bbque/rtlib.h"
+
+#include "bbque/config.h"
+#include "bbque/rtlib/rpc_messages.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/** The name of the shared memory region published by the RTRM */
+#define BBQUE_PUBLIC_SHM "/bbque_rpc_shm"
+
+#define BBQUE_SHM_NAME_LENGTH 32
+
+/** The maximum number of applications paired at the same time */
+#define BBQUE_SHM_MAX_CLIENTS 256
+
+/** The size of each ring buffer [bytes], it must be a power of two */
+#define BBQUE_SHM_RING_SIZE (64 * 1024)
+
+#define BBQUE_RPC_SHM_MAJOR_VERSION 1
+#define BBQUE_RPC_SHM_MINOR_VERSION 0
+
+#define BBQUE_RPC_SHM_VERSION \
+	((BBQUE_RPC_SHM_MAJOR_VERSION << 16) | BBQUE_RPC_SHM_MINOR_VERSION)
+
+namespace bbque
+{
+namespace rtlib
+{
+
+/******************************************************************************
+ * Ring buffers
+ ******************************************************************************/
+
+/**
+ * @brief The header of a record in a ring buffer
+ *
+ * Each record holds a single RPC message, starting right after the header.
+ * The records are 8 bytes aligned, and they never wrap around the end of the
+ * ring: the space left at the end is filled by a padding record.
+ */
+typedef struct rpc_shm_record {
+	/** The bytes of the RPC message */
+	uint32_t size;
+	/** Record flags */
+	uint32_t flags;
+} rpc_shm_record_t;
+
+/** The record is just a padding up to the end of the ring */
+#define RPC_SHM_RECORD_PAD 0x1
+
+/**
+ * @brief A single producer, single consumer ring buffer of RPC messages
+ *
+ * The head and tail positions are free running byte counters, written only
+ * by the producer and the consumer respectively. The doorbell is a futex
+ * word, bumped by the producer at each new message: the consumer sleeps on
+ * it when the ring is empty, and it is woken up only if it has declared to
+ * be sleeping.
+ */
+typedef struct rpc_shm_ring {
+	alignas(64) std::atomic<uint32_t> head;
+	alignas(64) std::atomic<uint32_t> tail;
+	alignas(64) std::atomic<uint32_t> doorbell;
+	std::atomic<uint32_t> sleeping;
+	alignas(64) uint8_t data[BBQUE_SHM_RING_SIZE];
+} rpc_shm_ring_t;
+
+/**
+ * @brief The shared memory segment of an application channel
+ *
+ * The segment is created by the application, which produces into the
+ * to_bbque ring and consumes from the to_app ring.
+ */
+typedef struct rpc_shm_channel {
+	/** The channel layout version */
+	uint32_t version;
+	/** The application (channel thread) PID */
+	int32_t app_pid;
+	/** Messages from the application (requests and responses) */
+	rpc_shm_ring_t to_bbque;
+	/** Messages to the application (commands and responses) */
+	rpc_shm_ring_t to_app;
+} rpc_shm_channel_t;
+
+
+/******************************************************************************
+ * Channels registry
+ ******************************************************************************/
+
+typedef enum rpc_shm_slot_state {
+	RPC_SHM_SLOT_FREE = 0,
+	/** Taken by an application, the channel name is being written */
+	RPC_SHM_SLOT_CLAIMED,
+	/** The channel is ready to be attached by the RTRM */
+	RPC_SHM_SLOT_READY,
+	/** The channel has been attached by the RTRM */
+	RPC_SHM_SLOT_ATTACHED
+} rpc_shm_slot_state_t;
+
+/**
+ * @brief An entry of the channels registry
+ */
+typedef struct rpc_shm_slot {
+	std::atomic<uint32_t> state;
+	/** The name of the application shared memory segment */
+	char channel[BBQUE_SHM_NAME_LENGTH];
+} rpc_shm_slot_t;
+
+/**
+ * @brief The shared memory region published by the RTRM
+ *
+ * An application claims a free slot to publish the name of its channel
+ * segment. The doorbell is bumped by the applications each time a channel
+ * is published or a message is sent to the RTRM, which thus needs to sleep
+ * on a single futex to serve all the applications.
+ */
+typedef struct rpc_shm_server {
+	/** The channel layout version */
+	uint32_t version;
+	alignas(64) std::atomic<uint32_t> doorbell;
+	std::atomic<uint32_t> sleeping;
+	rpc_shm_slot_t slots[BBQUE_SHM_MAX_CLIENTS];
+} rpc_shm_server_t;
+
+
+/******************************************************************************
+ * Ring operations
+ ******************************************************************************/
+
+#define RPC_SHM_ALIGN(SIZE) (((SIZE) + 7) & ~((uint32_t)7))
+#define RPC_SHM_RECORD_SIZE(SIZE) \
+	RPC_SHM_ALIGN(sizeof(bbque::rtlib::rpc_shm_record_t) + (SIZE))
+
+/** The size returned by rpc_shm_peek for a corrupted ring */
+#define RPC_SHM_RING_CORRUPTED 0xFFFFFFFF
+
+/**
+ * @brief Reserve the space for a message in the ring (producer side)
+ *
+ * @param pring the ring buffer
+ * @param size the bytes of the message
+ * @param pos returns the head position to publish by rpc_shm_commit
+ *
+ * @return a pointer where the message must be written in place, NULL if
+ * there is not enough free space
+ */
+inline void * rpc_shm_reserve(rpc_shm_ring_t * pring, uint32_t size,
+		uint32_t & pos) {
+	uint32_t total = RPC_SHM_RECORD_SIZE(size);
+	uint32_t head  = pring->head.load(std::memory_order_relaxed);
+	uint32_t used  = head - pring->tail.load(std::memory_order_acquire);
+	uint32_t off   = head & (BBQUE_SHM_RING_SIZE - 1);
+	uint32_t pad   = 0;
+
+	// Records are never split: wrap with a padding record
+	if (off + total > BBQUE_SHM_RING_SIZE)
+		pad = BBQUE_SHM_RING_SIZE - off;
+	if (used + pad + total > BBQUE_SHM_RING_SIZE)
+		return NULL;
+
+	if (pad) {
+		rpc_shm_record_t * prec = (rpc_shm_record_t *)&pring->data[off];
+		prec->size  = pad - sizeof(rpc_shm_record_t);
+		prec->flags = RPC_SHM_RECORD_PAD;
+		head += pad;
+		off = 0;
+	}
+
+	rpc_shm_record_t * prec = (rpc_shm_record_t *)&pring->data[off];
+	prec->size  = size;
+	prec->flags = 0;
+	pos = head + total;
+
+	return (void *)(prec + 1);
+}
+
+/**
+ * @brief Publish the message written into the reserved space
+ *
+ * @return true if the consumer is sleeping, and thus it must be woken up
+ */
+inline bool rpc_shm_commit(rpc_shm_ring_t * pring, uint32_t pos) {
+	pring->head.store(pos);
+	pring->doorbell.fetch_add(1);
+	return pring->sleeping.load() != 0;
+}
+
+/**
+ * @brief Get the next message of the ring, if any (consumer side)
+ *
+ * The message is accessed in place, and it must be released by
+ * rpc_shm_consume once processed. The ring could have been written by an
+ * untrusted producer, thus the positions and the record sizes are checked
+ * against the ring capacity before being used.
+ *
+ * @param size returns the bytes of the message, RPC_SHM_RING_CORRUPTED if
+ * the ring is not consistent (and it must not be used anymore)
+ *
+ * @return a pointer to the message, NULL if the ring is empty or corrupted
+ */
+inline void * rpc_shm_peek(rpc_shm_ring_t * pring, uint32_t & size) {
+	uint32_t tail = pring->tail.load(std::memory_order_relaxed);
+	uint32_t head = pring->head.load(std::memory_order_acquire);
+
+	size = 0;
+	if ((head - tail > BBQUE_SHM_RING_SIZE) || (tail & 7)) {
+		size = RPC_SHM_RING_CORRUPTED;
+		return NULL;
+	}
+
+	while (tail != head) {
+		uint32_t off = tail & (BBQUE_SHM_RING_SIZE - 1);
+		rpc_shm_record_t * prec = (rpc_shm_record_t *)&pring->data[off];
+		// Read once: the producer could change the record meanwhile
+		uint32_t rec_size  = ((volatile rpc_shm_record_t *)prec)->size;
+		uint32_t rec_flags = ((volatile rpc_shm_record_t *)prec)->flags;
+
+		// Records are never split, and never beyond the head
+		if ((rec_size > BBQUE_SHM_RING_SIZE - off - sizeof(rpc_shm_record_t)) ||
+				(RPC_SHM_RECORD_SIZE(rec_size) > head - tail)) {
+			size = RPC_SHM_RING_CORRUPTED;
+			return NULL;
+		}
+
+		if (rec_flags & RPC_SHM_RECORD_PAD) {
+			tail += RPC_SHM_RECORD_SIZE(rec_size);
+			pring->tail.store(tail, std::memory_order_release);
+			continue;
+		}
+		size = rec_size;
+		return (void *)(prec + 1);
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Release the message returned by rpc_shm_peek
+ */
+inline void rpc_shm_consume(rpc_shm_ring_t * pring, uint32_t size) {
+	uint32_t tail = pring->tail.load(std::memory_order_relaxed);
+	pring->tail.store(tail + RPC_SHM_RECORD_SIZE(size),
+			std::memory_order_release);
+}
+
+/**
+ * @brief Check if the ring has messages to consume
+ */
+inline bool rpc_shm_pending(rpc_shm_ring_t * pring) {
+	return pring->tail.load(std::memory_order_relaxed) !=
+		pring->head.load(std::memory_order_acquire);
+}
+
+
+/******************************************************************************
+ * Doorbells
+ ******************************************************************************/
+
+/**
+ * @brief Wake up the (process shared) waiter of a doorbell
+ */
+inline void rpc_shm_ring_doorbell(std::atomic<uint32_t> * pdoorbell) {
+	::syscall(SYS_futex, (uint32_t *)pdoorbell, FUTEX_WAKE, 1,
+			NULL, NULL, 0);
+}
+
+/**
+ * @brief Wait for a doorbell to be bumped after the specified value
+ *
+ * @param timeout_ms the maximum waiting time, 0 to wait forever
+ *
+ * @return 0 on doorbell (or spurious) wake-up, -ETIMEDOUT, -EINTR on signal
+ */
+inline int rpc_shm_wait_doorbell(std::atomic<uint32_t> * pdoorbell,
+		uint32_t value, uint32_t timeout_ms = 0) {
+	struct timespec ts;
+	struct timespec * pts = NULL;
+	long result;
+
+	if (timeout_ms) {
+		ts.tv_sec  = timeout_ms / 1000;
+		ts.tv_nsec = (timeout_ms % 1000) * 1000000;
+		pts = &ts;
+	}
+
+	result = ::syscall(SYS_futex, (uint32_t *)pdoorbell, FUTEX_WAIT, value,
+			pts, NULL, 0);
+	if (result == -1 && (errno == ETIMEDOUT || errno == EINTR))
+		return -errno;
+
+	return 0;
+}
+
+} // namespace rtlib
+
+} // namespace bbque
+
+#endif // BBQUE_RPC_SHM_CHANNEL_H_
@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2012  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BBQUE_RPC_SHM_CLIENT_H_
+#define BBQUE_RPC_SHM_CLIENT_H_
+
+#include "bbque/rtlib.h"
+
+#include "bbque/rtlib/bbque_rpc.h"
+#include "bbque/rtlib/rpc_messages.h"
+#include "bbque/rtlib/rpc_shm_channel.h"
+#include "bbque/cpp11/condition_variable.h"
+#include "bbque/cpp11/mutex.h"
+#include "bbque/cpp11/thread.h"
+
+#include <atomic>
+
+namespace bbque
+{
+namespace rtlib
+{
+
+/**
+ * @class BbqueRPC_SHM_Client
+ *
+ * @brief Client side of the RPC shared memory channel
+ *
+ * Definition of the RPC protocol based on POSIX shared memory to implement
+ * the Barbeque communication channel. The application creates a segment
+ * holding a ring buffer for each direction, and it publishes the segment
+ * name into the region of the RTRM. The messages are built directly into
+ * the ring buffers, and the received ones are processed in place.
+ *
+ * @see bbque/rtlib.h
+ * @see bbque/rtlib/rpc_messages.h
+ * @see bbque/rtlib/rpc_shm_channel.h
+ */
+class BbqueRPC_SHM_Client : public BbqueRPC
+{
+
+public:
+
+	BbqueRPC_SHM_Client();
+
+	~BbqueRPC_SHM_Client();
+
+protected:
+
+	RTLIB_ExitCode_t _Init(const char * name);
+
+	RTLIB_ExitCode_t _Register(pRegisteredEXC_t exc);
+
+	RTLIB_ExitCode_t _Unregister(pRegisteredEXC_t exc);
+
+	RTLIB_ExitCode_t _Enable(pRegisteredEXC_t exc);
+
+	RTLIB_ExitCode_t _Disable(pRegisteredEXC_t exc);
+
+	RTLIB_ExitCode_t _ScheduleRequest(pRegisteredEXC_t exc);
+
+	RTLIB_ExitCode_t _Set(pRegisteredEXC_t exc,
+						  RTLIB_Constraint * constraints, uint8_t count);
+
+	RTLIB_ExitCode_t _Clear(pRegisteredEXC_t exc);
+
+	RTLIB_ExitCode_t _RTNotify(pRegisteredEXC_t exc, int gap,
+							   int cusage, int ctime_ms);
+
+	void _Exit();
+
+	inline uint32_t RpcMsgToken()
+	{
+		return channel_thread_pid;
+	}
+
+	/******************************************************************************
+	 * Runtime profile timing
+	 ******************************************************************************/
+
+	RTLIB_ExitCode_t _GetRuntimeProfileResp(
+		rpc_msg_token_t token,
+		pRegisteredEXC_t exc,
+		uint32_t exc_time,
+		uint32_t mem_time);
+
+	/******************************************************************************
+	 * Synchronization Protocol Messages
+	 ******************************************************************************/
+
+	RTLIB_ExitCode_t _SyncpPreChangeResp(
+		rpc_msg_token_t token,
+		pRegisteredEXC_t exc,
+		uint32_t syncLatency);
+
+	RTLIB_ExitCode_t _SyncpSyncChangeResp(
+		rpc_msg_token_t token,
+		pRegisteredEXC_t exc,
+		RTLIB_ExitCode_t sync);
+
+	RTLIB_ExitCode_t _SyncpPostChangeResp(
+		rpc_msg_token_t token,
+		pRegisteredEXC_t exc,
+		RTLIB_ExitCode_t result);
+
+private:
+
+	char app_shm_name[BBQUE_SHM_NAME_LENGTH];
+
+	/**
+	 * @brief The region published by the RTRM
+	 */
+	rpc_shm_server_t * server = NULL;
+
+	/**
+	 * @brief The application channel segment
+	 */
+	rpc_shm_channel_t * channel = NULL;
+
+	std::atomic<bool> done;
+
+	bool running = false;
+
+	std::thread ChTrd;
+
+	std::mutex trdStatus_mtx;
+
+	std::condition_variable trdStatus_cv;
+
+	/**
+	 * @brief Serialize the producers of the ring to Barbeque
+	 *
+	 * Commands are sent by the application threads, while the
+	 * synchronization protocol responses are sent by the channel thread.
+	 * This mutex is held from the reservation of the ring space to the
+	 * publication of the message written in place.
+	 */
+	std::mutex chTx_mtx;
+
+	/**
+	 * @brief Serialize sending of command using the library
+	 *
+	 * The current implementation of the library allows to send a single
+	 * command at each time for single library instance. This is required do
+	 * properly handle responses from Barbque.
+	 * This mutex should be used to protect the chResp responce attribute,
+	 * which is always set to the last received response from Barbques.
+	 *
+	 * @see chResp
+	 */
+	std::mutex chCommand_mtx;
+
+	/**
+	 * @brief Signal the reception of a response from Barbeque
+	 *
+	 * Each time a new message has been received from Barbeque by the channel
+	 * fetch thread, this variable is notified. Thus, commands could wait for
+	 * a response by susepnding on it.
+	 */
+	std::condition_variable chResp_cv;
+
+	/**
+	 * @brief The last response reveiced by Barbeque
+	 *
+	 * This attribute should be always protected by the chCommand_mtx
+	 */
+	rpc_msg_resp_t chResp;
+
+	RTLIB_ExitCode_t ChannelRelease();
+
+	RTLIB_ExitCode_t ChannelSetup();
+
+	RTLIB_ExitCode_t ChannelPair(const char * name);
+
+	/**
+	 * @brief Reserve the ring space for a message to Barbeque
+	 *
+	 * The chTx_mtx must be held until the corresponding ChannelCommit.
+	 * If the ring is full, this waits up to BBQUE_RPC_TIMEOUT for Barbeque
+	 * to consume some messages.
+	 *
+	 * @return where the message must be written, NULL on errors
+	 */
+	void * ChannelReserve(size_t size, uint32_t & pos);
+
+	/**
+	 * @brief Publish a message written into the reserved space, and wake
+	 * up Barbeque if it is sleeping
+	 */
+	void ChannelCommit(uint32_t pos);
+
+	/**
+	 * @brief Wait for the next message from Barbeque
+	 *
+	 * The message is accessed in place, and it must be released by
+	 * rpc_shm_consume once processed.
+	 *
+	 * @return the message, NULL if the channel is being released
+	 */
+	rpc_msg_header_t * ChannelRecv(uint32_t & size);
+
+	void ChannelFetch();
+
+	void ChannelTrd(const char * name);
+
+	void RpcBbqResp(rpc_msg_header_t * phdr);
+
+	/**
+	 * @brief Get from the ring a PreChange RPC message
+	 */
+	void RpcBbqSyncpPreChange(rpc_msg_header_t * phdr, uint32_t size);
+
+	/**
+	 * @brief Get from the ring a SyncChange RPC message
+	 */
+	void RpcBbqSyncpSyncChange(rpc_msg_header_t * phdr);
+
+	/**
+	 * @brief Get from the ring a DoChange RPC message
+	 */
+	void RpcBbqSyncpDoChange(rpc_msg_header_t * phdr);
+
+	/**
+	 * @brief Get from the ring a PostChange RPC message
+	 */
+	void RpcBbqSyncpPostChange(rpc_msg_header_t * phdr);
+
+	/**
+	 * @brief Get from the ring a runtime profile request RPC message
+	 */
+	void RpcBbqGetRuntimeProfile(rpc_msg_header_t * phdr);
+
+};
+
+} // namespace rtlib
+
+} // namespace bbque
+
+#endif // BBQUE_RPC_SHM_CLIENT_H_
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2012  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BBQUE_RTP_TELEMETRY_H_
+#define BBQUE_RTP_TELEMETRY_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+/**
+ * The name of the telemetry page of an execution context, given the PID of
+ * the application (channel thread) and the EXC ID
+ */
+#define BBQUE_RTP_TELEMETRY_SHM "/bbque_rtp_%05d_%02d"
+
+#define BBQUE_RTP_TELEMETRY_NAME_LENGTH 32
+
+/** The maximum number of performance counters published */
+#define BBQUE_RTP_TELEMETRY_MAX_COUNTERS 8
+
+/** The number of attempts to read a consistent sample */
+#define BBQUE_RTP_TELEMETRY_READ_RETRIES 16
+
+#define BBQUE_RTP_TELEMETRY_VERSION 0x00010000
+
+namespace bbque
+{
+namespace rtlib
+{
+
+/**
+ * @brief A performance counter reading
+ */
+typedef struct rtp_telemetry_counter {
+	/** The perf event type (PERF_TYPE_*) */
+	uint32_t type;
+	/** The perf event configuration */
+	uint64_t config;
+	/** The counts since the current AWM has been assigned */
+	uint64_t value;
+} rtp_telemetry_counter_t;
+
+/**
+ * @brief The runtime profile of an execution context
+ *
+ * The sample is updated by the RTLib at the end of each processing cycle.
+ */
+typedef struct rtp_telemetry_sample {
+	/** [us] The CLOCK_MONOTONIC time of the update */
+	uint64_t timestamp_us;
+	/** The processing cycles completed */
+	uint64_t cycles;
+	/** The AWM the EXC is running into */
+	int32_t awm_id;
+	/** [ms] The last cycle time */
+	float cycle_time_ms;
+	/** [ms] The average cycle time */
+	float cycle_time_avg_ms;
+	/** [ms] The upper bound of the cycle time (99% confidence) */
+	float cycle_time_max_ms;
+	/** The cycles per second */
+	float cps;
+	/** The jobs per second */
+	float jps;
+	/** [%] The CPU goal gap */
+	float goal_gap;
+	/** [%] The measured CPU usage */
+	float cpu_usage;
+	/** [%] The CPU bandwidth assigned */
+	float cpu_budget;
+	/** The number of valid performance counters */
+	uint32_t counters_count;
+	rtp_telemetry_counter_t counters[BBQUE_RTP_TELEMETRY_MAX_COUNTERS];
+} rtp_telemetry_sample_t;
+
+/**
+ * @brief The telemetry page of an execution context
+ *
+ * The page is created by the application and mapped by the RTRM. The RTLib
+ * is the single writer of the sample, which is protected by a sequence
+ * lock: the sequence number is odd while the sample is being written, thus
+ * the readers never block the application, but retry the read if the
+ * sequence number was odd or it has changed meanwhile.
+ */
+typedef struct rtp_telemetry_page {
+	/** The page layout version */
+	uint32_t version;
+	/** The application (channel thread) PID */
+	int32_t app_pid;
+	/** The EXC ID */
+	uint32_t exc_id;
+	/** Set by the RTRM once the page has been mapped */
+	alignas(64) std::atomic<uint32_t> attached;
+	/**
+	 * Set by the RTLib when a runtime profile notification is sent, and
+	 * cleared by the RTRM when it is processed. Meanwhile, if the page has
+	 * been attached, the RTLib does not send further notifications: the
+	 * RTRM reads the latest profile from the page.
+	 */
+	std::atomic<uint32_t> notify_pending;
+	alignas(64) std::atomic<uint32_t> seq;
+	rtp_telemetry_sample_t sample;
+} rtp_telemetry_page_t;
+
+
+/**
+ * @brief Format the name of the telemetry page of an EXC
+ */
+inline void rtp_telemetry_name(char * name, int32_t app_pid, uint8_t exc_id) {
+	snprintf(name, BBQUE_RTP_TELEMETRY_NAME_LENGTH, BBQUE_RTP_TELEMETRY_SHM,
+			app_pid, exc_id);
+}
+
+/**
+ * @brief Update the sample (writer side)
+ */
+inline void rtp_telemetry_publish(rtp_telemetry_page_t * ppage,
+		rtp_telemetry_sample_t const & sample) {
+	uint32_t seq = ppage->seq.load(std::memory_order_relaxed);
+	ppage->seq.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	memcpy(&ppage->sample, &sample, sizeof(rtp_telemetry_sample_t));
+	ppage->seq.store(seq + 2, std::memory_order_release);
+}
+
+/**
+ * @brief Read a consistent copy of the sample (reader side)
+ *
+ * @return false if the sample has never been published, or if a
+ * consistent copy could not be read within BBQUE_RTP_TELEMETRY_READ_RETRIES
+ * attempts (e.g., the application died while writing it)
+ */
+inline bool rtp_telemetry_read(rtp_telemetry_page_t const * ppage,
+		rtp_telemetry_sample_t & sample) {
+	for (int i = 0; i < BBQUE_RTP_TELEMETRY_READ_RETRIES; ++i) {
+		uint32_t seq = ppage->seq.load(std::memory_order_acquire);
+		if (seq & 0x1)
+			continue;
+		memcpy(&sample, &ppage->sample, sizeof(rtp_telemetry_sample_t));
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (ppage->seq.load(std::memory_order_relaxed) == seq)
+			return seq != 0;
+	}
+	return false;
+}
+
+} // namespace rtlib
+
+} // namespace bbque
+
+#endif // BBQUE_RTP_TELEMETRY_H_
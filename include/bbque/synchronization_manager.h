@@ -20,6 +20,7 @@
 
 
 #include <set>
+#include <vector>
 
 #include "bbque/config.h"
 #include "bbque/plugin_manager.h"
@@ -215,16 +216,18 @@ private:
 	bool Reshuffling(AppPtr_t papp);
 
 	/**
-	 * @brief Collects result from EXCs during PreChange
+	 * @brief Check the result collected from an EXC during PreChange
 	 */
-	void Sync_PreChange_Check_EXC_Response(AppPtr_t papp, 
-                                 ApplicationProxy::pPreChangeRsp_t presp);
+	void Sync_PreChange_Check_EXC_Response(AppPtr_t papp,
+			ApplicationProxy::pPreChangeRsp_t presp,
+			RTLIB_ExitCode_t result);
 
 	/**
-	 * @brief Collects result from EXCs during SyncChange
+	 * @brief Check the result collected from an EXC during SyncChange
 	 */
-	void Sync_SyncChange_Check_EXC_Response(AppPtr_t papp, 
-                                 ApplicationProxy::pSyncChangeRsp_t presp);
+	void Sync_SyncChange_Check_EXC_Response(AppPtr_t papp,
+			ApplicationProxy::pSyncChangeRsp_t presp,
+			RTLIB_ExitCode_t result);
 
 	/**
 	 * @brief Disable EXCs for which the synchronization has not been
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2012  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BBQUE_EXECUTOR_POOL_H_
+#define BBQUE_EXECUTOR_POOL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bbque/cpp11/condition_variable.h"
+#include "bbque/cpp11/mutex.h"
+#include "bbque/cpp11/thread.h"
+
+/** The cache line size the queue positions are padded to */
+#define BBQUE_EXECUTOR_POOL_CACHE_LINE 64
+
+namespace bbque { namespace utils {
+
+/**
+ * @class ExecutorPool
+ *
+ * @brief A bounded set of executor threads serving a bounded queue of jobs
+ *
+ * The executors are started once, at construction time, and they pick the
+ * jobs in FIFO order from a single bounded queue. The queue is lock-free
+ * (multiple producers and multiple consumers on a ring of sequenced cells),
+ * thus submitting a job never blocks the caller. The executors go to sleep
+ * only when the queue is empty.
+ *
+ * Differently from the TaskPool, a job is allowed to block for a long time,
+ * e.g. waiting for the response of an application: the pool size bounds the
+ * number of jobs served concurrently.
+ */
+class ExecutorPool {
+
+public:
+
+	typedef std::function<void(void)> Job_t;
+
+	/**
+	 * @brief Start the executor threads
+	 *
+	 * @param nr_executors The number of executor threads (at least 1)
+	 * @param capacity The maximum number of queued jobs, rounded up to a
+	 * power of two
+	 * @param name The prefix of the executor threads name
+	 */
+	ExecutorPool(unsigned int nr_executors, size_t capacity,
+			std::string const & name = "bq.ex");
+
+	/**
+	 * @brief Complete the queued jobs and stop the executor threads
+	 */
+	~ExecutorPool();
+
+	/**
+	 * @brief Queue a job for the execution
+	 *
+	 * @return false if the queue is full (the job is not queued), true
+	 * otherwise
+	 */
+	bool Submit(Job_t && job);
+
+	/**
+	 * @brief The number of jobs queued and not yet taken by an executor
+	 */
+	inline size_t Depth() const {
+		return queued.load();
+	}
+
+	/**
+	 * @brief The number of executor threads
+	 */
+	inline unsigned int Executors() const {
+		return threads.size();
+	}
+
+	/**
+	 * @brief The maximum number of queued jobs
+	 */
+	inline size_t Capacity() const {
+		return mask + 1;
+	}
+
+private:
+
+	/**
+	 * @struct Cell
+	 * @brief A slot of the jobs ring
+	 *
+	 * The sequence number tells whether the slot is free for the producer
+	 * at a given position (seq == pos), or it holds the job for the
+	 * consumer at that position (seq == pos + 1).
+	 */
+	struct Cell {
+		std::atomic<size_t> seq;
+		Job_t job;
+	};
+
+	/** The name prefix of the executor threads */
+	std::string name;
+
+	/** The jobs ring */
+	std::unique_ptr<Cell[]> cells;
+
+	/** The ring size minus one (the size is a power of two) */
+	size_t mask;
+
+	/**
+	 * The next position to write, and the next one to read. Each one is
+	 * padded to a cache line of its own, instead of aligning the pool,
+	 * which is allocated on the heap.
+	 */
+	char pad_enqueue[BBQUE_EXECUTOR_POOL_CACHE_LINE];
+	std::atomic<size_t> enqueue_pos;
+	char pad_dequeue[BBQUE_EXECUTOR_POOL_CACHE_LINE - sizeof(std::atomic<size_t>)];
+	std::atomic<size_t> dequeue_pos;
+	char pad_end[BBQUE_EXECUTOR_POOL_CACHE_LINE - sizeof(std::atomic<size_t>)];
+
+	/** The number of queued jobs */
+	std::atomic<size_t> queued;
+
+	/** The number of executors sleeping on the idle condition */
+	std::atomic<unsigned int> sleeping;
+
+	/** Set when the pool is being destroyed */
+	std::atomic<bool> done;
+
+	/** Sleeping executors wait for new jobs on this */
+	std::mutex idle_mtx;
+	std::condition_variable idle_cv;
+
+	/** The executor threads */
+	std::vector<std::thread> threads;
+
+	/**
+	 * @brief Take the oldest job from the ring, if any
+	 */
+	bool Dequeue(Job_t & job);
+
+	/**
+	 * @brief The executor threads loop
+	 */
+	void Run(unsigned int id);
+
+};
+
+} // namespace utils
+
+} // namespace bbque
+
+#endif // BBQUE_EXECUTOR_POOL_H_
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2012  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BBQUE_UTILS_ASYNC_LOGGER_H_
+#define BBQUE_UTILS_ASYNC_LOGGER_H_
+
+#include "bbque/config.h"
+#include "bbque/utils/logging/logger.h"
+
+#include <cstdarg>
+#include <memory>
+
+/** Size of the per-thread buffer of captured messages [bytes] (power of 2) */
+#define BBQUE_LOG_ASYNC_RING_SIZE  (64 * 1024)
+
+/** Maximum size of a captured message, string arguments included [bytes] */
+#define BBQUE_LOG_ASYNC_RECORD_MAX 512
+
+/** Maximum number of arguments captured for a message */
+#define BBQUE_LOG_ASYNC_ARGS_MAX   32
+
+/** Maximum period between two drains of the buffers [ms] */
+#define BBQUE_LOG_ASYNC_PERIOD_MS  10
+
+namespace bbque { namespace utils {
+
+/**
+ * @class AsyncLogger
+ * @brief A Logger deferring formatting and I/O to a background thread
+ *
+ * The logging calls just copy the format string pointer and the raw
+ * arguments (string arguments by value) into a lock-free buffer owned by the
+ * calling thread. A background thread drains the buffers of all the threads,
+ * formats the messages and forwards them to the sink logger (e.g., the
+ * Log4CppLogger), which thus is never called concurrently.
+ *
+ * The order of the messages is preserved per thread only, and the sink
+ * timestamps the messages when they are drained, i.e., within
+ * BBQUE_LOG_ASYNC_PERIOD_MS from the logging call.
+ *
+ * When the buffer of a thread is full, the message is dropped (and the
+ * number of dropped messages reported along with the next one), unless
+ * CONFIG_BBQUE_LOGGER_ASYNC_BLOCK is set, in which case the calling thread
+ * waits for the background thread to free some space.
+ *
+ * Messages with priority CRIT or higher, as well as messages with format
+ * conversions which cannot be captured (e.g., "%n" or positional
+ * arguments), are formatted and logged synchronously, after the pending
+ * messages have been flushed.
+ */
+class AsyncLogger : public Logger {
+
+public:
+
+	/**
+	 * @brief Build a new asynchronous logger
+	 * @param conf the logger configuration
+	 * @param sink the logger the formatted messages are forwarded to
+	 */
+	static std::unique_ptr<Logger>
+	GetInstance(Configuration const & conf, std::unique_ptr<Logger> sink);
+
+	/**
+	 * @brief Wait for all the messages captured so far to be logged
+	 */
+	static void Flush();
+
+	/**
+	 * \brief Logger dtor
+	 */
+	virtual ~AsyncLogger();
+
+	bool IsEnabled(Priority priority) const {
+		return enabled[priority];
+	}
+
+//----- Logger module interface
+
+#ifdef BBQUE_DEBUG
+	/**
+	 * \brief Send a log message with the priority DEBUG
+	 * \param fmt the message to log
+	 */
+	void Debug(const char *fmt, ...);
+#endif
+
+	/**
+	 * \brief Send a log message with the priority INFO
+	 * \param fmt the message to log
+	 */
+	void Info(const char *fmt, ...);
+
+	/**
+	 * \brief Send a log message with the priority NOTICE
+	 * \param fmt the message to log
+	 */
+	void Notice(const char *fmt, ...);
+
+	/**
+	 * \brief Send a log message with the priority WARN
+	 * \param fmt the message to log
+	 */
+	void Warn(const char *fmt, ...);
+
+	/**
+	 * \brief Send a log message with the priority ERROR
+	 * \param fmt the message to log
+	 */
+	void Error(const char *fmt, ...);
+
+	/**
+	 * \brief Send a log message with the priority CRIT
+	 * \param fmt the message to log
+	 */
+	void Crit(const char *fmt, ...);
+
+	/**
+	 * \brief Send a log message with the priority ALERT
+	 * \param fmt the message to log
+	 */
+	void Alert(const char *fmt, ...);
+
+	/**
+	 * \brief Send a log message with the priority FATAL
+	 * \param fmt the message to log
+	 */
+	void Fatal(const char *fmt, ...);
+
+private:
+
+	/**
+	 * The logger formatting and writing the messages
+	 */
+	std::unique_ptr<Logger> sink;
+
+	/**
+	 * The priorities enabled on the sink, cached to discard the messages
+	 * without capturing them
+	 */
+	bool enabled[FATAL_LEVEL + 1];
+
+	/**
+	 * \brief Build an asynchronous logger on top of the specified sink
+	 */
+	AsyncLogger(Configuration const & conf, std::unique_ptr<Logger> sink);
+
+	/**
+	 * @brief Capture a message, or log it synchronously if required
+	 */
+	void Capture(Priority priority, const char *fmt, va_list args);
+
+};
+
+} // namespace utils
+
+} // namespace bbque
+
+#endif // BBQUE_UTILS_ASYNC_LOGGER_H_
@@ -55,6 +55,11 @@ public:
 	 */
 	virtual ~Log4CppLogger() {};
 
+	/**
+	 * \brief Check the priority against the one of the Log4CPP category
+	 */
+	bool IsEnabled(Priority priority) const;
+
 //----- Logger module interface
 
 #ifdef BBQUE_DEBUG
@@ -33,6 +33,21 @@
  */
 #define FORMAT_DEBUG(fmt) "%25s:%05d - " fmt, __FILE__, __LINE__
 
+/**
+ * The lowest priority of the log messages built in. The logging calls with a
+ * lower priority are turned into inline no-ops, which the compiler drops
+ * along with the evaluation of side-effect free arguments.
+ * DEBUG messages are built only in debug builds, INFO and NOTICE messages can
+ * be compiled out of the release builds by CONFIG_BBQUE_LOGGER_MIN_LEVEL.
+ */
+#ifdef BBQUE_DEBUG
+# define BBQUE_LOG_LEVEL_MIN 0
+#elif defined CONFIG_BBQUE_LOGGER_MIN_LEVEL
+# define BBQUE_LOG_LEVEL_MIN CONFIG_BBQUE_LOGGER_MIN_LEVEL
+#else
+# define BBQUE_LOG_LEVEL_MIN 1
+#endif
+
 namespace bbque { namespace utils {
 
 /**
@@ -82,6 +97,17 @@ public:
 
 	virtual ~Logger() {};
 
+	/**
+	 * \brief Check if the messages with the given priority are logged
+	 *
+	 * This allows to skip the preparation of messages which are going to be
+	 * discarded anyway.
+	 */
+	virtual bool IsEnabled(Priority priority) const {
+		(void)priority;
+		return true;
+	}
+
 //----- Objects interface
 
 #ifdef BBQUE_DEBUG
@@ -93,17 +119,25 @@ public:
 #else
 	void Debug(const char *fmt, ...) {(void)fmt;};
 #endif
+#if BBQUE_LOG_LEVEL_MIN <= 1
 	/**
 	 * \brief Send a log message with the priority INFO
 	 * \param fmt the message to log
 	 */
 	virtual void Info(const char *fmt, ...) = 0;
+#else
+	void Info(const char *fmt, ...) {(void)fmt;};
+#endif
 
+#if BBQUE_LOG_LEVEL_MIN <= 2
 	/**
 	 * \brief Send a log message with the priority NOTICE
 	 * \param fmt the message to log
 	 */
 	virtual void Notice(const char *fmt, ...) = 0;
+#else
+	void Notice(const char *fmt, ...) {(void)fmt;};
+#endif
 
 	/**
 	 * \brief Send a log message with the priority WARN
@@ -20,10 +20,13 @@
 
 #include "bbque/utils/logging/logger.h"
 #include "bbque/utils/timer.h"
+#include "bbque/utils/utility.h"
 #include "bbque/cpp11/mutex.h"
 #include "bbque/command_manager.h"
 
+#include <atomic>
 #include <map>
+#include <string>
 #include <vector>
 #include <memory>
 
@@ -40,6 +43,15 @@ using namespace boost::accumulators;
 using bbque::utils::Timer;
 using bbque::CommandHandler;
 
+/** The maximum number of metrics which could be registered */
+#define BBQUE_MC_MAX_METRICS 1024
+
+/**
+ * The number of per-thread shards of COUNTER and SAMPLE metrics. Threads
+ * exceeding this number share an additional, mutex protected, shard.
+ */
+#define BBQUE_MC_MAX_SHARDS 64
+
 namespace bbque { namespace utils {
 
 /**
@@ -83,7 +95,12 @@ public:
 
 	} MetricClass_t;
 
-	/** The handler of a registered metrics */
+	/**
+	 * @brief The handler of a registered metrics
+	 *
+	 * This is the (1-based) index of the metric into the metrics table,
+	 * thus 0 is never a valid handler.
+	 */
 	typedef size_t MetricHandler_t;
 
 	/**
@@ -148,9 +165,95 @@ public:
 			return (sm_count != 0);
 		}
 
+		virtual ~Metric() {};
+
 		virtual void Reset() = 0;
 	};
 
+	/**
+	 * @brief The partial statistics of a (sub-)metric collected by a thread
+	 *
+	 * A slot is updated only by the thread owning the shard, without locks.
+	 * The updates are enclosed by two increments of the sequence counter,
+	 * thus readers can detect (and retry) a concurrent update.
+	 */
+	struct ShardSlot {
+		std::atomic<uint32_t> seq;
+		/** The metric reset epoch these statistics refers to */
+		std::atomic<uint32_t> epoch;
+		/** The counter value, or the number of samples */
+		std::atomic<uint64_t> count;
+		std::atomic<double> mean;
+		/** The sum of the squared differences from the mean */
+		std::atomic<double> m2;
+		std::atomic<double> min;
+		std::atomic<double> max;
+	};
+
+	/**
+	 * @brief The statistics of a (sub-)metric aggregated from all the shards
+	 */
+	struct SlotStats {
+		uint64_t count = 0;
+		double mean = 0;
+		double m2 = 0;
+		double min = 0;
+		double max = 0;
+
+		/** Merge the statistics of another population */
+		void Merge(uint64_t n, double mean, double m2, double min, double max);
+
+		/** The variance of the complete population */
+		double Variance() const {
+			return count ? m2 / count : 0;
+		}
+	};
+
+	/**
+	 * @brief A metric updated through per-thread shards
+	 *
+	 * Each thread updates its own shard of the metric, which is allocated
+	 * at its first update. Shards are aggregated only when the metric is
+	 * read, while a reset just starts a new epoch: the shard slots of the
+	 * previous epochs are ignored by the readers, and re-initialized by the
+	 * owners at their next update.
+	 */
+	class ShardedMetric : public Metric {
+	public:
+		ShardedMetric(const char *name, const char *desc, MetricClass_t mc,
+				uint8_t sm_count = 0, const char **sm_desc = NULL);
+
+		~ShardedMetric();
+
+		/** Increase the count of the (sub-)metric */
+		void Count(uint64_t amount, uint8_t sm_idx);
+
+		/** Add a sample to the (sub-)metric statistics */
+		void Sample(double sample, uint8_t sm_idx);
+
+		/**
+		 * @brief Aggregate the statistics of all the shards
+		 *
+		 * @param slot 0 for the metric, 1 + index for a sub-metric
+		 */
+		SlotStats Collect(uint16_t slot) const;
+
+		void Reset();
+
+	private:
+		/** The current reset epoch */
+		std::atomic<uint32_t> epoch;
+
+		/** The per-thread shards, plus the shared one */
+		std::atomic<ShardSlot *> shards[BBQUE_MC_MAX_SHARDS + 1];
+
+		/** Get the slots of a shard, allocating them if required */
+		ShardSlot * GetShard(size_t shard_id);
+
+		template<typename UpdateFn>
+		void Update(uint8_t sm_idx, UpdateFn update);
+	};
+
 	/** A pointer to a (base class) registered metrics */
 	typedef std::shared_ptr<Metric> pMetric_t;
 
@@ -160,15 +263,10 @@ public:
 	 * This is a simple metric which could be used to count events. Indeed
 	 * this metrics supports only the "increment" operation.
 	 */
-	class CounterMetric : public Metric {
+	class CounterMetric : public ShardedMetric {
 	public:
-		uint64_t cnt;
-		std::vector<uint64_t> sm_cnt;
-
 		CounterMetric(const char *name, const char *desc,
 				uint8_t sm_count = 0, const char **sm_desc = NULL);
-
-		void Reset();
 	};
 
 	/**
@@ -210,20 +308,10 @@ public:
 	 * Mean and variance are computed on the <i>complete population</i>, i.e.
 	 * considering all the samples collected so far.
 	 */
-	class SamplesMetric : public Metric {
+	class SamplesMetric : public ShardedMetric {
 	public:
-		/** Statistics on collected Samples */
-		typedef accumulator_set<double,
-			stats<tag::min, tag::max, tag::variance>> statMetric_t;
-		typedef std::shared_ptr<statMetric_t> pStatMetric_t;
-		pStatMetric_t pstat;
-		std::vector<pStatMetric_t> sm_pstat;
-
 		SamplesMetric(const char *name, const char *desc,
 				uint8_t sm_count = 0, const char **sm_desc = NULL);
-
-		void Reset();
-
 	};
 
 	/**
@@ -368,6 +456,9 @@ private:
 	/** A map of metrics handlers on correpsonding registered metrics */
 	typedef std::map<MetricHandler_t, pMetric_t> MetricsMap_t;
 
+	/** A map of metrics names on corresponding handlers */
+	typedef std::map<std::string, MetricHandler_t> MetricsNames_t;
+
 	/** An entry of the metrics maps */
 	typedef std::pair<MetricHandler_t, pMetric_t> MetricsMapEntry_t;
 
@@ -396,9 +487,22 @@ private:
 	std::unique_ptr<bu::Logger> logger;
 
 	/**
-	 * @brief Map of all registered metrics
+	 * @brief The registered metrics, indexed by (handler - 1)
+	 *
+	 * Entries are written only at registration time, thus the metrics
+	 * update methods could access them without locking.
+	 */
+	std::atomic<Metric *> metricsTable[BBQUE_MC_MAX_METRICS];
+
+	/**
+	 * @brief The number of registered metrics
 	 */
-	MetricsMap_t metricsMap;
+	size_t metricsCount = 0;
+
+	/**
+	 * @brief Map of all registered metrics names
+	 */
+	MetricsNames_t metricsNames;
 
 	/**
 	 * @brief The mutex protecting access to metrics maps
@@ -418,27 +522,24 @@ private:
 	/**
 	 * @brief Get the handler of the metric specified by name
 	 *
-	 * Return the handler of a metrics with the specified name.
+	 * Return the handler of a metrics with the specified name, 0 if the
+	 * metric has not yet been registered.
+	 * @note this method requires a lock on the metrics maps
 	 */
 	MetricHandler_t GetHandler(const char *name);
 
 	/**
-	 * @brief Get a reference to the registered metrics with specified handler
+	 * @brief Get the registered metrics with specified handler
 	 *
-	 * Given the handler of a metrics, this method return a reference to its
-	 * base class, or an empty pointer if the metric has not yet been
-	 * registered.
-	 */
-	pMetric_t GetMetric(MetricHandler_t hdlr);
-
-	/**
-	 * @brief Get a reference to the registered metrics with specified name
-	 *
-	 * Given the name of a metrics, this method return a reference to its
-	 * base class, or an empty pointer if the metric has not yet been
-	 * registered.
-	 */
-	pMetric_t GetMetric(const char *name);
+	 * Given the handler of a metrics, this method return a pointer to its
+	 * base class, or NULL if the metric has not yet been registered.
+	 * This is a lock-free lookup into the metrics table.
+	 */
+	inline Metric * GetMetric(MetricHandler_t hdlr) {
+		if (unlikely((hdlr == 0) || (hdlr > BBQUE_MC_MAX_METRICS)))
+			return NULL;
+		return metricsTable[hdlr - 1].load(std::memory_order_acquire);
+	}
 
 	/**
 	 * @brief Update a metrics of VALUE class of the specified amout.
@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2012  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BBQUE_TASK_POOL_H_
+#define BBQUE_TASK_POOL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bbque/cpp11/condition_variable.h"
+#include "bbque/cpp11/future.h"
+#include "bbque/cpp11/mutex.h"
+#include "bbque/cpp11/thread.h"
+
+namespace bbque { namespace utils {
+
+/**
+ * @class TaskPool
+ *
+ * @brief A persistent pool of worker threads executing short tasks
+ *
+ * The worker threads are started once, at construction time, and they live
+ * as long as the pool object. Each worker has its own queue of tasks: the
+ * tasks submitted from a worker go into its own queue, the other ones are
+ * distributed round-robin. An idle worker picks the most recent task of its
+ * own queue, or it steals the oldest task from the queue of another worker.
+ *
+ * This is meant for fine grained fan-out, e.g. the evaluation of all the
+ * working modes of an application during a scheduling run, where spawning a
+ * thread per task costs more than the task itself.
+ */
+class TaskPool {
+
+public:
+
+	typedef std::function<void(void)> Task_t;
+
+	/**
+	 * @brief Start the worker threads
+	 *
+	 * @param nr_workers The number of worker threads. If 0, a worker for
+	 * each hardware thread is started.
+	 * @param name The prefix of the worker threads name
+	 */
+	TaskPool(unsigned int nr_workers = 0, std::string const & name = "bq.tp");
+
+	/**
+	 * @brief Complete the queued tasks and stop the worker threads
+	 */
+	~TaskPool();
+
+	/**
+	 * @brief Submit a task for the execution
+	 *
+	 * @param func The callable object to execute
+	 *
+	 * @return A future bound to the value returned by the task
+	 */
+	template<class Func>
+	auto Submit(Func func) -> std::future<decltype(func())> {
+		typedef decltype(func()) Result_t;
+		auto ptask = std::make_shared<std::packaged_task<Result_t()>>(func);
+		std::future<Result_t> result(ptask->get_future());
+		Enqueue([ptask]() { (*ptask)(); });
+		return result;
+	}
+
+	/**
+	 * @brief Execute a function for each index of a range, in parallel
+	 *
+	 * The calling thread takes part to the execution, and it returns only
+	 * when the function has been executed on all the indexes. While
+	 * waiting, it runs the queued tasks, thus it can be safely called also
+	 * from a task of the same pool.
+	 *
+	 * @param first The first index of the range
+	 * @param last The end of the range (not included)
+	 * @param func The function to call on each index
+	 */
+	void ParallelFor(size_t first, size_t last,
+			std::function<void(size_t)> const & func);
+
+	/**
+	 * @brief The number of worker threads
+	 */
+	inline unsigned int Workers() const {
+		return queues.size();
+	}
+
+	/**
+	 * @brief The number of tasks executed so far
+	 */
+	inline uint64_t Executed() const {
+		return executed.load();
+	}
+
+	/**
+	 * @brief The number of tasks stolen from the queue of another worker
+	 */
+	inline uint64_t Stolen() const {
+		return stolen.load();
+	}
+
+private:
+
+	/**
+	 * @struct WorkQueue
+	 * @brief The queue of tasks of a single worker
+	 */
+	struct WorkQueue {
+		std::mutex mtx;
+		std::deque<Task_t> tasks;
+	};
+
+	/** The name prefix of the worker threads */
+	std::string name;
+
+	/** The task queues, one per worker */
+	std::vector<std::unique_ptr<WorkQueue>> queues;
+
+	/** The worker threads */
+	std::vector<std::thread> threads;
+
+	/** The queue receiving the next task submitted from outside */
+	std::atomic<unsigned int> next_queue;
+
+	/** The number of queued tasks, not yet taken by a worker */
+	std::atomic<size_t> pending;
+
+	/** Statistics: executed tasks */
+	std::atomic<uint64_t> executed;
+
+	/** Statistics: tasks stolen from the queue of another worker */
+	std::atomic<uint64_t> stolen;
+
+	/** Set when the pool is being destroyed */
+	bool done = false;
+
+	/** Idle workers wait for new tasks on this */
+	std::mutex idle_mtx;
+	std::condition_variable idle_cv;
+
+	/** The pool of the calling thread, if it is a worker */
+	static thread_local TaskPool * current_pool;
+
+	/** The index of the calling thread, if it is a worker */
+	static thread_local int current_id;
+
+	/**
+	 * @brief Put a task into a queue and wake up an idle worker
+	 */
+	void Enqueue(Task_t && task);
+
+	/**
+	 * @brief Execute a queued task, if any
+	 *
+	 * @param id The index of the calling worker, -1 if it is not a worker
+	 *
+	 * @return true if a task has been executed, false otherwise
+	 */
+	bool RunPending(int id);
+
+	/**
+	 * @brief The worker threads loop
+	 */
+	void Run(unsigned int id);
+
+	/**
+	 * @brief The index of the calling thread, if it is a worker of this
+	 * pool, -1 otherwise
+	 */
+	inline int SelfId() const {
+		return (current_pool == this) ? current_id : -1;
+	}
+
+};
+
+} // namespace utils
+
+} // namespace bbque
+
+#endif // BBQUE_TASK_POOL_H_
@@ -19,8 +19,12 @@
 #define BBQUE_DATA_CLIENT_H_
 
 #include "dci/types.h"
+#include "dci/status_frame.h"
 
 #include <functional>
+#include <map>
+#include <memory>
+#include <vector>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -162,12 +166,68 @@ private:
 	    return b;
 	}
 
+	/**
+	 * @struct ServerStream_t
+	 * @brief A data connection opened by the DataManager server instance,
+	 * along with the status rebuilt from the frames received
+	 */
+	struct ServerStream_t {
+		ServerStream_t(boost::asio::io_service & ios): socket(ios) {}
+
+		boost::asio::ip::tcp::socket socket;
+
+		/// The encoded header of the frame being received
+		char header_buffer[sizeof(status_frame_header_t)];
+
+		/// The header of the frame being received
+		status_frame_header_t header;
+
+		/// The payload of the frame being received
+		std::vector<char> payload;
+
+		/// The sequence number of the last status received
+		uint32_t seq = 0;
+
+		/// A FULL frame has been requested, and it is not yet arrived
+		bool full_requested = false;
+
+		/// The status of the resources, by resource bitset
+		std::map<res_bitset_t, resource_status_t> resources;
+
+		/// The status of the applications, by id
+		std::map<uint64_t, app_status_t> applications;
+	};
+
+	using ServerStreamPtr_t = std::shared_ptr<ServerStream_t>;
+
 	/**
 	 * @brief This is the receiver loop-function to manage incoming information
 	 * published by the DataManager server instance.
 	 */
 	void ClientReceiver();
 
+	/**
+	 * @brief Wait for the next data connection from the server
+	 */
+	void AcceptNext();
+
+	/**
+	 * @brief Receive the next status frame from a data connection
+	 */
+	void ReadFrame(ServerStreamPtr_t stream);
+
+	/**
+	 * @brief Update the status with the frame received, and notify it to
+	 * the client callback
+	 * @return false if the frame is malformed
+	 */
+	bool ApplyFrame(ServerStream_t & stream);
+
+	/**
+	 * @brief Ask the server to send the whole status, with the next frame
+	 */
+	void RequestFullStatus(ServerStream_t & stream);
+
 
 	/// IP address of the server
 	std::string server_ip;
@@ -200,6 +260,9 @@ private:
 	/// The client receiver thread tid
 	pid_t client_thread_tid;
 
+	/// The event loop of the client receiver thread
+	std::shared_ptr<boost::asio::io_service> ios_ptr;
+
 	/// The acceptor of the client receiver thread
 	std::shared_ptr<boost::asio::ip::tcp::acceptor> acceptor_ptr;
 
@@ -0,0 +1,284 @@
+/*
+ * Copyright (C) 2018  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BBQUE_STAT_FRAME_H_
+#define BBQUE_STAT_FRAME_H_
+
+#include "dci/types.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+/**
+ * Binary status frames
+ *
+ * The status information are published by the DataManager over a persistent
+ * TCP connection, as a stream of frames. Each frame is made by a fixed size
+ * header, followed by a payload of:
+ * - n_res_records resource records
+ * - n_app_records application records
+ * - n_app_removed application ids (u64)
+ *
+ * A FULL frame carries all the resources and applications matching the
+ * subscription filter, and it resets the status known by the client.
+ * A DELTA frame carries only the records updated after the frame having
+ * sequence number base_seq, and the ids of the applications terminated in
+ * the meanwhile.
+ *
+ * The client never writes on the connection, but to request a FULL frame
+ * (a single byte), whenever it receives a DELTA frame not applying to the
+ * status it knows.
+ *
+ * All the integers are encoded in little-endian order, strings are prefixed
+ * by their u16 length.
+ */
+
+#define BBQUE_DCI_FRAME_MAGIC    0x46445142 // "BQDF"
+#define BBQUE_DCI_FRAME_VERSION  1
+
+/** The maximum size of a frame payload [bytes] */
+#define BBQUE_DCI_FRAME_MAX_SIZE (16 * 1024 * 1024)
+
+namespace bbque { namespace stat {
+
+/* Status frame type */
+enum status_frame_type_t {
+	FRAME_FULL  = 0,
+	FRAME_DELTA = 1
+};
+
+struct status_frame_header_t { // 44 Byte
+	uint32_t magic;
+	uint16_t version;
+	uint8_t  type;           /// FULL or DELTA
+	uint8_t  filter;         /// The sections included (status_filter_t)
+	uint32_t seq;            /// Sequence number of the status
+	uint32_t base_seq;       /// Status the DELTA applies to
+	uint32_t ts;             /// Timestamp
+	uint32_t n_res;          /// Number of managed resources
+	uint32_t n_app;          /// Number of running applications
+	uint32_t n_res_records;  /// Number of resource records in the payload
+	uint32_t n_app_records;  /// Number of application records in the payload
+	uint32_t n_app_removed;  /// Number of removed applications ids
+	uint32_t length;         /// Size of the payload [bytes]
+} __attribute__((packed));
+
+/**
+ * @class StatusFrameWriter
+ * @brief Append the encoding of the status records to a buffer
+ */
+class StatusFrameWriter {
+public:
+
+	StatusFrameWriter(std::string & buffer): out(buffer) {}
+
+	inline void Put8(uint8_t v) {
+		out.push_back(static_cast<char>(v));
+	}
+
+	inline void Put16(uint16_t v) {
+		Put8(v & 0xFF); Put8(v >> 8);
+	}
+
+	inline void Put32(uint32_t v) {
+		Put16(v & 0xFFFF); Put16(v >> 16);
+	}
+
+	inline void Put64(uint64_t v) {
+		Put32(v & 0xFFFFFFFF); Put32(v >> 32);
+	}
+
+	inline void PutString(std::string const & s) {
+		uint16_t len = s.size() > UINT16_MAX ? UINT16_MAX : s.size();
+		Put16(len);
+		out.append(s, 0, len);
+	}
+
+	void PutResource(resource_status_t const & res) {
+		Put64(res.id);
+		PutString(res.model);
+		Put8(res.occupancy);
+		Put8(res.load);
+		Put32(res.power);
+		Put32(res.temp);
+		Put32(res.fans);
+	}
+
+	void PutApplication(app_status_t const & app) {
+		Put64(app.id);
+		PutString(app.name);
+		Put8(app.state);
+		Put32(app.tasks.size());
+		for (auto const & task: app.tasks) {
+			Put32(task.id);
+			Put16(task.throughput);
+			Put32(task.completion_time);
+			Put64(task.mapping);
+			Put32(task.n_threads);
+		}
+		Put32(app.mapping.size());
+		for (auto mapping: app.mapping)
+			Put64(mapping);
+	}
+
+	/**
+	 * @brief Encode the header in front of a payload already in the buffer
+	 */
+	static void PutHeader(status_frame_header_t header, char * dest) {
+		std::string encoded;
+		StatusFrameWriter hw(encoded);
+		hw.Put32(header.magic);
+		hw.Put16(header.version);
+		hw.Put8(header.type);
+		hw.Put8(header.filter);
+		hw.Put32(header.seq);
+		hw.Put32(header.base_seq);
+		hw.Put32(header.ts);
+		hw.Put32(header.n_res);
+		hw.Put32(header.n_app);
+		hw.Put32(header.n_res_records);
+		hw.Put32(header.n_app_records);
+		hw.Put32(header.n_app_removed);
+		hw.Put32(header.length);
+		memcpy(dest, encoded.data(), sizeof(status_frame_header_t));
+	}
+
+private:
+
+	std::string & out;
+};
+
+/**
+ * @class StatusFrameReader
+ * @brief Decode the status records from a buffer
+ *
+ * Reading beyond the end of the buffer does not fail immediately, but it
+ * makes Good() return false.
+ */
+class StatusFrameReader {
+public:
+
+	StatusFrameReader(const char * data, size_t size):
+		pos(reinterpret_cast<const uint8_t *>(data)),
+		end(reinterpret_cast<const uint8_t *>(data) + size) {}
+
+	inline bool Good() const {
+		return good;
+	}
+
+	inline uint8_t Get8() {
+		if (pos >= end) {
+			good = false;
+			return 0;
+		}
+		return *pos++;
+	}
+
+	inline uint16_t Get16() {
+		uint16_t v = Get8();
+		return v | (static_cast<uint16_t>(Get8()) << 8);
+	}
+
+	inline uint32_t Get32() {
+		uint32_t v = Get16();
+		return v | (static_cast<uint32_t>(Get16()) << 16);
+	}
+
+	inline uint64_t Get64() {
+		uint64_t v = Get32();
+		return v | (static_cast<uint64_t>(Get32()) << 32);
+	}
+
+	inline std::string GetString() {
+		uint16_t len = Get16();
+		if (end - pos < len) {
+			good = false;
+			return std::string();
+		}
+		std::string s(reinterpret_cast<const char *>(pos), len);
+		pos += len;
+		return s;
+	}
+
+	void GetResource(resource_status_t & res) {
+		res.id        = Get64();
+		res.model     = GetString();
+		res.occupancy = Get8();
+		res.load      = Get8();
+		res.power     = Get32();
+		res.temp      = Get32();
+		res.fans      = Get32();
+	}
+
+	void GetApplication(app_status_t & app) {
+		app.id     = Get64();
+		app.name   = GetString();
+		app.state  = Get8();
+		app.n_task = Get32();
+		app.tasks.clear();
+		for (uint32_t i = 0; good && i < app.n_task; ++i) {
+			task_status_t task;
+			task.id              = Get32();
+			task.throughput      = Get16();
+			task.completion_time = Get32();
+			task.mapping         = Get64();
+			task.n_threads       = Get32();
+			app.tasks.push_back(task);
+		}
+		app.n_mapping = Get32();
+		app.mapping.clear();
+		for (uint32_t i = 0; good && i < app.n_mapping; ++i)
+			app.mapping.push_back(Get64());
+	}
+
+	/**
+	 * @brief Decode a frame header
+	 * @return false if the header is not valid
+	 */
+	static bool GetHeader(const char * src, status_frame_header_t & header) {
+		StatusFrameReader hr(src, sizeof(status_frame_header_t));
+		header.magic         = hr.Get32();
+		header.version       = hr.Get16();
+		header.type          = hr.Get8();
+		header.filter        = hr.Get8();
+		header.seq           = hr.Get32();
+		header.base_seq      = hr.Get32();
+		header.ts            = hr.Get32();
+		header.n_res         = hr.Get32();
+		header.n_app         = hr.Get32();
+		header.n_res_records = hr.Get32();
+		header.n_app_records = hr.Get32();
+		header.n_app_removed = hr.Get32();
+		header.length        = hr.Get32();
+		return header.magic == BBQUE_DCI_FRAME_MAGIC
+			&& header.version == BBQUE_DCI_FRAME_VERSION
+			&& header.length <= BBQUE_DCI_FRAME_MAX_SIZE;
+	}
+
+private:
+
+	const uint8_t * pos;
+	const uint8_t * end;
+	bool good = true;
+};
+
+} // namespace stat
+
+} // namespace bbque
+
+#endif // BBQUE_STAT_FRAME_H_
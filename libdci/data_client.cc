@@ -27,6 +27,7 @@
 #include <sys/socket.h>
 #include <sys/syscall.h>
 
+#include <chrono>
 #include <sstream>
 #include <string>
 #include <iostream>
@@ -42,6 +43,9 @@ using namespace boost::asio;
 using namespace boost::archive;
 using namespace bbque::res;
 
+/** The maximum time to wait for the receiver setup [ms] */
+#define BBQUE_DCI_SETUP_TIMEOUT 1000
+
 namespace bbque {
 
 DataClient::DataClient(
@@ -72,8 +76,10 @@ DataClient::ExitCode_t DataClient::Connect() {
 	client_thread = std::thread(&DataClient::ClientReceiver, this);
 	client_thread.detach();
 
+	// The receiver may be ready before we start waiting
 	std::unique_lock<std::mutex> lck(mtx_connection);
-	cv_connection.wait(lck);
+	cv_connection.wait_for(lck, std::chrono::milliseconds(BBQUE_DCI_SETUP_TIMEOUT),
+		[this]() { return is_connected; });
 	if (!is_connected) {
 		fprintf(stderr, "Initialization failed!\n");
 		return DataClient::ExitCode_t::ERR_SERVER_UNREACHABLE;
@@ -99,6 +105,8 @@ DataClient::ExitCode_t DataClient::Disconnect() {
 		} catch(boost::exception const& ex){
 			fprintf(stderr,"Exception closing the socket\n");
 		}
+		// Drop the data connections
+		ios_ptr->stop();
 	}
 
 	// Kill the connection thread
@@ -114,14 +122,12 @@ bool DataClient::IsConnected() {
 }
 
 void DataClient::ClientReceiver() {
-	status_message_t stat_msg;
 	client_thread_tid = syscall(SYS_gettid);
 
-	io_service ios;
+	ios_ptr = std::make_shared<io_service>();
 	ip::tcp::endpoint endpoint =
 		ip::tcp::endpoint(ip::tcp::v4(), client_port);
-	acceptor_ptr = std::make_shared<ip::tcp::acceptor>(ios);
-	//ip::tcp::acceptor acceptor(ios);
+	acceptor_ptr = std::make_shared<ip::tcp::acceptor>(*ios_ptr);
 
 	// TCP Socket setup
 	try {
@@ -140,6 +146,7 @@ void DataClient::ClientReceiver() {
 			client_thread_tid = 0;
 			return;
 		}
+		acceptor_ptr->listen();
 	} catch(boost::exception const& ex){
 		fprintf(stderr,"Exception during socket setup\n");
 		client_thread_tid = 0;
@@ -152,32 +159,135 @@ void DataClient::ClientReceiver() {
 		cv_connection.notify_one();
 	}
 
-	while (IsConnected()) {
-		ip::tcp::iostream stream;
-		// Incoming connection management
-		try {
-			acceptor_ptr->listen();
-			acceptor_ptr->accept(*stream.rdbuf());
-		} catch(boost::exception const& ex) {
-			fprintf(stderr,"Exception waiting for incoming replies\n");
-			break;
-		}
+	// The server keeps the data connections open: all of them, and the
+	// incoming ones, are served by this thread
+	AcceptNext();
+	try {
+		ios_ptr->run();
+	} catch(std::exception const & ex) {
+		fprintf(stderr,"Exception waiting for incoming updates\n");
+	}
 
-		// Receiving update
-		try {
-			boost::archive::text_iarchive archive(stream);
-			archive >> stat_msg;
-		} catch(boost::exception const& ex){
-			fprintf(stderr,"Exception while sending message\n");
-			break;
+	client_thread_tid = 0;
+}
+
+void DataClient::AcceptNext() {
+	ServerStreamPtr_t stream = std::make_shared<ServerStream_t>(*ios_ptr);
+	acceptor_ptr->async_accept(stream->socket,
+		[this, stream](boost::system::error_code const & err) {
+			if (err) {
+				if (IsConnected())
+					fprintf(stderr,"Exception waiting for incoming connections\n");
+				return;
+			}
+			ReadFrame(stream);
+			AcceptNext();
+		});
+}
+
+void DataClient::ReadFrame(ServerStreamPtr_t stream) {
+	boost::asio::async_read(stream->socket,
+		boost::asio::buffer(stream->header_buffer),
+		[this, stream](boost::system::error_code const & err, size_t) {
+			if (err) {
+				if (err != boost::asio::error::eof)
+					fprintf(stderr,"Exception while receiving message\n");
+				return;
+			}
+			if (!StatusFrameReader::GetHeader(
+					stream->header_buffer, stream->header)) {
+				fprintf(stderr,"Invalid status frame\n");
+				return;
+			}
+
+			if (stream->header.length > BBQUE_DCI_FRAME_MAX_SIZE) {
+				fprintf(stderr,"Oversized status frame [%u]\n",
+					stream->header.length);
+				return;
+			}
+			stream->payload.resize(stream->header.length);
+			boost::asio::async_read(stream->socket,
+				boost::asio::buffer(stream->payload),
+				[this, stream](boost::system::error_code const & err, size_t) {
+					if (err) {
+						fprintf(stderr,"Exception while receiving message\n");
+						return;
+					}
+					if (!ApplyFrame(*stream)) {
+						fprintf(stderr,"Malformed status frame\n");
+						return;
+					}
+					ReadFrame(stream);
+				});
+		});
+}
+
+bool DataClient::ApplyFrame(ServerStream_t & stream) {
+	status_frame_header_t const & header(stream.header);
+	StatusFrameReader reader(stream.payload.data(), stream.payload.size());
+
+	if (header.type == FRAME_FULL) {
+		// The frame carries the whole status of its sections
+		if (header.filter & FILTER_RESOURCE)
+			stream.resources.clear();
+		if (header.filter & FILTER_APPLICATION)
+			stream.applications.clear();
+		stream.full_requested = false;
+	}
+	else if (header.base_seq != stream.seq) {
+		// The delta does not apply to the status we have: drop it, and
+		// all the following ones, until the whole status is received
+		if (!stream.full_requested) {
+			fprintf(stderr,"Status updates lost [%u != %u]\n",
+				header.base_seq, stream.seq);
+			RequestFullStatus(stream);
 		}
+		return true;
+	}
 
-		// Execute callback function
-		client_callback(stat_msg);
+	for (uint32_t i = 0; reader.Good() && i < header.n_res_records; ++i) {
+		resource_status_t res_stat;
+		reader.GetResource(res_stat);
+		stream.resources[res_stat.id] = res_stat;
+	}
 
+	for (uint32_t i = 0; reader.Good() && i < header.n_app_records; ++i) {
+		app_status_t app_stat;
+		reader.GetApplication(app_stat);
+		stream.applications[app_stat.id] = app_stat;
 	}
 
-	client_thread_tid = 0;
+	for (uint32_t i = 0; reader.Good() && i < header.n_app_removed; ++i)
+		stream.applications.erase(reader.Get64());
+
+	if (!reader.Good())
+		return false;
+	stream.seq = header.seq;
+
+	// Status message for the client
+	status_message_t stat_msg;
+	stat_msg.ts = header.ts;
+	stat_msg.n_res_status_msgs = stream.resources.size();
+	for (auto const & res: stream.resources)
+		stat_msg.res_status_msgs.push_back(res.second);
+	stat_msg.n_app_status_msgs = stream.applications.size();
+	for (auto const & app: stream.applications)
+		stat_msg.app_status_msgs.push_back(app.second);
+
+	// Execute callback function
+	client_callback(stat_msg);
+	return true;
+}
+
+void DataClient::RequestFullStatus(ServerStream_t & stream) {
+	static const char request = 1;
+	stream.full_requested = true;
+	boost::asio::async_write(stream.socket,
+		boost::asio::buffer(&request, 1),
+		[](boost::system::error_code const & err, size_t) {
+			if (err && err != boost::asio::error::operation_aborted)
+				fprintf(stderr,"Exception while requesting the status\n");
+		});
 }
 
 DataClient::ExitCode_t DataClient::Subscribe(
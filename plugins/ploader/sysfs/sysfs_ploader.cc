@@ -0,0 +1,476 @@
+/*
+ * Copyright (C) 2017  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sysfs_ploader.h"
+
+#include "bbque/utils/logging/logger.h"
+#include "bbque/utils/utility.h"
+#include "bbque/config.h"
+
+#include <boost/program_options.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <sys/utsname.h>
+#include <unistd.h>
+
+namespace po = boost::program_options;
+
+
+namespace bbque {
+namespace plugins {
+
+/** Set true it means the plugin has read its options in the config file*/
+bool SysfsPlatformLoader::configured = false;
+
+/** The root of the sysfs topology */
+std::string SysfsPlatformLoader::sysfs_root = BBQUE_SYSFS_PLOADER_ROOT;
+
+/** The CPUs reserved to the host */
+std::string SysfsPlatformLoader::host_cpus = "";
+
+/** The share of each processing element */
+uint16_t SysfsPlatformLoader::pe_share = 100;
+
+/** Map of options (in the Barbeque config file) for the plugin */
+static po::variables_map sysfsploader_opts_value;
+
+SysfsPlatformLoader::~SysfsPlatformLoader() {
+
+}
+
+SysfsPlatformLoader::SysfsPlatformLoader() : initialized(false)
+{
+	// Get a logger
+	logger = bu::Logger::GetLogger(MODULE_NAMESPACE);
+	assert(logger);
+	logger->Debug("Built Sysfs PlatformLoader object @%p", (void*)this);
+
+	// Save the hostname of the current machine for future use.
+	local_hostname[1023] = '\0';
+	gethostname(local_hostname, 1023);
+}
+
+SysfsPlatformLoader::ExitCode_t SysfsPlatformLoader::loadPlatformInfo() noexcept {
+
+	if (this->initialized) {
+		logger->Warn("SysfsPlatformLoader already initialized (I will ignore"
+						"the replicated loadPlatformInfo() call)");
+		return PL_SUCCESS;
+	}
+
+	logger->Info("Discovering the local system topology from '%s'...",
+			sysfs_root.c_str());
+
+	ExitCode_t error = PL_GENERIC_ERROR;
+	try {
+		pp::PlatformDescription::System sys;
+		sys.SetId(0);
+		sys.SetLocal(true);
+		sys.SetHostname(local_hostname);
+
+		// Memories first, since referenced by the CPUs
+		std::map<int, int> cpu_nodes;
+		error = DiscoverMemories(sys, cpu_nodes);
+		if (error == PL_SUCCESS)
+			error = DiscoverCPUs(sys, cpu_nodes);
+		if (error == PL_SUCCESS)
+			pd.AddSystem(sys);
+	} catch(const std::runtime_error &e) {
+		logger->Error("Generic error: %s.", e.what());
+		error = PL_GENERIC_ERROR;
+	} catch(...) {
+		logger->Error("Generic error.");
+		error = PL_GENERIC_ERROR;
+	}
+
+	if (error != PL_SUCCESS) {
+		// Clean the platform description in case of error
+		this->pd = pp::PlatformDescription();
+		return error;
+	}
+
+	this->initialized = true;
+	return PL_SUCCESS;
+}
+
+const pp::PlatformDescription &SysfsPlatformLoader::getPlatformInfo() const {
+	if (!this->initialized) {
+		throw PlatformLoaderEXC("getPlatformInfo() called before initialization.");
+	}
+
+	return this->pd;
+}
+
+pp::PlatformDescription &SysfsPlatformLoader::getPlatformInfo() {
+	if (!this->initialized) {
+		throw PlatformLoaderEXC("getPlatformInfo() called before initialization.");
+	}
+
+	return this->pd;
+}
+
+// =======================[ Static plugin interface ]=========================
+
+void * SysfsPlatformLoader::Create(PF_ObjectParams *params) {
+	if (!Configure(params))
+		return nullptr;
+
+	return new SysfsPlatformLoader();
+}
+
+int32_t SysfsPlatformLoader::Destroy(void *plugin) {
+	if (!plugin)
+		return -1;
+	delete (SysfsPlatformLoader *)plugin;
+	return 0;
+}
+
+bool SysfsPlatformLoader::Configure(PF_ObjectParams * params) {
+
+	if (configured)
+		return true;
+
+	// Declare the supported options
+	po::options_description sysfsploader_opts_desc("Sysfs Platform Loader Options");
+	sysfsploader_opts_desc.add_options()
+		(MODULE_CONFIG".root_dir", po::value<std::string>
+		 (&sysfs_root)->default_value(BBQUE_SYSFS_PLOADER_ROOT),
+		 "root of the CPUs and NUMA nodes topology")
+		(MODULE_CONFIG".host_cpus", po::value<std::string>
+		 (&host_cpus)->default_value(""),
+		 "CPUs reserved to the host")
+		(MODULE_CONFIG".share", po::value<uint16_t>
+		 (&pe_share)->default_value(100),
+		 "share [%] of each processing element")
+	;
+
+	// Get configuration params
+	PF_Service_ConfDataIn data_in;
+	data_in.opts_desc = &sysfsploader_opts_desc;
+	PF_Service_ConfDataOut data_out;
+	data_out.opts_value = &sysfsploader_opts_value;
+
+	PF_ServiceData sd;
+	sd.id = MODULE_NAMESPACE;
+	sd.request = &data_in;
+	sd.response = &data_out;
+
+	int32_t response =
+		params->platform_services->InvokeService(PF_SERVICE_CONF_DATA, sd);
+
+	if (response!=PF_SERVICE_DONE)
+		return false;
+
+	if (daemonized)
+		syslog(LOG_INFO, "Using SysfsPlatformLoader topology root [%s]",
+				sysfs_root.c_str());
+	else
+		fprintf(stdout, FI("Using SysfsPlatformLoader topology root [%s]\n"),
+				sysfs_root.c_str());
+
+	configured = true;
+	return true;
+}
+
+// =======================[ Topology discovery ]=========================
+
+
+bool SysfsPlatformLoader::ParseCPUList(
+		const std::string & cpulist,
+		std::set<int> & ids) {
+	std::istringstream list_ss(cpulist);
+	std::string range;
+	char * end;
+
+	while (std::getline(list_ss, range, ',')) {
+		// Skip blanks and the trailing newline
+		size_t first = range.find_first_not_of(" \t\n");
+		if (first == std::string::npos)
+			continue;
+		range = range.substr(first, range.find_last_not_of(" \t\n") - first + 1);
+
+		long lo = strtol(range.c_str(), &end, 10);
+		long hi = lo;
+		if (*end == '-')
+			hi = strtol(end + 1, &end, 10);
+		if ((*end != '\0') || (lo < 0) || (hi < lo))
+			return false;
+
+		for (long id = lo; id <= hi; ++id)
+			ids.insert(id);
+	}
+
+	return true;
+}
+
+bool SysfsPlatformLoader::ReadAttribute(
+		const std::string & path,
+		std::string & value) const {
+	std::ifstream attr_file(path);
+	if (!attr_file.good())
+		return false;
+
+	std::getline(attr_file, value);
+	return !attr_file.fail();
+}
+
+int SysfsPlatformLoader::ReadAttribute(
+		const std::string & path,
+		int def_value) const {
+	std::string value;
+	if (!ReadAttribute(path, value))
+		return def_value;
+
+	try {
+		return std::stoi(value);
+	} catch(const std::exception &e) {
+		logger->Warn("'%s': not a valid integer [%s]", path.c_str(), value.c_str());
+	}
+
+	return def_value;
+}
+
+uint64_t SysfsPlatformLoader::ReadMemTotal(const std::string & path) const {
+	std::ifstream meminfo_file(path);
+	std::string line;
+
+	// Both "MemTotal: <n> kB" and "Node <id> MemTotal: <n> kB"
+	while (std::getline(meminfo_file, line)) {
+		size_t pos = line.find("MemTotal:");
+		if (pos == std::string::npos)
+			continue;
+		return strtoull(line.c_str() + pos + 9, nullptr, 10) * 1024;
+	}
+
+	return 0;
+}
+
+SysfsPlatformLoader::ExitCode_t SysfsPlatformLoader::DiscoverMemories(
+		pp::PlatformDescription::System & sys,
+		std::map<int, int> & cpu_nodes) {
+	std::string attr_str;
+	std::set<int> nodes;
+
+	// Kernels without NUMA support: the whole memory on a single node
+	if (!ReadAttribute(sysfs_root + "/node/online", attr_str) ||
+			!ParseCPUList(attr_str, nodes) || nodes.empty()) {
+		pp::PlatformDescription::Memory mem;
+		mem.SetPrefix(sys.GetPath());
+		mem.SetId(0);
+		mem.SetQuantity(ReadMemTotal("/proc/meminfo"));
+		sys.AddMemory(std::make_shared<pp::PlatformDescription::Memory>(mem));
+		logger->Info("No NUMA nodes: %lu MB of memory on a single node",
+				mem.GetQuantity() >> 20);
+		return PL_SUCCESS;
+	}
+
+	for (int node_id: nodes) {
+		std::string node_path(
+			sysfs_root + "/node/node" + std::to_string(node_id));
+
+		// Memories are identified by the node number
+		if (node_id > BBQUE_MAX_R_ID_NUM) {
+			logger->Warn("Node %d: ID out of range [0, %d], skipped "
+					"(increase CONFIG_BBQUE_RESOURCE_MAX_NUM)",
+					node_id, BBQUE_MAX_R_ID_NUM);
+			continue;
+		}
+
+		pp::PlatformDescription::Memory mem;
+		mem.SetPrefix(sys.GetPath());
+		mem.SetId(node_id);
+		mem.SetQuantity(ReadMemTotal(node_path + "/meminfo"));
+
+		// Distances to the online nodes, in ascending order (e.g.,
+		// "10 21"), mapped to the node IDs since they can have holes
+		if (ReadAttribute(node_path + "/distance", attr_str)) {
+			std::istringstream dist_ss(attr_str);
+			std::vector<uint32_t> distances(*nodes.rbegin() + 1, 0);
+			auto dst_it = nodes.begin();
+			uint32_t distance;
+			while ((dst_it != nodes.end()) && (dist_ss >> distance))
+				distances[*dst_it++] = distance;
+			mem.SetDistances(distances);
+		}
+
+		// CPUs of the node
+		std::set<int> cpus;
+		if (!ReadAttribute(node_path + "/cpulist", attr_str) ||
+				!ParseCPUList(attr_str, cpus)) {
+			logger->Warn("Node %d: CPUs list not available", node_id);
+		}
+		for (int cpu_id: cpus)
+			cpu_nodes[cpu_id] = node_id;
+
+		logger->Info("Node %d: %lu MB of memory, %zu CPUs",
+				node_id, mem.GetQuantity() >> 20, cpus.size());
+		sys.AddMemory(std::make_shared<pp::PlatformDescription::Memory>(mem));
+	}
+
+	return PL_SUCCESS;
+}
+
+void SysfsPlatformLoader::GetThreadInfo(
+		int cpu_id,
+		ThreadInfo_t & thread) const {
+	std::string cpu_path(sysfs_root + "/cpu/cpu" + std::to_string(cpu_id));
+	std::string attr_str;
+	std::set<int> siblings;
+
+	thread.package_id =
+		ReadAttribute(cpu_path + "/topology/physical_package_id", 0);
+
+	// The core is identified by its first hardware thread
+	thread.core_id = cpu_id;
+	if (ReadAttribute(cpu_path + "/topology/thread_siblings_list", attr_str) &&
+			ParseCPUList(attr_str, siblings) && !siblings.empty())
+		thread.core_id = *siblings.begin();
+
+	// The last level cache is the highest level data (or unified) cache
+	thread.llc_id = -1;
+	int llc_level = 0;
+	for (int index = 0; ; ++index) {
+		std::string index_path(
+			cpu_path + "/cache/index" + std::to_string(index));
+		if (!ReadAttribute(index_path + "/type", attr_str))
+			break;
+		if (attr_str == "Instruction")
+			continue;
+
+		int level = ReadAttribute(index_path + "/level", 0);
+		if (level <= llc_level)
+			continue;
+
+		siblings.clear();
+		if (!ReadAttribute(index_path + "/shared_cpu_list", attr_str) ||
+				!ParseCPUList(attr_str, siblings) || siblings.empty())
+			continue;
+
+		llc_level = level;
+		thread.llc_id = *siblings.begin();
+	}
+}
+
+SysfsPlatformLoader::ExitCode_t SysfsPlatformLoader::DiscoverCPUs(
+		pp::PlatformDescription::System & sys,
+		std::map<int, int> const & cpu_nodes) {
+	std::string attr_str;
+	std::set<int> online_ids;
+	std::set<int> host_ids;
+
+	if (!ReadAttribute(sysfs_root + "/cpu/online", attr_str) ||
+			!ParseCPUList(attr_str, online_ids) || online_ids.empty()) {
+		logger->Error("Online CPUs list not found in '%s'", sysfs_root.c_str());
+		return PL_NOT_FOUND;
+	}
+
+	if (!ParseCPUList(host_cpus, host_ids)) {
+		logger->Error("'%s' is not a valid value for `host_cpus`",
+				host_cpus.c_str());
+		return PL_LOGIC_ERROR;
+	}
+
+	// Check that share is in the limits
+	if (pe_share > 100) {
+		logger->Error("share must be between 0 and 100, but it's %i.", pe_share);
+		return PL_LOGIC_ERROR;
+	}
+
+	struct utsname uts;
+	std::string arch("unknown");
+	if (uname(&uts) == 0)
+		arch.assign(uts.machine);
+
+	// Group the hardware threads by package and last level cache
+	std::map<int, ThreadInfo_t> threads;
+	std::map<std::pair<int, int>, std::vector<int>> llc_groups;
+	int skipped_count = 0;
+	for (int cpu_id: online_ids) {
+		// Processing elements are identified by the CPU number
+		if (cpu_id > BBQUE_MAX_R_ID_NUM) {
+			++skipped_count;
+			continue;
+		}
+
+		ThreadInfo_t & thread(threads[cpu_id]);
+		GetThreadInfo(cpu_id, thread);
+
+		auto node_it = cpu_nodes.find(cpu_id);
+		thread.node_id = (node_it != cpu_nodes.end()) ? node_it->second : 0;
+
+		llc_groups[std::make_pair(thread.package_id, thread.llc_id)]
+			.push_back(cpu_id);
+	}
+
+	if (skipped_count > 0)
+		logger->Warn("%d CPUs skipped: IDs out of range [0, %d] "
+				"(increase CONFIG_BBQUE_RESOURCE_MAX_NUM)",
+				skipped_count, BBQUE_MAX_R_ID_NUM);
+
+	uint16_t cpu_count = 0;
+	int managed_count  = 0;
+	for (auto const & group: llc_groups) {
+		int node_id = threads[group.second.front()].node_id;
+		std::shared_ptr<pp::PlatformDescription::Memory>
+			curr_memory = sys.GetMemoryById(node_id);
+		if (curr_memory == nullptr) {
+			logger->Error("CPU%d: memory node %d not found",
+					group.second.front(), node_id);
+			return PL_LOGIC_ERROR;
+		}
+
+		pp::PlatformDescription::CPU cpu;
+		cpu.SetPrefix(sys.GetPath());
+		cpu.SetArchitecture(arch);
+		cpu.SetId(cpu_count++);
+		cpu.SetSocketId(group.first.first);
+		cpu.SetMemory(curr_memory);
+
+		for (int cpu_id: group.second) {
+			ThreadInfo_t const & thread(threads[cpu_id]);
+			if (thread.node_id != node_id)
+				logger->Warn("CPU%d: on node %d, while its cache group "
+						"is on node %d", cpu_id, thread.node_id, node_id);
+
+			pp::PlatformDescription::ProcessingElement pe(
+				cpu_id, thread.core_id, pe_share,
+				host_ids.count(cpu_id) ?
+					pp::PlatformDescription::HOST :
+					pp::PlatformDescription::MDEV);
+			pe.SetPrefix(cpu.GetPath());
+			cpu.AddProcessingElement(pe);
+			if (pe.GetPartitionType() != pp::PlatformDescription::HOST)
+				++managed_count;
+		}
+
+		logger->Info("%s: socket %d, node %d, %zu processing elements",
+				cpu.GetPath().c_str(), cpu.GetSocketId(), node_id,
+				group.second.size());
+		sys.AddCPU(cpu);
+	}
+
+	if (managed_count == 0)
+		logger->Warn("No processing elements available for the applications");
+
+	return PL_SUCCESS;
+}
+
+}   // namespace plugins
+}   // namespace bbque
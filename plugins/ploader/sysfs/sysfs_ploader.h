@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2017  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BBQUE_SYSFS_PLATFORM_LOADER_H_
+#define BBQUE_SYSFS_PLATFORM_LOADER_H_
+
+#include "bbque/plugins/platform_loader.h"
+#include "bbque/plugin_manager.h"
+#include "bbque/plugins/plugin.h"
+
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+#define MODULE_NAMESPACE PLATFORM_LOADER_NAMESPACE".sysfs"
+#define MODULE_CONFIG PLATFORM_LOADER_CONFIG".sysfs"
+
+/** The default root of the CPUs and NUMA nodes topology */
+#define BBQUE_SYSFS_PLOADER_ROOT "/sys/devices/system"
+
+
+namespace bbque {
+namespace plugins {
+
+/**
+ * @class SysfsPlatformLoader
+ * @brief Platform loader discovering the local system topology from sysfs
+ *
+ * The description of the local system is built at startup, without any
+ * platform XML file, from the CPUs and NUMA nodes exported by the kernel
+ * under BBQUE_SYSFS_PLOADER_ROOT:
+ * - a memory for each NUMA node, with the distances to the other nodes;
+ * - a CPU for each group of processing elements sharing the last level
+ *   cache (or the physical package, if no cache information is available),
+ *   bound to the memory of the node it belongs to;
+ * - a processing element for each online hardware thread, whose ID is the
+ *   Linux CPU number and whose core ID is the first thread of its core.
+ *
+ * CPUs and nodes whose number is beyond BBQUE_MAX_R_ID_NUM are skipped,
+ * with a warning, since they could not be identified as resources.
+ *
+ * Processing elements are managed (MDEV) unless listed into the
+ * "host_cpus" option, which reserves them to the host.
+ */
+class SysfsPlatformLoader : PlatformLoaderIF
+{
+public:
+
+	/**
+	 * @brief The runtime_error class for SysfsPlatformLoader errors.
+	 */
+	class PlatformLoaderEXC : public std::runtime_error {
+	public:
+		PlatformLoaderEXC(const char* x) : std::runtime_error(x) { }
+	};
+
+	using PlatformLoaderIF::ExitCode_t;
+
+	/**
+	 * Default destructor
+	 */
+	virtual ~SysfsPlatformLoader();
+
+
+	/**
+	 * @brief Method for creating the static plugin
+	 */
+	static void * Create(PF_ObjectParams *);
+
+	/**
+	 * @brief Method for destroying the static plugin
+	 */
+	static int32_t Destroy(void *);
+
+	/**
+	 * @brief  Discover the topology of the local system.
+	 *         Call multiple times this method does not imply a reloading, but
+	 *         a warning generation.
+	 * @return PL_SUCCESS in case of success or the error id in case of
+	 *         failure.
+	 */
+	virtual ExitCode_t loadPlatformInfo() noexcept final;
+
+	/**
+	 * @brief Return the loaded platform description. You must have successfully
+	 *        called loadPlatformInfo() before call this method.
+	 * @throw std::runtime_error in case of non loaded platform.
+	 * @return The current PlatformDescription.
+	 */
+	virtual const pp::PlatformDescription &getPlatformInfo() const final;
+	virtual       pp::PlatformDescription &getPlatformInfo()       final;
+
+	/**
+	 * @brief Parse a kernel CPU list (e.g., "0-3,8,10-11")
+	 *
+	 * @param cpulist The string to parse
+	 * @param ids The set to fill with the listed IDs
+	 * @return false in case of syntax error
+	 */
+	static bool ParseCPUList(const std::string & cpulist, std::set<int> & ids);
+
+private:
+
+	/** Topology of an online hardware thread */
+	struct ThreadInfo_t {
+		/** The physical package */
+		int package_id;
+		/** The first thread of the same core */
+		int core_id;
+		/** The first thread sharing the last level cache (-1 if unknown) */
+		int llc_id;
+		/** The NUMA node */
+		int node_id;
+	};
+
+	/**
+	 * @brief System logger instance
+	 */
+	std::unique_ptr<bu::Logger> logger;
+
+	/**
+	 * @brief True when the topology has been discovered and the platform
+	 *        description loaded into the object.
+	 */
+	bool initialized;
+
+	/**
+	 * Set true when the platform loader has been configured.
+	 * This is done by parsing a configuration file the first time a
+	 * platform loader is created.
+	 */
+	static bool configured;
+
+	/** The root of the sysfs topology */
+	static std::string sysfs_root;
+
+	/** The CPUs reserved to the host (kernel CPU list) */
+	static std::string host_cpus;
+
+	/** The share of each processing element [%] */
+	static uint16_t pe_share;
+
+	/**
+	 * @brief Load the platform loader configuration
+	 *
+	 * @param params @see PF_ObjectParams
+	 * @return True if the configuration has been properly loaded and object
+	 * could be built, false otherwise
+	 */
+	static bool Configure(PF_ObjectParams * params);
+
+
+	pp::PlatformDescription pd;
+
+	/**
+	 * @brief The local hostname of this machine.
+	 */
+	char local_hostname[1024];
+
+
+	SysfsPlatformLoader();
+
+	/**
+	 * @brief Read the first line of a sysfs attribute
+	 *
+	 * @return false if the attribute is not available
+	 */
+	bool ReadAttribute(const std::string & path, std::string & value) const;
+
+	/**
+	 * @brief Read a sysfs attribute as an integer
+	 *
+	 * @return The value, or def_value if not available
+	 */
+	int ReadAttribute(const std::string & path, int def_value) const;
+
+	/**
+	 * @brief Read the "MemTotal" entry of a meminfo file
+	 *
+	 * @return The amount of memory [bytes], 0 if not available
+	 */
+	uint64_t ReadMemTotal(const std::string & path) const;
+
+	/**
+	 * @brief Add a memory for each (online) NUMA node
+	 *
+	 * @param sys The system description to fill
+	 * @param cpu_nodes Filled with the NUMA node of each CPU
+	 */
+	ExitCode_t DiscoverMemories(pp::PlatformDescription::System & sys,
+			std::map<int, int> & cpu_nodes);
+
+	/**
+	 * @brief Add a CPU for each group of processing elements sharing the
+	 * last level cache
+	 */
+	ExitCode_t DiscoverCPUs(pp::PlatformDescription::System & sys,
+			std::map<int, int> const & cpu_nodes);
+
+	/**
+	 * @brief Collect the topology of an online hardware thread
+	 */
+	void GetThreadInfo(int cpu_id, ThreadInfo_t & thread) const;
+
+};
+
+
+}   // namespace plugins
+}   // namespace bbque
+#endif // BBQUE_SYSFS_PLATFORM_LOADER_H_
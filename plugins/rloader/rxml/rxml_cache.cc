@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2012  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rxml_cache.h"
+
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace bbque
+{
+namespace plugins
+{
+
+RecipeCacheFile::RecipeCacheFile(std::string const & path)
+{
+	struct stat st;
+	int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return;
+
+	if ((fstat(fd, &st) == 0) && (st.st_size > 0)) {
+		void * addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (addr != MAP_FAILED) {
+			data = static_cast<const char *>(addr);
+			size = st.st_size;
+		}
+	}
+	::close(fd);
+}
+
+RecipeCacheFile::~RecipeCacheFile()
+{
+	if (data)
+		munmap(const_cast<char *>(data), size);
+}
+
+bool RecipeCacheFile::Store(std::string const & path, std::string const & content)
+{
+	// Write a temporary file and rename it, so that concurrent readers
+	// always map either the old or the new compiled recipe
+	std::string tmp_path(path + "." + std::to_string(getpid()));
+	int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+			0644);
+	if (fd < 0)
+		return false;
+
+	size_t written = 0;
+	while (written < content.size()) {
+		ssize_t ret = ::write(fd, content.data() + written,
+				content.size() - written);
+		if (ret < 0) {
+			::close(fd);
+			::unlink(tmp_path.c_str());
+			return false;
+		}
+		written += ret;
+	}
+	::close(fd);
+
+	if (::rename(tmp_path.c_str(), path.c_str()) != 0) {
+		::unlink(tmp_path.c_str());
+		return false;
+	}
+	return true;
+}
+
+} // namespace plugins
+
+} // namespace bbque
@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2012  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BBQUE_RXML_CACHE_H_
+#define BBQUE_RXML_CACHE_H_
+
+#include "bbque/plugins/recipe_loader.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+/**
+ * Compiled recipes
+ *
+ * A compiled recipe is the sequence of the operations performed by the
+ * RXMLRecipeLoader on the Recipe object while parsing the XML file, e.g.,
+ * "add the working mode 3", "add a request of 200 for sys0.cpu.pe", ...
+ * Replaying such sequence builds the same Recipe object without parsing the
+ * XML file, while the checks depending on the current system status (i.e.,
+ * the availability of the requested resources) are still performed.
+ *
+ * Each compiled recipe is stored in a file, made by a header identifying the
+ * source recipe file (path, modification time and size), the recipe loader
+ * version and the platform section it was compiled for, followed by the
+ * encoded operations. All the integers are encoded in little-endian order,
+ * strings are prefixed by their u16 length.
+ */
+
+#define RXML_CACHE_MAGIC    0x43525142 // "BQRC"
+#define RXML_CACHE_VERSION  1
+
+/** The suffix of the compiled recipe files */
+#define RXML_CACHE_SUFFIX   ".rcache"
+
+namespace bbque
+{
+namespace plugins
+{
+
+/** The operations of a compiled recipe */
+enum RecipeCacheOp_t : uint8_t {
+	RCO_END = 0,
+	RCO_PRIORITY,         /// u8 priority
+	RCO_AWM,              /// u8 id, str name, u8 value, i32 config_time
+	RCO_AWM_RESOURCE,     /// str path, u64 amount
+	RCO_AWM_PLUGIN_DATA,  /// str plugin, str key, str value
+	RCO_TASK_REQS,        /// u32 id, f32 tput, u32 ctime, u32 inbw, u32 outbw,
+	                      /// u8 count, [u8 arch]...
+	RCO_TG_MAPPING,       /// u32 id, u32 exec_time, u32 power, u32 mem_bw,
+	                      /// 2 x (u32 count, [u32 obj, u8 type, u32 id, u32 freq]...)
+	RCO_CONSTRAINT,       /// str resource, u64 lower, u64 upper
+	RCO_APP_PLUGIN_DATA   /// str plugin, str key, str value
+};
+
+/** The identification of a compiled recipe */
+struct RecipeCacheKey_t {
+	std::string source_path;
+	int64_t source_mtime;
+	uint64_t source_size;
+	std::string platform;
+};
+
+/**
+ * @class RecipeCacheWriter
+ * @brief Append the encoding of the recipe operations to a buffer
+ */
+class RecipeCacheWriter
+{
+public:
+
+	inline void Put8(uint8_t v) {
+		out.push_back(static_cast<char>(v));
+	}
+
+	inline void Put16(uint16_t v) {
+		Put8(v & 0xFF); Put8(v >> 8);
+	}
+
+	inline void Put32(uint32_t v) {
+		Put16(v & 0xFFFF); Put16(v >> 16);
+	}
+
+	inline void Put64(uint64_t v) {
+		Put32(v & 0xFFFFFFFF); Put32(v >> 32);
+	}
+
+	inline void PutFloat(float v) {
+		uint32_t bits;
+		memcpy(&bits, &v, sizeof(bits));
+		Put32(bits);
+	}
+
+	inline void PutString(std::string const & s) {
+		uint16_t len = s.size() > UINT16_MAX ? UINT16_MAX : s.size();
+		Put16(len);
+		out.append(s, 0, len);
+	}
+
+	/**
+	 * @brief Encode the header identifying the compiled recipe
+	 */
+	void PutHeader(RecipeCacheKey_t const & key) {
+		Put32(RXML_CACHE_MAGIC);
+		Put16(RXML_CACHE_VERSION);
+		Put16(RECIPE_MAJOR_VERSION << 8 | RECIPE_MINOR_VERSION);
+		Put64(key.source_mtime);
+		Put64(key.source_size);
+		PutString(key.source_path);
+		PutString(key.platform);
+	}
+
+	inline std::string const & Data() const {
+		return out;
+	}
+
+	inline void Clear() {
+		out.clear();
+	}
+
+private:
+
+	std::string out;
+};
+
+/**
+ * @class RecipeCacheReader
+ * @brief Decode the recipe operations from a buffer
+ *
+ * Reading beyond the end of the buffer does not fail immediately, but it
+ * makes Good() return false.
+ */
+class RecipeCacheReader
+{
+public:
+
+	RecipeCacheReader(const char * data, size_t size):
+		pos(reinterpret_cast<const uint8_t *>(data)),
+		end(reinterpret_cast<const uint8_t *>(data) + size) {}
+
+	inline bool Good() const {
+		return good;
+	}
+
+	inline uint8_t Get8() {
+		if (pos >= end) {
+			good = false;
+			return 0;
+		}
+		return *pos++;
+	}
+
+	inline uint16_t Get16() {
+		uint16_t v = Get8();
+		return v | (static_cast<uint16_t>(Get8()) << 8);
+	}
+
+	inline uint32_t Get32() {
+		uint32_t v = Get16();
+		return v | (static_cast<uint32_t>(Get16()) << 16);
+	}
+
+	inline uint64_t Get64() {
+		uint64_t v = Get32();
+		return v | (static_cast<uint64_t>(Get32()) << 32);
+	}
+
+	inline float GetFloat() {
+		uint32_t bits = Get32();
+		float v;
+		memcpy(&v, &bits, sizeof(v));
+		return v;
+	}
+
+	inline std::string GetString() {
+		uint16_t len = Get16();
+		if (end - pos < len) {
+			good = false;
+			return std::string();
+		}
+		std::string s(reinterpret_cast<const char *>(pos), len);
+		pos += len;
+		return s;
+	}
+
+	/**
+	 * @brief Decode the header and check it matches the given key
+	 * @return false if the compiled recipe is not valid for the key
+	 */
+	bool CheckHeader(RecipeCacheKey_t const & key) {
+		if (Get32() != RXML_CACHE_MAGIC)
+			return false;
+		if (Get16() != RXML_CACHE_VERSION)
+			return false;
+		if (Get16() != (RECIPE_MAJOR_VERSION << 8 | RECIPE_MINOR_VERSION))
+			return false;
+		if (static_cast<int64_t>(Get64()) != key.source_mtime)
+			return false;
+		if (Get64() != key.source_size)
+			return false;
+		if (GetString() != key.source_path)
+			return false;
+		if (GetString() != key.platform)
+			return false;
+		return good;
+	}
+
+private:
+
+	const uint8_t * pos;
+	const uint8_t * end;
+	bool good = true;
+};
+
+/**
+ * @class RecipeCacheFile
+ * @brief A read-only memory mapping of a compiled recipe file
+ */
+class RecipeCacheFile
+{
+public:
+
+	/**
+	 * @brief Map the file, if it exists
+	 */
+	RecipeCacheFile(std::string const & path);
+
+	~RecipeCacheFile();
+
+	inline bool IsMapped() const {
+		return data != nullptr;
+	}
+
+	inline const char * Data() const {
+		return data;
+	}
+
+	inline size_t Size() const {
+		return size;
+	}
+
+	/**
+	 * @brief Atomically replace the content of a compiled recipe file
+	 * @return false in case of error
+	 */
+	static bool Store(std::string const & path, std::string const & content);
+
+private:
+
+	const char * data = nullptr;
+
+	size_t size = 0;
+};
+
+} // namespace plugins
+
+} // namespace bbque
+
+#endif // BBQUE_RXML_CACHE_H_
@@ -51,6 +51,9 @@ bool RXMLRecipeLoader::configured = false;
 /** Recipes directory */
 std::string RXMLRecipeLoader::recipe_dir = "";
 
+/** Compiled recipes directory */
+std::string RXMLRecipeLoader::cache_dir = "";
+
 /** Map of options (in the Barbeque config file) for the plugin */
 po::variables_map xmlrloader_opts_value;
 
@@ -80,6 +83,9 @@ bool RXMLRecipeLoader::Configure(PF_ObjectParams * params)
 	(MODULE_CONFIG".recipe_dir", po::value<std::string>
 	 (&recipe_dir)->default_value(BBQUE_PATH_PREFIX "/" BBQUE_PATH_RECIPES),
 	 "recipes folder")
+	(MODULE_CONFIG".cache_dir", po::value<std::string>
+	 (&cache_dir)->default_value(BBQUE_PATH_VAR "/recipes.cache"),
+	 "compiled recipes folder (empty to disable)")
 	;
 
 	// Get configuration params
@@ -106,6 +112,23 @@ bool RXMLRecipeLoader::Configure(PF_ObjectParams * params)
 		fprintf(stdout, FI("Using RXMLRecipeLoader recipe folder [%s]\n"),
 		        recipe_dir.c_str());
 
+	// The compiled recipes are just an optimization: disable them if the
+	// folder is not available
+	boost::system::error_code ec;
+	if (!cache_dir.empty()) {
+		boost::filesystem::create_directories(cache_dir, ec);
+		if (ec) {
+			if (daemonized)
+				syslog(LOG_WARNING, "Compiled recipes folder [%s] not "
+				       "available: %s", cache_dir.c_str(), ec.message().c_str());
+			else
+				fprintf(stdout, FW("Compiled recipes folder [%s] not "
+				        "available: %s\n"), cache_dir.c_str(),
+				        ec.message().c_str());
+			cache_dir.clear();
+		}
+	}
+
 	return true;
 }
 
@@ -151,6 +174,14 @@ RecipeLoaderIF::ExitCode_t RXMLRecipeLoader::LoadRecipe(
 	recipe_ptr = _recipe;
 	logger->Info("Loading recipe <%s>...", _recipe_name.c_str());
 
+	// Compiled version of the recipe
+	RecipeCacheKey_t cache_key;
+	bool cache_enabled = GetCacheKey(_recipe_name, cache_key);
+	if (cache_enabled && LoadCachedRecipe(_recipe_name, cache_key))
+		return RL_SUCCESS;
+	cache_ops.Clear();
+	cache_complete = true;
+
 	try {
 		// Plugin needs a logger
 		if (!logger) {
@@ -197,6 +228,8 @@ RecipeLoaderIF::ExitCode_t RXMLRecipeLoader::LoadRecipe(
 			std::string priority_str(app_attribute->value());
 			priority = (uint8_t) atoi(priority_str.c_str());
 			recipe_ptr->SetPriority(priority);
+			cache_ops.Put8(RCO_PRIORITY);
+			cache_ops.Put8(priority);
 
 			// Load the proper platform section
 			pp_node = LoadPlatform(app_node);
@@ -221,6 +254,10 @@ RecipeLoaderIF::ExitCode_t RXMLRecipeLoader::LoadRecipe(
 			LoadConstraints(pp_node);
 			LoadPluginsData<ba::RecipePtr_t>(recipe_ptr, pp_node);
 
+			// Compile the recipe, unless parts of it have been skipped
+			if (cache_enabled && cache_complete)
+				StoreCachedRecipe(_recipe_name, cache_key);
+
 		} catch(rapidxml::parse_error ex) {
 			logger->Error(ex.what());
 			result = RL_ABORTED;
@@ -335,6 +372,241 @@ std::time_t RXMLRecipeLoader::LastModifiedTime(std::string const & _name)
 }
 
 
+//========================[ Compiled recipes ]================================
+
+bool RXMLRecipeLoader::GetCacheKey(
+    std::string const & _recipe_name,
+    RecipeCacheKey_t & key)
+{
+	boost::system::error_code ec;
+
+	if (cache_dir.empty())
+		return false;
+
+	key.source_path = recipe_dir + "/" + _recipe_name + ".recipe";
+	key.source_mtime = boost::filesystem::last_write_time(key.source_path, ec);
+	if (ec)
+		return false;
+	key.source_size = boost::filesystem::file_size(key.source_path, ec);
+	if (ec)
+		return false;
+
+	// The platform section parsed depends on the system platform
+#ifndef CONFIG_BBQUE_TEST_PLATFORM_DATA
+	PlatformManager & plm = PlatformManager::GetInstance();
+	const char * platform_id = plm.GetPlatformID();
+	const char * hardware_id = plm.GetHardwareID();
+	if (!platform_id)
+		return false;
+	key.platform = std::string(platform_id) + ":" +
+		(hardware_id ? hardware_id : "");
+#else
+	key.platform = "TPD";
+#endif
+	return true;
+}
+
+std::string RXMLRecipeLoader::GetCachePath(std::string const & _recipe_name)
+{
+	std::string file_name(_recipe_name);
+	std::replace(file_name.begin(), file_name.end(), '/', '_');
+	return cache_dir + "/" + file_name + RXML_CACHE_SUFFIX;
+}
+
+bool RXMLRecipeLoader::LoadCachedRecipe(
+    std::string const & _recipe_name,
+    RecipeCacheKey_t const & key)
+{
+	RecipeCacheFile cache_file(GetCachePath(_recipe_name));
+	if (!cache_file.IsMapped()) {
+		logger->Debug("LoadCachedRecipe: <%s> not compiled yet",
+		              _recipe_name.c_str());
+		return false;
+	}
+
+	RecipeCacheReader header(cache_file.Data(), cache_file.Size());
+	if (!header.CheckHeader(key)) {
+		logger->Info("LoadCachedRecipe: <%s> compiled version out of date",
+		             _recipe_name.c_str());
+		return false;
+	}
+
+	// Validate the whole compiled recipe before touching the recipe object
+	RecipeCacheReader validation(header);
+	if (!ReplayCachedRecipe(validation, false)) {
+		logger->Warn("LoadCachedRecipe: <%s> compiled version corrupted",
+		             _recipe_name.c_str());
+		return false;
+	}
+
+	ReplayCachedRecipe(header, true);
+	logger->Info("LoadCachedRecipe: <%s> loaded from compiled version",
+	             _recipe_name.c_str());
+	return true;
+}
+
+bool RXMLRecipeLoader::ReplayCachedRecipe(
+    RecipeCacheReader & reader,
+    bool apply)
+{
+	AwmPtr_t awm;
+	bool in_awm = false;
+	bool awm_weak = false;
+	uint8_t op = RCO_END;
+
+	while (reader.Good() && ((op = reader.Get8()) != RCO_END)) {
+		switch (op) {
+		case RCO_PRIORITY: {
+			uint8_t priority = reader.Get8();
+			if (apply)
+				recipe_ptr->SetPriority(priority);
+			break;
+		}
+		case RCO_AWM: {
+			uint8_t wm_id = reader.Get8();
+			std::string wm_name(reader.GetString());
+			uint8_t wm_value = reader.Get8();
+			int32_t wm_config_time = reader.Get32();
+			in_awm = true;
+			if (!apply)
+				break;
+			awm = recipe_ptr->AddWorkingMode(wm_id, wm_name, wm_value);
+			if (!awm) {
+				logger->Error("AWM {%d:%s} error: Wrong ID specified %d",
+				              wm_id, wm_name.c_str(), wm_id);
+				return false;
+			}
+			if (wm_config_time > 0)
+				awm->SetRecipeConfigTime(wm_config_time);
+			awm_weak = false;
+			break;
+		}
+		case RCO_AWM_RESOURCE: {
+			std::string res_path(reader.GetString());
+			uint64_t res_usage = reader.Get64();
+			if (!in_awm)
+				return false;
+			if (!apply || awm_weak)
+				break;
+			if (AppendToWorkingMode(awm, res_path, res_usage) != __RSRC_SUCCESS) {
+				logger->Warn("AWM {%d:%s} weak load detected: skipping",
+				             awm->Id(), awm->Name().c_str());
+				awm_weak = true;
+			}
+			break;
+		}
+		case RCO_AWM_PLUGIN_DATA:
+		case RCO_APP_PLUGIN_DATA: {
+			std::string plugin(reader.GetString());
+			std::string key(reader.GetString());
+			std::string value(reader.GetString());
+			if ((op == RCO_AWM_PLUGIN_DATA) && !in_awm)
+				return false;
+			if (!apply || ((op == RCO_AWM_PLUGIN_DATA) && awm_weak))
+				break;
+			ba::AppPluginDataPtr_t pattr(new ba::AppPluginData_t(plugin, key));
+			pattr->str = value;
+			if (op == RCO_AWM_PLUGIN_DATA)
+				awm->SetPluginData(pattr);
+			else
+				recipe_ptr->SetPluginData(pattr);
+			break;
+		}
+		case RCO_TASK_REQS: {
+			uint32_t id = reader.Get32();
+			float tp = reader.GetFloat();
+			uint32_t ct = reader.Get32();
+			uint32_t inb = reader.Get32();
+			uint32_t outb = reader.Get32();
+			uint8_t num_archs = reader.Get8();
+			if (apply)
+				recipe_ptr->AddTaskRequirements(
+				    id, TaskRequirements(tp, ct, inb, outb));
+			for (uint8_t i = 0; i < num_archs; ++i) {
+				ArchType type = static_cast<ArchType>(reader.Get8());
+				if (apply)
+					recipe_ptr->GetTaskRequirements(id).AddArchPreference(type);
+			}
+			break;
+		}
+		case RCO_TG_MAPPING: {
+			ba::Recipe::TaskGraphMapping mapping;
+			uint32_t id = reader.Get32();
+			mapping.exec_time_ms = reader.Get32();
+			mapping.power_mw = reader.Get32();
+			mapping.mem_bw = reader.Get32();
+			for (auto mapping_map: { &mapping.tasks, &mapping.buffers }) {
+				uint32_t count = reader.Get32();
+				for (uint32_t i = 0; reader.Good() && (i < count); ++i) {
+					uint32_t obj_id = reader.Get32();
+					ba::Recipe::MappingData & map_data((*mapping_map)[obj_id]);
+					map_data.type = static_cast<br::ResourceType>(reader.Get8());
+					map_data.id = reader.Get32();
+					map_data.freq_khz = reader.Get32();
+				}
+			}
+			if (apply)
+				recipe_ptr->AddTaskGraphMapping(id, mapping);
+			break;
+		}
+		case RCO_CONSTRAINT: {
+			std::string resource(reader.GetString());
+			uint64_t lower = reader.Get64();
+			uint64_t upper = reader.Get64();
+			if (apply)
+				recipe_ptr->AddConstraint(resource, lower, upper);
+			break;
+		}
+		default:
+			return false;
+		}
+	}
+
+	return reader.Good() && (op == RCO_END);
+}
+
+void RXMLRecipeLoader::StoreCachedRecipe(
+    std::string const & _recipe_name,
+    RecipeCacheKey_t const & key)
+{
+	RecipeCacheWriter cache_file;
+	std::string cache_path(GetCachePath(_recipe_name));
+
+	cache_file.PutHeader(key);
+	cache_ops.Put8(RCO_END);
+	if (!RecipeCacheFile::Store(
+	        cache_path, cache_file.Data() + cache_ops.Data())) {
+		logger->Warn("StoreCachedRecipe: <%s> cannot write [%s]",
+		             _recipe_name.c_str(), cache_path.c_str());
+		return;
+	}
+	logger->Debug("StoreCachedRecipe: <%s> compiled into [%s]",
+	              _recipe_name.c_str(), cache_path.c_str());
+}
+
+void RXMLRecipeLoader::RecordPluginData(
+    ba::AwmPtr_t,
+    std::string const & plugin,
+    ba::AppPluginDataPtr_t pattr)
+{
+	cache_ops.Put8(RCO_AWM_PLUGIN_DATA);
+	cache_ops.PutString(plugin);
+	cache_ops.PutString(pattr->key);
+	cache_ops.PutString(pattr->str);
+}
+
+void RXMLRecipeLoader::RecordPluginData(
+    ba::RecipePtr_t,
+    std::string const & plugin,
+    ba::AppPluginDataPtr_t pattr)
+{
+	cache_ops.Put8(RCO_APP_PLUGIN_DATA);
+	cache_ops.PutString(plugin);
+	cache_ops.PutString(pattr->key);
+	cache_ops.PutString(pattr->str);
+}
+
+
 //========================[ Working modes ]===================================
 
 RecipeLoaderIF::ExitCode_t RXMLRecipeLoader::LoadWorkingModes(rapidxml::xml_node<>  *_xml_elem)
@@ -383,6 +655,11 @@ RecipeLoaderIF::ExitCode_t RXMLRecipeLoader::LoadWorkingModes(rapidxml::xml_node
 				              wm_id, wm_name.c_str(), wm_id);
 				return RL_FORMAT_ERROR;
 			}
+			cache_ops.Put8(RCO_AWM);
+			cache_ops.Put8(wm_id);
+			cache_ops.PutString(wm_name);
+			cache_ops.Put8(wm_value);
+			cache_ops.Put32(wm_config_time);
 
 			// Configuration time
 			if (wm_config_time > 0) {
@@ -402,6 +679,7 @@ RecipeLoaderIF::ExitCode_t RXMLRecipeLoader::LoadWorkingModes(rapidxml::xml_node
 			else if (result & __RSRC_WEAK_LOAD) {
 				logger->Warn("AWM {%d:%s} weak load detected: skipping",
 				             wm_id, wm_name.c_str());
+				cache_complete = false;
 				awm_elem = awm_elem->next_sibling("awm", 0, false);
 				continue;
 			}
@@ -499,6 +777,7 @@ void RXMLRecipeLoader::LoadTasksRequirements(rapidxml::xml_node<> *_xml_elem)
 			logger->Debug("LoadTasksRequirements: hw_prefs=%s", read_attrib.c_str());
 
 			std::list<std::string> archs;
+			std::vector<ArchType> arch_types;
 			bu::SplitString(read_attrib, archs, ",");
 			for(auto const & s: archs) {
 				ArchType type = GetArchTypeFromString(s);
@@ -507,8 +786,19 @@ void RXMLRecipeLoader::LoadTasksRequirements(rapidxml::xml_node<> *_xml_elem)
 					continue;
 				}
 				recipe_ptr->GetTaskRequirements(id).AddArchPreference(type);
+				arch_types.push_back(type);
 			}
 
+			cache_ops.Put8(RCO_TASK_REQS);
+			cache_ops.Put32(id);
+			cache_ops.PutFloat(tp);
+			cache_ops.Put32(ct);
+			cache_ops.Put32(inb);
+			cache_ops.Put32(outb);
+			cache_ops.Put8(arch_types.size());
+			for (auto type: arch_types)
+				cache_ops.Put8(static_cast<uint8_t>(type));
+
 			logger->Info("LoadTasksRequirements: <T%2d>: tput=%.2f ctime=%dms"
 			             " in_bw=%dKbps, out_bw=%dKbps #hw=<%d>", id,
 			             recipe_ptr->GetTaskRequirements(id).Throughput(),
@@ -581,6 +871,21 @@ void RXMLRecipeLoader::LoadTaskGraphMappings(rapidxml::xml_node<> *_xml_elem)
 			LoadTaskGraphMapping(map_elem, mapping);
 			recipe_ptr->AddTaskGraphMapping(id, mapping);
 
+			cache_ops.Put8(RCO_TG_MAPPING);
+			cache_ops.Put32(id);
+			cache_ops.Put32(mapping.exec_time_ms);
+			cache_ops.Put32(mapping.power_mw);
+			cache_ops.Put32(mapping.mem_bw);
+			for (auto mapping_map: { &mapping.tasks, &mapping.buffers }) {
+				cache_ops.Put32(mapping_map->size());
+				for (auto const & entry: *mapping_map) {
+					cache_ops.Put32(entry.first);
+					cache_ops.Put8(static_cast<uint8_t>(entry.second.type));
+					cache_ops.Put32(entry.second.id);
+					cache_ops.Put32(entry.second.freq_khz);
+				}
+			}
+
 			map_elem = map_elem->next_sibling("mapping", 0, false);
 		}
 
@@ -799,6 +1104,9 @@ uint8_t RXMLRecipeLoader::GetResourceAttributes(
 	// Convert the usage value accordingly to the units, and then append the
 	// request to the working mode.
 	res_usage = br::ConvertValue(res_usage, res_units);
+	cache_ops.Put8(RCO_AWM_RESOURCE);
+	cache_ops.PutString(_res_path);
+	cache_ops.Put64(res_usage);
 	return AppendToWorkingMode(_wm, _res_path, res_usage);
 }
 
@@ -871,6 +1179,7 @@ void RXMLRecipeLoader::GetPluginData(T _container,
 		                                 _plug_name, plugdata_node->name()));
 		pattr->str = plugdata_node->value();
 		_container->SetPluginData(pattr);
+		RecordPluginData(_container, _plug_name, pattr);
 
 	} catch (rapidxml::parse_error ex) {
 		logger->Error(ex.what());
@@ -912,8 +1221,16 @@ void RXMLRecipeLoader::LoadConstraints(rapidxml::xml_node<> * _xml_node)
 			// Add the constraint
 			if (constraint_type.compare("L") == 0) {
 				recipe_ptr->AddConstraint(resource, value, 0);
+				cache_ops.Put8(RCO_CONSTRAINT);
+				cache_ops.PutString(resource);
+				cache_ops.Put64(value);
+				cache_ops.Put64(0);
 			} else if (constraint_type.compare("U") == 0) {
 				recipe_ptr->AddConstraint(resource, 0, value);
+				cache_ops.Put8(RCO_CONSTRAINT);
+				cache_ops.PutString(resource);
+				cache_ops.Put64(0);
+				cache_ops.Put64(value);
 			} else {
 				logger->Warn("Constraint: unknown bound type");
 				continue;
@@ -28,6 +28,8 @@
 #include "bbque/utils/logging/logger.h"
 #include "bbque/utils/extra_data_container.h"
 
+#include "rxml_cache.h"
+
 #define MODULE_NAMESPACE RECIPE_LOADER_NAMESPACE".rxml"
 #define MODULE_CONFIG RECIPE_LOADER_CONFIG".rxml"
 
@@ -110,6 +112,26 @@ private:
 	 */
 	static std::string recipe_dir;
 
+	/**
+	 * The directory path containing the compiled recipes. Each recipe is
+	 * compiled into a file named with suffix <tt>.rcache</tt> the first time
+	 * it is parsed, and the compiled version is used until the recipe file
+	 * is modified. An empty path disables the compiled recipes.
+	 */
+	static std::string cache_dir;
+
+	/**
+	 * The operations performed on the recipe object while parsing the XML
+	 * file, i.e., the compiled recipe
+	 */
+	RecipeCacheWriter cache_ops;
+
+	/**
+	 * False if some sections of the XML file have been skipped (i.e., a weak
+	 * load happened), thus the compiled recipe is not complete
+	 */
+	bool cache_complete = false;
+
 	/**
 	 * Shared pointer to the recipe object
 	 */
@@ -129,6 +151,67 @@ private:
 	 */
 	static bool Configure(PF_ObjectParams * params);
 
+	/**
+	 * @brief Get the key identifying the compiled version of a recipe
+	 *
+	 * @param recipe_name The name of the recipe
+	 * @param key The key to fill
+	 * @return false if the compiled recipes are disabled or the recipe file
+	 * is missing
+	 */
+	bool GetCacheKey(std::string const & recipe_name, RecipeCacheKey_t & key);
+
+	/**
+	 * @brief The path of the compiled version of a recipe
+	 */
+	std::string GetCachePath(std::string const & recipe_name);
+
+	/**
+	 * @brief Load the recipe from its compiled version, if valid
+	 *
+	 * @param recipe_name The name of the recipe
+	 * @param key The key identifying the current version of the recipe
+	 * @return true if the recipe has been loaded, false if the XML file must
+	 * be parsed
+	 */
+	bool LoadCachedRecipe(
+	    std::string const & recipe_name,
+	    RecipeCacheKey_t const & key);
+
+	/**
+	 * @brief Replay the operations of a compiled recipe
+	 *
+	 * @param reader The reader of the operations
+	 * @param apply If false, the operations are only validated, otherwise
+	 * they are performed on the recipe object
+	 * @return false if the compiled recipe is not valid
+	 */
+	bool ReplayCachedRecipe(RecipeCacheReader & reader, bool apply);
+
+	/**
+	 * @brief Store the operations recorded while parsing the XML file as
+	 * the compiled version of the recipe
+	 */
+	void StoreCachedRecipe(
+	    std::string const & recipe_name,
+	    RecipeCacheKey_t const & key);
+
+	/**
+	 * @brief Record the plugin specific data of a working mode
+	 */
+	void RecordPluginData(
+	    ba::AwmPtr_t,
+	    std::string const & plugin,
+	    ba::AppPluginDataPtr_t pattr);
+
+	/**
+	 * @brief Record the plugin specific data of the application
+	 */
+	void RecordPluginData(
+	    ba::RecipePtr_t,
+	    std::string const & plugin,
+	    ba::AppPluginDataPtr_t pattr);
+
 	/**
 	 * @brief Lookup the platform section
 	 *
@@ -0,0 +1,488 @@
+/*
+ * Copyright (C) 2012  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "shm_rpc.h"
+
+#include "bbque/config.h"
+#include "bbque/cpp11/chrono.h"
+#include "bbque/cpp11/thread.h"
+#include "bbque/utils/utility.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cstring>
+
+namespace po = boost::program_options;
+
+namespace bbque { namespace plugins {
+
+ShmRPC::ShmChannel::ShmChannel(int slot, const char * name,
+		bl::rpc_shm_channel_t * pch) :
+	slot(slot),
+	pch(pch),
+	attach_time(std::chrono::steady_clock::now()),
+	paired(false) {
+	::strncpy(this->name, name, BBQUE_SHM_NAME_LENGTH);
+	this->name[BBQUE_SHM_NAME_LENGTH-1] = '\0';
+}
+
+ShmRPC::ShmChannel::~ShmChannel() {
+	::munmap(pch, sizeof(bl::rpc_shm_channel_t));
+}
+
+ShmRPC::ShmRPC(uint32_t tx_timeout_ms) :
+	initialized(false),
+	conf_tx_timeout_ms(tx_timeout_ms),
+	server(NULL),
+	next_slot(0) {
+
+	// Get a logger
+	logger = bu::Logger::GetLogger(MODULE_NAMESPACE);
+	assert(logger);
+
+	logger->Debug("Built SHM rpc object @%p", (void*)this);
+
+}
+
+ShmRPC::~ShmRPC() {
+
+	logger->Debug("SHM RPC: cleaning up region [%s]...", BBQUE_PUBLIC_SHM);
+
+	for (int i = 0; i < BBQUE_SHM_MAX_CLIENTS; ++i)
+		channels[i].reset();
+
+	if (server)
+		::munmap(server, sizeof(bl::rpc_shm_server_t));
+	// Remove the server side region
+	::shm_unlink(BBQUE_PUBLIC_SHM);
+}
+
+//----- RPCChannelIF module interface
+
+int ShmRPC::Init() {
+	void * paddr;
+	int fd;
+
+	if (initialized)
+		return 0;
+
+	logger->Debug("SHM RPC: channel initialization...");
+
+	// If the region already exists: destroy it and rebuild a new one
+	if (::shm_unlink(BBQUE_PUBLIC_SHM) == 0)
+		logger->Debug("SHM RPC: destroyed old region [%s]",
+				BBQUE_PUBLIC_SHM);
+
+	logger->Debug("SHM RPC: create region [%s]...", BBQUE_PUBLIC_SHM);
+	fd = ::shm_open(BBQUE_PUBLIC_SHM, O_RDWR | O_CREAT | O_EXCL, 0666);
+	if (fd < 0) {
+		logger->Error("SHM RPC: region [%s] creation FAILED "
+				"(Error %d: %s)",
+				BBQUE_PUBLIC_SHM, errno, strerror(errno));
+		return -1;
+	}
+
+	// Ensuring the region is R/W to everyone (despite of the umask)
+	if (fchmod(fd, S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP|S_IROTH|S_IWOTH) ||
+			ftruncate(fd, sizeof(bl::rpc_shm_server_t))) {
+		logger->Error("SHM RPC: region [%s] setup FAILED "
+				"(Error %d: %s)",
+				BBQUE_PUBLIC_SHM, errno, strerror(errno));
+		::close(fd);
+		::shm_unlink(BBQUE_PUBLIC_SHM);
+		return -2;
+	}
+
+	paddr = ::mmap(NULL, sizeof(bl::rpc_shm_server_t),
+			PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (paddr == MAP_FAILED) {
+		logger->Error("SHM RPC: region [%s] mapping FAILED "
+				"(Error %d: %s)",
+				BBQUE_PUBLIC_SHM, errno, strerror(errno));
+		::shm_unlink(BBQUE_PUBLIC_SHM);
+		return -3;
+	}
+
+	// The region is zero filled, i.e. all the slots are free. The version
+	// is set last: applications do not use the region before.
+	server = (bl::rpc_shm_server_t *)paddr;
+	std::atomic_thread_fence(std::memory_order_release);
+	server->version = BBQUE_RPC_SHM_VERSION;
+
+	// Marking channel as already initialized
+	initialized = true;
+
+	logger->Info("SHM RPC: channel initialization DONE");
+	return 0;
+}
+
+int ShmRPC::Poll() {
+	uint32_t doorbell = server->doorbell.load();
+	int ret = 0;
+
+	// Wait for a doorbell or signal
+	logger->Debug("SHM RPC: waiting message...");
+	server->sleeping.store(1);
+	ret = bl::rpc_shm_wait_doorbell(&server->doorbell, doorbell);
+	server->sleeping.store(0);
+	if (ret == -EINTR)
+		logger->Debug("SHM RPC: interrupted...");
+
+	return ret;
+}
+
+void ShmRPC::AttachChannels() {
+	bl::rpc_shm_channel_t * pch;
+	struct stat fd_stat;
+	void * paddr;
+	int fd;
+
+	for (int i = 0; i < BBQUE_SHM_MAX_CLIENTS; ++i) {
+		bl::rpc_shm_slot_t & slot(server->slots[i]);
+		if (slot.state.load() != bl::RPC_SHM_SLOT_READY)
+			continue;
+
+		slot.channel[BBQUE_SHM_NAME_LENGTH-1] = '\0';
+		logger->Debug("SHM RPC: attaching application channel [%s]...",
+				slot.channel);
+
+		// The application should build the channel, this could be used as
+		// an additional handshaking protocol and API versioning verification
+		fd = ::shm_open(slot.channel, O_RDWR, 0);
+		if (fd < 0) {
+			logger->Error("SHM RPC: opening channel [%s] FAILED "
+					"(Error %d: %s)",
+					slot.channel, errno, strerror(errno));
+			slot.state.store(bl::RPC_SHM_SLOT_FREE);
+			continue;
+		}
+
+		// Accessing a mapping beyond the end of the segment raises a
+		// SIGBUS, thus undersized segments must not be mapped
+		if (::fstat(fd, &fd_stat) < 0 ||
+				fd_stat.st_size < (off_t)sizeof(bl::rpc_shm_channel_t)) {
+			logger->Error("SHM RPC: channel [%s] size check FAILED "
+					"(%ld < %lu)", slot.channel,
+					(long)fd_stat.st_size,
+					sizeof(bl::rpc_shm_channel_t));
+			::close(fd);
+			slot.state.store(bl::RPC_SHM_SLOT_FREE);
+			continue;
+		}
+
+		paddr = ::mmap(NULL, sizeof(bl::rpc_shm_channel_t),
+				PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		::close(fd);
+		if (paddr == MAP_FAILED) {
+			logger->Error("SHM RPC: mapping channel [%s] FAILED "
+					"(Error %d: %s)",
+					slot.channel, errno, strerror(errno));
+			slot.state.store(bl::RPC_SHM_SLOT_FREE);
+			continue;
+		}
+
+		pch = (bl::rpc_shm_channel_t *)paddr;
+		if (pch->version != BBQUE_RPC_SHM_VERSION) {
+			logger->Error("SHM RPC: channel [%s] version mismatch "
+					"(0x%08X != 0x%08X)", slot.channel,
+					pch->version, BBQUE_RPC_SHM_VERSION);
+			::munmap(paddr, sizeof(bl::rpc_shm_channel_t));
+			slot.state.store(bl::RPC_SHM_SLOT_FREE);
+			continue;
+		}
+
+		channels[i] = std::make_shared<ShmChannel_t>(i, slot.channel, pch);
+		slot.state.store(bl::RPC_SHM_SLOT_ATTACHED);
+
+		logger->Info("SHM RPC: [%3d:%s] channel attached",
+				i, slot.channel);
+	}
+}
+
+void ShmRPC::ReleaseStaleChannels() {
+	std::chrono::steady_clock::time_point now =
+		std::chrono::steady_clock::now();
+
+	for (int i = 0; i < BBQUE_SHM_MAX_CLIENTS; ++i) {
+		if (!channels[i] || channels[i]->paired)
+			continue;
+		if (now - channels[i]->attach_time <
+				std::chrono::milliseconds(BBQUE_SHM_PAIR_TIMEOUT_MS))
+			continue;
+
+		logger->Warn("SHM RPC: [%3d:%s] channel not paired, releasing...",
+				i, channels[i]->name);
+		channels[i].reset();
+		server->slots[i].state.store(bl::RPC_SHM_SLOT_FREE);
+	}
+}
+
+ssize_t ShmRPC::FetchMessage(rpc_msg_ptr_t & msg) {
+	shm_msg_t * pmsg;
+	uint32_t size;
+	void * prec;
+
+	for (int i = 0; i < BBQUE_SHM_MAX_CLIENTS; ++i) {
+		int slot = (next_slot + i) % BBQUE_SHM_MAX_CLIENTS;
+		if (!channels[slot])
+			continue;
+
+		bl::rpc_shm_ring_t * pring = &(channels[slot]->pch->to_bbque);
+		prec = bl::rpc_shm_peek(pring, size);
+		if (unlikely(size == RPC_SHM_RING_CORRUPTED)) {
+			// The application is not following the protocol: its ring
+			// positions can not be trusted anymore
+			logger->Error("SHM RPC: [%3d:%s] corrupted ring, "
+					"releasing the channel...", slot, channels[slot]->name);
+			channels[slot].reset();
+			server->slots[slot].state.store(bl::RPC_SHM_SLOT_FREE);
+			continue;
+		}
+		if (!prec)
+			continue;
+		next_slot = (slot + 1) % BBQUE_SHM_MAX_CLIENTS;
+
+		if (unlikely(size < sizeof(rpc_msg_header_t))) {
+			logger->Error("SHM RPC: [%3d:%s] dropping malformed message "
+					"[sze: %u]", slot, channels[slot]->name, size);
+			bl::rpc_shm_consume(pring, size);
+			continue;
+		}
+
+		// Copy out the message: the RTRM keeps it for an unbounded time,
+		// while the ring space should be returned to the application
+		pmsg = (shm_msg_t *)::malloc(offsetof(shm_msg_t, pyl) + size);
+		if (!pmsg) {
+			logger->Error("SHM RPC: message buffer creation FAILED");
+			bl::rpc_shm_consume(pring, size);
+			continue;
+		}
+		pmsg->hdr.slot = slot;
+		pmsg->hdr.size = size;
+		::memcpy(&(pmsg->pyl), prec, size);
+		bl::rpc_shm_consume(pring, size);
+
+		msg = &(pmsg->pyl);
+		logger->Debug("SHM RPC: Rx [slt: %3d, sze: %3u] "
+				"RPC_HDR [typ: %d, pid: %d, eid: %hd]",
+				slot, size, msg->typ, msg->app_pid, msg->exc_id);
+
+		return size;
+	}
+
+	return 0;
+}
+
+ssize_t ShmRPC::RecvMessage(rpc_msg_ptr_t & msg) {
+	std::unique_lock<std::mutex> channels_ul(channels_mtx, std::defer_lock);
+	uint32_t doorbell;
+	ssize_t bytes;
+	int result;
+
+	assert(initialized);
+
+	while (true) {
+		// Read the doorbell before looking for messages, thus a message
+		// published right after the scan makes the wait to return
+		doorbell = server->doorbell.load();
+
+		channels_ul.lock();
+		AttachChannels();
+		ReleaseStaleChannels();
+		bytes = FetchMessage(msg);
+		channels_ul.unlock();
+		if (bytes > 0)
+			return bytes;
+
+		// Declare to be sleeping, then check again for a doorbell rang in
+		// the meantime (applications wake up only sleeping servers)
+		result = 0;
+		server->sleeping.store(1);
+		if (server->doorbell.load() == doorbell)
+			result = bl::rpc_shm_wait_doorbell(&server->doorbell, doorbell);
+		server->sleeping.store(0);
+
+		if (result == -EINTR) {
+			logger->Debug("SHM RPC: exiting message wait...");
+			return -EINTR;
+		}
+	}
+}
+
+RPCChannelIF::plugin_data_t ShmRPC::GetPluginData(
+		rpc_msg_ptr_t & msg) {
+	std::unique_lock<std::mutex> channels_ul(channels_mtx);
+	std::shared_ptr<shm_data_t> pd;
+	shm_msg_t * pmsg;
+
+	// We should have the public region already on place
+	assert(initialized);
+
+	// We should also have a valid RPC message
+	assert(msg->typ == bl::RPC_APP_PAIR);
+
+	// Get a reference to the channel the message comes from
+	pmsg = container_of(msg, shm_msg_t, pyl);
+	logger->Debug("SHM RPC: plugin data initialization...");
+
+	pShmChannel_t & pch(channels[pmsg->hdr.slot]);
+	if (!pch) {
+		logger->Error("SHM RPC: [%3d] channel NOT attached",
+				pmsg->hdr.slot);
+		return plugin_data_t();
+	}
+
+	if (pch->pch->app_pid != msg->app_pid)
+		logger->Warn("SHM RPC: [%3d:%s] channel PID mismatch [%d != %d]",
+				pmsg->hdr.slot, pch->name,
+				pch->pch->app_pid, msg->app_pid);
+
+	// Build a new set of plugins data
+	pd = std::make_shared<shm_data_t>();
+	pd->channel = pch;
+	pch->paired = true;
+
+	logger->Info("SHM RPC: [%3d:%s] channel initialization DONE",
+			pch->slot, pch->name);
+
+	return pd;
+}
+
+void ShmRPC::ReleasePluginData(plugin_data_t & pd) {
+	std::unique_lock<std::mutex> channels_ul(channels_mtx);
+	shm_data_t * ppd = (shm_data_t*)pd.get();
+
+	assert(initialized==true);
+	assert(ppd && ppd->channel);
+
+	// Detach the channel, the segment is unmapped once the last reference
+	// is released
+	int slot = ppd->channel->slot;
+	if (channels[slot] == ppd->channel) {
+		channels[slot].reset();
+		server->slots[slot].state.store(bl::RPC_SHM_SLOT_FREE);
+	}
+
+	logger->Info("SHM RPC: [%3d:%s] channel release DONE",
+			slot, ppd->channel->name);
+
+}
+
+ssize_t ShmRPC::SendMessage(plugin_data_t & pd, rpc_msg_ptr_t msg,
+		size_t count) {
+	shm_data_t * ppd = (shm_data_t*)pd.get();
+	std::chrono::steady_clock::time_point timeout;
+	bl::rpc_shm_ring_t * pring;
+	void * pbuf;
+	uint32_t pos;
+
+	assert(server);
+	assert(ppd && ppd->channel);
+
+	ShmChannel_t & ch(*(ppd->channel));
+	if (RPC_SHM_RECORD_SIZE(count) > BBQUE_SHM_RING_SIZE) {
+		logger->Error("SHM RPC: [%3d:%s] message too big [sze: %d]",
+				ch.slot, ch.name, count);
+		return -1;
+	}
+
+	// Serialize the producers of the application ring
+	std::unique_lock<std::mutex> tx_ul(ch.tx_mtx);
+	pring = &(ch.pch->to_app);
+
+	// Wait for the application to free some space
+	timeout = std::chrono::steady_clock::now() +
+		std::chrono::milliseconds(conf_tx_timeout_ms);
+	while (!(pbuf = bl::rpc_shm_reserve(pring, count, pos))) {
+		if (std::chrono::steady_clock::now() > timeout) {
+			logger->Error("SHM RPC: [%3d:%s] send message FAILED "
+					"(Error: ring full)", ch.slot, ch.name);
+			return -1;
+		}
+		std::this_thread::sleep_for(std::chrono::microseconds(100));
+	}
+
+	logger->Debug("SHM RPC: TX [typ: %d, sze: %d] "
+			"using app channel [%d:%s]...",
+			msg->typ, count, ch.slot, ch.name);
+
+	// Write the message into the ring and wake up the application
+	::memcpy(pbuf, msg, count);
+	if (bl::rpc_shm_commit(pring, pos))
+		bl::rpc_shm_ring_doorbell(&(pring->doorbell));
+
+	return count;
+}
+
+void ShmRPC::FreeMessage(rpc_msg_ptr_t & msg) {
+	// Releaseing the message buffer
+	::free(container_of(msg, shm_msg_t, pyl));
+}
+
+//----- static plugin interface
+
+void * ShmRPC::Create(PF_ObjectParams *params) {
+	static uint32_t conf_tx_timeout_ms;
+
+	// Declare the supported options
+	po::options_description shm_rpc_opts_desc("SHM RPC Options");
+	shm_rpc_opts_desc.add_options()
+		(MODULE_NAMESPACE".tx_timeout", po::value<uint32_t>
+		 (&conf_tx_timeout_ms)->default_value(BBQUE_RPC_TIMEOUT),
+		 "time to wait for an application ring to have free space [ms]")
+		;
+	static po::variables_map shm_rpc_opts_value;
+
+	// Get configuration params
+	PF_Service_ConfDataIn data_in;
+	data_in.opts_desc = &shm_rpc_opts_desc;
+	PF_Service_ConfDataOut data_out;
+	data_out.opts_value = &shm_rpc_opts_value;
+	PF_ServiceData sd;
+	sd.id = MODULE_NAMESPACE;
+	sd.request = &data_in;
+	sd.response = &data_out;
+
+	int32_t response = params->
+		platform_services->InvokeService(PF_SERVICE_CONF_DATA, sd);
+	if (response!=PF_SERVICE_DONE)
+		return NULL;
+
+	if (daemonized)
+		syslog(LOG_INFO, "Using RPC shared memory region [%s]",
+				BBQUE_PUBLIC_SHM);
+	else
+		fprintf(stderr, FI("SHM RPC: using region [%s]\n"),
+				BBQUE_PUBLIC_SHM);
+
+	return new ShmRPC(conf_tx_timeout_ms);
+
+}
+
+int32_t ShmRPC::Destroy(void *plugin) {
+  if (!plugin)
+    return -1;
+  delete (ShmRPC *)plugin;
+  return 0;
+}
+
+} // namesapce plugins
+
+} // namespace bque
@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2012  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BBQUE_PLUGINS_SHM_RPC_H_
+#define BBQUE_PLUGINS_SHM_RPC_H_
+
+#include "bbque/rtlib/rpc_shm_channel.h"
+
+#include "bbque/plugins/rpc_channel.h"
+#include "bbque/plugins/plugin.h"
+#include "bbque/utils/logging/logger.h"
+#include "bbque/cpp11/chrono.h"
+#include "bbque/cpp11/mutex.h"
+
+#include <cstdint>
+#include <memory>
+
+#define MODULE_NAMESPACE RPC_CHANNEL_NAMESPACE ".shm"
+
+/** The time [ms] an attached channel is kept waiting for the pairing */
+#define BBQUE_SHM_PAIR_TIMEOUT_MS 10000
+
+// These are the parameters received by the PluginManager on create calls
+struct PF_ObjectParams;
+
+namespace bl = bbque::rtlib;
+namespace bu = bbque::utils;
+
+namespace bbque { namespace plugins {
+
+/**
+ * @class ShmRPC
+ * @brief A shared memory based implementation of the RPCChannelIF interface.
+ * @details
+ * This class provide a shared memory based communication channel between the
+ * Barbque RTRM and the applications. Each application publishes a segment
+ * with a pair of single producer, single consumer ring buffers, one for each
+ * direction, where the messages are written in place. Both the sides wait
+ * for new messages on a futex doorbell, which is signaled only if the
+ * consumer is actually sleeping.
+ */
+class ShmRPC : public RPCChannelIF {
+
+/**
+ * @brief The mapping of an application channel segment
+ *
+ * This is shared by the plugin data handed to the RTRM, thus the segment is
+ * unmapped only once the last message has been sent.
+ */
+typedef struct ShmChannel {
+	/** The channel slot into the public region */
+	int slot;
+	/** The application shared memory segment name */
+	char name[BBQUE_SHM_NAME_LENGTH];
+	/** The mapped application segment */
+	bl::rpc_shm_channel_t * pch;
+	/** Serialize the messages sent to the application (single producer) */
+	std::mutex tx_mtx;
+	/** The time the segment has been mapped */
+	std::chrono::steady_clock::time_point attach_time;
+	/** Set once the application has been paired */
+	bool paired;
+
+	ShmChannel(int slot, const char * name, bl::rpc_shm_channel_t * pch);
+	~ShmChannel();
+} ShmChannel_t;
+
+typedef std::shared_ptr<ShmChannel_t> pShmChannel_t;
+
+typedef struct shm_data : ChannelData {
+	/** The application channel */
+	pShmChannel_t channel;
+} shm_data_t;
+
+/**
+ * @brief The header of a received message buffer
+ *
+ * The RTRM keeps the received messages for an unbounded time, thus they are
+ * copied out of the ring. The header tells which channel the message comes
+ * from.
+ */
+typedef struct shm_msg_header {
+	/** The channel slot */
+	int32_t slot;
+	/** The size of the RPC message */
+	uint32_t size;
+} shm_msg_header_t;
+
+typedef struct shm_msg {
+	shm_msg_header_t hdr;
+	rpc_msg_header_t pyl;
+} shm_msg_t;
+
+public:
+
+//----- static plugin interface
+
+	/**
+	 *
+	 */
+	static void * Create(PF_ObjectParams *);
+
+	/**
+	 *
+	 */
+	static int32_t Destroy(void *);
+
+	virtual ~ShmRPC();
+
+//----- RPCChannelIF module interface
+
+	virtual int Init();
+
+	virtual int Poll();
+
+	virtual ssize_t RecvMessage(rpc_msg_ptr_t & msg);
+
+	virtual plugin_data_t GetPluginData(rpc_msg_ptr_t & msg);
+
+	virtual void ReleasePluginData(plugin_data_t & pd);
+
+	virtual ssize_t SendMessage(plugin_data_t & pd, rpc_msg_ptr_t msg,
+								size_t count);
+
+	virtual void FreeMessage(rpc_msg_ptr_t & msg);
+
+private:
+
+	/**
+	 * @brief System logger instance
+	 */
+	std::unique_ptr<bu::Logger> logger;
+
+	/**
+	 * @brief Thrue if the channel has been correctly initalized
+	 */
+	bool initialized;
+
+	/**
+	 * @brief The time to wait for free space on a full ring [ms]
+	 */
+	uint32_t conf_tx_timeout_ms;
+
+	/**
+	 * @brief The public region, where applications publish their channels
+	 */
+	bl::rpc_shm_server_t * server;
+
+	/**
+	 * @brief The attached application channels, indexed by slot
+	 */
+	pShmChannel_t channels[BBQUE_SHM_MAX_CLIENTS];
+
+	/**
+	 * @brief Protect the channels table
+	 */
+	std::mutex channels_mtx;
+
+	/**
+	 * @brief The next slot to scan for incoming messages (round-robin)
+	 */
+	int next_slot;
+
+	/**
+	 * @brief   The plugins constructor
+	 * Plugins objects could be build only by using the "create" method.
+	 * Usually the PluginManager acts as object
+	 * @param
+	 * @return
+	 */
+	ShmRPC(uint32_t tx_timeout_ms);
+
+	/**
+	 * @brief Map the channels published by new applications
+	 *
+	 * This must be called with the channels_mtx held.
+	 */
+	void AttachChannels();
+
+	/**
+	 * @brief Release the channels not paired within
+	 * BBQUE_SHM_PAIR_TIMEOUT_MS since their mapping
+	 *
+	 * This makes free again the slots of the applications which died, or
+	 * whose pairing failed, before completing the pairing.
+	 * This must be called with the channels_mtx held.
+	 */
+	void ReleaseStaleChannels();
+
+	/**
+	 * @brief Copy out the next message of a channel, if any
+	 *
+	 * The channels are scanned round-robin, to not starve an application
+	 * when another one is flooding the RTRM with messages.
+	 * This must be called with the channels_mtx held.
+	 *
+	 * @return the size of the RPC message, 0 if there are not messages,
+	 * a negative error otherwise
+	 */
+	ssize_t FetchMessage(rpc_msg_ptr_t & msg);
+
+};
+
+} // namespace plugins
+
+} // namespace bbque
+
+#endif // BBQUE_PLUGINS_SHM_RPC_H_
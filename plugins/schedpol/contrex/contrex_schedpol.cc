@@ -113,7 +113,7 @@ void ContrexSchedPol::InitProcessorsPath()
 	br::ResourcePathPtr_t r_path;
 	br::ResourcePtrList_t r_list(ra.GetResources("sys.cpu.pe"));
 	for (auto & resource_ptr: r_list) {
-		r_path = ra.GetPath(resource_ptr->Path());
+		r_path = resource_ptr->GetResourcePath();
 		if (r_path != nullptr) {
 			logger->Debug("Got the resource path object for %s ",
 				resource_ptr->Path().c_str());
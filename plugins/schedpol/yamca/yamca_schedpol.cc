@@ -23,6 +23,7 @@
 #include <iostream>
 #include <thread>
 
+#include "bbque/configuration_manager.h"
 #include "bbque/modules_factory.h"
 #include "bbque/res/resource_assignment.h"
 #include "bbque/res/resource_path.h"
@@ -61,6 +62,7 @@
 namespace ba = bbque::app;
 namespace br = bbque::res;
 namespace bu = bbque::utils;
+namespace po = boost::program_options;
 
 namespace bbque { namespace plugins {
 
@@ -75,7 +77,8 @@ YamcaSchedPol::coll_metrics[YAMCA_METRICS_COUNT] = {
 	//----- Timing metrics
 	YAMCA_SAMPLE_METRIC("ord", "Time to order SchedEntity into a cluster [ms]"),
 	YAMCA_SAMPLE_METRIC("mcomp", "Time for computing a single metrics [ms]"),
-	YAMCA_SAMPLE_METRIC("sel", "Time to assign AWMs to EXCs of a cluster [ms]")
+	YAMCA_SAMPLE_METRIC("sel", "Time to assign AWMs to EXCs of a cluster [ms]"),
+	YAMCA_SAMPLE_METRIC("awmq", "Time an AWM evaluation waits for a worker [ms]")
 };
 
 
@@ -92,6 +95,19 @@ YamcaSchedPol::YamcaSchedPol():
 
 	// Register all the metrics to collect
 	mc.Register(coll_metrics, YAMCA_METRICS_COUNT);
+
+	// Persistent workers for the evaluation of the working modes
+	uint16_t nr_workers;
+	po::options_description opts_desc("YaMCA scheduling policy options");
+	opts_desc.add_options()
+		(MODULE_CONFIG ".workers",
+		 po::value<uint16_t>(&nr_workers)->default_value(0),
+		 "Number of threads evaluating the AWMs (0: one per CPU)");
+	po::variables_map opts_vm;
+	ConfigurationManager::GetInstance().ParseConfigurationFile(
+			opts_desc, opts_vm);
+	awm_pool.reset(new bu::TaskPool(nr_workers, "bq.yamca."));
+	logger->Info("AWMs evaluation workers: %u", awm_pool->Workers());
 }
 
 
@@ -334,30 +350,30 @@ inline bool YamcaSchedPol::CheckSkipConditions(ba::AppCPtr_t const & papp) {
 }
 
 
-void join_thread(std::thread & t) {
-	t.join();
-}
-
 SchedulerPolicyIF::ExitCode_t YamcaSchedPol::InsertWorkingModes(
 		SchedEntityMap_t & sched_map,
 		ba::AppCPtr_t const & papp,
 		int cl_id) {
-	std::list<std::thread> awm_thds;
+	std::vector<std::future<ExitCode_t>> awm_evals;
 
 	// Working modes
 	ba::AwmPtrList_t const & awms(papp->WorkingModes());
-	ba::AwmPtrList_t::const_iterator awm_it(awms.begin());
-	ba::AwmPtrList_t::const_iterator end_awm(awms.end());
-
-	for (; awm_it != end_awm; ++awm_it) {
-		awm_thds.push_back(
-			std::thread(&YamcaSchedPol::EvalWorkingMode, this,
-			&sched_map, papp, (*awm_it), cl_id)
-		);
+	awm_evals.reserve(awms.size());
+
+	for (ba::AwmPtr_t const & pawm: awms) {
+		auto queued = std::chrono::steady_clock::now();
+		awm_evals.push_back(awm_pool->Submit(
+			[this, &sched_map, &papp, pawm, cl_id, queued]() {
+				std::chrono::duration<double, std::milli> wait_ms(
+					std::chrono::steady_clock::now() - queued);
+				YAMCA_GET_SAMPLE(coll_metrics, YAMCA_QUEUE_TIME,
+					wait_ms.count());
+				return EvalWorkingMode(&sched_map, papp, pawm, cl_id);
+			}));
 	}
 
-	for_each(awm_thds.begin(), awm_thds.end(), join_thread);
-	awm_thds.clear();
+	for (auto & awm_eval: awm_evals)
+		awm_eval.wait();
 
 	logger->Debug("Schedule table size = %d", sched_map.size());
 	return SCHED_OK;
@@ -24,6 +24,7 @@
 #include "bbque/plugins/scheduler_policy.h"
 #include "bbque/plugins/plugin.h"
 #include "bbque/utils/logging/logger.h"
+#include "bbque/utils/task_pool.h"
 
 #define SCHEDULER_POLICY_NAME "yamca"
 #define MODULE_NAMESPACE SCHEDULER_POLICY_NAMESPACE "." SCHEDULER_POLICY_NAME
@@ -108,6 +109,9 @@ private:
 
 	std::mutex sched_mtx;
 
+	/** Worker threads evaluating the working modes */
+	std::unique_ptr<bu::TaskPool> awm_pool;
+
 	/**
 	 * @brief The collection of metrics generated by this module
 	 */
@@ -119,6 +123,7 @@ private:
 		YAMCA_ORDER_TIME,
 		YAMCA_METCOMP_TIME,
 		YAMCA_SELECT_TIME,
+		YAMCA_QUEUE_TIME,
 
 		YAMCA_METRICS_COUNT
 	} SchedPolMetrics_t;
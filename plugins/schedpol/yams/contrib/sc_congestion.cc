@@ -83,6 +83,26 @@ SCCongestion::Init(void * params) {
 	return SC_SUCCESS;
 }
 
+uint64_t
+SCCongestion::Signature(SchedulerPolicyIF::EvalEntity_t const & evl_ent,
+		SchedContribCache const & sc_cache) {
+	br::ResourceAssignmentMapPtr_t const bound_map(
+			evl_ent.pawm->GetSchedResourceBinding(evl_ent.bind_refn));
+	uint64_t sig = 1;
+
+	if (!bound_map)
+		return 0;
+
+	// The availability of each bound resource is tracked by the epoch of
+	// its binding domain
+	for (auto const & ru_entry: *(bound_map.get())) {
+		sig = SchedContribCache::Mix(sig, *(ru_entry.first.get()));
+		sig = SchedContribCache::Mix(sig, sc_cache.Epoch(ru_entry.first));
+		sig = SchedContribCache::Mix(sig, ru_entry.second->GetAmount());
+	}
+	return sig;
+}
+
 SchedContrib::ExitCode_t
 SCCongestion::_Compute(SchedulerPolicyIF::EvalEntity_t const & evl_ent,
 		float & ctrib) {
@@ -49,6 +49,13 @@ public:
 	 */
 	ExitCode_t Init(void * params);
 
+	/**
+	 * @brief The bound resource requests, plus the epochs of the binding
+	 * domains including them
+	 */
+	uint64_t Signature(SchedulerPolicyIF::EvalEntity_t const & evl_ent,
+			SchedContribCache const & sc_cache);
+
 private:
 
 	/**
@@ -99,6 +99,7 @@ SchedContrib::ExitCode_t SCFairness::Init(void * params) {
 			bd_info.base_path->ToString().c_str(),
 			bd_info.resources.size());
 	logger->Debug("Resource types: %d", r_types.size());
+	init_sig = SchedContribCache::Mix(1, static_cast<uint64_t>(num_apps));
 
 	// For each resource type get the availability and the fair partitioning
 	// among the application having the same priority
@@ -148,11 +149,33 @@ SchedContrib::ExitCode_t SCFairness::Init(void * params) {
 				r_path_str,
 				max_bd_r_avail[r_type_index],
 				fair_pt[r_type_index]);
+
+		init_sig = SchedContribCache::Mix(init_sig,
+				static_cast<uint64_t>(r_type_index));
+		init_sig = SchedContribCache::Mix(init_sig, min_bd_r_avail[r_type_index]);
+		init_sig = SchedContribCache::Mix(init_sig, max_bd_r_avail[r_type_index]);
+		init_sig = SchedContribCache::Mix(init_sig, fair_pt[r_type_index]);
 	}
 
 	return SC_SUCCESS;
 }
 
+uint64_t
+SCFairness::Signature(SchedulerPolicyIF::EvalEntity_t const & evl_ent,
+		SchedContribCache const & sc_cache) {
+	uint64_t sig = init_sig;
+	(void) sc_cache;
+
+	sig = SchedContribCache::Mix(sig,
+			static_cast<uint64_t>(bd_info.resources.size()));
+	for (auto const & ru_entry: evl_ent.pawm->ResourceRequests()) {
+		sig = SchedContribCache::Mix(sig,
+				static_cast<uint64_t>(ru_entry.first->Type()));
+		sig = SchedContribCache::Mix(sig, ru_entry.second->GetAmount());
+	}
+	return sig;
+}
+
 SchedContrib::ExitCode_t
 SCFairness::_Compute(SchedulerPolicyIF::EvalEntity_t const & evl_ent,
 		float & ctrib) {
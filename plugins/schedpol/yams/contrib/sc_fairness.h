@@ -57,6 +57,13 @@ public:
 	 */
 	ExitCode_t Init(void * params);
 
+	/**
+	 * @brief The resource requests, plus the fair partitions computed by
+	 * the last Init()
+	 */
+	uint64_t Signature(SchedulerPolicyIF::EvalEntity_t const & evl_ent,
+			SchedContribCache const & sc_cache);
+
 private:
 
 	/** Base for exponential functions used in the computation */
@@ -86,6 +93,9 @@ private:
 	/** Fair partitions */
 	uint64_t fair_pt[R_TYPE_COUNT];
 
+	/** Signature of the per-priority information set by Init() */
+	uint64_t init_sig = 0;
+
 	/**
 	 * @brief Compute the congestion contribute
 	 *
@@ -36,6 +36,17 @@ SCMigration::Init(void * params) {
 	return SC_SUCCESS;
 }
 
+uint64_t
+SCMigration::Signature(
+		SchedulerPolicyIF::EvalEntity_t const & evl_ent,
+		SchedContribCache const & sc_cache) {
+	br::ResourceType r_type = bd_info.base_path->Type();
+	(void) sc_cache;
+
+	return SchedContribCache::Mix(1,
+			static_cast<uint64_t>(evl_ent.IsMigrating(r_type)));
+}
+
 SchedContrib::ExitCode_t
 SCMigration::_Compute(
 		SchedulerPolicyIF::EvalEntity_t const & evl_ent,
@@ -41,6 +41,12 @@ public:
 
 	ExitCode_t Init(void * params);
 
+	/**
+	 * @brief The migration condition
+	 */
+	uint64_t Signature(SchedulerPolicyIF::EvalEntity_t const & evl_ent,
+			SchedContribCache const & sc_cache);
+
 private:
 
 	/**
@@ -38,6 +38,30 @@ SchedContrib::ExitCode_t SCReconfig::Init(void * params) {
 	return SC_SUCCESS;
 }
 
+uint64_t
+SCReconfig::Signature(
+		SchedulerPolicyIF::EvalEntity_t const & evl_ent,
+		SchedContribCache const & sc_cache) {
+	uint64_t sig = 1;
+
+	sig = SchedContribCache::Mix(sig,
+			static_cast<uint64_t>(evl_ent.IsReconfiguring()));
+	if (!evl_ent.IsReconfiguring())
+		return sig;
+
+	sig = SchedContribCache::Mix(sig, evl_ent.pawm->ConfigTime());
+	if (evl_ent.pawm->ConfigTime() >= 0)
+		return sig;
+
+	// Resource proportional estimation
+	sig = SchedContribCache::Mix(sig, sc_cache.PlatformSignature());
+	for (auto const & ru_entry: evl_ent.pawm->ResourceRequests()) {
+		sig = SchedContribCache::Mix(sig, *(ru_entry.first.get()));
+		sig = SchedContribCache::Mix(sig, ru_entry.second->GetAmount());
+	}
+	return sig;
+}
+
 SchedContrib::ExitCode_t
 SCReconfig::_Compute(
 		SchedulerPolicyIF::EvalEntity_t const & evl_ent,
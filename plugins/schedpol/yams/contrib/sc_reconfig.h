@@ -39,6 +39,13 @@ public:
 
 	ExitCode_t Init(void * params);
 
+	/**
+	 * @brief The AWM change and its configuration time, plus the
+	 * resource requests if the estimator is used
+	 */
+	uint64_t Signature(SchedulerPolicyIF::EvalEntity_t const & evl_ent,
+			SchedContribCache const & sc_cache);
+
 private:
 
 	/**
@@ -67,6 +67,24 @@ SCValue::Init(void * params) {
 	return SC_SUCCESS;
 }
 
+uint64_t
+SCValue::Signature(SchedulerPolicyIF::EvalEntity_t const & evl_ent,
+		SchedContribCache const & sc_cache) {
+	ba::AwmPtr_t const & curr_awm(evl_ent.papp->CurrentAWM());
+	ba::RuntimeProfiling_t rt_prof(evl_ent.papp->GetRuntimeProfile());
+	uint64_t sig = 1;
+	(void) sc_cache;
+
+	sig = SchedContribCache::Mix(sig, evl_ent.pawm->Value());
+	if (!curr_awm || (rt_prof.ggap_percent == 0))
+		return sig;
+
+	sig = SchedContribCache::Mix(sig, curr_awm->Value());
+	sig = SchedContribCache::Mix(sig,
+			static_cast<uint64_t>(rt_prof.ggap_percent));
+	return sig;
+}
+
 SchedContrib::ExitCode_t
 SCValue::_Compute(SchedulerPolicyIF::EvalEntity_t const & evl_ent,
 		float & ctrib) {
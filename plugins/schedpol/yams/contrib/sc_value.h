@@ -43,6 +43,13 @@ public:
 
 	ExitCode_t Init(void * params);
 
+	/**
+	 * @brief The AWM value, plus the current AWM value and the goal gap,
+	 * if a goal gap has been set
+	 */
+	uint64_t Signature(SchedulerPolicyIF::EvalEntity_t const & evl_ent,
+			SchedContribCache const & sc_cache);
+
 private:
 
 	/** The weight of the NAP assertion in the contribution value */
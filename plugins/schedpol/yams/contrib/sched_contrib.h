@@ -29,6 +29,8 @@
 #include "bbque/res/resource_path.h"
 #include "bbque/utils/logging/logger.h"
 
+#include "sched_contrib_cache.h"
+
 #define SC_CONF_BASE_STR 	SCHEDULER_POLICY_CONFIG".Contrib."
 #define SC_NAME_MAX_LEN 	11
 
@@ -242,6 +244,27 @@ public:
 	 ExitCode_t Compute(SchedulerPolicyIF::EvalEntity_t const & evl_ent,
 			 float & ctrib);
 
+	/**
+	 * @brief Signature of the inputs of the metrics computation
+	 *
+	 * Two computations of the contribute having the same signature are
+	 * expected to return the same value, which can thus be reused across
+	 * scheduling runs (@see SchedContribCache). The default implementation
+	 * returns 0, i.e. the contribute must be always computed.
+	 *
+	 * @param evl_ent The scheduling entity to evaluate (App/AWM/Cluster)
+	 * @param sc_cache The cache providing the binding domains epochs
+	 *
+	 * @return The signature value, 0 if the contribute cannot be reused
+	 */
+	 virtual uint64_t Signature(
+			 SchedulerPolicyIF::EvalEntity_t const & evl_ent,
+			 SchedContribCache const & sc_cache) {
+		 (void) evl_ent;
+		 (void) sc_cache;
+		 return 0;
+	 }
+
 protected:
 
 	 /** Logger */
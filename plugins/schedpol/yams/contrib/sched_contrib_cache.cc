@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2012  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sched_contrib_cache.h"
+
+#include "bbque/res/identifier.h"
+#include "bbque/res/resources.h"
+
+#define MODULE_NAMESPACE SCHEDULER_POLICY_NAMESPACE ".sc.cache"
+
+namespace bbque { namespace plugins {
+
+
+SchedContribCache::SchedContribCache() {
+	logger = bu::Logger::GetLogger(MODULE_NAMESPACE);
+	assert(logger);
+	memset(is_domain_type, 0, sizeof(is_domain_type));
+}
+
+void SchedContribCache::Reset(
+		System * sv,
+		br::RViewToken_t status_view,
+		BindingMap_t & bindings) {
+	char r_path_str[30];
+	uint64_t type_epoch;
+
+	logger->Debug("Reset: run %u: %zu indices, %u reused, %u computed",
+			run, entries.size(), hits, misses);
+	++run;
+	hits   = 0;
+	misses = 0;
+
+	// Release the indices not used recently
+	if ((run % SC_CACHE_MAX_AGE) == 0) {
+		for (auto it = entries.begin(); it != entries.end(); ) {
+			if (run - it->second.run > SC_CACHE_MAX_AGE)
+				it = entries.erase(it);
+			else
+				++it;
+		}
+	}
+
+	// Initial epochs of the binding domains
+	epochs.clear();
+	platform_sig = 0;
+	memset(is_domain_type, 0, sizeof(is_domain_type));
+	for (auto & bd_entry: bindings) {
+		br::ResourceType bd_type = bd_entry.first;
+		BindingInfo_t const & bd_info(*(bd_entry.second));
+		if (bd_info.resources.empty())
+			continue;
+		is_domain_type[static_cast<int>(bd_type)] = true;
+
+		type_epoch = 0;
+		for (BBQUE_RID_TYPE bd_id: bd_info.r_ids) {
+			uint64_t bd_epoch = 0;
+			for (br::ResourceType r_type: bd_info.r_types) {
+				snprintf(r_path_str, sizeof(r_path_str), "%s%d.%s",
+						bd_info.base_path->ToString().c_str(), bd_id,
+						br::GetResourceTypeString(r_type));
+				bd_epoch = MixResources(bd_epoch,
+						sv->GetResources(r_path_str), status_view);
+			}
+			epochs[DomainKey(bd_type, bd_id)] = bd_epoch;
+			type_epoch = Mix(type_epoch, bd_epoch);
+		}
+		epochs[DomainKey(bd_type, R_ID_ANY)] = type_epoch;
+	}
+
+	// System-wide resources
+	global_epoch = 0;
+	int r_type_index = static_cast<int>(br::ResourceType::PROC_ELEMENT);
+	int r_type_last  = static_cast<int>(br::ResourceType::CUSTOM);
+	for (; r_type_index <= r_type_last; ++r_type_index) {
+		br::ResourceType r_type = static_cast<br::ResourceType>(r_type_index);
+		snprintf(r_path_str, sizeof(r_path_str), "sys.%s",
+				br::GetResourceTypeString(r_type));
+		global_epoch = MixResources(global_epoch,
+				sv->GetResources(r_path_str), status_view);
+	}
+}
+
+void SchedContribCache::Booked(
+		br::ResourceAssignmentMapPtr_t const & assign_map) {
+	br::ResourceType bd_type;
+	BBQUE_RID_TYPE bd_id;
+
+	if (!assign_map)
+		return;
+
+	for (auto const & ru_entry: *(assign_map.get())) {
+		br::ResourcePath const & r_path(*(ru_entry.first.get()));
+		uint64_t booking = Mix(Mix(0, r_path), ru_entry.second->GetAmount());
+
+		// Outside any binding domain
+		if (!FindDomain(r_path, bd_type, bd_id)) {
+			global_epoch = Mix(global_epoch, booking);
+			continue;
+		}
+
+		// Not bound: any domain of the type could be affected
+		if (bd_id == R_ID_ANY) {
+			uint32_t key_type = DomainKey(bd_type, 0) >> 16;
+			for (auto & epoch: epochs) {
+				if ((epoch.first >> 16) == key_type)
+					epoch.second = Mix(epoch.second, booking);
+			}
+			continue;
+		}
+
+		uint64_t & bd_epoch(epochs[DomainKey(bd_type, bd_id)]);
+		bd_epoch = Mix(bd_epoch, booking);
+		uint64_t & type_epoch(epochs[DomainKey(bd_type, R_ID_ANY)]);
+		type_epoch = Mix(type_epoch, booking);
+	}
+}
+
+uint64_t SchedContribCache::Epoch(br::ResourcePathPtr_t const & r_path) const {
+	br::ResourceType bd_type;
+	BBQUE_RID_TYPE bd_id;
+
+	if (!FindDomain(*(r_path.get()), bd_type, bd_id))
+		return global_epoch;
+
+	auto const epoch_it = epochs.find(DomainKey(bd_type, bd_id));
+	if (epoch_it == epochs.end())
+		return global_epoch;
+	return epoch_it->second;
+}
+
+uint64_t SchedContribCache::Key(
+		SchedulerPolicyIF::EvalEntity_t const & evl_ent,
+		uint8_t sc_type,
+		uint64_t signature) {
+	uint64_t key = Mix(signature, static_cast<uint64_t>(evl_ent.papp->Uid()));
+	key = Mix(key, static_cast<uint64_t>(evl_ent.pawm->Id()) << 8 | sc_type);
+	key = Mix(key,
+		static_cast<uint64_t>(DomainKey(evl_ent.bind_type, evl_ent.bind_id)));
+	return key;
+}
+
+bool SchedContribCache::Lookup(uint64_t key, float & index) {
+	std::unique_lock<std::mutex> cache_ul(cache_mtx);
+
+	auto entry_it = entries.find(key);
+	if (entry_it == entries.end()) {
+		++misses;
+		return false;
+	}
+
+	entry_it->second.run = run;
+	index = entry_it->second.index;
+	++hits;
+	return true;
+}
+
+void SchedContribCache::Store(uint64_t key, float index) {
+	std::unique_lock<std::mutex> cache_ul(cache_mtx);
+	Entry_t & entry(entries[key]);
+	entry.index = index;
+	entry.run   = run;
+}
+
+float SchedContribCache::HitRatio() {
+	std::unique_lock<std::mutex> cache_ul(cache_mtx);
+	if (hits + misses == 0)
+		return 0.0;
+	return (100.0 * hits) / (hits + misses);
+}
+
+uint64_t SchedContribCache::Mix(uint64_t sig, br::ResourcePath const & r_path) {
+	for (auto const & r_ident: r_path.GetIdentifiers()) {
+		sig = Mix(sig, static_cast<uint64_t>(
+				DomainKey(r_ident->Type(), r_ident->ID())));
+	}
+	return sig;
+}
+
+bool SchedContribCache::FindDomain(
+		br::ResourcePath const & r_path,
+		br::ResourceType & r_type,
+		BBQUE_RID_TYPE & r_id) const {
+	for (auto const & r_ident: r_path.GetIdentifiers()) {
+		if (!is_domain_type[static_cast<int>(r_ident->Type())])
+			continue;
+		r_type = r_ident->Type();
+		r_id   = r_ident->ID() < 0 ? R_ID_ANY : r_ident->ID();
+		return true;
+	}
+	return false;
+}
+
+uint64_t SchedContribCache::MixResources(
+		uint64_t sig,
+		br::ResourcePtrList_t const & r_list,
+		br::RViewToken_t status_view) {
+	for (br::ResourcePtr_t const & rsrc: r_list) {
+		uint64_t total = rsrc->Total();
+		sig = Mix(sig, total);
+		sig = Mix(sig, rsrc->Available(nullptr, status_view));
+		platform_sig = Mix(platform_sig, total);
+	}
+	return sig;
+}
+
+} // namespace plugins
+
+} // namespace bbque
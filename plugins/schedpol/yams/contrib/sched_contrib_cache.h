@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2012  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BBQUE_SCHED_CONTRIB_CACHE_H_
+#define BBQUE_SCHED_CONTRIB_CACHE_H_
+
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+#include "bbque/binding_manager.h"
+#include "bbque/system.h"
+#include "bbque/plugins/scheduler_policy.h"
+#include "bbque/res/resource_assignment.h"
+#include "bbque/res/resource_path.h"
+#include "bbque/utils/logging/logger.h"
+
+/** Number of scheduling runs an unused index is kept into the cache */
+#define SC_CACHE_MAX_AGE  16
+
+namespace br = bbque::res;
+namespace bu = bbque::utils;
+
+namespace bbque { namespace plugins {
+
+/**
+ * @class SchedContribCache
+ * @brief Scheduling contribution indices reused across scheduling runs
+ *
+ * Most of the times, a scheduling run evaluates the same applications, in
+ * the same working modes and binding domains, of the previous run, while
+ * only a few inputs of the evaluation changed (e.g., an application has
+ * updated its runtime profile, or a new one has been started). Each index
+ * computed by a SchedContrib is thus stored along with a signature of the
+ * inputs of the computation (@see SchedContrib::Signature), and returned as
+ * is as long as the signature does not change.
+ *
+ * The resource state view of the run is tracked by binding domain: the
+ * signature of a domain (epoch) summarizes the availability of its
+ * resources, and it is updated each time the policy books resources into
+ * the domain. Since the epochs depend only on the resource state, the
+ * indices depending on a domain are recomputed only if the bookings
+ * performed into that domain, during the current run, differ from the
+ * ones of the previous run.
+ */
+class SchedContribCache {
+
+public:
+
+	SchedContribCache();
+
+	/**
+	 * @brief Start a new scheduling run
+	 *
+	 * Compute the initial epochs of the binding domains, given the
+	 * (clean) resource state view of the run, and release the indices not
+	 * used in the last SC_CACHE_MAX_AGE runs.
+	 *
+	 * @param sv Pointer to the System instance
+	 * @param status_view The token of scheduling resource state view
+	 * @param bindings The binding domains
+	 */
+	void Reset(System * sv, br::RViewToken_t status_view,
+			BindingMap_t & bindings);
+
+	/**
+	 * @brief Update the epochs of the domains including booked resources
+	 *
+	 * @param assign_map The resources booked into the state view
+	 */
+	void Booked(br::ResourceAssignmentMapPtr_t const & assign_map);
+
+	/**
+	 * @brief The epoch of the binding domain including a resource path
+	 *
+	 * Resource paths not included into any binding domain share the same
+	 * (system-wide) epoch.
+	 */
+	uint64_t Epoch(br::ResourcePathPtr_t const & r_path) const;
+
+	/**
+	 * @brief The signature of the resources registered in the platform
+	 */
+	inline uint64_t PlatformSignature() const {
+		return platform_sig;
+	}
+
+	/**
+	 * @brief Build the key of a cached index
+	 *
+	 * @param evl_ent The scheduling entity evaluated
+	 * @param sc_type The scheduling contribution type
+	 * @param signature The signature of the inputs of the computation
+	 */
+	static uint64_t Key(SchedulerPolicyIF::EvalEntity_t const & evl_ent,
+			uint8_t sc_type, uint64_t signature);
+
+	/**
+	 * @brief Look for a cached index
+	 *
+	 * @return true if found, with index set accordingly
+	 */
+	bool Lookup(uint64_t key, float & index);
+
+	/**
+	 * @brief Store a computed index
+	 */
+	void Store(uint64_t key, float index);
+
+	/**
+	 * @brief Percentage of the indices found into the cache, in the
+	 * current scheduling run
+	 */
+	float HitRatio();
+
+
+	/**** Signature helpers ****/
+
+	/** Combine a value into a signature */
+	static inline uint64_t Mix(uint64_t sig, uint64_t value) {
+		value *= 0x9e3779b97f4a7c15ULL;
+		value ^= value >> 32;
+		return (sig ^ value) * 0x100000001b3ULL + 0x7f4a7c15;
+	}
+
+	/** Combine a floating point value into a signature */
+	static inline uint64_t Mix(uint64_t sig, float value) {
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		return Mix(sig, static_cast<uint64_t>(bits));
+	}
+
+	/** Combine the identifiers of a resource path into a signature */
+	static uint64_t Mix(uint64_t sig, br::ResourcePath const & r_path);
+
+private:
+
+	/** Cached index */
+	struct Entry_t {
+		/** The index value */
+		float index;
+		/** The last scheduling run the index has been used */
+		uint32_t run;
+	};
+
+	/** Logger */
+	std::unique_ptr<bu::Logger> logger;
+
+	/** Mutual exclusion on the indices (computed by concurrent workers) */
+	std::mutex cache_mtx;
+
+	/** The cached indices */
+	std::unordered_map<uint64_t, Entry_t> entries;
+
+	/** Counter of the scheduling runs */
+	uint32_t run = 0;
+
+	/** Indices found into the cache during the current run */
+	uint32_t hits = 0;
+
+	/** Indices computed during the current run */
+	uint32_t misses = 0;
+
+	/** Binding domain types */
+	bool is_domain_type[R_TYPE_COUNT];
+
+	/**
+	 * Epochs of the binding domains, indexed by DomainKey(). The epoch of
+	 * the whole set of domains of a type has ID R_ID_ANY.
+	 */
+	std::unordered_map<uint32_t, uint64_t> epochs;
+
+	/** Epoch of the resources not included into any binding domain */
+	uint64_t global_epoch = 0;
+
+	/** Signature of the resources registered in the platform */
+	uint64_t platform_sig = 0;
+
+	static inline uint32_t DomainKey(br::ResourceType r_type,
+			BBQUE_RID_TYPE r_id) {
+		return (static_cast<uint32_t>(r_type) << 16) |
+			static_cast<uint16_t>(r_id);
+	}
+
+	/**
+	 * @brief Find the binding domain including a resource path
+	 *
+	 * @return false if the path is not included into any binding domain,
+	 * otherwise the domain type and ID (R_ID_ANY for all the domains of the
+	 * type)
+	 */
+	bool FindDomain(br::ResourcePath const & r_path,
+			br::ResourceType & r_type, BBQUE_RID_TYPE & r_id) const;
+
+	/**
+	 * @brief Combine the state of a set of resources into a signature
+	 */
+	uint64_t MixResources(uint64_t sig, br::ResourcePtrList_t const & r_list,
+			br::RViewToken_t status_view);
+};
+
+} // namespace plugins
+
+} // namespace bbque
+
+#endif // BBQUE_SCHED_CONTRIB_CACHE_H_
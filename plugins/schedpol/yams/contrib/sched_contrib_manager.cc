@@ -149,12 +149,27 @@ SchedContribManager::ExitCode_t SchedContribManager::GetIndex(
 		return SC_TYPE_MISSING;
 	}
 
-	// Compute the SchedContrib index
-	sc_ret = psc->Compute(evl_ent, sc_value);
-	if (unlikely(sc_ret != SchedContrib::SC_SUCCESS)) {
-		logger->Error("GetIndex: error in contribution %d. Return code:%d",
-				sc_type, sc_ret);
-		return SC_ERROR;
+	// Look for the index computed with the same inputs
+	uint64_t sc_key = 0;
+	uint64_t sc_sig = 0;
+	if (sc_cache)
+		sc_sig = psc->Signature(evl_ent, *sc_cache);
+	if (sc_sig != 0)
+		sc_key = SchedContribCache::Key(evl_ent, sc_type, sc_sig);
+
+	if ((sc_sig != 0) && sc_cache->Lookup(sc_key, sc_value)) {
+		sc_ret = SchedContrib::SC_SUCCESS;
+	}
+	else {
+		// Compute the SchedContrib index
+		sc_ret = psc->Compute(evl_ent, sc_value);
+		if (unlikely(sc_ret != SchedContrib::SC_SUCCESS)) {
+			logger->Error("GetIndex: error in contribution %d. Return code:%d",
+					sc_type, sc_ret);
+			return SC_ERROR;
+		}
+		if (sc_sig != 0)
+			sc_cache->Store(sc_key, sc_value);
 	}
 
 	// Multiply the index for the weight
@@ -154,6 +154,18 @@ public:
 	 */
 	void SetBindingInfo(BindingInfo_t & _bd_info);
 
+	/**
+	 * @brief Set the cache of the contribution indices
+	 *
+	 * If set, GetIndex() returns the cached index of a contribution, as long
+	 * as the signature of its inputs does not change.
+	 *
+	 * @param _sc_cache Pointer to the cache (nullptr to disable it)
+	 */
+	inline void SetCache(SchedContribCache * _sc_cache) {
+		sc_cache = _sc_cache;
+	}
+
 	/**
 	 * @brief Return a resource path string reference the binding domain
 	 */
@@ -188,6 +200,9 @@ private:
 	/** The base resource path for the binding step */
 	BindingInfo_t bd_info;
 
+	/** Cache of the contribution indices */
+	SchedContribCache * sc_cache = nullptr;
+
 	/** Scheduling contributions required*/
 	std::map<Type_t, SchedContribPtr_t> sc_objs_reqs;
 
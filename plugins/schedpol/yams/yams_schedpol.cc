@@ -17,11 +17,13 @@
 
 #include "yams_schedpol.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <cstdint>
 #include <iostream>
 #include <functional>
+#include <unordered_set>
 #include "bbque/cpp11/thread.h"
 #include "bbque/modules_factory.h"
 #include "bbque/app/working_mode.h"
@@ -72,7 +74,13 @@ YamsSchedPol::coll_metrics[YAMS_METRICS_COUNT] = {
 	YAMS_SAMPLE_METRIC("mcomp",
 			"Time for computing a single metrics [ms]"),
 	YAMS_SAMPLE_METRIC("awmvalue",
-			"AWM value of the scheduled entity")
+			"AWM value of the scheduled entity"),
+	YAMS_SAMPLE_METRIC("awmq",
+			"Time an AWM evaluation waits for a worker [ms]"),
+	YAMS_SAMPLE_METRIC("schits",
+			"Scheduling contributions reused from previous runs [%]"),
+	YAMS_SAMPLE_METRIC("specgain",
+			"Objective gain of the speculative selection")
 };
 
 // Definition of time metrics for each SchedContrib computation
@@ -148,6 +156,46 @@ YamsSchedPol::YamsSchedPol():
 		static_cast<CommandHandler*>(this),
 		"Set COWS binding metrics weights");
 #endif
+
+#ifdef CONFIG_BBQUE_SP_PARALLEL
+	// Persistent workers for the evaluation of the working modes
+	uint16_t nr_workers;
+	po::options_description opts_desc("YaMS scheduling policy options");
+	opts_desc.add_options()
+		(MODULE_CONFIG ".workers",
+		 po::value<uint16_t>(&nr_workers)->default_value(0),
+		 "Number of threads evaluating the AWMs (0: one per CPU)");
+	po::variables_map opts_vm;
+	cm.ParseConfigurationFile(opts_desc, opts_vm);
+	awm_pool.reset(new bu::TaskPool(nr_workers, "bq.yams."));
+	logger->Info("AWMs evaluation workers: %u", awm_pool->Workers());
+#endif
+
+#ifdef CONFIG_BBQUE_SP_YAMS_SPECULATIVE
+	// Alternative selection orders and their ranking
+	std::string opt_objective;
+	po::options_description spec_opts_desc("YaMS speculative selection options");
+	spec_opts_desc.add_options()
+		(MODULE_CONFIG ".candidates",
+		 po::value<uint16_t>(&spec_candidates)->default_value(
+			 YAMS_SPEC_CANDIDATES),
+		 "Number of selection orders evaluated (0 or 1: disabled)")
+		(MODULE_CONFIG ".objective",
+		 po::value<std::string>(&opt_objective)->default_value("metrics"),
+		 "Objective ranking the selection orders (metrics, value, apps)");
+	po::variables_map spec_opts_vm;
+	cm.ParseConfigurationFile(spec_opts_desc, spec_opts_vm);
+
+	if (opt_objective == "value")
+		spec_objective = YAMS_SPEC_VALUE;
+	else if (opt_objective == "apps")
+		spec_objective = YAMS_SPEC_APPS;
+	else if (opt_objective != "metrics")
+		logger->Warn("Unknown speculative selection objective '%s': "
+				"using 'metrics'", opt_objective.c_str());
+	logger->Info("Speculative selection: %d candidates, objective '%s'",
+			spec_candidates, opt_objective.c_str());
+#endif
 }
 
 YamsSchedPol::~YamsSchedPol() {
@@ -163,6 +211,11 @@ YamsSchedPol::ExitCode_t YamsSchedPol::Init() {
 	if (result != YAMS_SUCCESS)
 		return result;
 
+#ifdef CONFIG_BBQUE_SP_YAMS_SC_CACHE
+	// Track the resource state of the binding domains in the new view
+	sc_cache.Reset(sv, status_view, bdm.GetBindingDomains());
+#endif
+
 	// Initialize information for scheduling contributions
 	InitSchedContribManagers();
 
@@ -213,6 +266,9 @@ YamsSchedPol::ExitCode_t YamsSchedPol::InitSchedContribManagers() {
 		SchedContribManager * scm = scm_it->second;
 		scm->SetViewInfo(sv, status_view);
 		scm->SetBindingInfo(*(bindings[scm_it->first]));
+#ifdef CONFIG_BBQUE_SP_YAMS_SC_CACHE
+		scm->SetCache(&sc_cache);
+#endif
 		logger->Debug("Init: Scheduling contribution manager for R{%s} ready",
 				br::GetResourceTypeString(scm_it->first));
 	}
@@ -271,6 +327,9 @@ YamsSchedPol::Schedule(System & sys_if, br::RViewToken_t & rav) {
 	}
 	// Set the new resource state view token
 	rav = status_view;
+#ifdef CONFIG_BBQUE_SP_YAMS_SC_CACHE
+	YAMS_GET_SAMPLE(coll_metrics, YAMS_SC_CACHE_HITS, sc_cache.HitRatio());
+#endif
 
 	// Reset scheduling entities and resource bindings status
 	Clear();
@@ -312,6 +371,12 @@ void YamsSchedPol::SchedulePrioQueue(AppPrio_t prio) {
 do_schedule:
 	// Order schedule entities by aggregate metrics
 	naps_count = OrderSchedEntities(prio);
+#ifdef CONFIG_BBQUE_SP_YAMS_SPECULATIVE
+	// NAPped applications are selected incrementally, by re-ordering the
+	// entities after each one of them has been scheduled
+	if (naps_count == 0)
+		SpeculateSchedEntities(prio);
+#endif
 	YAMS_GET_TIMING(coll_metrics, YAMS_ORDERING_TIME, yams_tmr);
 	YAMS_RESET_TIMING(yams_tmr);
 
@@ -352,6 +417,124 @@ uint8_t YamsSchedPol::OrderSchedEntities(AppPrio_t prio) {
 	return naps_count;
 }
 
+#ifdef CONFIG_BBQUE_SP_YAMS_SPECULATIVE
+
+void YamsSchedPol::SpeculateSchedEntities(AppPrio_t prio) {
+	std::vector<AppUid_t> apps_rank;
+	std::unordered_set<AppUid_t> apps_seen;
+
+	// Applications ranked by their best scheduling entity
+	for (auto const & pschd: entities) {
+		if (apps_seen.insert(pschd->papp->Uid()).second)
+			apps_rank.push_back(pschd->papp->Uid());
+	}
+
+	size_t nr_candidates = std::min<size_t>(spec_candidates, apps_rank.size());
+	if (nr_candidates < 2)
+		return;
+
+	// Simulate the selection of each candidate order
+	std::vector<float> objectives(nr_candidates);
+	auto eval_candidate = [&](size_t cand_id) {
+		objectives[cand_id] =
+			EvalSchedCandidate(prio, cand_id, apps_rank[cand_id]);
+	};
+#ifdef CONFIG_BBQUE_SP_PARALLEL
+	awm_pool->ParallelFor(0, nr_candidates, eval_candidate);
+#else
+	for (size_t cand_id = 0; cand_id < nr_candidates; ++cand_id)
+		eval_candidate(cand_id);
+#endif
+
+	// The best order, the current one in case of ties
+	size_t best_id = 0;
+	for (size_t cand_id = 1; cand_id < nr_candidates; ++cand_id) {
+		logger->Debug("Speculate: prio[%d] candidate %zu: objective = %.4f",
+				prio, cand_id, objectives[cand_id]);
+		if (objectives[cand_id] > objectives[best_id])
+			best_id = cand_id;
+	}
+	YAMS_GET_SAMPLE(coll_metrics, YAMS_SPEC_GAIN,
+			objectives[best_id] - objectives[0]);
+	if (best_id == 0)
+		return;
+
+	logger->Info("Speculate: prio[%d] candidate %zu improves the objective "
+			"%.4f => %.4f", prio, best_id,
+			objectives[0], objectives[best_id]);
+
+	// Move the entities of the promoted application ahead of the others
+	SchedEntityList_t promoted;
+	AppUid_t first_uid = apps_rank[best_id];
+	for (auto se_it = entities.begin(); se_it != entities.end(); ) {
+		auto curr_it = se_it++;
+		if ((*curr_it)->papp->Uid() == first_uid)
+			promoted.splice(promoted.end(), entities, curr_it);
+	}
+	entities.splice(entities.begin(), promoted);
+}
+
+float YamsSchedPol::EvalSchedCandidate(
+		AppPrio_t prio,
+		size_t cand_id,
+		AppUid_t first_uid) {
+	ResourceAccounterStatusIF::ExitCode_t ra_result;
+	std::unordered_set<AppUid_t> apps_scheduled;
+	br::RViewToken_t cand_view;
+	char token_path[40];
+	float objective = 0.0;
+
+	// A private view, inheriting the bookings of the previous queues
+	snprintf(token_path, sizeof(token_path), "%s%d.spec%d.%zu",
+			MODULE_NAMESPACE, status_view_count, prio, cand_id);
+	ra_result = ra.GetView(token_path, cand_view);
+	if (ra_result != ResourceAccounterStatusIF::RA_SUCCESS) {
+		logger->Error("Speculate: cannot get a resource state view");
+		return -1.0;
+	}
+	ra_result = ra.InheritView(status_view, cand_view);
+	if (ra_result != ResourceAccounterStatusIF::RA_SUCCESS) {
+		logger->Error("Speculate: cannot inherit the resource state view");
+		ra.PutView(cand_view);
+		return -1.0;
+	}
+
+	// Greedy selection, the entities of the promoted application first
+	for (uint8_t pass = 0; pass < 2; ++pass) {
+		for (auto const & pschd: entities) {
+			AppUid_t app_uid = pschd->papp->Uid();
+			bool promoted = (cand_id != 0) && (app_uid == first_uid);
+			if ((pass == 0) != promoted)
+				continue;
+			if (apps_scheduled.count(app_uid))
+				continue;
+
+			ra_result = ra.BookResources(pschd->papp,
+					pschd->pawm->GetSchedResourceBinding(pschd->bind_refn),
+					cand_view);
+			if (ra_result != ResourceAccounterStatusIF::RA_SUCCESS)
+				continue;
+			apps_scheduled.insert(app_uid);
+
+			switch (spec_objective) {
+			case YAMS_SPEC_VALUE:
+				objective += pschd->pawm->Value();
+				break;
+			case YAMS_SPEC_APPS:
+				objective += 1.0;
+				break;
+			default:
+				objective += pschd->metrics;
+			}
+		}
+	}
+
+	ra.PutView(cand_view);
+	return objective;
+}
+
+#endif // CONFIG_BBQUE_SP_YAMS_SPECULATIVE
+
 inline bool YamsSchedPol::CheckSkipConditions(ba::AppCPtr_t const & papp) {
 	// Skip if rescheduled yet or disabled in the meanwhile
 	if (!papp->Active() && !papp->Blocking()) {
@@ -446,6 +629,12 @@ bool YamsSchedPol::SelectSchedEntities(uint8_t naps_count) {
 		}
 #endif
 
+#ifdef CONFIG_BBQUE_SP_YAMS_SC_CACHE
+		// The availability of the binding domains has changed
+		sc_cache.Booked(
+			pschd->pawm->GetSchedResourceBinding(pschd->bind_refn));
+#endif
+
 		if (!pschd->papp->Synching() || pschd->papp->Blocking()) {
 			logger->Debug("Selecting: [%s] state {%s|%s}", pschd->papp->StrId(),
 					Application::StateStr(pschd->papp->State()),
@@ -477,24 +666,31 @@ bool YamsSchedPol::SelectSchedEntities(uint8_t naps_count) {
 }
 
 void YamsSchedPol::InsertWorkingModes(ba::AppCPtr_t const & papp) {
-	std::list<std::thread> awm_thds;
+#ifdef CONFIG_BBQUE_SP_PARALLEL
+	std::vector<std::future<void>> awm_evals;
+	awm_evals.reserve(papp->WorkingModes().size());
+#endif
 
 	// AWMs evaluation (no binding)
 	ba::AwmPtrList_t const & awms(papp->WorkingModes());
 	for (ba::AwmPtr_t const & pawm: awms) {
 		SchedEntityPtr_t pschd(new SchedEntity_t(papp, pawm, R_ID_NONE, 0.0));
 #ifdef CONFIG_BBQUE_SP_PARALLEL
-		awm_thds.push_back(
-				std::thread(&YamsSchedPol::EvalWorkingMode, this, pschd)
-		);
+		auto queued = std::chrono::steady_clock::now();
+		awm_evals.push_back(awm_pool->Submit([this, pschd, queued]() {
+			std::chrono::duration<double, std::milli> wait_ms(
+				std::chrono::steady_clock::now() - queued);
+			YAMS_GET_SAMPLE(coll_metrics, YAMS_AWM_QUEUE_TIME, wait_ms.count());
+			EvalWorkingMode(pschd);
+		}));
 #else
 		EvalWorkingMode(pschd);
 #endif
 	}
 
 #ifdef CONFIG_BBQUE_SP_PARALLEL
-	for_each(awm_thds.begin(), awm_thds.end(), mem_fn(&std::thread::join));
-	awm_thds.clear();
+	for (auto & awm_eval: awm_evals)
+		awm_eval.wait();
 #endif
 	logger->Debug("Eval: number of entities = %d", entities.size());
 }
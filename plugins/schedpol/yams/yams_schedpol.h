@@ -26,7 +26,9 @@
 #include "bbque/command_manager.h"
 #include "bbque/plugins/plugin.h"
 #include "bbque/utils/logging/logger.h"
+#include "bbque/utils/task_pool.h"
 
+#include "contrib/sched_contrib_cache.h"
 #include "contrib/sched_contrib_manager.h"
 
 #undef  MODULE_NAMESPACE
@@ -61,6 +63,9 @@
 #endif
 #define YAMS_SC_COUNT (YAMS_AWM_SC_COUNT + YAMS_BD_SC_COUNT)
 
+/** Default number of selection orders evaluated by the speculative selection */
+#define YAMS_SPEC_CANDIDATES 4
+
 #ifdef CONFIG_BBQUE_SP_COWS_BINDING
 	#define COWS_BOUND_METRICS  1
 	#define COWS_UNITS_METRICS  3
@@ -156,6 +161,9 @@ private:
 		YAMS_SELECTING_TIME,
 		YAMS_METRICS_COMP_TIME,
 		YAMS_METRICS_AWMVALUE,
+		YAMS_AWM_QUEUE_TIME,
+		YAMS_SC_CACHE_HITS,
+		YAMS_SPEC_GAIN,
 		YAMS_METRICS_COUNT
 	};
 
@@ -284,6 +292,34 @@ private:
 	/** Mutex */
 	std::mutex sched_mtx;
 
+#ifdef CONFIG_BBQUE_SP_YAMS_SC_CACHE
+	/** Scheduling contributions indices reused across the runs */
+	SchedContribCache sc_cache;
+#endif
+
+#ifdef CONFIG_BBQUE_SP_PARALLEL
+	/** Worker threads evaluating the working modes */
+	std::unique_ptr<bu::TaskPool> awm_pool;
+#endif
+
+#ifdef CONFIG_BBQUE_SP_YAMS_SPECULATIVE
+	/** Objective ranking the alternative selection orders */
+	enum SpecObjective_t {
+		/** Sum of the metrics of the scheduled entities */
+		YAMS_SPEC_METRICS,
+		/** Sum of the values of the scheduled AWMs */
+		YAMS_SPEC_VALUE,
+		/** Number of scheduled applications */
+		YAMS_SPEC_APPS
+	};
+
+	/** Number of selection orders evaluated per priority queue */
+	uint16_t spec_candidates = YAMS_SPEC_CANDIDATES;
+
+	/** The objective of the speculative selection */
+	SpecObjective_t spec_objective = YAMS_SPEC_METRICS;
+#endif
+
 	/** The High-Resolution timer used for profiling */
 	bu::Timer yams_tmr;
 
@@ -365,6 +401,36 @@ private:
 	 */
 	uint8_t OrderSchedEntities(AppPrio_t prio);
 
+#ifdef CONFIG_BBQUE_SP_YAMS_SPECULATIVE
+	/**
+	 * @brief Pick the best selection order of the scheduling entities
+	 *
+	 * The greedy selection of the ordered entities can be improved by
+	 * giving precedence to an application other than the one of the best
+	 * entity. The selection of the first spec_candidates orders (the
+	 * current one, plus one for each of the top ranked applications
+	 * promoted ahead of the others) is simulated into private resource
+	 * state views, concurrently if the parallel execution is enabled.
+	 * The entities are then reordered according to the order maximizing
+	 * the objective, the current one in case of ties.
+	 *
+	 * @param prio The priority queue to schedule
+	 */
+	void SpeculateSchedEntities(AppPrio_t prio);
+
+	/**
+	 * @brief Simulate the selection of the scheduling entities
+	 *
+	 * @param prio The priority queue to schedule
+	 * @param cand_id The candidate order (0 for the current one)
+	 * @param first_uid The application to promote ahead of the others
+	 *
+	 * @return The objective value, negative in case of error
+	 */
+	float EvalSchedCandidate(AppPrio_t prio, size_t cand_id,
+			AppUid_t first_uid);
+#endif
+
 	/**
 	 * @brief Metrics of all the AWMs of an Application
 	 *
@@ -0,0 +1,402 @@
+/*
+ * Copyright (C) 2016  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "schedbench_test.h"
+
+#include "bbque/binding_manager.h"
+#include "bbque/configuration_manager.h"
+#include "bbque/modules_factory.h"
+#include "bbque/system.h"
+#include "bbque/plugins/recipe_loader.h"
+#include "bbque/utils/timer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include <malloc.h>
+#include <sys/resource.h>
+
+#define MODULE_NAMESPACE TEST_NAMESPACE SCHEDBENCH_NAMESPACE
+#define MODULE_CONFIG    SCHEDBENCH_CONFIG
+
+namespace ba = bbque::app;
+namespace br = bbque::res;
+namespace bu = bbque::utils;
+namespace po = boost::program_options;
+
+namespace bbque { namespace plugins {
+
+
+SchedBenchTest::SchedBenchTest() :
+		am(ApplicationManager::GetInstance()),
+		ra(ResourceAccounter::GetInstance()) {
+
+	// Get a logger
+	logger = bu::Logger::GetLogger(MODULE_NAMESPACE);
+	assert(logger);
+
+	// Benchmark parameters
+	ConfigurationManager & cm(ConfigurationManager::GetInstance());
+	po::options_description opts_desc("Scheduling policies benchmark options");
+	opts_desc.add_options()
+		(MODULE_CONFIG".policies",
+		 po::value<std::string>(&policies)->default_value(
+			 BBQUE_SCHEDPOL_DEFAULT),
+		 "The scheduling policies to measure (comma separated)")
+		(MODULE_CONFIG".recipe_dir",
+		 po::value<std::string>(&recipe_dir)->default_value(
+			 BBQUE_PATH_PREFIX "/" BBQUE_PATH_RECIPES),
+		 "The recipes folder of the recipe loader")
+		(MODULE_CONFIG".cpus",
+		 po::value<uint16_t>(&cpus_num)->default_value(4),
+		 "Number of CPUs of the synthetic platform")
+		(MODULE_CONFIG".pes",
+		 po::value<uint16_t>(&pes_num)->default_value(4),
+		 "Number of processing elements per CPU")
+		(MODULE_CONFIG".mem",
+		 po::value<uint32_t>(&mem_mb)->default_value(1024),
+		 "Memory [MB] per CPU")
+		(MODULE_CONFIG".recipes",
+		 po::value<uint16_t>(&recipes_num)->default_value(8),
+		 "Number of synthetic recipes")
+		(MODULE_CONFIG".apps",
+		 po::value<uint16_t>(&apps_num)->default_value(32),
+		 "Maximum number of applications running at the same time")
+		(MODULE_CONFIG".churn",
+		 po::value<uint16_t>(&churn)->default_value(4),
+		 "Number of applications arriving/leaving per scheduling round")
+		(MODULE_CONFIG".rounds",
+		 po::value<uint32_t>(&rounds)->default_value(100),
+		 "Number of scheduling rounds per policy")
+		(MODULE_CONFIG".seed",
+		 po::value<uint32_t>(&seed)->default_value(1),
+		 "Seed of the workload script")
+		;
+	po::variables_map opts_vm;
+	cm.ParseConfigurationFile(opts_desc, opts_vm);
+}
+
+SchedBenchTest::~SchedBenchTest() {
+
+}
+
+// ===================[ Plugin interfaces ]====================================
+
+void * SchedBenchTest::Create(PF_ObjectParams *) {
+	return new SchedBenchTest();
+}
+
+int32_t SchedBenchTest::Destroy(void * plugin) {
+	if (!plugin)
+		return -1;
+	delete (SchedBenchTest *) plugin;
+	return 0;
+}
+
+
+// ===================[ Test functions ]=======================================
+
+bool SchedBenchTest::SetupPlatform() {
+	char r_path[32];
+
+	if (ra.Total("sys") != 0) {
+		logger->Info("Platform: already loaded, synthetic platform not used");
+		return true;
+	}
+
+	logger->Info("Platform: registering %d CPUs x %d PEs, %d MB per CPU...",
+			cpus_num, pes_num, mem_mb);
+	ra.SetPlatformNotReady();
+	for (uint16_t cpu_id = 0; cpu_id < cpus_num; ++cpu_id) {
+		for (uint16_t pe_id = 0; pe_id < pes_num; ++pe_id) {
+			snprintf(r_path, sizeof(r_path), "sys0.cpu%d.pe%d", cpu_id, pe_id);
+			if (!ra.RegisterResource(r_path, "", 100))
+				return false;
+		}
+		snprintf(r_path, sizeof(r_path), "sys0.cpu%d.mem0", cpu_id);
+		if (!ra.RegisterResource(r_path, "Mb", mem_mb))
+			return false;
+	}
+	ra.SetPlatformReady();
+
+	// Binding domains for the policies
+	BindingManager & bdm(BindingManager::GetInstance());
+	return (bdm.LoadBindingDomains() == BindingManager::OK);
+}
+
+bool SchedBenchTest::GenerateRecipes() {
+	char recipe_name[32];
+
+	// Each recipe has 2 to 4 AWMs, with a CPU quota ranging from one to
+	// (at most) all the processing elements of a CPU
+	for (uint16_t i = 0; i < recipes_num; ++i) {
+		uint32_t awms_num = 2 + (i % 3);
+		uint32_t pe_max   = 100 * (1 + (i % pes_num));
+
+		snprintf(recipe_name, sizeof(recipe_name),
+				SCHEDBENCH_RECIPE_PREFIX "%02d", i);
+		std::string path(recipe_dir + "/" + recipe_name + ".recipe");
+		std::ofstream recipe_file(path);
+		if (!recipe_file) {
+			logger->Error("Recipes: cannot write <%s>", path.c_str());
+			return false;
+		}
+		recipes.push_back(recipe_name);
+
+		recipe_file
+			<< "<?xml version=\"1.0\"?>\n"
+			<< "<BarbequeRTRM recipe_version=\"0.8\">\n"
+			<< "\t<application priority=\"" << (i % BBQUE_APP_PRIO_LEVELS) << "\">\n"
+			<< "\t\t<platform id=\"" PLATFORM_ID_GENERIC "\">\n"
+			<< "\t\t\t<awms>\n";
+		for (uint32_t awm_id = 0; awm_id < awms_num; ++awm_id) {
+			uint32_t pe_qty = std::max(pe_max * (awm_id + 1) / awms_num, 10u);
+			recipe_file
+				<< "\t\t\t\t<awm id=\"" << awm_id << "\" name=\"awm-"
+				<< awm_id << "\" value=\"" << (100 * (awm_id + 1) / awms_num)
+				<< "\">\n"
+				<< "\t\t\t\t\t<resources>\n"
+				<< "\t\t\t\t\t\t<cpu>\n"
+				<< "\t\t\t\t\t\t\t<pe qty=\"" << pe_qty << "\"/>\n"
+				<< "\t\t\t\t\t\t\t<mem units=\"Mb\" qty=\""
+				<< 10 * (awm_id + 1) << "\"/>\n"
+				<< "\t\t\t\t\t\t</cpu>\n"
+				<< "\t\t\t\t\t</resources>\n"
+				<< "\t\t\t\t</awm>\n";
+		}
+		recipe_file
+			<< "\t\t\t</awms>\n"
+			<< "\t\t</platform>\n"
+			<< "\t</application>\n"
+			<< "</BarbequeRTRM>\n";
+		logger->Debug("Recipes: <%s> generated [AWMs: %d]", recipe_name, awms_num);
+	}
+
+	return true;
+}
+
+void SchedBenchTest::RemoveRecipes() {
+	for (auto const & recipe_name: recipes) {
+		std::string path(recipe_dir + "/" + recipe_name + ".recipe");
+		std::remove(path.c_str());
+	}
+	recipes.clear();
+}
+
+void SchedBenchTest::Arrivals(uint16_t count) {
+	char app_name[16];
+
+	for (; count > 0; --count) {
+		std::string const & recipe_name(recipes[rng() % recipes.size()]);
+		snprintf(app_name, sizeof(app_name), "bench%d",
+				next_pid - SCHEDBENCH_PID_BASE);
+		AppPtr_t papp = am.CreateEXC(app_name, next_pid++, 0, recipe_name);
+		if (!papp) {
+			logger->Error("Arrivals: <%s> creation FAILED", app_name);
+			continue;
+		}
+		am.EnableEXC(papp);
+		apps.push_back(papp);
+	}
+}
+
+void SchedBenchTest::Departures(uint16_t count) {
+	for (; count > 0 && !apps.empty(); --count) {
+		auto app_it = apps.begin() + (rng() % apps.size());
+		AppPtr_t papp = *app_it;
+		apps.erase(app_it);
+		am.DisableEXC(papp, true);
+		am.DestroyEXC(papp);
+	}
+}
+
+void SchedBenchTest::Commit(br::RViewToken_t sched_view) {
+	AppsUidMapIt apps_it;
+	AppPtr_t papp;
+
+	// Applications not reconfigured
+	papp = am.GetFirst(ApplicationStatusIF::RUNNING, apps_it);
+	for (; papp; papp = am.GetNext(ApplicationStatusIF::RUNNING, apps_it))
+		am.SyncContinue(papp);
+	ra.SetScheduledView(sched_view);
+
+	// Synchronization session, without the applications notification
+	if (ra.SyncStart() != ResourceAccounter::RA_SUCCESS) {
+		logger->Error("Commit: resource accounting session not started");
+		return;
+	}
+
+	for (uint8_t i = ApplicationStatusIF::STARTING;
+			i <= ApplicationStatusIF::BLOCKED; ++i) {
+		ApplicationStatusIF::SyncState_t sync_state =
+			static_cast<ApplicationStatusIF::SyncState_t>(i);
+		papp = am.GetFirst(sync_state, apps_it);
+		for (; papp; papp = am.GetNext(sync_state, apps_it)) {
+			if (!papp->Blocking() && !papp->Disabled() &&
+					(ra.SyncAcquireResources(papp) !=
+						ResourceAccounter::RA_SUCCESS))
+				am.SyncAbort(papp);
+			am.SyncCommit(papp);
+		}
+	}
+
+	if (ra.SyncCommit() != ResourceAccounter::RA_SUCCESS)
+		logger->Error("Commit: resource accounting commit failed");
+}
+
+bool SchedBenchTest::Run(std::string const & name, Stats_t & stats) {
+	System & sys(System::GetInstance());
+	br::RViewToken_t sched_view;
+	bu::Timer sched_tmr;
+	double heap_growth_sum = 0;
+
+	SchedulerPolicyIF * policy = ModulesFactory::GetModule<SchedulerPolicyIF>(
+			SCHEDULER_POLICY_NAMESPACE "." + name);
+	if (!policy) {
+		logger->Error("Run: policy <%s> not available", name.c_str());
+		return false;
+	}
+
+	// Same workload script for all the policies
+	rng.seed(seed);
+	stats.sched_ms.reserve(rounds);
+	long rss_start = PeakRSS();
+
+	for (uint32_t round = 0; round < rounds; ++round) {
+		// Steady state: some applications leave, the same number arrive
+		if (apps.size() >= apps_num)
+			Departures(churn);
+		Arrivals(std::min<uint16_t>(churn, apps_num - apps.size()));
+		stats.apps_max = std::max<uint32_t>(stats.apps_max, apps.size());
+
+		size_t heap_start = HeapInUse();
+		sched_tmr.start();
+		SchedulerPolicyIF::ExitCode_t result = policy->Schedule(sys, sched_view);
+		sched_tmr.stop();
+		size_t heap_end = HeapInUse();
+
+		stats.sched_ms.push_back(sched_tmr.getElapsedTimeMs());
+		if (heap_end > heap_start)
+			heap_growth_sum += heap_end - heap_start;
+		stats.heap_max = std::max(stats.heap_max, heap_end);
+
+		if (result != SchedulerPolicyIF::SCHED_DONE) {
+			logger->Warn("Run: <%s> round %d FAILED", name.c_str(), round);
+			++stats.failures;
+			continue;
+		}
+		Commit(sched_view);
+	}
+
+	// Leave the system empty for the next policy
+	Departures(apps.size());
+
+	stats.heap_growth = rounds ? heap_growth_sum / rounds : 0;
+	stats.rss_kb = PeakRSS() - rss_start;
+	return true;
+}
+
+void SchedBenchTest::Report(std::string const & name, Stats_t & stats) {
+	std::vector<double> & samples(stats.sched_ms);
+	if (samples.empty())
+		return;
+
+	std::sort(samples.begin(), samples.end());
+	auto percentile = [&samples](double p) {
+		size_t idx = std::ceil(p * samples.size());
+		return samples[idx > 0 ? idx - 1 : 0];
+	};
+
+	logger->Notice("%-12s | %4d | %9.3f %9.3f %9.3f %9.3f | %9.1f %9lu | %7ld | %4d",
+			name.c_str(), stats.apps_max,
+			percentile(0.50), percentile(0.90), percentile(0.99),
+			samples.back(),
+			stats.heap_growth / 1024, stats.heap_max / 1024,
+			stats.rss_kb, stats.failures);
+}
+
+size_t SchedBenchTest::HeapInUse() {
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || (__GLIBC_MINOR__ >= 33))
+	struct mallinfo2 mi = mallinfo2();
+#else
+	struct mallinfo mi = mallinfo();
+#endif
+	return static_cast<size_t>(mi.uordblks) + static_cast<size_t>(mi.hblkhd);
+}
+
+long SchedBenchTest::PeakRSS() {
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+	return usage.ru_maxrss;
+}
+
+
+// ===================[ Start the test ]=======================================
+
+void SchedBenchTest::Test() {
+	std::vector<std::pair<std::string, Stats_t>> results;
+	std::istringstream policies_ss(policies);
+	std::string name;
+
+	logger->Info("Scheduling policies benchmark STARTED");
+
+	if (!SetupPlatform()) {
+		logger->Fatal("Scheduling policies benchmark FAILED: platform setup");
+		return;
+	}
+	if (!GenerateRecipes()) {
+		RemoveRecipes();
+		logger->Fatal("Scheduling policies benchmark FAILED: recipes generation");
+		return;
+	}
+
+	while (std::getline(policies_ss, name, ',')) {
+		if (name.empty())
+			continue;
+		logger->Info("Running <%s>: %d rounds, up to %d applications...",
+				name.c_str(), rounds, apps_num);
+		Stats_t stats;
+		if (Run(name, stats))
+			results.emplace_back(name, std::move(stats));
+	}
+
+	RemoveRecipes();
+
+	// Latencies are in [ms], heap and RSS figures are in [KB]. Heap.grw is
+	// the net heap growth per round.
+	logger->Notice("=================================================="
+			"====================================");
+	logger->Notice("%-12s | %4s | %9s %9s %9s %9s | %9s %9s | %7s | %4s",
+			"Policy", "Apps", "p50", "p90", "p99", "max",
+			"Heap.grw", "Heap.max", "RSS.inc", "Fail");
+	logger->Notice("--------------------------------------------------"
+			"------------------------------------");
+	for (auto & result: results)
+		Report(result.first, result.second);
+	logger->Notice("=================================================="
+			"====================================");
+
+	logger->Info("Scheduling policies benchmark COMPLETED");
+}
+
+} // namespace plugins
+
+} // namespace bbque
@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2016  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BBQUE_SCHEDBENCH_TEST_H_
+#define BBQUE_SCHEDBENCH_TEST_H_
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bbque/application_manager.h"
+#include "bbque/resource_accounter.h"
+#include "bbque/plugins/plugin.h"
+#include "bbque/plugins/scheduler_policy.h"
+#include "bbque/plugins/test.h"
+#include "bbque/utils/logging/logger.h"
+
+#define SCHEDBENCH_NAMESPACE "schedbench"
+#define SCHEDBENCH_CONFIG    "SchedBench"
+
+/** The prefix of the generated recipes */
+#define SCHEDBENCH_RECIPE_PREFIX "SchedBench_"
+
+/**
+ * The PID of the first synthetic application. This is beyond the maximum
+ * PID value supported by Linux, thus never matching a real process.
+ */
+#define SCHEDBENCH_PID_BASE 0x7f000000
+
+namespace bu = bbque::utils;
+
+// These are the parameters received by the PluginManager on create calls
+struct PF_ObjectParams;
+
+namespace bbque { namespace plugins {
+
+/**
+ * @class SchedBenchTest
+ * @brief A benchmark of the scheduling policies
+ *
+ * Measure how the Schedule() of each scheduling policy scales, without any
+ * real hardware or application. A synthetic platform of configurable size is
+ * registered into the ResourceAccounter, and a set of synthetic recipes, in
+ * the spirit of test/RecipeGenerator.sh, is generated into the recipes
+ * folder. Then, for each policy, a scripted workload of application
+ * arrivals and departures is executed for a given number of scheduling
+ * rounds. Each round is committed as the SynchronizationManager would do,
+ * without actually notifying the (not existing) applications.
+ *
+ * The workload is the same for all the policies (same random seed), thus
+ * the reported figures (latency percentiles of Schedule(), net heap growth
+ * per round, peak heap usage and peak RSS) are comparable. The net heap
+ * growth is the heap in use after a Schedule() minus the heap in use
+ * before it (when positive): it is not a count of allocations.
+ *
+ * The benchmark is configured by the SchedBench section of the
+ * configuration file, and it is executed by running the daemon in testing
+ * mode (-t), on a build with the Test Platform Data support.
+ */
+class SchedBenchTest: public TestIF {
+
+public:
+
+	/**
+	 * @brief Plugin creation method
+	 */
+	static void * Create(PF_ObjectParams *);
+
+	/**
+	 * @brief Plugin destruction method
+	 */
+	static int32_t Destroy(void *);
+
+	/**
+	 * @brief class destructor
+	 */
+	virtual ~SchedBenchTest();
+
+	/**
+	 * @brief Test launcher
+	 */
+	void Test();
+
+private:
+
+	/**
+	 * @struct Stats_t
+	 * @brief The figures collected for a scheduling policy
+	 */
+	struct Stats_t {
+		/** [ms] Execution time of each Schedule() */
+		std::vector<double> sched_ms;
+		/** Failed scheduling rounds */
+		uint32_t failures = 0;
+		/** [bytes] Net heap growth across a Schedule(), mean value */
+		double heap_growth = 0;
+		/** [bytes] Heap in use, maximum value */
+		size_t heap_max = 0;
+		/** [KB] Increase of the peak RSS */
+		long rss_kb = 0;
+		/** Maximum number of applications scheduled in a round */
+		uint32_t apps_max = 0;
+	};
+
+	std::unique_ptr<bu::Logger> logger;
+
+	ApplicationManager & am;
+
+	ResourceAccounter & ra;
+
+	/** The scheduling policies to measure (comma separated) */
+	std::string policies;
+
+	/** The recipes folder of the recipe loader */
+	std::string recipe_dir;
+
+	/** Synthetic platform: number of CPUs */
+	uint16_t cpus_num;
+
+	/** Synthetic platform: number of processing elements per CPU */
+	uint16_t pes_num;
+
+	/** Synthetic platform: [MB] memory per CPU */
+	uint32_t mem_mb;
+
+	/** Number of recipes to generate */
+	uint16_t recipes_num;
+
+	/** Maximum number of applications running at the same time */
+	uint16_t apps_num;
+
+	/** Number of applications arriving/leaving per scheduling round */
+	uint16_t churn;
+
+	/** Number of scheduling rounds per policy */
+	uint32_t rounds;
+
+	/** Seed of the workload script */
+	uint32_t seed;
+
+	/** The names of the generated recipes */
+	std::vector<std::string> recipes;
+
+	/** The applications currently in the system, in order of arrival */
+	std::deque<AppPtr_t> apps;
+
+	/** The PID of the next application */
+	AppPid_t next_pid = SCHEDBENCH_PID_BASE;
+
+	/** Pseudo-random generator driving the workload script */
+	std::mt19937 rng;
+
+	/**
+	 * @brief Constructor
+	 */
+	SchedBenchTest();
+
+	/**
+	 * @brief Register the synthetic platform (if no platform is loaded)
+	 */
+	bool SetupPlatform();
+
+	/**
+	 * @brief Generate the synthetic recipes into the recipes folder
+	 */
+	bool GenerateRecipes();
+
+	/**
+	 * @brief Remove the generated recipes
+	 */
+	void RemoveRecipes();
+
+	/**
+	 * @brief Run the workload script with a scheduling policy
+	 *
+	 * @return false if the policy is not available
+	 */
+	bool Run(std::string const & name, Stats_t & stats);
+
+	/**
+	 * @brief Start new applications, each one with a random recipe
+	 */
+	void Arrivals(uint16_t count);
+
+	/**
+	 * @brief Terminate random applications
+	 */
+	void Departures(uint16_t count);
+
+	/**
+	 * @brief Make a scheduling effective
+	 *
+	 * Perform the resource accounting as the SynchronizationManager does at
+	 * the end of a synchronization session.
+	 */
+	void Commit(br::RViewToken_t sched_view);
+
+	/**
+	 * @brief Report the figures collected for a policy
+	 */
+	void Report(std::string const & name, Stats_t & stats);
+
+	/**
+	 * @brief [bytes] The heap currently in use
+	 */
+	static size_t HeapInUse();
+
+	/**
+	 * @brief [KB] The peak resident set size of the process
+	 */
+	static long PeakRSS();
+
+};
+
+} // namespace plugins
+
+} // namespace bbque
+
+#endif // BBQUE_SCHEDBENCH_TEST_H_
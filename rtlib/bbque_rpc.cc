@@ -19,7 +19,12 @@
 
 #include "bbque/config.h"
 #include "bbque/rtlib/bbque_rpc.h"
-#include "bbque/rtlib/rpc_fifo_client.h"
+#ifdef CONFIG_BBQUE_RPC_FIFO
+# include "bbque/rtlib/rpc_fifo_client.h"
+#endif
+#ifdef CONFIG_BBQUE_RPC_SHM
+# include "bbque/rtlib/rpc_shm_client.h"
+#endif
 #include "bbque/rtlib/rpc_unmanaged_client.h"
 #include "bbque/app/application.h"
 #include "bbque/utils/cgroups.h"
@@ -29,7 +34,13 @@
 #include <cstdio>
 #include <cmath>
 #include <cstring>
+#include <ctime>
 #include <sys/stat.h>
+#ifdef CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <unistd.h>
+#endif
 
 #ifdef CONFIG_BBQUE_OPENCL
 #include "bbque/rtlib/bbque_ocl.h"
@@ -56,6 +67,9 @@ std::unique_ptr<bu::Logger> BbqueRPC::logger;
 // The RTLib configuration
 RTLIB_Conf_t BbqueRPC::rtlib_configuration;
 
+// The EXC returned by failed lookups
+const BbqueRPC::pRegisteredEXC_t BbqueRPC::no_exc;
+
 #ifdef CONFIG_BBQUE_RTLIB_CGROUPS_SUPPORT
 // The CGroup forcing configuration (for UNMANAGED applications)
 static bu::CGroups::CGSetup cgsetup;
@@ -94,6 +108,9 @@ BbqueRPC * BbqueRPC::GetInstance()
 #ifdef CONFIG_BBQUE_RPC_FIFO
 	logger->Debug("Using FIFO RPC channel");
 	instance = new BbqueRPC_FIFO_Client();
+#elif defined(CONFIG_BBQUE_RPC_SHM)
+	logger->Debug("Using SHM RPC channel");
+	instance = new BbqueRPC_SHM_Client();
 #else
 #error RPC Channel NOT defined
 #endif // CONFIG_BBQUE_RPC_FIFO
@@ -399,19 +416,37 @@ RTLIB_EXCHandler_t BbqueRPC::Register(
 	// Build the new EXC
 	auto new_exc =
 		pRegisteredEXC_t(new RegisteredExecutionContext_t(name, NextExcID()));
+	assert((void *) new_exc.get() == (void *) & (new_exc->parameters));
 	memcpy((void *) & (new_exc->parameters), (void *) params,
 		   sizeof (RTLIB_EXCParameters_t));
+
+	// The EXC ID must be free before registering the EXC to the RTRM
+	if (exc_map.find(new_exc->id) != exc_map.end()) {
+		logger->Error("Registering EXC [%s] FAILED "
+					  "(Error: EXC ID %d already in use)", name, new_exc->id);
+		return nullptr;
+	}
+
+#ifdef CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+	// The telemetry page must be available before the RTRM creates the EXC
+	if (! rtlib_configuration.unmanaged.enabled)
+		TelemetrySetup(new_exc);
+#endif
 	// Calling the Low-level registration
 	result = _Register(new_exc);
 
 	if (result != RTLIB_OK) {
 		logger->Error("Registering EXC [%s] FAILED "
 					  "(Error %d: %s)", name, result, RTLIB_ErrorStr(result));
+#ifdef CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+		TelemetryRelease(new_exc);
+#endif
 		return nullptr;
 	}
 
 	// Save the registered execution context
-	exc_map.emplace(new_exc->id, new_exc);
+	auto exc_entry = exc_map.emplace(new_exc->id, new_exc);
+	new_exc->entry = & (exc_entry.first->second);
 	// Mark the EXC as Registered
 	setRegistered(new_exc);
 	return (RTLIB_EXCHandler_t) & (new_exc->parameters);
@@ -429,75 +464,55 @@ RTLIB_ExitCode_t BbqueRPC::SetupCGroup(
 	return CGroupPathSetup(exc);
 }
 
-BbqueRPC::pRegisteredEXC_t BbqueRPC::getRegistered(
+BbqueRPC::pRegisteredEXC_t const & BbqueRPC::getRegistered(
 	const RTLIB_EXCHandler_t exc_handler)
 {
 	assert(exc_handler);
 
 	// Checking for library initialization
-	if (! rtlib_is_initialized) {
+	if (unlikely(! rtlib_is_initialized)) {
 		logger->Error("EXC [%p] lookup FAILED "
 					  "(Error: RTLIB not initialized)", (void *) exc_handler);
 		assert(rtlib_is_initialized);
-		return nullptr;
+		return no_exc;
 	}
 
-	bool exc_found = false;
-	pRegisteredEXC_t exc;
-
-	// Ensuring the execution context has been registered
-	for (auto & registered_exc : exc_map) {
-		exc = registered_exc.second;
-
-		if ((void *) exc_handler == (void *) &exc->parameters) {
-			exc_found = true;
-			break;
-		}
-	}
+	// The handler is the address of the EXC parameters, i.e., of the EXC
+	// itself. Registered EXCs are never released before the RTLib, thus the
+	// magic number and the map entry identify a handler we returned.
+	auto exc = reinterpret_cast<RegisteredExecutionContext_t *>(exc_handler);
 
-	// Handle EXC not found
-	if (exc_found == false) {
+	if (unlikely(exc->magic != EXC_MAGIC || exc->entry == nullptr)) {
 		logger->Error("EXC [%p] lookup FAILED "
 					  "(Error: EXC not registered)", (void *) exc_handler);
-		assert(exc_found != false);
-		return nullptr;
+		assert(exc->magic == EXC_MAGIC && exc->entry != nullptr);
+		return no_exc;
 	}
 
-	return exc;
+	return *(exc->entry);
 }
 
-BbqueRPC::pRegisteredEXC_t BbqueRPC::getRegistered(uint8_t exc_id)
+BbqueRPC::pRegisteredEXC_t const & BbqueRPC::getRegistered(uint8_t exc_id)
 {
 	// Checking for library initialization
 	if (! rtlib_is_initialized) {
 		logger->Error("EXC [uid %d] lookup FAILED "
 					  "(Error: RTLIB not initialized)", exc_id);
 		assert(rtlib_is_initialized);
-		return nullptr;
+		return no_exc;
 	}
 
-	bool exc_found = false;
-	pRegisteredEXC_t exc;
-
-	// Ensuring the execution context has been registered
-	for (auto & registered_exc : exc_map) {
-		exc = registered_exc.second;
-
-		if (registered_exc.first == exc_id) {
-			exc_found = true;
-			break;
-		}
-	}
+	auto exc_it = exc_map.find(exc_id);
 
 	// Handle EXC not found
-	if (exc_found == false) {
+	if (exc_it == exc_map.end()) {
 		logger->Error("EXC [uid %d] lookup FAILED "
 					  "(Error: EXC not registered)", exc_id);
-		assert(exc_found != false);
-		return nullptr;
+		assert(exc_it != exc_map.end());
+		return no_exc;
 	}
 
-	return exc;
+	return exc_it->second;
 }
 
 void BbqueRPC::Unregister(
@@ -530,6 +545,9 @@ void BbqueRPC::Unregister(
 	clearRegistered(exc);
 	// Release the controlling CGroup
 	CGroupDelete(exc);
+#ifdef CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+	TelemetryRelease(exc);
+#endif
 }
 
 void BbqueRPC::UnregisterAll()
@@ -562,6 +580,9 @@ void BbqueRPC::UnregisterAll()
 
 		// Mark the EXC as Unregistered
 		clearRegistered(exc);
+#ifdef CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+		TelemetryRelease(exc);
+#endif
 	}
 }
 
@@ -1110,9 +1131,9 @@ void BbqueRPC::SyncTimeEstimation(pRegisteredEXC_t exc)
 	_SyncTimeEstimation(exc);
 }
 
-RTLIB_ExitCode_t BbqueRPC::UpdateStatistics(pRegisteredEXC_t exc)
+RTLIB_ExitCode_t BbqueRPC::UpdateStatistics(pRegisteredEXC_t const & exc)
 {
-	pAwmStats_t awm_stats(exc->current_awm_stats);
+	pAwmStats_t const & awm_stats(exc->current_awm_stats);
 	double last_config_ms;
 
 	// Check if this is the first re-start on this AWM
@@ -1133,45 +1154,52 @@ RTLIB_ExitCode_t BbqueRPC::UpdateStatistics(pRegisteredEXC_t exc)
 	return RTLIB_OK;
 }
 
-RTLIB_ExitCode_t BbqueRPC::UpdateCPUBandwidthStats(pRegisteredEXC_t exc)
+/**
+ * @brief Sample a clock [ns]
+ *
+ * The CPU time of the process is sampled by clock_gettime() rather than
+ * times(), since the latter has a clock tick resolution (usually 10 ms),
+ * i.e., it does not measure cycles shorter than that.
+ */
+static inline uint64_t SampleClockNs(clockid_t clock_id)
 {
-	exc->cpu_usage_info.current_time = times(&exc->cpu_usage_info.time_sample);
-	clock_t elapsed_time = exc->cpu_usage_info.current_time
-						   - exc->cpu_usage_info.previous_time;
-	clock_t system_time = exc->cpu_usage_info.time_sample.tms_stime
-						  - exc->cpu_usage_info.previous_tms_stime;
-	clock_t user_time = exc->cpu_usage_info.time_sample.tms_utime
-						- exc->cpu_usage_info.previous_tms_utime;
+	struct timespec ts;
+	clock_gettime(clock_id, &ts);
+	return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
 
-	if (elapsed_time <= 0 || system_time < 0 || user_time < 0)
+RTLIB_ExitCode_t BbqueRPC::UpdateCPUBandwidthStats(pRegisteredEXC_t const & exc)
+{
+	uint64_t current_time_ns = SampleClockNs(CLOCK_MONOTONIC);
+	uint64_t current_cpu_time_ns = SampleClockNs(CLOCK_PROCESS_CPUTIME_ID);
+	uint64_t elapsed_time_ns =
+		current_time_ns - exc->cpu_usage_info.previous_time_ns;
+	uint64_t cpu_time_ns =
+		current_cpu_time_ns - exc->cpu_usage_info.previous_cpu_time_ns;
+
+	if (elapsed_time_ns == 0)
 		return RTLIB_ERROR;
 
-	double cpu_usage = 100.0 * (system_time + user_time) / elapsed_time;
+	double cpu_usage = 100.0 * cpu_time_ns / elapsed_time_ns;
 	exc->cpu_usage_analyser.InsertValue(cpu_usage);
 	logger->Debug("Measured CPU Usage: %f, average: %f",
 				  cpu_usage, exc->cpu_usage_analyser.GetMean());
-	exc->cpu_usage_info.previous_time = exc->cpu_usage_info.current_time;
-	exc->cpu_usage_info.previous_tms_stime =
-		exc->cpu_usage_info.time_sample.tms_stime;
-	exc->cpu_usage_info.previous_tms_utime =
-		exc->cpu_usage_info.time_sample.tms_utime;
+	exc->cpu_usage_info.previous_time_ns = current_time_ns;
+	exc->cpu_usage_info.previous_cpu_time_ns = current_cpu_time_ns;
 	return RTLIB_OK;
 }
 
-void BbqueRPC::InitCPUBandwidthStats(pRegisteredEXC_t exc)
+void BbqueRPC::InitCPUBandwidthStats(pRegisteredEXC_t const & exc)
 {
-	exc->cpu_usage_info.current_time = times(&exc->cpu_usage_info.time_sample);
-	exc->cpu_usage_info.previous_time = exc->cpu_usage_info.current_time;
-	exc->cpu_usage_info.previous_tms_stime =
-		exc->cpu_usage_info.time_sample.tms_stime;
-	exc->cpu_usage_info.previous_tms_utime =
-		exc->cpu_usage_info.time_sample.tms_utime;
+	exc->cpu_usage_info.previous_time_ns = SampleClockNs(CLOCK_MONOTONIC);
+	exc->cpu_usage_info.previous_cpu_time_ns =
+		SampleClockNs(CLOCK_PROCESS_CPUTIME_ID);
 }
 
-RTLIB_ExitCode_t BbqueRPC::UpdateMonitorStatistics(pRegisteredEXC_t exc)
+RTLIB_ExitCode_t BbqueRPC::UpdateMonitorStatistics(pRegisteredEXC_t const & exc)
 {
 	double last_monitor_ms;
-	pAwmStats_t awm_stats(exc->current_awm_stats);
+	pAwmStats_t const & awm_stats(exc->current_awm_stats);
 	last_monitor_ms  = exc->execution_timer.getElapsedTimeMs();
 	last_monitor_ms -= exc->mon_tstart;
 	awm_stats->time_spent_monitoring += last_monitor_ms;
@@ -2096,9 +2124,8 @@ RTLIB_ExitCode_t BbqueRPC::UpdateAllocation(
 	const RTLIB_EXCHandler_t exc_handler)
 {
 	// Get the execution context ///////////////////////////////////////////////
-	pRegisteredEXC_t exc;
 	assert(exc_handler);
-	exc = getRegistered(exc_handler);
+	auto const & exc = getRegistered(exc_handler);
 
 	if (! exc) {
 		logger->Error("[%p] RTP forward FAILED (EXC not registered)",
@@ -2106,6 +2133,11 @@ RTLIB_ExitCode_t BbqueRPC::UpdateAllocation(
 		return RTLIB_EXC_NOT_REGISTERED;
 	}
 
+	return UpdateAllocation(exc);
+}
+
+RTLIB_ExitCode_t BbqueRPC::UpdateAllocation(pRegisteredEXC_t const & exc)
+{
 	// Init ggap info
 	float goal_gap = 0.0f;
 	exc->runtime_profiling.cpu_goal_gap = 0.0f;
@@ -2271,9 +2303,8 @@ RTLIB_ExitCode_t BbqueRPC::ForwardRuntimeProfile(
 	const RTLIB_EXCHandler_t exc_handler)
 {
 	// Get the execution context ///////////////////////////////////////////////
-	pRegisteredEXC_t exc;
 	assert(exc_handler);
-	exc = getRegistered(exc_handler);
+	auto const & exc = getRegistered(exc_handler);
 
 	if (! exc) {
 		logger->Error("[%p] RTP forward FAILED (EXC not registered)",
@@ -2281,6 +2312,11 @@ RTLIB_ExitCode_t BbqueRPC::ForwardRuntimeProfile(
 		return RTLIB_EXC_NOT_REGISTERED;
 	}
 
+	return ForwardRuntimeProfile(exc);
+}
+
+RTLIB_ExitCode_t BbqueRPC::ForwardRuntimeProfile(pRegisteredEXC_t const & exc)
+{
 	// Check SKIP conditions ///////////////////////////////////////////////////
 
 	// Ggap computing is inhibited for some ms when the application is
@@ -2321,8 +2357,19 @@ RTLIB_ExitCode_t BbqueRPC::ForwardRuntimeProfile(
 			rtlib_configuration.runtime_profiling.rt_profile_wait_for_sync_ms;
 	exc->is_waiting_for_sync = true;
 
+#ifdef CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+	// The previous notification has not been processed yet: the RTRM will
+	// read the latest profile from the telemetry page
+	if (exc->telemetry && exc->telemetry->attached.load() &&
+			exc->telemetry->notify_pending.exchange(1) != 0) {
+		logger->Debug("[%p:%s] Profile notification COALESCED",
+					 (void *) &exc->parameters, exc->name.c_str());
+		return RTLIB_OK;
+	}
+#endif
+
 	logger->Debug("[%p:%s] Profile notification : {Gap: %.2f, CPU: "
-				 "%.2f, CTime: %.2f ms}", (void *) exc_handler, exc->name.c_str(),
+				 "%.2f, CTime: %.2f ms}", (void *) &exc->parameters, exc->name.c_str(),
 				 goal_gap, cpu_usage, cycle_time_avg_ms);
 	// Forward the RTP
 	RTLIB_ExitCode_t result =
@@ -2331,13 +2378,136 @@ RTLIB_ExitCode_t BbqueRPC::ForwardRuntimeProfile(
 
 	if (result != RTLIB_OK) {
 		logger->Error("[%p:%s] Profile notification FAILED (Error %d: %s)",
-					  (void *) exc_handler, exc->name.c_str(), result, RTLIB_ErrorStr(result));
+					  (void *) &exc->parameters, exc->name.c_str(), result, RTLIB_ErrorStr(result));
+#ifdef CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+		// Not sent: the next profile must be notified
+		if (exc->telemetry)
+			exc->telemetry->notify_pending.store(0);
+#endif
 		return RTLIB_EXC_ENABLE_FAILED;
 	}
 
 	return RTLIB_OK;
 }
 
+#ifdef CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+
+RTLIB_ExitCode_t BbqueRPC::TelemetrySetup(pRegisteredEXC_t const & exc)
+{
+	char shm_name[BBQUE_RTP_TELEMETRY_NAME_LENGTH];
+	void * paddr;
+	int fd;
+
+	rtp_telemetry_name(shm_name, channel_thread_pid, exc->id);
+
+	// Creating the page (cleaning up a stale one)
+	::shm_unlink(shm_name);
+	fd = ::shm_open(shm_name, O_RDWR | O_CREAT | O_EXCL, 0600);
+
+	if (fd < 0) {
+		logger->Warn("Telemetry page [%s] creation FAILED (Error %d: %s)",
+					 shm_name, errno, strerror(errno));
+		return RTLIB_ERROR;
+	}
+
+	// The page is R/W to the owner only (the RTRM daemon runs privileged)
+	if (ftruncate(fd, sizeof(rtp_telemetry_page_t))) {
+		logger->Warn("Telemetry page [%s] setup FAILED (Error %d: %s)",
+					 shm_name, errno, strerror(errno));
+		::close(fd);
+		::shm_unlink(shm_name);
+		return RTLIB_ERROR;
+	}
+
+	paddr = ::mmap(NULL, sizeof(rtp_telemetry_page_t),
+			PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+
+	if (paddr == MAP_FAILED) {
+		logger->Warn("Telemetry page [%s] mapping FAILED (Error %d: %s)",
+					 shm_name, errno, strerror(errno));
+		::shm_unlink(shm_name);
+		return RTLIB_ERROR;
+	}
+
+	// The page is zero filled, i.e. no sample published yet
+	exc->telemetry = (rtp_telemetry_page_t *) paddr;
+	exc->telemetry->app_pid = channel_thread_pid;
+	exc->telemetry->exc_id  = exc->id;
+	exc->telemetry->version = BBQUE_RTP_TELEMETRY_VERSION;
+	logger->Debug("Telemetry page [%s] ready", shm_name);
+
+	return RTLIB_OK;
+}
+
+void BbqueRPC::TelemetryRelease(pRegisteredEXC_t const & exc)
+{
+	char shm_name[BBQUE_RTP_TELEMETRY_NAME_LENGTH];
+
+	if (! exc->telemetry)
+		return;
+
+	// The page is released once unmapped also by the RTRM
+	::munmap(exc->telemetry, sizeof(rtp_telemetry_page_t));
+	exc->telemetry = nullptr;
+	rtp_telemetry_name(shm_name, channel_thread_pid, exc->id);
+	::shm_unlink(shm_name);
+}
+
+void BbqueRPC::TelemetryPublish(pRegisteredEXC_t const & exc)
+{
+	rtp_telemetry_sample_t sample;
+
+	if (! exc->telemetry)
+		return;
+
+	sample.timestamp_us = SampleClockNs(CLOCK_MONOTONIC) / 1000;
+	sample.cycles = exc->cycles_count;
+	sample.awm_id = exc->current_awm_id;
+
+	// Cycle times and throughput
+	sample.cycle_time_ms     = exc->cycletime_analyser_user.GetLastValue();
+	sample.cycle_time_avg_ms = exc->cycletime_analyser_user.GetMean();
+	sample.cycle_time_max_ms = exc->cycletime_analyser_system.GetMean() +
+		exc->cycletime_analyser_system.GetConfidenceInterval99();
+	sample.cps = (sample.cycle_time_avg_ms > 0) ?
+		1000.0 / sample.cycle_time_avg_ms : 0;
+	sample.jps = sample.cps * exc->jpc;
+
+	// CPU usage and goal gap
+	sample.goal_gap  = exc->runtime_profiling.cpu_goal_gap;
+	sample.cpu_usage = exc->cpu_usage_analyser.GetMean();
+#ifdef CONFIG_BBQUE_CGROUPS_DISTRIBUTED_ACTUATION
+	sample.cpu_budget = 100.0f * exc->cg_budget.cpu_budget_shared;
+#else
+	auto const sys_res_it = exc->resource_assignment.find(0);
+	sample.cpu_budget = (sys_res_it != exc->resource_assignment.end()) ?
+		sys_res_it->second->cpu_bandwidth : 0;
+#endif
+
+	// Performance counters of the current AWM
+	sample.counters_count = 0;
+#ifdef CONFIG_BBQUE_RTLIB_PERF_SUPPORT
+	if (exc->current_awm_stats) {
+		pAwmStats_t const & awm_stats(exc->current_awm_stats);
+		std::unique_lock<std::mutex> stats_lock(awm_stats->stats_mutex);
+		for (auto const & event_entry : awm_stats->events_map) {
+			if (sample.counters_count == BBQUE_RTP_TELEMETRY_MAX_COUNTERS)
+				break;
+			rtp_telemetry_counter_t & counter(
+				sample.counters[sample.counters_count++]);
+			counter.type   = event_entry.second->pattr->type;
+			counter.config = event_entry.second->pattr->config;
+			counter.value  = event_entry.second->value;
+		}
+	}
+#endif
+
+	rtp_telemetry_publish(exc->telemetry, sample);
+}
+
+#endif // CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+
 RTLIB_ExitCode_t BbqueRPC::SetExplicitGoalGap(
 	const RTLIB_EXCHandler_t exc_handler,
 	int ggap)
@@ -2605,7 +2775,7 @@ void BbqueRPC::PerfSetupStats(pRegisteredEXC_t exc, pAwmStats_t awm_stats)
 	}
 }
 
-void BbqueRPC::PerfCollectStats(pRegisteredEXC_t exc)
+void BbqueRPC::PerfCollectStats(pRegisteredEXC_t const & exc)
 {
 	std::unique_lock<std::mutex> stats_lock(exc->current_awm_stats->stats_mutex);
 	pAwmStats_t       awm_stats = exc->current_awm_stats;
@@ -3142,7 +3312,7 @@ float BbqueRPC::GetJPS(
 	return GetCPS(exc_handler) * exc->jpc;
 }
 
-void BbqueRPC::ForceCPS(pRegisteredEXC_t exc)
+void BbqueRPC::ForceCPS(pRegisteredEXC_t const & exc)
 {
 	float delay_ms = 0; // [ms] delay to stick with the required FPS
 	uint32_t sleep_us;
@@ -3365,28 +3535,31 @@ void BbqueRPC::NotifyPostConfigure(
 	}
 }
 
+/*
+ * The notifiers below are called at each processing cycle: they resolve the
+ * EXC handler in constant time, without copying the EXC pointer, and they
+ * do not allocate memory or take locks (unless perf counters are enabled).
+ */
+
 void BbqueRPC::NotifyPreRun(
 	RTLIB_EXCHandler_t exc_handler)
 {
-	logger->Debug("Pre-Run: retrieving execution context info");
 	// Retrieving the requested execution context
 	assert(exc_handler);
-	auto exc = getRegistered(exc_handler);
+	auto const & exc = getRegistered(exc_handler);
 
-	if (! exc) {
+	if (unlikely(! exc)) {
 		logger->Error("NotifyPreRun EXC [%p] FAILED "
 					  "(EXC not registered)", (void *) exc_handler);
 		return;
 	}
 
 	assert(isRegistered(exc) == true);
-	logger->Debug("Pre-Run: Checking if perf counters are activated");
 	bool pcounters_collected_systemwide =
 		rtlib_configuration.profile.perf_counters.global;
 	bool pcounters_to_be_monitored = PerfRegisteredEvents(exc);
 
 	if (! pcounters_collected_systemwide && pcounters_to_be_monitored > 0) {
-		logger->Debug("Pre-Run: per-EXC perf counter support: ACTIVE");
 		bool pcounters_monitor_rtlib_overheads =
 			rtlib_configuration.profile.perf_counters.overheads;
 
@@ -3396,36 +3569,32 @@ void BbqueRPC::NotifyPreRun(
 			PerfCollectStats(exc);
 		}
 		else {
-			logger->Debug("Pre-Run: standard profiling mode: enabling perf");
 			PerfEnable(exc);
 		}
 	}
 
-	logger->Debug("Pre-Run: Starting computing CPU quota");
+	// Start computing CPU quota
 	InitCPUBandwidthStats(exc);
 }
 
 void BbqueRPC::NotifyPostRun(
 	RTLIB_EXCHandler_t exc_handler)
 {
-	logger->Debug("Post-Run: retrieving execution context info");
 	assert(exc_handler);
-	auto exc = getRegistered(exc_handler);
+	auto const & exc = getRegistered(exc_handler);
 
-	if (! exc) {
+	if (unlikely(! exc)) {
 		logger->Error("NotifyPostRun EXC [%p] FAILED "
 					  "(EXC not registered)", (void *) exc_handler);
 		return;
 	}
 
 	assert(isRegistered(exc) == true);
-	logger->Debug("Post-Run: Checking if perf counters are activated");
 	bool pcounters_collected_systemwide =
 		rtlib_configuration.profile.perf_counters.global;
 	bool pcounters_to_be_monitored = PerfRegisteredEvents(exc);
 
 	if (! pcounters_collected_systemwide && pcounters_to_be_monitored > 0) {
-		logger->Debug("Post-Run: per-EXC perf counter support: ACTIVE");
 		bool pcounters_monitor_rtlib_overheads =
 			rtlib_configuration.profile.perf_counters.overheads;
 
@@ -3434,14 +3603,12 @@ void BbqueRPC::NotifyPostRun(
 			PerfEnable(exc);
 		}
 		else {
-			logger->Debug("Post-Run: standard profiling mode: disabling perf");
 			PerfDisable(exc);
 			PerfCollectStats(exc);
 		}
 	}
 
-	logger->Debug("Post-Run: Stop computing CPU quota");
-
+	// Stop computing CPU quota
 	if (UpdateCPUBandwidthStats(exc) != RTLIB_OK)
 		logger->Debug("PostRun: could not compute current CPU bandwidth");
 
@@ -3456,36 +3623,32 @@ void BbqueRPC::NotifyPostRun(
 void BbqueRPC::NotifyPreMonitor(
 	RTLIB_EXCHandler_t exc_handler)
 {
-	pRegisteredEXC_t exc;
 	assert(exc_handler);
-	exc = getRegistered(exc_handler);
+	auto const & exc = getRegistered(exc_handler);
 
-	if (! exc) {
+	if (unlikely(! exc)) {
 		logger->Error("NotifyPreMonitor EXC [%p] FAILED "
 					  "(EXC not registered)", (void *) exc_handler);
 		return;
 	}
 
 	assert(isRegistered(exc) == true);
-	logger->Debug("===> NotifyMonitor");
 	// Keep track of monitoring start time
 	exc->mon_tstart = exc->execution_timer.getElapsedTimeMs();
 }
 
 void BbqueRPC::NotifyPostMonitor(RTLIB_EXCHandler_t exc_handler)
 {
-	pRegisteredEXC_t exc;
 	assert(exc_handler);
-	exc = getRegistered(exc_handler);
+	auto const & exc = getRegistered(exc_handler);
 
-	if (! exc) {
+	if (unlikely(! exc)) {
 		logger->Error("NotifyPostMonitor EXC [%p] FAILED "
 					  "(EXC not registered)", (void *) exc_handler);
 		return;
 	}
 
 	assert(isRegistered(exc) == true);
-	logger->Debug("<=== NotifyMonitor");
 	// Update monitoring statistics
 	UpdateMonitorStatistics(exc);
 
@@ -3498,14 +3661,16 @@ void BbqueRPC::NotifyPostMonitor(RTLIB_EXCHandler_t exc_handler)
 
 	// Compute the ideal resource allocation for the application,
 	// given its history
-	UpdateAllocation(exc_handler);
+	UpdateAllocation(exc);
+#ifdef CONFIG_BBQUE_RTLIB_RTP_TELEMETRY
+	TelemetryPublish(exc);
+#endif
 
 	// Check is there is a goal gap
 	if (abs(exc->runtime_profiling.cpu_goal_gap) > 1.0f) {
 		logger->Debug("Goal gap forwarding (ggap %f)", exc->runtime_profiling.cpu_goal_gap);
-		ForwardRuntimeProfile(exc_handler);
-	} else
-		logger->Debug("No goal gap forwarding (ggap 0)");
+		ForwardRuntimeProfile(exc);
+	}
 }
 
 #ifdef CONFIG_BBQUE_OPENCL
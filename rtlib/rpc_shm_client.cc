@@ -0,0 +1,769 @@
+/*
+ * Copyright (C) 2012  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bbque/rtlib/rpc_shm_client.h"
+
+#include "bbque/rtlib/rpc_messages.h"
+#include "bbque/utils/utility.h"
+#include "bbque/utils/logging/console_logger.h"
+#include "bbque/config.h"
+#include "bbque/cpp11/chrono.h"
+
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/stat.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+
+namespace bu = bbque::utils;
+
+// Setup logging
+#undef  BBQUE_LOG_MODULE
+#define BBQUE_LOG_MODULE "rpc.shm"
+
+/**
+ * Reserve into the ring to Barbeque the room for a message of the specified
+ * type, which is then built in place by means of the "pmsg" pointer
+ */
+#define RPC_SHM_RESERVE_SIZE(RPC_MSG, SIZE)\
+std::unique_lock<std::mutex> chTx_ul(chTx_mtx);\
+uint32_t ring_pos;\
+rpc_msg_ ## RPC_MSG ## _t * pmsg =\
+	(rpc_msg_ ## RPC_MSG ## _t *)ChannelReserve(SIZE, ring_pos);\
+if (!pmsg) {\
+	logger->Error("write to BBQUE channel FAILED [%s]\n",\
+		app_shm_name);\
+	return RTLIB_BBQUE_CHANNEL_WRITE_FAILED;\
+}
+
+#define RPC_SHM_RESERVE(RPC_MSG)\
+	RPC_SHM_RESERVE_SIZE(RPC_MSG, RPC_PKT_SIZE(RPC_MSG))
+
+#define RPC_SHM_HEADER(TYPE, TOKEN, EXC_ID)\
+	pmsg->hdr.typ = TYPE;\
+	pmsg->hdr.token = TOKEN;\
+	pmsg->hdr.app_pid = channel_thread_pid;\
+	pmsg->hdr.exc_id = EXC_ID;
+
+#define RPC_SHM_SEND(RPC_MSG)\
+logger->Debug("Tx [" #RPC_MSG "] Request "\
+				"RPC_HDR [typ: %d, pid: %d, eid: %" PRIu8 "]...\n",\
+	pmsg->hdr.typ,\
+	pmsg->hdr.app_pid,\
+	pmsg->hdr.exc_id\
+);\
+ChannelCommit(ring_pos);\
+chTx_ul.unlock();
+
+namespace bbque
+{
+namespace rtlib
+{
+
+BbqueRPC_SHM_Client::BbqueRPC_SHM_Client() :
+BbqueRPC(),
+done(false)
+{
+	logger->Debug("Building SHM RPC channel");
+}
+
+BbqueRPC_SHM_Client::~ BbqueRPC_SHM_Client()
+{
+	logger = bu::ConsoleLogger::GetInstance(BBQUE_LOG_MODULE);
+	logger->Debug("BbqueRPC_SHM_Client dtor");
+	ChannelRelease();
+}
+
+RTLIB_ExitCode_t BbqueRPC_SHM_Client::ChannelRelease()
+{
+	std::unique_lock<std::mutex> trdStatus_ul(trdStatus_mtx, std::defer_lock);
+	std::unique_lock<std::mutex> chTx_ul(chTx_mtx, std::defer_lock);
+	rpc_msg_APP_EXIT_t * pmsg;
+	uint32_t ring_pos;
+
+	if (channel) {
+		logger->Debug("Releasing SHM RPC channel");
+		// Sending RPC Request
+		chTx_ul.lock();
+		pmsg = (rpc_msg_APP_EXIT_t *)ChannelReserve(
+				RPC_PKT_SIZE(APP_EXIT), ring_pos);
+		if (pmsg) {
+			RPC_SHM_HEADER(RPC_APP_EXIT, RpcMsgToken(), 0);
+			ChannelCommit(ring_pos);
+		}
+		else
+			logger->Error("Notify BBQUE exit FAILED");
+		chTx_ul.unlock();
+	}
+
+	// Stop the fetch thread, even if waiting for the channel setup
+	trdStatus_ul.lock();
+	done = true;
+	trdStatus_cv.notify_one();
+	trdStatus_ul.unlock();
+	if (channel) {
+		channel->to_app.doorbell.fetch_add(1);
+		rpc_shm_ring_doorbell(&(channel->to_app.doorbell));
+	}
+
+	// Joining fetch thread
+	if (ChTrd.joinable())
+		ChTrd.join();
+
+	// Releasing the channel segment: the name is removed, the memory is
+	// released once unmapped also by Barbeque
+	if (channel) {
+		::munmap(channel, sizeof(rpc_shm_channel_t));
+		channel = NULL;
+		::shm_unlink(app_shm_name);
+	}
+
+	if (server) {
+		::munmap(server, sizeof(rpc_shm_server_t));
+		server = NULL;
+	}
+
+	return RTLIB_OK;
+}
+
+void * BbqueRPC_SHM_Client::ChannelReserve(size_t size, uint32_t & pos)
+{
+	std::chrono::steady_clock::time_point timeout;
+	void * pbuf;
+
+	if (unlikely(!channel))
+		return NULL;
+
+	if (unlikely(RPC_SHM_RECORD_SIZE(size) > BBQUE_SHM_RING_SIZE)) {
+		logger->Error("Message too big for the channel [sze: %d]", size);
+		return NULL;
+	}
+
+	pbuf = rpc_shm_reserve(&(channel->to_bbque), size, pos);
+	if (likely(pbuf != NULL))
+		return pbuf;
+
+	// Wait for Barbeque to consume some messages
+	logger->Warn("Channel to BBQUE full, waiting...");
+	timeout = std::chrono::steady_clock::now() +
+		std::chrono::milliseconds(BBQUE_RPC_TIMEOUT);
+	while (!(pbuf = rpc_shm_reserve(&(channel->to_bbque), size, pos))) {
+		if (std::chrono::steady_clock::now() > timeout)
+			return NULL;
+		std::this_thread::sleep_for(std::chrono::microseconds(100));
+	}
+
+	return pbuf;
+}
+
+void BbqueRPC_SHM_Client::ChannelCommit(uint32_t pos)
+{
+	// Barbeque sleeps on the doorbell of its own region, where all the
+	// applications ring
+	rpc_shm_commit(&(channel->to_bbque), pos);
+	server->doorbell.fetch_add(1);
+	if (server->sleeping.load())
+		rpc_shm_ring_doorbell(&(server->doorbell));
+}
+
+rpc_msg_header_t * BbqueRPC_SHM_Client::ChannelRecv(uint32_t & size)
+{
+	rpc_shm_ring_t * pring = &(channel->to_app);
+	uint32_t doorbell;
+	void * prec;
+
+	while (! done) {
+		// Read the doorbell before looking for messages, thus a message
+		// published right after the check makes the wait to return
+		doorbell = pring->doorbell.load();
+		prec = rpc_shm_peek(pring, size);
+		if (prec)
+			return (rpc_msg_header_t *) prec;
+
+		// Declare to be sleeping, then check again for a doorbell rang in
+		// the meantime (Barbeque wakes up only sleeping applications)
+		pring->sleeping.store(1);
+		if (pring->doorbell.load() == doorbell && ! done)
+			rpc_shm_wait_doorbell(&(pring->doorbell), doorbell);
+		pring->sleeping.store(0);
+	}
+
+	return NULL;
+}
+
+void BbqueRPC_SHM_Client::RpcBbqResp(rpc_msg_header_t * phdr)
+{
+	std::unique_lock<std::mutex> chCommand_ul(chCommand_mtx);
+	chResp = *((rpc_msg_resp_t *) phdr);
+	// Notify about reception of a new response
+	logger->Debug("Notify response [%d]", chResp.result);
+	chResp_cv.notify_one();
+}
+
+void BbqueRPC_SHM_Client::ChannelFetch()
+{
+	rpc_msg_header_t * phdr;
+	uint32_t size;
+	logger->Debug("Waiting for a message...");
+	phdr = ChannelRecv(size);
+
+	if (! phdr)
+		return;
+
+	logger->Debug("Rx RPC_HDR [typ: %d, sze: %u]", phdr->typ, size);
+
+	// Dispatching the received message (in place)
+	switch (phdr->typ) {
+
+		//--- Application Originated Messages
+	case RPC_APP_RESP:
+		logger->Debug("APP_RESP");
+		RpcBbqResp(phdr);
+		break;
+
+		//--- Execution Context Originated Messages
+	case RPC_EXC_RESP:
+		logger->Debug("EXC_RESP");
+		RpcBbqResp(phdr);
+		break;
+
+		//--- Barbeque Originated Messages
+	case RPC_BBQ_STOP_EXECUTION:
+		logger->Debug("BBQ_STOP_EXECUTION");
+		break;
+
+	case RPC_BBQ_GET_PROFILE:
+		logger->Debug("BBQ_GET_PROFILE");
+		RpcBbqGetRuntimeProfile(phdr);
+		break;
+
+	case RPC_BBQ_SYNCP_PRECHANGE:
+		logger->Debug("BBQ_SYNCP_PRECHANGE");
+		// The message is released before getting the systems ones
+		RpcBbqSyncpPreChange(phdr, size);
+		return;
+
+	case RPC_BBQ_SYNCP_SYNCCHANGE:
+		logger->Debug("BBQ_SYNCP_SYNCCHANGE");
+		RpcBbqSyncpSyncChange(phdr);
+		break;
+
+	case RPC_BBQ_SYNCP_DOCHANGE:
+		logger->Debug("BBQ_SYNCP_DOCHANGE");
+		RpcBbqSyncpDoChange(phdr);
+		break;
+
+	case RPC_BBQ_SYNCP_POSTCHANGE:
+		logger->Debug("BBQ_SYNCP_POSTCHANGE");
+		RpcBbqSyncpPostChange(phdr);
+		break;
+
+	default:
+		logger->Error("Unknown BBQ response/command [%d]", phdr->typ);
+		assert(false);
+		break;
+	}
+
+	// Release the message ring space
+	rpc_shm_consume(&(channel->to_app), size);
+}
+
+void BbqueRPC_SHM_Client::ChannelTrd(const char * name)
+{
+	std::unique_lock<std::mutex> trdStatus_ul(trdStatus_mtx);
+
+	// Set the thread name
+	if (unlikely(prctl(PR_SET_NAME, (long unsigned int) "bq.shm", 0, 0, 0)))
+		logger->Error("Set name FAILED! (Error: %s)\n", strerror(errno));
+
+	// Setup the RTLib UID
+	SetChannelThreadID(gettid(), name);
+	logger->Debug("channel thread [PID: %d] CREATED", channel_thread_pid);
+	// Notifying the thread has beed started
+	trdStatus_cv.notify_one();
+
+	// Waiting for channel setup to be completed
+	trdStatus_cv.wait(trdStatus_ul, [this]() { return running || done; });
+	trdStatus_ul.unlock();
+
+	logger->Debug("channel thread [PID: %d] START", channel_thread_pid);
+
+	while (! done)
+		ChannelFetch();
+
+	logger->Debug("channel thread [PID: %d] END", channel_thread_pid);
+}
+
+#define WAIT_RPC_RESP \
+	chResp.result = RTLIB_BBQUE_CHANNEL_TIMEOUT; \
+	chResp_cv.wait_for(chCommand_ul, \
+			std::chrono::milliseconds(BBQUE_RPC_TIMEOUT), [this]() { \
+			return chResp.result != RTLIB_BBQUE_CHANNEL_TIMEOUT; }); \
+	if (chResp.result == RTLIB_BBQUE_CHANNEL_TIMEOUT) {\
+		logger->Warn("RTLIB response TIMEOUT"); \
+	}
+
+RTLIB_ExitCode_t BbqueRPC_SHM_Client::ChannelPair(const char * name)
+{
+	std::unique_lock<std::mutex> chCommand_ul(chCommand_mtx);
+	logger->Debug("Pairing SHM channel [app: %s, pid: %d]", name,
+		channel_thread_pid);
+	// Sending RPC Request
+	RPC_SHM_RESERVE(APP_PAIR);
+	RPC_SHM_HEADER(RPC_APP_PAIR, RpcMsgToken(), 0);
+	pmsg->mjr_version = RTLIB_VERSION_MAJOR;
+	pmsg->mnr_version = RTLIB_VERSION_MINOR;
+	::memset(pmsg->app_name, '\0', RTLIB_APP_NAME_LENGTH);
+	::strncpy(pmsg->app_name, name, RTLIB_APP_NAME_LENGTH-1);
+	RPC_SHM_SEND(APP_PAIR);
+	logger->Debug("Waiting BBQUE response...");
+	WAIT_RPC_RESP;
+	return (RTLIB_ExitCode_t) chResp.result;
+}
+
+RTLIB_ExitCode_t BbqueRPC_SHM_Client::ChannelSetup()
+{
+	void * paddr;
+	int fd;
+	logger->Debug("Initializing channel");
+	// Mapping the Barbeque region
+	logger->Debug("Opening bbque region [%s]...", BBQUE_PUBLIC_SHM);
+	fd = ::shm_open(BBQUE_PUBLIC_SHM, O_RDWR, 0);
+
+	if (fd < 0) {
+		logger->Error("FAILED opening bbque region [%s] (Error %d: %s)",
+			BBQUE_PUBLIC_SHM, errno, strerror(errno));
+		return RTLIB_BBQUE_CHANNEL_SETUP_FAILED;
+	}
+
+	paddr = ::mmap(NULL, sizeof(rpc_shm_server_t),
+			PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+
+	if (paddr == MAP_FAILED) {
+		logger->Error("FAILED mapping bbque region [%s] (Error %d: %s)",
+			BBQUE_PUBLIC_SHM, errno, strerror(errno));
+		return RTLIB_BBQUE_CHANNEL_SETUP_FAILED;
+	}
+
+	server = (rpc_shm_server_t *) paddr;
+	if (server->version != BBQUE_RPC_SHM_VERSION) {
+		logger->Error("FAILED bbque region [%s] version mismatch "
+			"(0x%08X != 0x%08X)", BBQUE_PUBLIC_SHM,
+			server->version, BBQUE_RPC_SHM_VERSION);
+		::munmap(server, sizeof(rpc_shm_server_t));
+		server = NULL;
+		return RTLIB_BBQUE_CHANNEL_SETUP_FAILED;
+	}
+
+	// Creating the application segment (cleaning up a stale one)
+	logger->Debug("Creating [%s]...", app_shm_name);
+	::shm_unlink(app_shm_name);
+	fd = ::shm_open(app_shm_name, O_RDWR | O_CREAT | O_EXCL, 0600);
+
+	if (fd < 0) {
+		logger->Error("FAILED creating application segment [%s] (Error %d: %s)",
+			app_shm_name, errno, strerror(errno));
+		return RTLIB_BBQUE_CHANNEL_SETUP_FAILED;
+	}
+
+	// The segment is R/W to the owner only: the rings of an application
+	// must not be accessed by other users (the RTRM daemon runs privileged)
+	if (ftruncate(fd, sizeof(rpc_shm_channel_t))) {
+		logger->Error("FAILED setting up application segment [%s] (Error %d: %s)",
+			app_shm_name, errno, strerror(errno));
+		::close(fd);
+		::shm_unlink(app_shm_name);
+		return RTLIB_BBQUE_CHANNEL_SETUP_FAILED;
+	}
+
+	paddr = ::mmap(NULL, sizeof(rpc_shm_channel_t),
+			PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+
+	if (paddr == MAP_FAILED) {
+		logger->Error("FAILED mapping application segment [%s] (Error %d: %s)",
+			app_shm_name, errno, strerror(errno));
+		::shm_unlink(app_shm_name);
+		return RTLIB_BBQUE_CHANNEL_SETUP_FAILED;
+	}
+
+	// The segment is zero filled, i.e. both the rings are empty
+	channel = (rpc_shm_channel_t *) paddr;
+	channel->app_pid = channel_thread_pid;
+	std::atomic_thread_fence(std::memory_order_release);
+	channel->version = BBQUE_RPC_SHM_VERSION;
+
+	// Publishing the segment into a free slot
+	for (int i = 0; i < BBQUE_SHM_MAX_CLIENTS; ++i) {
+		rpc_shm_slot_t & slot(server->slots[i]);
+		uint32_t state = RPC_SHM_SLOT_FREE;
+
+		if (! slot.state.compare_exchange_strong(state, RPC_SHM_SLOT_CLAIMED))
+			continue;
+
+		::strncpy(slot.channel, app_shm_name, BBQUE_SHM_NAME_LENGTH);
+		slot.state.store(RPC_SHM_SLOT_READY);
+		logger->Debug("Published [%s] into slot [%d]", app_shm_name, i);
+		return RTLIB_OK;
+	}
+
+	logger->Error("FAILED publishing application segment [%s] "
+		"(Error: no free slots)", app_shm_name);
+	::munmap(channel, sizeof(rpc_shm_channel_t));
+	channel = NULL;
+	::shm_unlink(app_shm_name);
+	return RTLIB_BBQUE_CHANNEL_SETUP_FAILED;
+}
+
+RTLIB_ExitCode_t BbqueRPC_SHM_Client::_Init(
+					     const char * name)
+{
+	std::unique_lock<std::mutex> trdStatus_ul(trdStatus_mtx);
+	RTLIB_ExitCode_t result;
+	// Starting the communication thread
+	done = false;
+	running = false;
+	ChTrd = std::thread(&BbqueRPC_SHM_Client::ChannelTrd, this, name);
+	trdStatus_cv.wait(trdStatus_ul);
+	// Setting up application segment name
+	snprintf(app_shm_name, BBQUE_SHM_NAME_LENGTH,
+		"/bbque_%05d_%s", channel_thread_pid, name);
+	// Setting up the communication channel
+	result = ChannelSetup();
+
+	if (result != RTLIB_OK)
+		return result;
+
+	// Start the reception thread
+	running = true;
+	trdStatus_cv.notify_one();
+	trdStatus_ul.unlock();
+	// Pairing channel with server
+	result = ChannelPair(name);
+
+	if (result != RTLIB_OK)
+		return result;
+
+	return RTLIB_OK;
+}
+
+RTLIB_ExitCode_t BbqueRPC_SHM_Client::_Register(pRegisteredEXC_t prec)
+{
+	std::unique_lock<std::mutex> chCommand_ul(chCommand_mtx);
+	RPC_SHM_RESERVE(EXC_REGISTER);
+	RPC_SHM_HEADER(RPC_EXC_REGISTER, RpcMsgToken(), prec->id);
+	// EXC and Recipe name: we need a null-termination character to
+	// properly separate two char[] fields
+	memset(pmsg->exc_name, '\0', RTLIB_EXC_NAME_LENGTH);
+	strncpy(pmsg->exc_name, prec->name.c_str(),
+		RTLIB_EXC_NAME_LENGTH-1);
+	memset(pmsg->recipe, '\0', RTLIB_RECIPE_NAME_LENGTH);
+	strncpy(pmsg->recipe, prec->parameters.recipe,
+		RTLIB_RECIPE_NAME_LENGTH-1);
+	pmsg->lang = prec->parameters.language;
+	logger->Debug("Registering EXC [%d:%d:%s:%d]...",
+		pmsg->hdr.app_pid,
+		pmsg->hdr.exc_id,
+		pmsg->exc_name,
+		pmsg->lang);
+	// Sending RPC Request
+	RPC_SHM_SEND(EXC_REGISTER);
+	logger->Debug("Waiting BBQUE response...");
+	WAIT_RPC_RESP;
+	return (RTLIB_ExitCode_t) chResp.result;
+}
+
+RTLIB_ExitCode_t BbqueRPC_SHM_Client::_Unregister(pRegisteredEXC_t prec)
+{
+	std::unique_lock<std::mutex> chCommand_ul(chCommand_mtx);
+	RPC_SHM_RESERVE(EXC_UNREGISTER);
+	RPC_SHM_HEADER(RPC_EXC_UNREGISTER, RpcMsgToken(), prec->id);
+	memset(pmsg->exc_name, '\0', RTLIB_EXC_NAME_LENGTH);
+	strncpy(pmsg->exc_name, prec->name.c_str(),
+		RTLIB_EXC_NAME_LENGTH-1);
+	logger->Debug("Unregistering EXC [%d:%d:%s]...",
+		pmsg->hdr.app_pid,
+		pmsg->hdr.exc_id,
+		pmsg->exc_name);
+	// Sending RPC Request
+	RPC_SHM_SEND(EXC_UNREGISTER);
+	logger->Debug("Waiting BBQUE response...");
+	WAIT_RPC_RESP;
+	return (RTLIB_ExitCode_t) chResp.result;
+}
+
+RTLIB_ExitCode_t BbqueRPC_SHM_Client::_Enable(pRegisteredEXC_t prec)
+{
+	std::unique_lock<std::mutex> chCommand_ul(chCommand_mtx);
+	RPC_SHM_RESERVE(EXC_START);
+	RPC_SHM_HEADER(RPC_EXC_START, RpcMsgToken(), prec->id);
+	logger->Debug("Enabling EXC [%d:%d]...",
+		pmsg->hdr.app_pid,
+		pmsg->hdr.exc_id);
+	// Sending RPC Request
+	RPC_SHM_SEND(EXC_START);
+	logger->Debug("Waiting BBQUE response...");
+	WAIT_RPC_RESP;
+	return (RTLIB_ExitCode_t) chResp.result;
+}
+
+RTLIB_ExitCode_t BbqueRPC_SHM_Client::_Disable(pRegisteredEXC_t prec)
+{
+	std::unique_lock<std::mutex> chCommand_ul(chCommand_mtx);
+	RPC_SHM_RESERVE(EXC_STOP);
+	RPC_SHM_HEADER(RPC_EXC_STOP, RpcMsgToken(), prec->id);
+	logger->Debug("Disabling EXC [%d:%d]...",
+		pmsg->hdr.app_pid,
+		pmsg->hdr.exc_id);
+	// Sending RPC Request
+	RPC_SHM_SEND(EXC_STOP);
+	logger->Debug("Waiting BBQUE response...");
+	WAIT_RPC_RESP;
+	return (RTLIB_ExitCode_t) chResp.result;
+}
+
+RTLIB_ExitCode_t BbqueRPC_SHM_Client::_Set(pRegisteredEXC_t prec,
+					    RTLIB_Constraint_t * constraints, uint8_t count)
+{
+	std::unique_lock<std::mutex> chCommand_ul(chCommand_mtx);
+	// At least 1 constraint it is expected
+	assert(count);
+	// The message is built in place, with room for all the constraints
+	RPC_SHM_RESERVE_SIZE(EXC_SET, RPC_PKT_SIZE(EXC_SET) +
+		((count - 1) * sizeof (RTLIB_Constraint_t)));
+	RPC_SHM_HEADER(RPC_EXC_SET, RpcMsgToken(), prec->id);
+	logger->Debug("_Set: Copying [%d] constraints using buffer @%p "
+		"of [%" PRIu64 "] Bytes...",
+		count, (void *) & (pmsg->constraints),
+		(count) * sizeof (RTLIB_Constraint_t));
+	pmsg->count = count;
+	::memcpy(&(pmsg->constraints), constraints,
+		(count) * sizeof (RTLIB_Constraint_t));
+	logger->Debug("_Set: Set [%d] constraints on EXC [%d:%d]...",
+		count,
+		pmsg->hdr.app_pid,
+		pmsg->hdr.exc_id);
+	// Sending RPC Request
+	RPC_SHM_SEND(EXC_SET);
+	logger->Debug("_Set: Waiting BBQUE response...");
+	WAIT_RPC_RESP;
+	return (RTLIB_ExitCode_t) chResp.result;
+}
+
+RTLIB_ExitCode_t BbqueRPC_SHM_Client::_Clear(pRegisteredEXC_t prec)
+{
+	std::unique_lock<std::mutex> chCommand_ul(chCommand_mtx);
+	RPC_SHM_RESERVE(EXC_CLEAR);
+	RPC_SHM_HEADER(RPC_EXC_CLEAR, RpcMsgToken(), prec->id);
+	logger->Debug("_Clear: Remove constraints for EXC [%d:%d]...",
+		pmsg->hdr.app_pid,
+		pmsg->hdr.exc_id);
+	// Sending RPC Request
+	RPC_SHM_SEND(EXC_CLEAR);
+	logger->Debug("_Clear: Waiting BBQUE response...");
+	WAIT_RPC_RESP;
+	return (RTLIB_ExitCode_t) chResp.result;
+}
+
+RTLIB_ExitCode_t BbqueRPC_SHM_Client::_RTNotify(pRegisteredEXC_t prec, int gap,
+						 int cpu_usage, int cycle_time_ms)
+{
+	std::unique_lock<std::mutex> chCommand_ul(chCommand_mtx);
+	logger->Debug("_RTNotify: Set Goal-Gap for EXC [%d:%d]...",
+		channel_thread_pid, prec->id);
+
+	// Sending RPC Request
+	if (! isSyncMode(prec)) {
+		RPC_SHM_RESERVE(EXC_RTNOTIFY);
+		RPC_SHM_HEADER(RPC_EXC_RTNOTIFY, RpcMsgToken(), prec->id);
+		pmsg->gap = gap;
+		pmsg->cusage = cpu_usage;
+		pmsg->ctime_ms = cycle_time_ms;
+		RPC_SHM_SEND(EXC_RTNOTIFY);
+	}
+
+	return RTLIB_OK;
+}
+
+RTLIB_ExitCode_t BbqueRPC_SHM_Client::_ScheduleRequest(pRegisteredEXC_t prec)
+{
+	std::unique_lock<std::mutex> chCommand_ul(chCommand_mtx);
+	RPC_SHM_RESERVE(EXC_SCHEDULE);
+	RPC_SHM_HEADER(RPC_EXC_SCHEDULE, RpcMsgToken(), prec->id);
+	logger->Debug("_ScheduleRequest: Schedule request for EXC [%d:%d]...",
+		pmsg->hdr.app_pid,
+		pmsg->hdr.exc_id);
+	// Sending RPC Request
+	RPC_SHM_SEND(EXC_SCHEDULE);
+	logger->Debug("_ScheduleRequest: Waiting BBQUE response...");
+	WAIT_RPC_RESP;
+	return (RTLIB_ExitCode_t) chResp.result;
+}
+
+void BbqueRPC_SHM_Client::_Exit()
+{
+	ChannelRelease();
+}
+
+/******************************************************************************
+ * Synchronization Protocol Messages - PreChange
+ ******************************************************************************/
+
+RTLIB_ExitCode_t BbqueRPC_SHM_Client::_SyncpPreChangeResp(
+							   rpc_msg_token_t token, pRegisteredEXC_t prec, uint32_t syncLatency)
+{
+	RPC_SHM_RESERVE(BBQ_SYNCP_PRECHANGE_RESP);
+	RPC_SHM_HEADER(RPC_BBQ_RESP, token, prec->id);
+	pmsg->syncLatency = syncLatency;
+	pmsg->result = RTLIB_OK;
+	logger->Debug("PreChange response EXC [%d:%d] "
+		"latency [%d]...",
+		pmsg->hdr.app_pid,
+		pmsg->hdr.exc_id,
+		pmsg->syncLatency);
+	// Sending RPC Request
+	RPC_SHM_SEND(BBQ_SYNCP_PRECHANGE_RESP);
+	return RTLIB_OK;
+}
+
+void BbqueRPC_SHM_Client::RpcBbqSyncpPreChange(rpc_msg_header_t * phdr,
+		uint32_t size)
+{
+	rpc_msg_BBQ_SYNCP_PRECHANGE_t msg;
+	rpc_msg_header_t * psys;
+	uint32_t sys_size;
+
+	// The systems descriptors follow into the ring: keep the command and
+	// release its ring space
+	msg = *((rpc_msg_BBQ_SYNCP_PRECHANGE_t *) phdr);
+	rpc_shm_consume(&(channel->to_app), size);
+
+	std::vector<rpc_msg_BBQ_SYNCP_PRECHANGE_SYSTEM_t> messages;
+	messages.reserve(msg.nr_sys);
+
+	for (uint_fast16_t i = 0; i < msg.nr_sys; i ++) {
+		psys = ChannelRecv(sys_size);
+
+		if (! psys) {
+			logger->Error("RpcBbqSyncpPreChange: channel released");
+			return;
+		}
+
+		messages.push_back(*((rpc_msg_BBQ_SYNCP_PRECHANGE_SYSTEM_t *) psys));
+		rpc_shm_consume(&(channel->to_app), sys_size);
+	}
+
+	// Notify the Pre-Change
+	SyncP_PreChangeNotify(msg, messages);
+}
+
+/******************************************************************************
+ * Synchronization Protocol Messages - SyncChange
+ ******************************************************************************/
+
+RTLIB_ExitCode_t BbqueRPC_SHM_Client::_SyncpSyncChangeResp(
+							    rpc_msg_token_t token, pRegisteredEXC_t prec, RTLIB_ExitCode_t sync)
+{
+	// Check that the ExitCode can be represented by the response message
+	assert(sync < 256);
+	RPC_SHM_RESERVE(BBQ_SYNCP_SYNCCHANGE_RESP);
+	RPC_SHM_HEADER(RPC_BBQ_RESP, token, prec->id);
+	pmsg->result = (uint8_t) sync;
+	logger->Debug("_SyncpSyncChangeResp: response EXC [%d:%d]...",
+		pmsg->hdr.app_pid,
+		pmsg->hdr.exc_id);
+	// Sending RPC Request
+	RPC_SHM_SEND(BBQ_SYNCP_SYNCCHANGE_RESP);
+	return RTLIB_OK;
+}
+
+void BbqueRPC_SHM_Client::RpcBbqSyncpSyncChange(rpc_msg_header_t * phdr)
+{
+	// Notify the Sync-Change
+	SyncP_SyncChangeNotify(*((rpc_msg_BBQ_SYNCP_SYNCCHANGE_t *) phdr));
+}
+
+/******************************************************************************
+ * Synchronization Protocol Messages - DoChange
+ ******************************************************************************/
+
+void BbqueRPC_SHM_Client::RpcBbqSyncpDoChange(rpc_msg_header_t * phdr)
+{
+	// Notify the Do-Change
+	SyncP_DoChangeNotify(*((rpc_msg_BBQ_SYNCP_DOCHANGE_t *) phdr));
+}
+
+/******************************************************************************
+ * Synchronization Protocol Messages - PostChange
+ ******************************************************************************/
+
+RTLIB_ExitCode_t BbqueRPC_SHM_Client::_SyncpPostChangeResp(
+							    rpc_msg_token_t token, pRegisteredEXC_t prec,
+							    RTLIB_ExitCode_t result)
+{
+	// Check that the ExitCode can be represented by the response message
+	assert(result < 256);
+	RPC_SHM_RESERVE(BBQ_SYNCP_POSTCHANGE_RESP);
+	RPC_SHM_HEADER(RPC_BBQ_RESP, token, prec->id);
+	pmsg->result = (uint8_t) result;
+	logger->Debug("_SyncpPostChangeResp: response EXC [%d:%d]...",
+		pmsg->hdr.app_pid,
+		pmsg->hdr.exc_id);
+	// Sending RPC Request
+	RPC_SHM_SEND(BBQ_SYNCP_POSTCHANGE_RESP);
+	return RTLIB_OK;
+}
+
+void BbqueRPC_SHM_Client::RpcBbqSyncpPostChange(rpc_msg_header_t * phdr)
+{
+	// Notify the Post-Change
+	SyncP_PostChangeNotify(*((rpc_msg_BBQ_SYNCP_POSTCHANGE_t *) phdr));
+}
+
+/*******************************************************************************
+ * Runtime profiling
+ ******************************************************************************/
+
+void BbqueRPC_SHM_Client::RpcBbqGetRuntimeProfile(rpc_msg_header_t * phdr)
+{
+	// Get runtime profile
+	GetRuntimeProfile(*((rpc_msg_BBQ_GET_PROFILE_t *) phdr));
+}
+
+RTLIB_ExitCode_t BbqueRPC_SHM_Client::_GetRuntimeProfileResp(
+							      rpc_msg_token_t token,
+							      pRegisteredEXC_t prec,
+							      uint32_t exc_time,
+							      uint32_t mem_time)
+{
+	RPC_SHM_RESERVE(BBQ_GET_PROFILE_RESP);
+	RPC_SHM_HEADER(RPC_BBQ_RESP, token, prec->id);
+	pmsg->exec_time = exc_time;
+	pmsg->mem_time = mem_time;
+	// Sending RPC response
+	logger->Debug("_GetRuntimeProfileResp: Setting runtime profile info for EXC [%d:%d]...",
+		pmsg->hdr.app_pid,
+		pmsg->hdr.exc_id);
+	RPC_SHM_SEND(BBQ_GET_PROFILE_RESP);
+	return RTLIB_OK;
+}
+
+} // namespace rtlib
+
+} // namespace bbque
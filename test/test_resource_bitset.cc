@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2012  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tests.h"
+
+#include "bbque/res/bitset.h"
+#include "bbque/res/resource_type.h"
+
+// These are a set of useful debugging log formatters
+#define FMT_DBG(fmt) BBQUE_FMT(COLOR_LGRAY,  "BITSET     [DBG]", fmt)
+#define FMT_INF(fmt) BBQUE_FMT(COLOR_GREEN,  "BITSET     [INF]", fmt)
+#define FMT_WRN(fmt) BBQUE_FMT(COLOR_YELLOW, "BITSET     [WRN]", fmt)
+#define FMT_ERR(fmt) BBQUE_FMT(COLOR_RED,    "BITSET     [ERR]", fmt)
+
+using bbque::res::ResourceBitset;
+
+#define CHECK(COND) \
+	if (!(COND)) { \
+		fprintf(stderr, FMT_ERR("%s:%d: check FAILED [%s]\n"), \
+				__FILE__, __LINE__, # COND); \
+		return TEST_FAILED; \
+	}
+
+/** An ID beyond the inline storage */
+#define BITSET_HIGH_ID (2 * BBQUE_RBS_INLINE_WORDS * BBQUE_RBS_WORD_BITS - 1)
+
+static TestResult_t test_set_clear() {
+	ResourceBitset rbs;
+
+	CHECK(rbs.Count() == 0);
+	CHECK(rbs.FirstSet() == R_ID_NONE);
+	CHECK(rbs.LastSet() == R_ID_NONE);
+
+	// Word boundaries
+	CHECK(rbs.Set(0) == ResourceBitset::OK);
+	CHECK(rbs.Set(63) == ResourceBitset::OK);
+	CHECK(rbs.Set(64) == ResourceBitset::OK);
+	CHECK(rbs.Test(0) && rbs.Test(63) && rbs.Test(64));
+	CHECK(!rbs.Test(1) && !rbs.Test(62) && !rbs.Test(65));
+	CHECK(rbs.Count() == 3);
+	CHECK(rbs.FirstSet() == 0);
+	CHECK(rbs.LastSet() == 64);
+
+	// Setting twice does not count twice
+	CHECK(rbs.Set(63) == ResourceBitset::OK);
+	CHECK(rbs.Count() == 3);
+
+	CHECK(rbs.Reset(63) == ResourceBitset::OK);
+	CHECK(!rbs.Test(63) && rbs.Test(64));
+	CHECK(rbs.Count() == 2);
+	CHECK(rbs.Reset(0) == ResourceBitset::OK);
+	CHECK(rbs.FirstSet() == 64);
+
+	// Out of range IDs
+	CHECK(rbs.Set(-1) == ResourceBitset::OUT_OF_RANGE);
+	CHECK(rbs.Reset(-1) == ResourceBitset::OUT_OF_RANGE);
+	CHECK(!rbs.Test(-1) && !rbs.Test(BITSET_HIGH_ID));
+
+	CHECK(rbs.Reset() == ResourceBitset::OK);
+	CHECK(rbs.Count() == 0);
+	CHECK(rbs.ToStringCG().empty());
+
+	return TEST_PASSED;
+}
+
+static TestResult_t test_growth() {
+	ResourceBitset rbs, small;
+	BBQUE_RID_TYPE high = BITSET_HIGH_ID;
+
+	CHECK(rbs.Set(1) == ResourceBitset::OK);
+	CHECK(rbs.Set(high) == ResourceBitset::OK);
+	CHECK(rbs.Test(1) && rbs.Test(high));
+	CHECK(rbs.Count() == 2);
+	CHECK(rbs.LastSet() == high);
+	CHECK(rbs.ToString().size() >= (size_t)high + 1);
+
+	// Sets of different storage sizes
+	CHECK(small.Set(1) == ResourceBitset::OK);
+	CHECK(small != rbs);
+	CHECK(rbs.Reset(high) == ResourceBitset::OK);
+	CHECK(small == rbs);
+	CHECK(rbs == small);
+
+	CHECK(rbs.Set(high) == ResourceBitset::OK);
+	small |= rbs;
+	CHECK(small.Test(high) && small.Count() == 2);
+
+	ResourceBitset mask;
+	CHECK(mask.Set(high) == ResourceBitset::OK);
+	small &= mask;
+	CHECK(small.Count() == 1 && small.FirstSet() == high);
+
+	// Intersection with a smaller set
+	ResourceBitset empty;
+	rbs &= empty;
+	CHECK(rbs.Count() == 0);
+
+	return TEST_PASSED;
+}
+
+static TestResult_t test_cpuset_string() {
+	ResourceBitset rbs;
+
+	for (BBQUE_RID_TYPE id = 0; id <= 3; ++id)
+		rbs.Set(id);
+	rbs.Set(8);
+	rbs.Set(10);
+	rbs.Set(11);
+	CHECK(rbs.ToStringCG() == "0-3,8,10-11");
+
+	// The string is rebuilt after a change
+	rbs.Reset(2);
+	CHECK(rbs.ToStringCG() == "0-1,3,8,10-11");
+
+	// Ranges across words
+	ResourceBitset cross;
+	for (BBQUE_RID_TYPE id = 60; id <= 68; ++id)
+		cross.Set(id);
+	CHECK(cross.ToStringCG() == "60-68");
+
+	rbs |= cross;
+	CHECK(rbs.ToStringCG() == "0-1,3,8,10-11,60-68");
+
+	rbs.Reset();
+	CHECK(rbs.ToStringCG().empty());
+	rbs.Set(5);
+	CHECK(rbs.ToStringCG() == "5");
+
+	return TEST_PASSED;
+}
+
+/**
+ * Check the ResourceBitset operations, across the storage words boundaries
+ * and the growth of the storage
+ */
+TestResult_t test_resource_bitset(int argc, char *argv[]) {
+	(void)argc;
+	(void)argv;
+
+	fprintf(stderr, FMT_INF("Here is the ResourceBitset test\n"));
+
+	if (test_set_clear() != TEST_PASSED)
+		return TEST_FAILED;
+	if (test_growth() != TEST_PASSED)
+		return TEST_FAILED;
+	if (test_cpuset_string() != TEST_PASSED)
+		return TEST_FAILED;
+
+	return TEST_PASSED;
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2012  Politecnico di Milano
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tests.h"
+
+#include <cstdlib>
+
+// These are a set of useful debugging log formatters
+#define FMT_DBG(fmt) BBQUE_FMT(COLOR_LGRAY,  "OVERHEAD   [DBG]", fmt)
+#define FMT_INF(fmt) BBQUE_FMT(COLOR_GREEN,  "OVERHEAD   [INF]", fmt)
+#define FMT_WRN(fmt) BBQUE_FMT(COLOR_YELLOW, "OVERHEAD   [WRN]", fmt)
+#define FMT_ERR(fmt) BBQUE_FMT(COLOR_RED,    "OVERHEAD   [ERR]", fmt)
+
+/** The default number of measured processing cycles */
+#define OVERHEAD_CYCLES 100000
+
+/** The workloads [us] of the processing cycles to measure */
+static const double overhead_workloads_us[] = {0, 10, 50, 100};
+
+using bbque::rtlib::BbqueEXC;
+using bbque::utils::Timer;
+
+// The RTLib context;
+extern RTLIB_Services_t *rtlib;
+
+
+/**
+ * @class OverheadEXC
+ * @brief An EXC measuring the RTLib overhead of its processing cycles
+ *
+ * Each onRun() busy-waits for the specified workload, while onMonitor() does
+ * nothing. The time spent outside of these methods, i.e., in the control
+ * loop and in the RTLib notifiers, is the per-cycle overhead.
+ */
+class OverheadEXC : public BbqueEXC {
+
+public:
+
+	OverheadEXC(std::string const & name,
+			std::string const & recipe,
+			RTLIB_Services_t *rtlib,
+			uint32_t cycles, double workload_us) :
+		BbqueEXC(name, recipe, rtlib),
+		cycles_max(cycles),
+		workload_us(workload_us) {
+	}
+
+	/** The number of measured cycles */
+	uint32_t cycles_done = 0;
+
+	/** [us] The time elapsed since the first measured cycle */
+	double elapsed_us = 0;
+
+	/** [us] The time spent within onRun() and onMonitor() */
+	double callbacks_us = 0;
+
+private:
+
+	uint32_t cycles_max;
+
+	double workload_us;
+
+	double tstart_us = 0;
+
+	RTLIB_ExitCode_t onRun();
+	RTLIB_ExitCode_t onMonitor();
+
+};
+
+RTLIB_ExitCode_t
+OverheadEXC::onRun() {
+	double tenter_us = Timer::getTimestampUs();
+
+	if (cycles_done == cycles_max)
+		return RTLIB_EXC_WORKLOAD_NONE;
+
+	if (cycles_done == 0)
+		tstart_us = tenter_us;
+
+	// Busy waiting, not to leave the CPU
+	while (Timer::getTimestampUs() - tenter_us < workload_us);
+
+	callbacks_us += Timer::getTimestampUs() - tenter_us;
+	return RTLIB_OK;
+}
+
+RTLIB_ExitCode_t
+OverheadEXC::onMonitor() {
+	double tenter_us = Timer::getTimestampUs();
+
+	++cycles_done;
+	elapsed_us = tenter_us - tstart_us;
+	callbacks_us += Timer::getTimestampUs() - tenter_us;
+	return RTLIB_OK;
+}
+
+/**
+ * Measure the RTLib overhead for processing cycles of different lengths.
+ *
+ * Unless BBQUE_RTLIB_OPTS is already defined, the EXCs run in UNMANAGED mode,
+ * thus not requiring the BarbequeRTRM daemon. The number of cycles can be
+ * specified as the second argument.
+ */
+TestResult_t test_rtlib_overhead(int argc, char *argv[]) {
+	uint32_t cycles = OVERHEAD_CYCLES;
+	char exc_name[32];
+
+	if (argc > 2)
+		cycles = std::strtoul(argv[2], nullptr, 10);
+
+	fprintf(stderr, FMT_INF("Here is the RTLib overhead benchmark\n"));
+
+	// Initializing the RTLib library
+	fprintf(stderr, FMT_INF("Init RTLib library...\n"));
+
+	setenv("BBQUE_RTLIB_OPTS", "U", 0);
+	RTLIB_Init("BbqTesting", &rtlib);
+	if (!rtlib) {
+		fprintf(stderr, FMT_ERR("RTLib initialization FAILED\n"));
+		return TEST_FAILED;
+	}
+
+	for (double workload_us : overhead_workloads_us) {
+		snprintf(exc_name, sizeof(exc_name), "Overhead_%03.0fus", workload_us);
+		OverheadEXC oexc(exc_name, "Test_Testing8", rtlib,
+				cycles, workload_us);
+		if (!oexc.isRegistered()) {
+			fprintf(stderr, FMT_ERR("OverheadEXC creation FAILED\n"));
+			return TEST_FAILED;
+		}
+
+		// Run all the cycles
+		oexc.Start();
+		oexc.WaitCompletion();
+
+		if (oexc.cycles_done == 0) {
+			fprintf(stderr, FMT_ERR("[%s] no cycles completed\n"), exc_name);
+			return TEST_FAILED;
+		}
+
+		double overhead_ns = 1e3 *
+			(oexc.elapsed_us - oexc.callbacks_us) / oexc.cycles_done;
+		fprintf(stderr, FMT_INF("[%s] %u cycles, %.3f [ms] "
+					"=> RTLib overhead: %.1f [ns/cycle]\n"),
+				exc_name, oexc.cycles_done, oexc.elapsed_us / 1e3,
+				overhead_ns);
+	}
+
+	return TEST_PASSED;
+}